@@ -0,0 +1,664 @@
+#!/usr/bin/env python3
+#
+# HYDROTEL a spatially distributed hydrological model
+# Copyright (C) 2013 INRS Eau Terre Environnement
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+# USA
+#
+
+#banc d'essai de performance
+#
+#chaque cas de cases.csv est une variante fixe du projet DemoProject/DELISLE:
+#  - le bassin (zones, troncons, noeuds, rasters physitel) est replique N fois; les copies sont placees a l'est
+#    du bassin original et leur exutoire se jette dans le troncon exutoire du projet
+#  - periode, pas de temps et sous-modeles imposes par le cas
+#  - etats initiaux, milieux humides et sorties desactives (sauf DEBITS_AVAL)
+#  - cas horaires: les fichiers .met journaliers des stations sont desagreges au pas horaire
+#
+#hydrotel est execute avec -lps; les debits (zone-pas/s, troncon-sous-pas/s) sont lus dans le fichier log-performance
+
+import argparse
+import csv
+import datetime
+import math
+import os
+import re
+import shutil
+import statistics
+import subprocess
+import sys
+
+
+REPERTOIRE_BENCH = os.path.dirname(os.path.abspath(__file__))
+REPERTOIRE_DEPOT = os.path.dirname(REPERTOIRE_BENCH)
+
+ETAPES = [
+	('Weather interpolation',			'interpolation'),
+	('Snow cover evolution',			'fonte_neige'),
+	('Glacier melt',					'fonte_glacier'),
+	('Soil temp/Frost depth',			'tempsol'),
+	('Potential evp',					'etp'),
+	('Vertical water balance',			'bilan_vertical'),
+	('Flow towards network (runoff)',	'ruisselement'),
+	('Flow in the network (routing)',	'acheminement'),
+]
+
+INTERPOLATION = {
+	'THIESSEN1':	('THIESSEN', 1),
+	'THIESSEN2':	('THIESSEN', 2),
+	'GRILLE':		('GRILLE', None),
+}
+
+BILAN_VERTICAL = {
+	'BV3C1':	('BV3C', 1),
+	'BV3C2':	('BV3C', 2),
+	'CEQUEAU':	('CEQUEAU', None),
+}
+
+
+VALEUR_MANQUANTE = -999.0
+
+
+class ERREUR_BENCH(Exception):
+	pass
+
+
+#--------------------------------------------------------------------------------------------------------------------
+#fichiers texte hydrotel (latin-1, fin de ligne conservee)
+
+def LectureLignes(nom_fichier):
+	with open(nom_fichier, 'r', encoding='latin-1', newline='') as fichier:
+		texte = fichier.read()
+
+	eol = '\r\n' if '\r\n' in texte else '\n'
+	return texte.splitlines(), eol
+
+
+def SauvegardeLignes(nom_fichier, lignes, eol):
+	with open(nom_fichier, 'w', encoding='latin-1', newline='') as fichier:
+		fichier.write(eol.join(lignes) + eol)
+
+
+def Cle(ligne):
+	return ligne.split(';', 1)[0].strip().upper()
+
+
+def ChangeCles(nom_fichier, valeurs):
+	#remplace la valeur des lignes CLE;valeur; valeurs: {cle: valeur ou fonction(cle)->valeur}
+	lignes, eol = LectureLignes(nom_fichier)
+
+	for i, ligne in enumerate(lignes):
+		cle = Cle(ligne)
+		for motif, valeur in valeurs.items():
+			if cle == motif or (motif.endswith('*') and cle.startswith(motif[:-1])):
+				lignes[i] = cle + ';' + valeur
+				break
+
+	SauvegardeLignes(nom_fichier, lignes, eol)
+
+
+def LectureCle(nom_fichier, cle):
+	lignes, _ = LectureLignes(nom_fichier)
+	for ligne in lignes:
+		if Cle(ligne) == cle:
+			return ligne.split(';', 1)[1].split(';')[0].strip()
+	raise ERREUR_BENCH('%s: cle absente: %s' % (nom_fichier, cle))
+
+
+def Decale(ident, decalage):
+	#decalage d'un identifiant (zones: negatif pour les lacs)
+	return ident - decalage if ident < 0 else ident + decalage
+
+
+#--------------------------------------------------------------------------------------------------------------------
+#replication du bassin
+
+def RepliqueTable(nom_fichier, entetes, decalage, nb_copie, separateur=';'):
+	#replique les lignes d'une table dont la 1ere colonne est un identifiant (zone ou troncon)
+	#la table commence apres la ligne dont la 1ere colonne est dans entetes
+	if not os.path.isfile(nom_fichier):
+		return
+
+	lignes, eol = LectureLignes(nom_fichier)
+
+	debut = None
+	for i, ligne in enumerate(lignes):
+		if Cle(ligne) in entetes:
+			debut = i + 1
+			break
+
+	if debut is None:
+		return
+
+	table = [l for l in lignes[debut:] if l.strip() != '']
+	nouvelles = list(table)
+
+	for k in range(1, nb_copie):
+		for ligne in table:
+			cols = ligne.split(separateur)
+			cols[0] = str(Decale(int(cols[0]), k * decalage))
+			nouvelles.append(separateur.join(cols))
+
+	SauvegardeLignes(nom_fichier, lignes[:debut] + nouvelles, eol)
+
+
+def RepliqueCla(nom_fichier, nb_entete, decalage, nb_copie):
+	#occupation_sol.cla (3 lignes d'entete), type_sol.cla (1 ligne): ident valeurs...
+	lignes, eol = LectureLignes(nom_fichier)
+
+	table = [l for l in lignes[nb_entete:] if l.strip() != '']
+	nouvelles = list(table)
+
+	for k in range(1, nb_copie):
+		for ligne in table:
+			cols = ligne.split()
+			cols[0] = str(Decale(int(cols[0]), k * decalage))
+			nouvelles.append(' '.join(cols))
+
+	SauvegardeLignes(nom_fichier, lignes[:nb_entete] + nouvelles, eol)
+
+
+def RepliqueNoeuds(nom_fichier, nb_copie):
+	lignes, eol = LectureLignes(nom_fichier)
+
+	table = [l.split() for l in lignes[3:] if l.strip() != '']
+	nb_noeud = max(int(cols[0]) for cols in table)
+
+	nouvelles = [' '.join(cols) for cols in table]
+	for k in range(1, nb_copie):
+		for cols in table:
+			nouvelles.append(' '.join([str(int(cols[0]) + k * nb_noeud)] + cols[1:]))
+
+	lignes[1] = str(len(nouvelles))
+	SauvegardeLignes(nom_fichier, lignes[:3] + nouvelles, eol)
+
+	return nb_noeud
+
+
+def RepliqueTroncons(nom_fichier, nb_copie, nb_zone, nb_noeud):
+	#format PHYSITEL4: id type noeud_aval ...
+	#  riviere (1): noeud_amont longueur largeur manning nb_zone zones... [shreve]
+	#  lac (2):     nb_noeud_amont noeuds_amont... longueur surface c k nb_zone zones... [shreve]
+	lignes, eol = LectureLignes(nom_fichier)
+
+	table = [l.split() for l in lignes[3:] if l.strip() != '']
+	nb_troncon = len(table)
+
+	if int(table[0][0]) == 0:
+		raise ERREUR_BENCH('%s: ancien format de fichier troncon non supporte' % nom_fichier)
+
+	#noeud amont du troncon exutoire (1er troncon); recoit l'exutoire des copies
+	if int(table[0][1]) == 1:
+		noeud_confluence = int(table[0][3])
+	else:
+		noeud_confluence = int(table[0][4])
+
+	nouvelles = [' '.join(cols) for cols in table]
+
+	for k in range(1, nb_copie):
+		for n, cols in enumerate(table):
+			cols = list(cols)
+			type_troncon = int(cols[1])
+
+			cols[0] = str(int(cols[0]) + k * nb_troncon)
+			cols[2] = str(int(cols[2]) + k * nb_noeud)
+
+			if type_troncon == 1:
+				cols[3] = str(int(cols[3]) + k * nb_noeud)
+				pos = 7
+			elif type_troncon == 2:
+				nb_amont = int(cols[3])
+				for j in range(4, 4 + nb_amont):
+					cols[j] = str(int(cols[j]) + k * nb_noeud)
+				pos = 4 + nb_amont + 4
+			else:
+				raise ERREUR_BENCH('%s: type de troncon non supporte: %d' % (nom_fichier, type_troncon))
+
+			nb = int(cols[pos])
+			for j in range(pos + 1, pos + 1 + nb):
+				cols[j] = str(Decale(int(cols[j]), k * nb_zone))
+
+			if n == 0:
+				cols[2] = str(noeud_confluence)
+
+			nouvelles.append(' '.join(cols))
+
+	lignes[1] = str(len(nouvelles))
+	SauvegardeLignes(nom_fichier, lignes[:3] + nouvelles, eol)
+
+	return nb_troncon
+
+
+def RepliquePixels(nom_fichier, nb_copie, nb_troncon):
+	#point.rdx: nb_ligne nb_colonne nb_pixel, puis ligne colonne id_troncon
+	if not os.path.isfile(nom_fichier):
+		return
+
+	lignes, eol = LectureLignes(nom_fichier)
+
+	nb_ligne, nb_col, nb_pixel = [int(v) for v in lignes[0].split()]
+	table = [l.split() for l in lignes[1:1 + nb_pixel]]
+
+	nouvelles = [' '.join(cols) for cols in table]
+	for k in range(1, nb_copie):
+		for cols in table:
+			nouvelles.append('%s %d %d' % (cols[0], int(cols[1]) + k * nb_col, int(cols[2]) + k * nb_troncon))
+
+	entete = '%d %d %d' % (nb_ligne, nb_col * nb_copie, len(nouvelles))
+	SauvegardeLignes(nom_fichier, [entete] + nouvelles, eol)
+
+
+def RepliqueRaster(nom_fichier, nb_copie, decalage_zone=None):
+	#les copies sont juxtaposees a l'est; decalage_zone: identifiants de zone decales pour chaque copie
+	if nb_copie == 1:
+		return
+
+	try:
+		from osgeo import gdal
+		import numpy
+	except ImportError:
+		raise ERREUR_BENCH('la replication des rasters requiert les modules python osgeo (gdal) et numpy')
+
+	source = gdal.Open(nom_fichier)
+	if source is None:
+		raise ERREUR_BENCH('erreur de lecture: %s' % nom_fichier)
+
+	bande = source.GetRasterBand(1)
+	donnees = bande.ReadAsArray()
+	nodata = bande.GetNoDataValue()
+
+	copies = []
+	for k in range(nb_copie):
+		copie = donnees.copy()
+		if decalage_zone is not None and k != 0:
+			masque = copie != 0
+			if nodata is not None:
+				masque &= copie != nodata
+			copie[masque & (copie > 0)] += k * decalage_zone
+			copie[masque & (copie < 0)] -= k * decalage_zone
+		copies.append(copie)
+
+	resultat = numpy.hstack(copies)
+
+	pilote = source.GetDriver()
+	nom_temp = nom_fichier + '.tmp' + os.path.splitext(nom_fichier)[1]
+
+	destination = pilote.Create(nom_temp, resultat.shape[1], resultat.shape[0], 1, bande.DataType)
+	destination.SetGeoTransform(source.GetGeoTransform())
+	destination.SetProjection(source.GetProjection())
+
+	bande_dest = destination.GetRasterBand(1)
+	if nodata is not None:
+		bande_dest.SetNoDataValue(nodata)
+	bande_dest.WriteArray(resultat)
+
+	destination = None
+	source = None
+
+	os.replace(nom_temp, nom_fichier)
+
+
+def RepliqueBassin(projet, simulation, nb_copie):
+	physitel = os.path.join(projet, 'physitel')
+	physio = os.path.join(projet, 'physio')
+	nom_projet = NomFichierProjet(projet)
+
+	#zones
+	nom_zone = os.path.join(projet, LectureCle(nom_projet, 'FICHIER ZONE'))
+	nom_resumer = os.path.splitext(nom_zone)[0] + '.csv'
+
+	lignes, _ = LectureLignes(nom_resumer)
+	nb_zone = max(abs(int(l.split(';')[0])) for l in lignes[3:] if l.strip() != '')
+
+	RepliqueRaster(nom_zone, nb_copie, nb_zone)
+	for cle in ['FICHIER ALTITUDE', 'FICHIER PENTE', 'FICHIER ORIENTATION']:
+		RepliqueRaster(os.path.join(projet, LectureCle(nom_projet, cle)), nb_copie)
+
+	RepliqueTable(nom_resumer, ['UHRH ID'], nb_zone, nb_copie)
+
+	RepliqueCla(os.path.join(physitel, 'occupation_sol.cla'), 3, nb_zone, nb_copie)
+	RepliqueCla(os.path.join(physitel, 'type_sol.cla'), 1, nb_zone, nb_copie)
+
+	#reseau
+	nb_noeud = RepliqueNoeuds(os.path.join(projet, LectureCle(nom_projet, 'FICHIER NOEUD')), nb_copie)
+	nb_troncon = RepliqueTroncons(os.path.join(projet, LectureCle(nom_projet, 'FICHIER TRONCON')), nb_copie, nb_zone, nb_noeud)
+	RepliquePixels(os.path.join(projet, LectureCle(nom_projet, 'FICHIER PIXELS')), nb_copie, nb_troncon)
+
+	RepliqueTable(os.path.join(physio, 'troncon_width_depth.csv'), ['ID'], nb_troncon, nb_copie)
+	RepliqueTable(os.path.join(physio, 'shreve.csv'), ['IDTRONCON'], nb_troncon, nb_copie)
+	RepliqueTable(os.path.join(physio, 'strahler.csv'), ['IDTRONCON'], nb_troncon, nb_copie)
+	RepliqueTable(os.path.join(physio, 'wet_pixel_info.csv'), ['UHRHID'], nb_zone, nb_copie)
+
+	#parametres des sous-modeles (par zone ou par troncon)
+	for nom in os.listdir(simulation):
+		if nom.lower().endswith('.csv'):
+			RepliqueTable(os.path.join(simulation, nom), ['UHRH ID'], nb_zone, nb_copie)
+			RepliqueTable(os.path.join(simulation, nom), ['TRONCON ID'], nb_troncon, nb_copie)
+
+	return nb_zone * nb_copie, nb_troncon * nb_copie
+
+
+#--------------------------------------------------------------------------------------------------------------------
+#donnees meteo horaires
+
+def LectureDate(texte):
+	return datetime.datetime.strptime(texte.strip(), '%Y-%m-%d %H:%M')
+
+
+def TemperatureHoraire(tmax, tmin, heure):
+	#cycle journalier: tmin a 3h, tmax a 15h; heure de fin du pas de temps (1 a 24)
+	if tmax <= VALEUR_MANQUANTE and tmin <= VALEUR_MANQUANTE:
+		return VALEUR_MANQUANTE
+	if tmax <= VALEUR_MANQUANTE:
+		return tmin
+	if tmin <= VALEUR_MANQUANTE:
+		return tmax
+
+	return (tmax + tmin) / 2.0 - (tmax - tmin) / 2.0 * math.cos(2.0 * math.pi * (heure - 0.5 - 3.0) / 24.0)
+
+
+def DesagregeMeteoHoraire(projet, nom_fichier_simulation, date_debut, date_fin):
+	#fichiers GIBSI journaliers (en-tete "1 24": JJ/MM/AAAA TMax TMin Precip.) convertis au pas horaire
+	#(en-tete "1 1": JJ/MM/AAAA HH Temp. Precip.); precipitation repartie egalement sur les 24 heures
+	#seuls les jours de la periode du cas sont conserves
+	nom_stm = os.path.join(projet, LectureCle(nom_fichier_simulation, 'FICHIER STATIONS METEO'))
+	repertoire = os.path.dirname(nom_stm)
+
+	jour_debut = (date_debut - datetime.timedelta(days=1)).date()
+	jour_fin = date_fin.date()
+
+	for nom in sorted(os.listdir(repertoire)):
+		if not nom.lower().endswith('.met'):
+			continue
+
+		nom_fichier = os.path.join(repertoire, nom)
+		lignes, eol = LectureLignes(nom_fichier)
+
+		entete = lignes[0].split()
+		if len(entete) < 2 or entete[1] != '24':
+			continue
+
+		nouvelles = [entete[0] + '\t1']
+
+		for no_ligne, ligne in enumerate(lignes[1:], 2):
+			cols = ligne.split()
+			if not cols:
+				continue
+
+			if len(cols) != 4:
+				raise ERREUR_BENCH('%s: ligne %d: format journalier attendu: JJ/MM/AAAA TMax TMin Precip.' % (nom_fichier, no_ligne))
+
+			jour = datetime.datetime.strptime(cols[0], '%d/%m/%Y').date()
+			if jour < jour_debut or jour > jour_fin:
+				continue
+
+			tmax, tmin, pluie = float(cols[1]), float(cols[2]), float(cols[3])
+			pluie_horaire = VALEUR_MANQUANTE if pluie <= VALEUR_MANQUANTE else pluie / 24.0
+
+			for heure in range(1, 25):
+				temperature = TemperatureHoraire(tmax, tmin, heure)
+				nouvelles.append('%s\t%d\t%.2f\t%.4f' % (cols[0], heure, temperature, pluie_horaire))
+
+		SauvegardeLignes(nom_fichier, nouvelles, eol)
+
+
+#--------------------------------------------------------------------------------------------------------------------
+#preparation d'un cas
+
+def NomFichierProjet(projet):
+	nom = os.path.join(projet, os.path.basename(os.path.normpath(projet)) + '.csv')
+	if not os.path.isfile(nom):
+		raise ERREUR_BENCH('fichier projet introuvable: %s' % nom)
+	return nom
+
+
+def PrepareCas(cas, source, travail, grille_meteo):
+	projet = os.path.join(travail, cas['nom'], os.path.basename(os.path.normpath(source)))
+
+	if os.path.isdir(projet):
+		shutil.rmtree(projet)
+	shutil.copytree(source, projet)
+
+	nom_simulation = LectureCle(NomFichierProjet(projet), 'SIMULATION COURANTE')
+	simulation = os.path.join(projet, 'simulation', nom_simulation)
+	nom_fichier_simulation = os.path.join(simulation, nom_simulation + '.csv')
+
+	#resultats d'une execution precedente du projet source
+	shutil.rmtree(os.path.join(simulation, 'resultat'), ignore_errors=True)
+
+	#hgm recalcule pour le pas de temps et le bassin replique
+	repertoire_hgm = os.path.join(projet, 'hgm')
+	if os.path.isdir(repertoire_hgm):
+		for nom in os.listdir(repertoire_hgm):
+			if nom.lower().endswith('.hgm'):
+				os.remove(os.path.join(repertoire_hgm, nom))
+
+	interpolation, version_thiessen = INTERPOLATION[cas['interpolation']]
+	bilan_vertical, version_bv3c = BILAN_VERTICAL[cas['bilan_vertical']]
+
+	valeurs = {
+		'DATE DEBUT':				cas['date_debut'],
+		'DATE FIN':					cas['date_fin'],
+		'PAS DE TEMPS':				cas['pas_de_temps'],
+		'PREVISION METEO':			'0',
+		'INTERPOLATION DONNEES':	interpolation,
+		'FONTE DE NEIGE':			cas['fonte_neige'],
+		'BILAN VERTICAL':			bilan_vertical,
+		'ACHEMINEMENT RIVIERE':		cas['acheminement'],
+		'MILIEUX HUMIDES ISOLES':	'0',
+		'MILIEUX HUMIDES RIVERAINS':	'0',
+		'LECTURE ETAT*':			'',
+		'ECRITURE ETAT*':			'',
+	}
+
+	if interpolation == 'GRILLE':
+		if grille_meteo is None:
+			raise ERREUR_BENCH('le cas %s requiert --grille-meteo' % cas['nom'])
+		valeurs['FICHIER GRILLE METEO'] = os.path.abspath(grille_meteo)
+
+	ChangeCles(nom_fichier_simulation, valeurs)
+
+	#les stations du projet sont journalieres
+	if int(cas['pas_de_temps']) != 24:
+		if int(cas['pas_de_temps']) != 1:
+			raise ERREUR_BENCH('cas %s: pas de temps non supporte: %s (1 ou 24)' % (cas['nom'], cas['pas_de_temps']))
+		DesagregeMeteoHoraire(projet, nom_fichier_simulation, LectureDate(cas['date_debut']), LectureDate(cas['date_fin']))
+
+	#versions des sous-modeles
+	nom_versions = os.path.join(simulation, 'submodels-versions.txt')
+	versions = {}
+	if version_thiessen is not None:
+		versions['THIESSEN'] = str(version_thiessen)
+	if version_bv3c is not None:
+		versions['BV3C'] = str(version_bv3c)
+	if versions:
+		ChangeCles(nom_versions, versions)
+
+	#sorties: debits aval seulement
+	lignes, eol = LectureLignes(os.path.join(simulation, 'output.csv'))
+	for i, ligne in enumerate(lignes):
+		cle = Cle(ligne)
+		if re.match(r'^[A-Z0-9_]+;1$', ligne.strip()) and cle != 'DEBITS_AVAL':
+			lignes[i] = cle + ';0'
+	SauvegardeLignes(os.path.join(simulation, 'output.csv'), lignes, eol)
+
+	nb_zone, nb_troncon = RepliqueBassin(projet, simulation, int(cas['replication']))
+
+	return projet, simulation, nb_zone, nb_troncon
+
+
+#--------------------------------------------------------------------------------------------------------------------
+#execution et lecture du log de performance
+
+def LectureLogPerformance(nom_fichier):
+	lignes, _ = LectureLignes(nom_fichier)
+
+	resultat = {'simulation': None, 'duree': {}, 'debit': {}, 'unite': {}}
+	section = None
+
+	for ligne in lignes:
+		m = re.match(r'^Simulation: ([0-9.]+) sec\.$', ligne)
+		if m:
+			resultat['simulation'] = float(m.group(1))
+			section = 'duree'
+			continue
+
+		if ligne.startswith('Throughput'):
+			section = 'debit'
+			continue
+
+		if ligne.startswith('Post-processing'):
+			section = None
+			continue
+
+		for etape, cle in ETAPES:
+			m = re.match(r'^\s+' + re.escape(etape) + r':\s+([0-9.]+) (sec|zone-steps/s|reach-substeps/s|reach-steps/s)\.$', ligne)
+			if m and section is not None:
+				if section == 'duree':
+					resultat['duree'][cle] = float(m.group(1))
+				else:
+					resultat['debit'][cle] = float(m.group(1))
+					resultat['unite'][cle] = m.group(2)
+
+	if resultat['simulation'] is None:
+		raise ERREUR_BENCH('log de performance invalide: %s' % nom_fichier)
+
+	return resultat
+
+
+def ExecuteCas(hydrotel, projet, simulation, nb_thread):
+	avant = set(f for f in os.listdir(simulation) if f.startswith('log-performance-'))
+
+	commande = [hydrotel, NomFichierProjet(projet), '-c', '-lps']
+	if nb_thread is not None:
+		commande += ['-t', str(nb_thread)]
+
+	proc = subprocess.run(commande, cwd=projet, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True, errors='replace')
+	if proc.returncode != 0:
+		raise ERREUR_BENCH('hydrotel a echoue (code %d):\n%s' % (proc.returncode, proc.stdout[-2000:]))
+
+	nouveaux = sorted(f for f in os.listdir(simulation) if f.startswith('log-performance-') and f.endswith('.txt') and f not in avant)
+	if not nouveaux:
+		raise ERREUR_BENCH('fichier log-performance introuvable dans %s' % simulation)
+
+	return LectureLogPerformance(os.path.join(simulation, nouveaux[-1]))
+
+
+#--------------------------------------------------------------------------------------------------------------------
+
+def LectureCas(nom_fichier):
+	with open(nom_fichier, 'r', encoding='latin-1', newline='') as fichier:
+		lignes = [l for l in fichier.read().splitlines() if l.strip() != '' and not l.startswith('#')]
+
+	return list(csv.DictReader(lignes, delimiter=';'))
+
+
+def main():
+	parser = argparse.ArgumentParser(description='Banc d\'essai de performance HYDROTEL (variantes de DemoProject/DELISLE).')
+	parser.add_argument('--hydrotel', default=os.path.join(REPERTOIRE_DEPOT, 'gcc', 'hydrotel'), help='executable hydrotel')
+	parser.add_argument('--projet', default=os.path.join(REPERTOIRE_DEPOT, 'DemoProject', 'DELISLE'), help='projet source')
+	parser.add_argument('--cas', default=os.path.join(REPERTOIRE_BENCH, 'cases.csv'), help='fichier des cas')
+	parser.add_argument('--filtre', default=None, help='expression reguliere sur le nom des cas a executer')
+	parser.add_argument('--travail', default=os.path.join(REPERTOIRE_BENCH, 'travail'), help='repertoire des projets generes')
+	parser.add_argument('--repetitions', type=int, default=3, help='nb executions par cas (mediane)')
+	parser.add_argument('--thread', type=int, default=None, help='nb threads (option -t de hydrotel)')
+	parser.add_argument('--grille-meteo', default=None, help='fichier grille meteo (netCDF) pour les cas GRILLE')
+	parser.add_argument('--sortie', default=os.path.join(REPERTOIRE_DEPOT, 'bench_output.txt'), help='fichier resultat (csv)')
+	parser.add_argument('--rapide', action='store_true', help='essai rapide (integration continue): 1er cas horaire THIESSEN, 1 copie du bassin, 31 jours, 1 execution')
+	args = parser.parse_args()
+
+	if not os.path.isfile(args.hydrotel):
+		print('executable introuvable: %s' % args.hydrotel, file=sys.stderr)
+		return 1
+
+	hydrotel = os.path.abspath(args.hydrotel)
+	liste_cas = LectureCas(args.cas)
+	if args.filtre:
+		liste_cas = [c for c in liste_cas if re.search(args.filtre, c['nom'])]
+
+	if args.rapide:
+		liste_cas = [c for c in liste_cas if c['pas_de_temps'] == '1' and INTERPOLATION[c['interpolation']][0] != 'GRILLE'][:1]
+		if not liste_cas:
+			print('aucun cas horaire THIESSEN pour l\'essai rapide', file=sys.stderr)
+			return 1
+
+		cas = dict(liste_cas[0])
+		cas['nom'] += '-rapide'
+		cas['replication'] = '1'
+		cas['date_fin'] = (LectureDate(cas['date_debut']) + datetime.timedelta(days=31)).strftime('%Y-%m-%d %H:%M')
+
+		liste_cas = [cas]
+		args.repetitions = 1
+
+	os.makedirs(args.travail, exist_ok=True)
+
+	nb_erreur = 0
+	resultats = []
+
+	for cas in liste_cas:
+		print('%-40s ' % cas['nom'], end='', flush=True)
+
+		if INTERPOLATION[cas['interpolation']][0] == 'GRILLE' and args.grille_meteo is None:
+			print('ignore (--grille-meteo non specifie)')
+			continue
+
+		try:
+			projet, simulation, nb_zone, nb_troncon = PrepareCas(cas, args.projet, args.travail, args.grille_meteo)
+
+			executions = [ExecuteCas(hydrotel, projet, simulation, args.thread) for _ in range(args.repetitions)]
+		except ERREUR_BENCH as err:
+			nb_erreur += 1
+			print('erreur')
+			print('   ' + str(err), file=sys.stderr)
+			continue
+
+		duree = statistics.median(e['simulation'] for e in executions)
+		print('%d zones, %d troncons, simulation %.2f sec' % (nb_zone, nb_troncon, duree))
+
+		for _, cle in ETAPES:
+			valeurs = [e['debit'][cle] for e in executions if cle in e['debit']]
+			if not valeurs:
+				continue
+
+			ligne = {
+				'cas':			cas['nom'],
+				'zones':		nb_zone,
+				'troncons':		nb_troncon,
+				'etape':		cle,
+				'duree_sec':	statistics.median(e['duree'].get(cle, 0.0) for e in executions),
+				'debit':		statistics.median(valeurs),
+				'unite':		executions[0]['unite'][cle],
+			}
+			resultats.append(ligne)
+
+			print('   %-20s %14.0f %s' % (cle, ligne['debit'], ligne['unite']))
+
+	with open(args.sortie, 'w', newline='') as fichier:
+		ecrivain = csv.DictWriter(fichier, fieldnames=['cas', 'zones', 'troncons', 'etape', 'duree_sec', 'debit', 'unite'], delimiter=';')
+		ecrivain.writeheader()
+		ecrivain.writerows(resultats)
+
+	print()
+	print('resultats: %s' % args.sortie)
+
+	if nb_erreur != 0 or (args.rapide and not resultats):
+		return 1
+
+	return 0
+
+
+if __name__ == '__main__':
+	sys.exit(main())
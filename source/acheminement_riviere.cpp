@@ -50,6 +50,13 @@ namespace HYDROTEL
 
 	ACHEMINEMENT_RIVIERE::~ACHEMINEMENT_RIVIERE()
 	{
+		//fichiers netcdf non fermes par Termine (exception); OUTPUT_NETCDF ecrit les pas de temps deja calcules
+		if(_netCdf_debitaval != NULL)
+			delete _netCdf_debitaval;
+		if(_netCdf_debitamont != NULL)
+			delete _netCdf_debitamont;
+		if(_netCdf_prelevements_pression != NULL)
+			delete _netCdf_prelevements_pression;
 	}
 
 
@@ -109,68 +116,50 @@ namespace HYDROTEL
 		if(_pOutput->SauvegardeDebitAval())
 		{
 			if(_sim_hyd._outputCDF)
-				_netCdf_debitaval = new float[_sim_hyd._lNbPasTempsSim*_pOutput->_tronconOutputNb];
+				_netCdf_debitaval = _pOutput->CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "debit_aval.nc"), false, "debit_aval", "m3/s", "Debit en aval du troncon");
 			else
 			{
 				string nom_fichier( Combine(_sim_hyd.PrendreRepertoireResultat(), "debit_aval.csv") );
 
-				_fichier_debit_aval.open(nom_fichier.c_str());
+				_fichier_debit_aval.Ouvre(*_pOutput, nom_fichier, false, _pOutput->_nbDigit_m3s);
 
-				_fichier_debit_aval << "Dbit en aval du tronon (m3/s)" << _pOutput->Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl;
-				_fichier_debit_aval << "date heure\\troncon" << _pOutput->Separator();
+				_fichier_debit_aval.Entete() << "Dbit en aval du tronon (m3/s)" << _pOutput->Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl;
+				_fichier_debit_aval.Entete() << "date heure\\troncon" << _pOutput->Separator();
 
 				ostringstream oss;
 				oss.str("");
 
-				for(size_t index = 0; index < troncons.PrendreNbTroncon(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreTronconsSimules()), end(_sim_hyd.PrendreTronconsSimules()), index) != end(_sim_hyd.PrendreTronconsSimules()))
-					{
-						if(_pOutput->_bSauvegardeTous ||
-							find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), troncons[index]->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
-						{
-							oss << troncons[index]->PrendreIdent() << _pOutput->Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < _pOutput->_tronconOutputNb; ++n)
+					oss << troncons[_pOutput->_tronconOutputIndex[n]]->PrendreIdent() << _pOutput->Separator();
 
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_debit_aval << str << endl;
+				_fichier_debit_aval.Entete() << str << endl;
 			}
 		}
 
 		if(_pOutput->SauvegardeDebitAmont())
 		{
 			if(_sim_hyd._outputCDF)
-				_netCdf_debitamont = new float[_sim_hyd._lNbPasTempsSim*_pOutput->_tronconOutputNb];
+				_netCdf_debitamont = _pOutput->CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "debit_amont.nc"), false, "debit_amont", "m3/s", "Debit en amont du troncon");
 			else
 			{
 				string nom_fichier( Combine(_sim_hyd.PrendreRepertoireResultat(), "debit_amont.csv") );
 
-				_fichier_debit_amont.open(nom_fichier.c_str());
+				_fichier_debit_amont.Ouvre(*_pOutput, nom_fichier, false, _pOutput->_nbDigit_m3s);
 
-				_fichier_debit_amont << "Dbit en amont du tronon (m3/s)" << _pOutput->Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl;
-				_fichier_debit_amont << "date heure\\troncon" << _pOutput->Separator();
+				_fichier_debit_amont.Entete() << "Dbit en amont du tronon (m3/s)" << _pOutput->Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl;
+				_fichier_debit_amont.Entete() << "date heure\\troncon" << _pOutput->Separator();
 
 				ostringstream oss;
 				oss.str("");
 			
-				for(size_t index = 0; index < troncons.PrendreNbTroncon(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreTronconsSimules()), end(_sim_hyd.PrendreTronconsSimules()), index) != end(_sim_hyd.PrendreTronconsSimules()))
-					{
-						if(_pOutput->_bSauvegardeTous ||
-							find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), troncons[index]->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
-						{
-							oss << troncons[index]->PrendreIdent() << _pOutput->Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < _pOutput->_tronconOutputNb; ++n)
+					oss << troncons[_pOutput->_tronconOutputIndex[n]]->PrendreIdent() << _pOutput->Separator();
 
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_debit_amont << str << endl;
+				_fichier_debit_amont.Entete() << str << endl;
 			}
 		}
 
@@ -182,63 +171,45 @@ namespace HYDROTEL
 			//{
 				string nom_fichier( Combine(_sim_hyd.PrendreRepertoireResultat(), "hauteur_aval.csv") );
 
-				_fichier_hauteur_aval.open(nom_fichier.c_str());
+				_fichier_hauteur_aval.Ouvre(*_pOutput, nom_fichier, false, _pOutput->_nbDigit_m3s);
 
-				_fichier_hauteur_aval << "Hauteur eau en aval du tronon (m)" << _pOutput->Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl;
-				_fichier_hauteur_aval << "date heure\\troncon" << _pOutput->Separator();
+				_fichier_hauteur_aval.Entete() << "Hauteur eau en aval du tronon (m)" << _pOutput->Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl;
+				_fichier_hauteur_aval.Entete() << "date heure\\troncon" << _pOutput->Separator();
 
 				ostringstream oss;
 				oss.str("");
 
-				for(size_t index = 0; index < troncons.PrendreNbTroncon(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreTronconsSimules()), end(_sim_hyd.PrendreTronconsSimules()), index) != end(_sim_hyd.PrendreTronconsSimules()))
-					{
-						if(_pOutput->_bSauvegardeTous ||
-							find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), troncons[index]->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
-						{
-							oss << troncons[index]->PrendreIdent() << _pOutput->Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < _pOutput->_tronconOutputNb; ++n)
+					oss << troncons[_pOutput->_tronconOutputIndex[n]]->PrendreIdent() << _pOutput->Separator();
 
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_hauteur_aval << str << endl;
+				_fichier_hauteur_aval.Entete() << str << endl;
 			//}
 		}
 
 		if(_sim_hyd._pr->_bSimulePrelevements)	//if (_pOutput->SauvegardePrelevementPression())
 		{
 			if(_sim_hyd._outputCDF)
-				_netCdf_prelevements_pression = new float[_sim_hyd._lNbPasTempsSim*_pOutput->_tronconOutputNb];
+				_netCdf_prelevements_pression = _pOutput->CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "prelevements_pression.nc"), false, "prelevements_pression", "0-1", "Indice de pression des prlvements");
 			else
 			{
 				string nom_fichier( Combine(_sim_hyd.PrendreRepertoireResultat(), "prelevements_pression.csv") );
 
-				_fichier_prelevements_pression.open(nom_fichier.c_str());
+				_fichier_prelevements_pression.Ouvre(*_pOutput, nom_fichier, false, _pOutput->_nbDigit_ratio);
 
-				_fichier_prelevements_pression << "Indice de pression (0-1)" << _pOutput->Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl;
-				_fichier_prelevements_pression << "Date heure\\troncon" << _pOutput->Separator();
+				_fichier_prelevements_pression.Entete() << "Indice de pression (0-1)" << _pOutput->Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl;
+				_fichier_prelevements_pression.Entete() << "Date heure\\troncon" << _pOutput->Separator();
 
 				ostringstream oss;
 				oss.str("");
 
-				for(size_t index = 0; index < troncons.PrendreNbTroncon(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreTronconsSimules()), end(_sim_hyd.PrendreTronconsSimules()), index) != end(_sim_hyd.PrendreTronconsSimules()))
-					{
-						if(_pOutput->_bSauvegardeTous ||
-							find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), troncons[index]->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
-						{
-							oss << troncons[index]->PrendreIdent() << _pOutput->Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < _pOutput->_tronconOutputNb; ++n)
+					oss << troncons[_pOutput->_tronconOutputIndex[n]]->PrendreIdent() << _pOutput->Separator();
 
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_prelevements_pression << str << endl;
+				_fichier_prelevements_pression.Entete() << str << endl;
 			}
 		}
 	}
@@ -246,9 +217,8 @@ namespace HYDROTEL
 
 	void ACHEMINEMENT_RIVIERE::Calcule()
 	{
-		ostringstream oss;
-		size_t i, idx, index;
-		string str;
+		size_t i;
+		float* pLigne;
 
 		TRONCONS& troncons = _sim_hyd.PrendreTroncons();
 
@@ -256,31 +226,17 @@ namespace HYDROTEL
 		{
 			if(_netCdf_debitaval != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _pOutput->_tronconOutputNb;
+				pLigne = _netCdf_debitaval->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for(i=0; i<_pOutput->_tronconOutputNb; i++)
-					_netCdf_debitaval[idx+i] = troncons[_pOutput->_tronconOutputIndex[i]]->PrendreDebitAvalMoyen();
+					pLigne[i] = troncons[_pOutput->_tronconOutputIndex[i]]->PrendreDebitAvalMoyen();
 			}
 			else
 			{
-				oss.str("");
-				oss << _sim_hyd.PrendreDateCourante() << _pOutput->Separator() << setprecision(_pOutput->_nbDigit_m3s) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_debit_aval.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for(index = 0; index < troncons.PrendreNbTroncon(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreTronconsSimules()), end(_sim_hyd.PrendreTronconsSimules()), index) != end(_sim_hyd.PrendreTronconsSimules()))
-					{
-						if(_pOutput->_bSauvegardeTous ||
-							find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), troncons[index]->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
-						{
-							oss << troncons[index]->PrendreDebitAvalMoyen() << _pOutput->Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_debit_aval << str << endl;
+				for (size_t n = 0; n < _pOutput->_tronconOutputNb; ++n)
+					pValeur[n] = troncons[_pOutput->_tronconOutputIndex[n]]->PrendreDebitAvalMoyen();
 			}
 		}
 
@@ -288,31 +244,17 @@ namespace HYDROTEL
 		{
 			if(_netCdf_debitamont != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _pOutput->_tronconOutputNb;
+				pLigne = _netCdf_debitamont->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for(i=0; i<_pOutput->_tronconOutputNb; i++)
-					_netCdf_debitamont[idx+i] = troncons[_pOutput->_tronconOutputIndex[i]]->PrendreDebitAmontMoyen();
+					pLigne[i] = troncons[_pOutput->_tronconOutputIndex[i]]->PrendreDebitAmontMoyen();
 			}
 			else
 			{
-				oss.str("");
-				oss << _sim_hyd.PrendreDateCourante() << _pOutput->Separator() << setprecision(_pOutput->_nbDigit_m3s) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_debit_amont.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for(index = 0; index < troncons.PrendreNbTroncon(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreTronconsSimules()), end(_sim_hyd.PrendreTronconsSimules()), index) != end(_sim_hyd.PrendreTronconsSimules()))
-					{
-						if(_pOutput->_bSauvegardeTous ||
-							find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), troncons[index]->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
-						{
-							oss << troncons[index]->PrendreDebitAmontMoyen() << _pOutput->Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_debit_amont << str << endl;
+				for (size_t n = 0; n < _pOutput->_tronconOutputNb; ++n)
+					pValeur[n] = troncons[_pOutput->_tronconOutputIndex[n]]->PrendreDebitAmontMoyen();
 			}
 		}
 
@@ -327,24 +269,10 @@ namespace HYDROTEL
 			//}
 			//else
 			//{
-				oss.str("");
-				oss << _sim_hyd.PrendreDateCourante() << _pOutput->Separator() << setprecision(_pOutput->_nbDigit_m3s) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_hauteur_aval.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for(index = 0; index < troncons.PrendreNbTroncon(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreTronconsSimules()), end(_sim_hyd.PrendreTronconsSimules()), index) != end(_sim_hyd.PrendreTronconsSimules()))
-					{
-						if(_pOutput->_bSauvegardeTous ||
-							find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), troncons[index]->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
-						{
-							oss << troncons[index]->_hauteurAvalMoy << _pOutput->Separator();
-						}
-					}
-				}
-
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_hauteur_aval << str << endl;
+				for (size_t n = 0; n < _pOutput->_tronconOutputNb; ++n)
+					pValeur[n] = troncons[_pOutput->_tronconOutputIndex[n]]->_hauteurAvalMoy;
 			//}
 		}
 
@@ -352,31 +280,17 @@ namespace HYDROTEL
 		{
 			if(_netCdf_prelevements_pression != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _pOutput->_tronconOutputNb;
+				pLigne = _netCdf_prelevements_pression->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for(i=0; i<_pOutput->_tronconOutputNb; i++)
-					_netCdf_prelevements_pression[idx+i] = static_cast<float>(troncons[_pOutput->_tronconOutputIndex[i]]->_prIndicePression);
+					pLigne[i] = static_cast<float>(troncons[_pOutput->_tronconOutputIndex[i]]->_prIndicePression);
 			}
 			else
 			{
-				oss.str("");
-				oss << _sim_hyd.PrendreDateCourante() << _pOutput->Separator() << setprecision(_pOutput->_nbDigit_ratio) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_prelevements_pression.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for(index = 0; index < troncons.PrendreNbTroncon(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreTronconsSimules()), end(_sim_hyd.PrendreTronconsSimules()), index) != end(_sim_hyd.PrendreTronconsSimules()))
-					{
-						if(_pOutput->_bSauvegardeTous ||
-							find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), troncons[index]->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
-						{
-							oss << troncons[index]->_prIndicePression << _pOutput->Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_prelevements_pression << str << endl;
+				for (size_t n = 0; n < _pOutput->_tronconOutputNb; ++n)
+					pValeur[n] = troncons[_pOutput->_tronconOutputIndex[n]]->_prIndicePression;
 			}
 		}
 	}
@@ -384,40 +298,36 @@ namespace HYDROTEL
 
 	void ACHEMINEMENT_RIVIERE::Termine()
 	{
-		string str1, str2;
+		string str;
 
 		if(_pOutput->SauvegardeDebitAval())
 		{
 			if(_netCdf_debitaval != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "acheminement-debit_aval.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "debit_aval.nc");
-				//str2 = _pOutput->SauvegardeOutputNetCDF(str1, false, "acheminement-debit_aval", _netCdf_debitaval, "m3/s", "Debit en aval du troncon");
-				str2 = _pOutput->SauvegardeOutputNetCDF(str1, false, "debit_aval", _netCdf_debitaval, "m3/s", "Debit en aval du troncon");
-				if(str2 != "")
-					throw ERREUR(str2);
-
-				delete [] _netCdf_debitaval;
+				str = _netCdf_debitaval->Ferme();
+				delete _netCdf_debitaval;
+				_netCdf_debitaval = NULL;
+
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_debit_aval.close();
+				_fichier_debit_aval.Ferme();
 		}
 
 		if(_pOutput->SauvegardeDebitAmont())
 		{
 			if(_netCdf_debitamont != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "acheminement-debit_amont.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "debit_amont.nc");
-				//str2 = _pOutput->SauvegardeOutputNetCDF(str1, false, "acheminement-debit_amont", _netCdf_debitamont, "m3/s", "Debit en amont du troncon");
-				str2 = _pOutput->SauvegardeOutputNetCDF(str1, false, "debit_amont", _netCdf_debitamont, "m3/s", "Debit en amont du troncon");
-				if(str2 != "")
-					throw ERREUR(str2);
-
-				delete [] _netCdf_debitamont;
+				str = _netCdf_debitamont->Ferme();
+				delete _netCdf_debitamont;
+				_netCdf_debitamont = NULL;
+
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_debit_amont.close();
+				_fichier_debit_amont.Ferme();
 		}
 
 		if(_pOutput->_hauteur_aval)
@@ -434,24 +344,22 @@ namespace HYDROTEL
 			//	delete [] _netCdf_hauteuraval;
 			//}
 			//else
-				_fichier_hauteur_aval.close();
+				_fichier_hauteur_aval.Ferme();
 		}
 
 		if(_sim_hyd._pr->_bSimulePrelevements)	//if (_pOutput->SauvegardePrelevementPression())
 		{
 			if(_netCdf_prelevements_pression != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "acheminement-debit_aval.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "prelevements_pression.nc");
-				//str2 = _pOutput->SauvegardeOutputNetCDF(str1, false, "acheminement-debit_aval", _netCdf_debitaval, "m3/s", "Debit en aval du troncon");
-				str2 = _pOutput->SauvegardeOutputNetCDF(str1, false, "prelevements_pression", _netCdf_prelevements_pression, "0-1", "Indice de pression des prlvements");
-				if(str2 != "")
-					throw ERREUR(str2);
-
-				delete [] _netCdf_prelevements_pression;
+				str = _netCdf_prelevements_pression->Ferme();
+				delete _netCdf_prelevements_pression;
+				_netCdf_prelevements_pression = NULL;
+
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_prelevements_pression.close();
+				_fichier_prelevements_pression.Ferme();
 		}
 	}
 
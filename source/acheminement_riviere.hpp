@@ -23,6 +23,8 @@
 
 
 #include "sous_modele.hpp"
+#include "output_netcdf.hpp"
+#include "output_csv.hpp"
 #include "milieu_humide_riverain.hpp"
 
 #include <fstream>
@@ -48,18 +50,18 @@ namespace HYDROTEL
 
 		OUTPUT*				_pOutput;
 
-		float*				_netCdf_debitaval;
-		float*				_netCdf_debitamont;
+		OUTPUT_NETCDF*		_netCdf_debitaval;
+		OUTPUT_NETCDF*		_netCdf_debitamont;
 
-		float*				_netCdf_prelevements_pression;
+		OUTPUT_NETCDF*		_netCdf_prelevements_pression;
 
 	private:
-		std::ofstream		_fichier_debit_aval;
-		std::ofstream		_fichier_debit_amont;
+		OUTPUT_CSV			_fichier_debit_aval;
+		OUTPUT_CSV			_fichier_debit_amont;
 
-		std::ofstream		_fichier_hauteur_aval;
+		OUTPUT_CSV			_fichier_hauteur_aval;
 
-		std::ofstream		_fichier_prelevements_pression;
+		OUTPUT_CSV			_fichier_prelevements_pression;
 	};
 
 }
@@ -0,0 +1,132 @@
+//
+// HYDROTEL a spatially distributed hydrological model
+// Copyright (C) 2013 INRS Eau Terre Environnement
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+// USA
+//
+
+#include "arbre_kd.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+using namespace std;
+
+
+namespace HYDROTEL
+{
+
+	namespace
+	{
+		const size_t INDEX_AUCUN = static_cast<size_t>(-1);
+	}
+
+
+	ARBRE_KD::ARBRE_KD(const vector<COORDONNEE>& coordonnees)
+	{
+		size_t index, nb;
+
+		nb = coordonnees.size();
+
+		_x.resize(nb);
+		_y.resize(nb);
+		_noeuds.resize(nb);
+
+		for(index=0; index<nb; index++)
+		{
+			_x[index] = coordonnees[index].PrendreX();
+			_y[index] = coordonnees[index].PrendreY();
+			_noeuds[index] = index;
+		}
+
+		Construit(0, nb, 0);
+	}
+
+
+	ARBRE_KD::~ARBRE_KD()
+	{
+	}
+
+
+	void ARBRE_KD::Construit(size_t debut, size_t fin, int axe)
+	{
+		if(fin - debut < 2)
+			return;
+
+		size_t milieu = (debut + fin) / 2;
+		const vector<double>& v = axe == 0 ? _x : _y;
+
+		nth_element(_noeuds.begin() + debut, _noeuds.begin() + milieu, _noeuds.begin() + fin, 
+			[&v](size_t a, size_t b) { return v[a] < v[b] || (v[a] == v[b] && a < b); });
+
+		Construit(debut, milieu, 1 - axe);
+		Construit(milieu + 1, fin, 1 - axe);
+	}
+
+
+	size_t ARBRE_KD::PrendreIndexPlusProche(const COORDONNEE& coordonnee) const
+	{
+		double distance;
+		size_t index;
+
+		//meme distance initiale que GetIndexNearestCoord
+		distance = 1000000000.0;
+		index = INDEX_AUCUN;
+
+		Recherche(0, _noeuds.size(), 0, coordonnee.PrendreX(), coordonnee.PrendreY(), distance, index);
+
+		if(index == INDEX_AUCUN)
+			return 0;
+
+		return index;
+	}
+
+
+	void ARBRE_KD::Recherche(size_t debut, size_t fin, int axe, double x, double y, double& distance, size_t& index) const
+	{
+		if(debut >= fin)
+			return;
+
+		size_t milieu = (debut + fin) / 2;
+		size_t noeud = _noeuds[milieu];
+		double d, diff;
+
+		//meme calcul de distance que GetIndexNearestCoord
+		d = sqrt(pow(x - _x[noeud], 2.0) + pow(y - _y[noeud], 2.0));
+		if(d < distance || (d == distance && index != INDEX_AUCUN && noeud < index))
+		{
+			distance = d;
+			index = noeud;
+		}
+
+		diff = axe == 0 ? x - _x[noeud] : y - _y[noeud];
+
+		if(diff < 0.0)
+		{
+			Recherche(debut, milieu, 1 - axe, x, y, distance, index);
+			if(-diff <= distance)
+				Recherche(milieu + 1, fin, 1 - axe, x, y, distance, index);
+		}
+		else
+		{
+			Recherche(milieu + 1, fin, 1 - axe, x, y, distance, index);
+			if(diff <= distance)
+				Recherche(debut, milieu, 1 - axe, x, y, distance, index);
+		}
+	}
+
+}
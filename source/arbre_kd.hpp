@@ -0,0 +1,56 @@
+//
+// HYDROTEL a spatially distributed hydrological model
+// Copyright (C) 2013 INRS Eau Terre Environnement
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+// USA
+//
+
+#ifndef ARBRE_KD_H_INCLUDED
+#define ARBRE_KD_H_INCLUDED
+
+
+#include "coordonnee.hpp"
+
+#include <vector>
+
+
+namespace HYDROTEL 
+{
+
+	//arbre k-d (x, y) pour la recherche de la coordonnee la plus proche
+	class ARBRE_KD
+	{
+	public:
+		ARBRE_KD(const std::vector<COORDONNEE>& coordonnees);
+		~ARBRE_KD();
+
+		/// retourne l'index de la coordonnee la plus proche; meme resultat que GetIndexNearestCoord (egalite: plus petit index)
+		size_t PrendreIndexPlusProche(const COORDONNEE& coordonnee) const;
+
+	private:
+		void Construit(size_t debut, size_t fin, int axe);
+
+		void Recherche(size_t debut, size_t fin, int axe, double x, double y, double& distance, size_t& index) const;
+
+		std::vector<double> _x;
+		std::vector<double> _y;
+
+		std::vector<size_t> _noeuds;	//arbre implicite; le noeud de [debut, fin) est a (debut + fin) / 2
+	};
+
+}
+
+#endif
@@ -43,6 +43,13 @@ namespace HYDROTEL
 
 	BILAN_VERTICAL::~BILAN_VERTICAL()
 	{
+		//fichiers netcdf non fermes par Termine (exception); OUTPUT_NETCDF ecrit les pas de temps deja calcules
+		if(_netCdf_prodSurf != NULL)
+			delete _netCdf_prodSurf;
+		if(_netCdf_prodHypo != NULL)
+			delete _netCdf_prodHypo;
+		if(_netCdf_prodBase != NULL)
+			delete _netCdf_prodBase;
 	}
 
 
@@ -62,96 +69,69 @@ namespace HYDROTEL
 		if (output.SauvegardeProductionSurf())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_prodSurf = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_prodSurf = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "production_surf.nc"), true, "production_surf", "mm", "Lame d`eau produite a la surface (production)");
 			else
 			{
 				string nom_fichier_surf( Combine(_sim_hyd.PrendreRepertoireResultat(), "production_surf.csv") );
-				_fichier_production_surf.open(nom_fichier_surf.c_str());
-				_fichier_production_surf << "Lame d'eau produite  la couche 1 (surface) (production) (mm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+				_fichier_production_surf.Ouvre(output, nom_fichier_surf, true, output._nbDigit_mm);
+				_fichier_production_surf.Entete() << "Lame d'eau produite  la couche 1 (surface) (production) (mm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 			
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(std::find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							std::find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 			
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_production_surf << str << endl;
+				_fichier_production_surf.Entete() << str << endl;
 			}
 		}
 
 		if (output.SauvegardeProductionHypo())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_prodHypo = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_prodHypo = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "production_hypo.nc"), true, "production_hypo", "mm", "Lame d`eau produite par la 2e couche (production)");
 			else
 			{
 				string nom_fichier_hypo( Combine(_sim_hyd.PrendreRepertoireResultat(), "production_hypo.csv") );
-				_fichier_production_hypo.open(nom_fichier_hypo.c_str());
-				_fichier_production_hypo << "Lame d'eau produite  la couche 2 (hypodermique) (production) (mm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+				_fichier_production_hypo.Ouvre(output, nom_fichier_hypo, true, output._nbDigit_mm);
+				_fichier_production_hypo.Entete() << "Lame d'eau produite  la couche 2 (hypodermique) (production) (mm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 			
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(std::find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							std::find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 			
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_production_hypo << str << endl;
+				_fichier_production_hypo.Entete() << str << endl;
 			}
 		}
 
 		if (output.SauvegardeProductionBase())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_prodBase = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_prodBase = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "production_base.nc"), true, "production_base", "mm", "Lame d`eau produite par la 3e couche (production)");
 			else
 			{
 				string nom_fichier_base( Combine(_sim_hyd.PrendreRepertoireResultat(), "production_base.csv") );
-				_fichier_production_base.open(nom_fichier_base.c_str());
-				_fichier_production_base << "Lame d'eau produite  la couche 3 (base) (production) (mm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+				_fichier_production_base.Ouvre(output, nom_fichier_base, true, output._nbDigit_mm);
+				_fichier_production_base.Entete() << "Lame d'eau produite  la couche 3 (base) (production) (mm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 			
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(std::find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							std::find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 			
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_production_base << str << endl;
+				_fichier_production_base.Entete() << str << endl;
 			}
 		}
 	}
@@ -167,41 +147,26 @@ namespace HYDROTEL
 		//_fichier_production << endl;
 
 		OUTPUT& output = _sim_hyd.PrendreOutput();
+		const ETAT_ZONES& etat = zones.PrendreEtat();
 
-		size_t i, idx;
-		string str;
+		size_t i;
+		float* pLigne;
 
 		if (output.SauvegardeProductionSurf())
 		{
 			if (_netCdf_prodSurf != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_prodSurf->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
-				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_prodSurf[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreProdSurf();
+				for (i=0; i<output._uhrhOutputNb; i++)
+					pLigne[i] = etat._surf[output._uhrhOutputIndex[i]];
 			}
 			else
 			{
-				ostringstream oss;
-				oss.str("");
-			
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(output._nbDigit_mm) << setiosflags(ios::fixed);
-
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(std::find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							std::find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreProdSurf() << output.Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_production_surf << str << endl;
+				double* pValeur = _fichier_production_surf.Ligne(_sim_hyd.PrendreDateCourante());
+
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					pValeur[n] = etat._surf[output._uhrhOutputIndex[n]];
 			}
 		}
 
@@ -209,33 +174,17 @@ namespace HYDROTEL
 		{
 			if (_netCdf_prodHypo != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_prodHypo->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
-				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_prodHypo[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreProdHypo();
+				for (i=0; i<output._uhrhOutputNb; i++)
+					pLigne[i] = etat._hypo[output._uhrhOutputIndex[i]];
 			}
 			else
 			{
-				ostringstream oss;
-				oss.str("");
-			
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(output._nbDigit_mm) << setiosflags(ios::fixed);
-
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(std::find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							std::find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreProdHypo() << output.Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_production_hypo << str << endl;
+				double* pValeur = _fichier_production_hypo.Ligne(_sim_hyd.PrendreDateCourante());
+
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					pValeur[n] = etat._hypo[output._uhrhOutputIndex[n]];
 			}
 		}
 
@@ -243,33 +192,17 @@ namespace HYDROTEL
 		{
 			if (_netCdf_prodBase != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_prodBase->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
-				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_prodBase[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreProdBase();
+				for (i=0; i<output._uhrhOutputNb; i++)
+					pLigne[i] = etat._base[output._uhrhOutputIndex[i]];
 			}
 			else
 			{
-				ostringstream oss;
-				oss.str("");
-			
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(output._nbDigit_mm) << setiosflags(ios::fixed);
-
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(std::find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							std::find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreProdBase() << output.Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_production_base << str << endl;
+				double* pValeur = _fichier_production_base.Ligne(_sim_hyd.PrendreDateCourante());
+
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					pValeur[n] = etat._base[output._uhrhOutputIndex[n]];
 			}
 		}
 	}
@@ -277,7 +210,7 @@ namespace HYDROTEL
 
 	void BILAN_VERTICAL::Termine()
 	{
-		string str1, str2;
+		string str;
 
 		//_fichier_production.close();
 
@@ -287,51 +220,45 @@ namespace HYDROTEL
 		{
 			if (_netCdf_prodSurf != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "bilanvertical-production_surf.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "production_surf.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "bilanvertical-production_surf", _netCdf_prodSurf, "mm", "Lame d`eau produite a la surface (production)");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "production_surf", _netCdf_prodSurf, "mm", "Lame d`eau produite a la surface (production)");
-				if(str2 != "")
-					throw ERREUR(str2);
-
-				delete [] _netCdf_prodSurf;
+				str = _netCdf_prodSurf->Ferme();
+				delete _netCdf_prodSurf;
+				_netCdf_prodSurf = NULL;
+
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_production_surf.close();
+				_fichier_production_surf.Ferme();
 		}
 	
 		if (output.SauvegardeProductionHypo())
 		{
 			if (_netCdf_prodHypo != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "bilanvertical-production_hypo.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "production_hypo.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "bilanvertical-production_hypo", _netCdf_prodHypo, "mm", "Lame d`eau produite par la 2e couche (production)");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "production_hypo", _netCdf_prodHypo, "mm", "Lame d`eau produite par la 2e couche (production)");
-				if(str2 != "")
-					throw ERREUR(str2);
-
-				delete [] _netCdf_prodHypo;
+				str = _netCdf_prodHypo->Ferme();
+				delete _netCdf_prodHypo;
+				_netCdf_prodHypo = NULL;
+
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_production_hypo.close();
+				_fichier_production_hypo.Ferme();
 		}
 
 		if (output.SauvegardeProductionBase())
 		{
 			if (_netCdf_prodBase != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "bilanvertical-production_base.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "production_base.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "bilanvertical-production_base", _netCdf_prodBase, "mm", "Lame d`eau produite par la 3e couche (production)");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "production_base", _netCdf_prodBase, "mm", "Lame d`eau produite par la 3e couche (production)");
-				if(str2 != "")
-					throw ERREUR(str2);
-
-				delete [] _netCdf_prodBase;
+				str = _netCdf_prodBase->Ferme();
+				delete _netCdf_prodBase;
+				_netCdf_prodBase = NULL;
+
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_production_base.close();
+				_fichier_production_base.Ferme();
 		}
 	}
 
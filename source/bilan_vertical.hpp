@@ -23,6 +23,8 @@
 
 
 #include "sous_modele.hpp"
+#include "output_netcdf.hpp"
+#include "output_csv.hpp"
 
 #include <fstream>
 
@@ -47,14 +49,14 @@ namespace HYDROTEL
 		std::string _nom_fichier_production_hypo;
 		std::string _nom_fichier_production_surf;
 
-		float*				_netCdf_prodSurf;
-		float*				_netCdf_prodHypo;
-		float*				_netCdf_prodBase;
+		OUTPUT_NETCDF*		_netCdf_prodSurf;
+		OUTPUT_NETCDF*		_netCdf_prodHypo;
+		OUTPUT_NETCDF*		_netCdf_prodBase;
 
 	private:
-		std::ofstream _fichier_production_surf;
-		std::ofstream _fichier_production_hypo;
-		std::ofstream _fichier_production_base;
+		OUTPUT_CSV _fichier_production_surf;
+		OUTPUT_CSV _fichier_production_hypo;
+		OUTPUT_CSV _fichier_production_base;
 	};
 
 }
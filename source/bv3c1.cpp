@@ -22,6 +22,7 @@
 
 #include "constantes.hpp"
 #include "erreur.hpp"
+#include "etat_binaire.hpp"
 #include "util.hpp"
 #include "version.hpp"
 
@@ -41,6 +42,9 @@ namespace HYDROTEL
 		_sauvegarde_etat = false;
 		_sauvegarde_tous_etat = false;
 
+		_annee_facteur_extinction = -1;
+		_jour_facteur_extinction = -1;
+
 		_netCdf_theta1 = NULL;
 		_netCdf_theta2 = NULL;
 		_netCdf_theta3 = NULL;
@@ -54,6 +58,28 @@ namespace HYDROTEL
 
 	BV3C1::~BV3C1()
 	{
+		//fichiers netcdf non fermes par Termine (exception); OUTPUT_NETCDF ecrit les pas de temps deja calcules
+		if(_netCdf_theta1 != NULL)
+			delete _netCdf_theta1;
+		if(_netCdf_theta2 != NULL)
+			delete _netCdf_theta2;
+		if(_netCdf_theta3 != NULL)
+			delete _netCdf_theta3;
+		if(_netCdf_etr1 != NULL)
+			delete _netCdf_etr1;
+		if(_netCdf_etr2 != NULL)
+			delete _netCdf_etr2;
+		if(_netCdf_etr3 != NULL)
+			delete _netCdf_etr3;
+		if(_netCdf_etr_total != NULL)
+			delete _netCdf_etr_total;
+		if(_netCdf_q12 != NULL)
+			delete _netCdf_q12;
+		if(_netCdf_q23 != NULL)
+			delete _netCdf_q23;
+
+		for(auto milieu_humide : _milieu_humide_isole)
+			delete milieu_humide;
 	}
 
 	float BV3C1::PrendreTheta1Initial(size_t index_zone) const
@@ -153,6 +179,34 @@ namespace HYDROTEL
 
 	void BV3C1::LectureEtat(DATE_HEURE date_courante)
 	{
+		TRACE_PERFORMANCE trace("BV3C1::LectureEtat");
+
+		if(ETAT_BINAIRE::EstBinaire(_nom_fichier_lecture_etat))
+		{
+			ETAT_BINAIRE etat;
+			etat.Lecture(_nom_fichier_lecture_etat, 3);
+
+			ZONES& zones = _sim_hyd.PrendreZones();
+			ETAT_ZONES& etat_zones = zones.PrendreEtat();
+			vector<size_t> index_ligne = etat.AssocieIndex(zones, _sim_hyd.PrendreZonesSimules(), "BILAN_VERTICAL; fichier etat BV3C");
+
+			for(size_t ligne=0; ligne<index_ligne.size(); ligne++)
+			{
+				const size_t index_zone = index_ligne[ligne];
+
+				if(index_zone != string::npos)
+				{
+					const double* valeurs = etat.PrendreLigne(ligne);
+
+					etat_zones._theta1[index_zone] = static_cast<float>(valeurs[0]);
+					etat_zones._theta2[index_zone] = static_cast<float>(valeurs[1]);
+					etat_zones._theta3[index_zone] = static_cast<float>(valeurs[2]);
+				}
+			}
+
+			return;
+		}
+
 		ifstream fichier(_nom_fichier_lecture_etat);
 		if (!fichier)
 			throw ERREUR_LECTURE_FICHIER("BILAN_VERTICAL; fichier etat BV3C; " + _nom_fichier_lecture_etat);
@@ -168,6 +222,7 @@ namespace HYDROTEL
 		getline_mod(fichier, ligne);	//colums descriptions
 
 		ZONES& zones = _sim_hyd.PrendreZones();
+		ETAT_ZONES& etat_zones = zones.PrendreEtat();
 
 		while(fichier.good())
 		{
@@ -181,9 +236,9 @@ namespace HYDROTEL
 				{
 					index_zone = _sim_hyd.PrendreZones().IdentVersIndex(iIdent);
 
-					zones[index_zone]._theta1 = valeurs[1];
-					zones[index_zone]._theta2 = valeurs[2];
-					zones[index_zone]._theta3 = valeurs[3];
+					etat_zones._theta1[index_zone] = valeurs[1];
+					etat_zones._theta2[index_zone] = valeurs[2];
+					etat_zones._theta3[index_zone] = valeurs[3];
 
 					vValidation.push_back(iIdent);
 				}
@@ -197,6 +252,8 @@ namespace HYDROTEL
 
 	void BV3C1::SauvegardeEtat(DATE_HEURE date_courante) const
 	{
+		TRACE_PERFORMANCE trace("BV3C1::SauvegardeEtat");
+
 		BOOST_ASSERT(_repertoire_ecriture_etat.size() != 0);
 
 		date_courante.AdditionHeure( _sim_hyd.PrendrePasDeTemps() );
@@ -218,7 +275,28 @@ namespace HYDROTEL
 			        << setw(2) << date_courante.PrendreMois() 
 			        << setw(2) << date_courante.PrendreJour() 
 			        << setw(2) << date_courante.PrendreHeure() 
-					<< ".csv";
+					<< _sim_hyd._output.ExtensionFichiersEtats();
+
+		if(_sim_hyd._output._bFichiersEtatsBinaire)
+		{
+			ZONES& zones = _sim_hyd.PrendreZones();
+			ETAT_ZONES& etat_zones = zones.PrendreEtat();
+			ETAT_BINAIRE etat;
+
+			etat.Initialise(PrendreNomSousModele(), date_courante, { "THETA 1", "THETA 2", "THETA 3" }, _sim_hyd.PrendreZonesSimules().size());
+
+			for(size_t index_zone : _sim_hyd.PrendreZonesSimules())
+			{
+				double* valeurs = etat.AjouteLigne(zones[index_zone].PrendreIdent());
+
+				valeurs[0] = etat_zones._theta1[index_zone];
+				valeurs[1] = etat_zones._theta2[index_zone];
+				valeurs[2] = etat_zones._theta3[index_zone];
+			}
+
+			etat.Sauvegarde(nom_fichier.str());
+			return;
+		}
 
 		ofstream fichier(nom_fichier.str());
 		if (!fichier)
@@ -233,6 +311,7 @@ namespace HYDROTEL
 		fichier << "UHRH" << sSep << "THETA 1" << sSep << "THETA 2" << sSep << "THETA 3" << endl;
 
 		ZONES& zones = _sim_hyd.PrendreZones();
+		ETAT_ZONES& etat_zones = zones.PrendreEtat();
 
 		nbSimuler = _sim_hyd.PrendreZonesSimules().size();
 		x = 0;
@@ -245,9 +324,9 @@ namespace HYDROTEL
 
 				fichier << zone.PrendreIdent() << sSep;
 
-				fichier << zones[index_zone]._theta1 << sSep;
-				fichier << zones[index_zone]._theta2 << sSep;
-				fichier << zones[index_zone]._theta3;
+				fichier << etat_zones._theta1[index_zone] << sSep;
+				fichier << etat_zones._theta2[index_zone] << sSep;
+				fichier << etat_zones._theta3[index_zone];
 
 				fichier << endl;
 				++x;
@@ -258,33 +337,22 @@ namespace HYDROTEL
 	}
 
 
-	void BV3C1::Initialise()
+	void BV3C1::InitialiseParametres()
 	{
-		_corrections_reserve_sol = _sim_hyd.PrendreCorrections().PrendreCorrectionsReserveSol();
-		_corrections_saturation_sol = _sim_hyd.PrendreCorrections().PrendreCorrectionsSaturationReserveSol();
-
-		ZONES& zones = _sim_hyd.PrendreZones();
-
-		const size_t nb_zone = zones.PrendreNbZone();
+		const size_t nb_zone = _sim_hyd.PrendreZones().PrendreNbZone();
 
 		auto& occupation_sol = _sim_hyd.PrendreOccupationSol();
-		auto& propriete_hydroliques = _sim_hyd.PrendreProprieteHydrotliques();
-
-		const size_t nb_propriete_hydrolique = propriete_hydroliques.PrendreNb();
 
-		vector<size_t> index_autres;
+		_index_autres.clear();
 		for (size_t index = 0; index < occupation_sol.PrendreNbClasse(); ++index)
 		{
 			if (find(begin(_index_eaux), end(_index_eaux), index) == end(_index_eaux) &&
 				find(begin(_index_impermeables), end(_index_impermeables), index) == end(_index_impermeables))
 			{
-				index_autres.push_back(index);
+				_index_autres.push_back(index);
 			}
 		}
 
-		index_autres.shrink_to_fit();
-		_index_autres.swap(index_autres);
-
 		// calcul pourcentage des classes integrees
 
 		_pourcentage_eau.resize(nb_zone, 0);
@@ -312,6 +380,28 @@ namespace HYDROTEL
 		_pourcentage_autre.resize(nb_zone, 0);
 		for (size_t index_zone = 0; index_zone < nb_zone; ++index_zone)
 			_pourcentage_autre[index_zone] = max(1.0f - (_pourcentage_impermeable[index_zone] + _pourcentage_eau[index_zone]), 0.0f);
+	}
+
+
+	void BV3C1::Initialise()
+	{
+		_corrections_reserve_sol = _sim_hyd.PrendreCorrections().PrendreCorrectionsReserveSol();
+		_corrections_saturation_sol = _sim_hyd.PrendreCorrections().PrendreCorrectionsSaturationReserveSol();
+
+		ZONES& zones = _sim_hyd.PrendreZones();
+		ETAT_ZONES& etat_zones = zones.PrendreEtat();
+
+		const size_t nb_zone = zones.PrendreNbZone();
+
+		auto& propriete_hydroliques = _sim_hyd.PrendreProprieteHydrotliques();
+
+		const size_t nb_propriete_hydrolique = propriete_hydroliques.PrendreNb();
+
+		_facteur_extinction.clear();
+		_annee_facteur_extinction = -1;
+		_jour_facteur_extinction = -1;
+
+		InitialiseParametres();
 
 		_q12.resize(nb_zone);
 		_q23.resize(nb_zone);
@@ -325,9 +415,9 @@ namespace HYDROTEL
 		{
 			size_t index_zone = index_zones[index];
 
-			zones[index_zone]._theta1 = _theta1_initial[index_zone] * propriete_hydroliques.PrendreProprieteHydroliqueCouche1(index_zone).PrendreThetas();
-			zones[index_zone]._theta2 = _theta2_initial[index_zone] * propriete_hydroliques.PrendreProprieteHydroliqueCouche2(index_zone).PrendreThetas();
-			zones[index_zone]._theta3 = _theta3_initial[index_zone] * propriete_hydroliques.PrendreProprieteHydroliqueCouche3(index_zone).PrendreThetas();
+			etat_zones._theta1[index_zone] = _theta1_initial[index_zone] * propriete_hydroliques.PrendreProprieteHydroliqueCouche1(index_zone).PrendreThetas();
+			etat_zones._theta2[index_zone] = _theta2_initial[index_zone] * propriete_hydroliques.PrendreProprieteHydroliqueCouche2(index_zone).PrendreThetas();
+			etat_zones._theta3[index_zone] = _theta3_initial[index_zone] * propriete_hydroliques.PrendreProprieteHydroliqueCouche3(index_zone).PrendreThetas();
 		}
 
 		//initialisation milieux humides isoles
@@ -381,288 +471,207 @@ namespace HYDROTEL
 		if (output.SauvegardeTheta1())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_theta1 = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_theta1 = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "theta1.nc"), true, "theta1", "[0-1]", "Teneur en eau de la couche 1");
 			else
 			{
 				string nom_fichier_theta1( Combine(_sim_hyd.PrendreRepertoireResultat(), "theta1.csv") );
-				_fichier_theta1.open(nom_fichier_theta1);
-				_fichier_theta1 << "theta 1" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+				_fichier_theta1.Ouvre(output, nom_fichier_theta1, true, 6);
+				_fichier_theta1.Entete() << "theta 1" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_theta1 << str << endl;
+				_fichier_theta1.Entete() << str << endl;
 			}
 		}
 
 		if (output.SauvegardeTheta2())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_theta2 = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_theta2 = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "theta2.nc"), true, "theta2", "[0-1]", "Teneur en eau de la couche 2");
 			else
 			{
 				string nom_fichier_theta2( Combine(_sim_hyd.PrendreRepertoireResultat(), "theta2.csv") );
-				_fichier_theta2.open(nom_fichier_theta2);
-				_fichier_theta2 << "theta 2" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+				_fichier_theta2.Ouvre(output, nom_fichier_theta2, true, 6);
+				_fichier_theta2.Entete() << "theta 2" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 			
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 			
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_theta2 << str << endl;
+				_fichier_theta2.Entete() << str << endl;
 			}
 		}
 
 		if (output.SauvegardeTheta3())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_theta3 = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_theta3 = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "theta3.nc"), true, "theta3", "[0-1]", "Teneur en eau de la couche 3");
 			else
 			{
 				string nom_fichier_theta3( Combine(_sim_hyd.PrendreRepertoireResultat(), "theta3.csv") );
-				_fichier_theta3.open(nom_fichier_theta3);
-				_fichier_theta3 << "theta 3" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+				_fichier_theta3.Ouvre(output, nom_fichier_theta3, true, 6);
+				_fichier_theta3.Entete() << "theta 3" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 			
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 			
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_theta3 << str << endl;
+				_fichier_theta3.Entete() << str << endl;
 			}
 		}
 
 		if (output.SauvegardeEtr1())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_etr1 = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_etr1 = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "etr1.nc"), true, "etr1", "mm", "Evapotranspiration reelle de la couche 1");
 			else
 			{
 				string nom_fichier_etr1( Combine(_sim_hyd.PrendreRepertoireResultat(), "etr1.csv") );
-				_fichier_etr1.open(nom_fichier_etr1);
-				_fichier_etr1 << "etr 1" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+				_fichier_etr1.Ouvre(output, nom_fichier_etr1, true, 6);
+				_fichier_etr1.Entete() << "etr 1" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 			
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 			
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_etr1 << str << endl;
+				_fichier_etr1.Entete() << str << endl;
 			}
 		}
 
 		if (output.SauvegardeEtr2())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_etr2 = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_etr2 = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "etr2.nc"), true, "etr2", "mm", "Evapotranspiration reelle de la couche 2");
 			else
 			{
 				string nom_fichier_etr2( Combine(_sim_hyd.PrendreRepertoireResultat(), "etr2.csv") );
-				_fichier_etr2.open(nom_fichier_etr2);
-				_fichier_etr2 << "etr 2" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+				_fichier_etr2.Ouvre(output, nom_fichier_etr2, true, 6);
+				_fichier_etr2.Entete() << "etr 2" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 			
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 			
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_etr2 << str << endl;
+				_fichier_etr2.Entete() << str << endl;
 			}
 		}
 
 		if (output.SauvegardeEtr3())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_etr3 = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_etr3 = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "etr3.nc"), true, "etr3", "mm", "Evapotranspiration reelle de la couche 3");
 			else
 			{
 				string nom_fichier_etr3( Combine(_sim_hyd.PrendreRepertoireResultat(), "etr3.csv") );
-				_fichier_etr3.open(nom_fichier_etr3);
-				_fichier_etr3 << "etr 3" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+				_fichier_etr3.Ouvre(output, nom_fichier_etr3, true, 6);
+				_fichier_etr3.Entete() << "etr 3" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 			
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 			
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_etr3 << str << endl;
+				_fichier_etr3.Entete() << str << endl;
 			}
 		}
 
 		if (output.SauvegardeEtrTotal())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_etr_total = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_etr_total = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "etr_total.nc"), true, "etr_total", "mm", "Evapotranspiration reelle totale");
 			else
 			{
 				string nom_fichier_etr_total( Combine(_sim_hyd.PrendreRepertoireResultat(), "etr_total.csv") );
-				_fichier_etr_total.open(nom_fichier_etr_total);
-				_fichier_etr_total << "etr total" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+				_fichier_etr_total.Ouvre(output, nom_fichier_etr_total, true, 6);
+				_fichier_etr_total.Entete() << "etr total" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 			
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 			
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_etr_total << str << endl;
+				_fichier_etr_total.Entete() << str << endl;
 			}
 		}
 
 		if (output.SauvegardeQ12())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_q12 = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_q12 = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "q12.nc"), true, "q12", "mm/pdt", "Ecoulement vertical de la couche 1 a 2");
 			else
 			{
 				string nom_fichier( Combine(_sim_hyd.PrendreRepertoireResultat(), "q12.csv") );
-				_fichier_q12.open(nom_fichier);
-				_fichier_q12 << "q12 (mm/pdt)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+				_fichier_q12.Ouvre(output, nom_fichier, true, 6);
+				_fichier_q12.Entete() << "q12 (mm/pdt)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 			
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 			
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_q12 << str << endl;
+				_fichier_q12.Entete() << str << endl;
 			}
 		}
 
 		if (output.SauvegardeQ23())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_q23 = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_q23 = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "q23.nc"), true, "q23", "mm/pdt", "Ecoulement vertical de la couche 2 a 3");
 			else
 			{
 				string nom_fichier( Combine(_sim_hyd.PrendreRepertoireResultat(), "q23.csv") );
-				_fichier_q23.open(nom_fichier);
-				_fichier_q23 << "q23 (mm/pdt)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+				_fichier_q23.Ouvre(output, nom_fichier, true, 6);
+				_fichier_q23.Entete() << "q23 (mm/pdt)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 			
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 			
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_q23 << str << endl;
+				_fichier_q23.Entete() << str << endl;
 			}
 		}
 
@@ -822,6 +831,7 @@ namespace HYDROTEL
 		CalculeEtr();
 
 		ZONES& zones = _sim_hyd.PrendreZones();
+		ETAT_ZONES& etat_zones = zones.PrendreEtat();
 
 		unsigned short pas_de_temps = _sim_hyd.PrendrePasDeTemps();
 
@@ -873,22 +883,22 @@ namespace HYDROTEL
 						float saturationCouche2 = typeSolCouche2.PrendreThetas();
 						float saturationCouche3 = typeSolCouche3.PrendreThetas();
 
-						zones[index_zone]._theta3 = (correction->PrendreCoefficientMultiplicatif() * 
-							(zones[index_zone].PrendreZ11() * zones[index_zone]._theta1 + zones[index_zone].PrendreZ22() * zones[index_zone]._theta2 + zones[index_zone].PrendreZ33() * zones[index_zone]._theta3) - 
-							(zones[index_zone].PrendreZ11() * zones[index_zone]._theta1 + zones[index_zone].PrendreZ22() * zones[index_zone]._theta2)) / zones[index_zone].PrendreZ33();
+						etat_zones._theta3[index_zone] = (correction->PrendreCoefficientMultiplicatif() * 
+							(zones[index_zone].PrendreZ11() * etat_zones._theta1[index_zone] + zones[index_zone].PrendreZ22() * etat_zones._theta2[index_zone] + zones[index_zone].PrendreZ33() * etat_zones._theta3[index_zone]) - 
+							(zones[index_zone].PrendreZ11() * etat_zones._theta1[index_zone] + zones[index_zone].PrendreZ22() * etat_zones._theta2[index_zone])) / zones[index_zone].PrendreZ33();
 
-						if (zones[index_zone]._theta3 > saturationCouche3)
+						if (etat_zones._theta3[index_zone] > saturationCouche3)
 						{
-							zones[index_zone]._theta2 += (zones[index_zone]._theta3 - saturationCouche3) * zones[index_zone].PrendreZ33() / zones[index_zone].PrendreZ22();
-							zones[index_zone]._theta3 = saturationCouche3;
+							etat_zones._theta2[index_zone] += (etat_zones._theta3[index_zone] - saturationCouche3) * zones[index_zone].PrendreZ33() / zones[index_zone].PrendreZ22();
+							etat_zones._theta3[index_zone] = saturationCouche3;
 						
-							if (zones[index_zone]._theta2 > saturationCouche2)
+							if (etat_zones._theta2[index_zone] > saturationCouche2)
 							{
-								zones[index_zone]._theta1 += (zones[index_zone]._theta2 - saturationCouche2) * zones[index_zone].PrendreZ22() / zones[index_zone].PrendreZ11();
-								zones[index_zone]._theta2 = saturationCouche2;
+								etat_zones._theta1[index_zone] += (etat_zones._theta2[index_zone] - saturationCouche2) * zones[index_zone].PrendreZ22() / zones[index_zone].PrendreZ11();
+								etat_zones._theta2[index_zone] = saturationCouche2;
 							
-								if (zones[index_zone]._theta1 > saturationCouche1)
-									zones[index_zone]._theta1 = saturationCouche1;
+								if (etat_zones._theta1[index_zone] > saturationCouche1)
+									etat_zones._theta1[index_zone] = saturationCouche1;
 							}
 						}
 					}
@@ -937,9 +947,9 @@ namespace HYDROTEL
 						float saturationCouche2 = typeSolCouche2.PrendreThetas();
 						float saturationCouche3 = typeSolCouche3.PrendreThetas();
 
-						zones[index_zone]._theta1 = correction->PrendreCoeffSaturationCouche1() * saturationCouche1;
-						zones[index_zone]._theta2 = correction->PrendreCoeffSaturationCouche2() * saturationCouche2;
-						zones[index_zone]._theta3 = correction->PrendreCoeffSaturationCouche3() * saturationCouche3;
+						etat_zones._theta1[index_zone] = correction->PrendreCoeffSaturationCouche1() * saturationCouche1;
+						etat_zones._theta2[index_zone] = correction->PrendreCoeffSaturationCouche2() * saturationCouche2;
+						etat_zones._theta3[index_zone] = correction->PrendreCoeffSaturationCouche3() * saturationCouche3;
 					}
 				}
 			}
@@ -947,12 +957,10 @@ namespace HYDROTEL
 
 		//calcule
 
-		int iIndexZone;
+		//chaque uhrh est independante; le resultat est identique peu importe le nombre de thread
+		#pragma omp parallel for num_threads(_sim_hyd.PrendreNbThread()) schedule(dynamic, 64)
 		for (index = 0; index < nb_zone_simule; ++index)
-		{
-			iIndexZone = static_cast<int>(index_zones[index]);
-			CalculeUHRH(iIndexZone);
-		}
+			CalculeUHRH(static_cast<int>(index_zones[index]));
 
 		//sauvegarde des variables intermediaires
 
@@ -989,40 +997,24 @@ namespace HYDROTEL
 
 		//
 
-		size_t i, idx;
-		string str;
+		size_t i;
+		float* pLigne;
 
 		if (output.SauvegardeTheta1())
 		{
 			if (_netCdf_theta1 != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_theta1->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_theta1[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]]._theta1;
+					pLigne[i] = etat_zones._theta1[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]];
 			}
 			else
 			{
-				ostringstream oss;
-				oss.str("");
-			
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(6) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_theta1.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for (szindex = 0; szindex < zones.PrendreNbZone(); ++szindex)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), szindex) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[szindex].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[szindex]._theta1 << output.Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_theta1 << str << endl;
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					pValeur[n] = etat_zones._theta1[output._uhrhOutputIndex[n]];
 			}
 		}
 
@@ -1030,33 +1022,17 @@ namespace HYDROTEL
 		{
 			if (_netCdf_theta2 != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_theta2->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_theta2[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]]._theta2;
+					pLigne[i] = etat_zones._theta2[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]];
 			}
 			else
 			{
-				ostringstream oss;
-				oss.str("");
-			
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(6) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_theta2.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for (szindex = 0; szindex < zones.PrendreNbZone(); ++szindex)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), szindex) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[szindex].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[szindex]._theta2 << output.Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_theta2 << str << endl;
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					pValeur[n] = etat_zones._theta2[output._uhrhOutputIndex[n]];
 			}
 		}
 
@@ -1064,33 +1040,17 @@ namespace HYDROTEL
 		{
 			if (_netCdf_theta3 != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_theta3->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_theta3[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]]._theta3;
+					pLigne[i] = etat_zones._theta3[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]];
 			}
 			else
 			{
-				ostringstream oss;
-				oss.str("");
-			
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(6) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_theta3.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for (szindex = 0; szindex < zones.PrendreNbZone(); ++szindex)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), szindex) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[szindex].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[szindex]._theta3 << output.Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_theta3 << str << endl;
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					pValeur[n] = etat_zones._theta3[output._uhrhOutputIndex[n]];
 			}
 		}
 
@@ -1098,33 +1058,17 @@ namespace HYDROTEL
 		{
 			if (_netCdf_etr1 != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_etr1->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_etr1[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreEtr1();
+					pLigne[i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreEtr1();
 			}
 			else
 			{
-				ostringstream oss;
-				oss.str("");
-			
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(6) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_etr1.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for (szindex = 0; szindex < zones.PrendreNbZone(); ++szindex)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), szindex) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[szindex].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[szindex].PrendreEtr1() << output.Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_etr1 << str << endl;
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					pValeur[n] = zones[output._uhrhOutputIndex[n]].PrendreEtr1();
 			}
 		}
 
@@ -1132,33 +1076,17 @@ namespace HYDROTEL
 		{
 			if (_netCdf_etr2 != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_etr2->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_etr2[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreEtr2();
+					pLigne[i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreEtr2();
 			}
 			else
 			{
-				ostringstream oss;
-				oss.str("");
-			
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(6) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_etr2.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for (szindex = 0; szindex < zones.PrendreNbZone(); ++szindex)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), szindex) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[szindex].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[szindex].PrendreEtr2() << output.Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_etr2 << str << endl;
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					pValeur[n] = zones[output._uhrhOutputIndex[n]].PrendreEtr2();
 			}
 		}
 
@@ -1166,33 +1094,17 @@ namespace HYDROTEL
 		{
 			if (_netCdf_etr3 != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_etr3->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_etr3[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreEtr3();
+					pLigne[i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreEtr3();
 			}
 			else
 			{
-				ostringstream oss;
-				oss.str("");
-			
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(6) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_etr3.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for (szindex = 0; szindex < zones.PrendreNbZone(); ++szindex)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), szindex) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[szindex].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[szindex].PrendreEtr3() << output.Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_etr3 << str << endl;
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					pValeur[n] = zones[output._uhrhOutputIndex[n]].PrendreEtr3();
 			}
 		}
 
@@ -1200,33 +1112,17 @@ namespace HYDROTEL
 		{
 			if (_netCdf_etr_total != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_etr_total->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_etr_total[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreEtrTotal();
+					pLigne[i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreEtrTotal();
 			}
 			else
 			{
-				ostringstream oss;
-				oss.str("");
-			
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(6) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_etr_total.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for (szindex = 0; szindex < zones.PrendreNbZone(); ++szindex)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), szindex) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[szindex].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[szindex].PrendreEtrTotal() << output.Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_etr_total << str << endl;
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					pValeur[n] = zones[output._uhrhOutputIndex[n]].PrendreEtrTotal();
 			}
 		}
 
@@ -1234,33 +1130,17 @@ namespace HYDROTEL
 		{
 			if (_netCdf_q12 != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_q12->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_q12[idx+i] = _q12[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]];
+					pLigne[i] = _q12[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]];
 			}
 			else
 			{
-				ostringstream oss;
-				oss.str("");
-			
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(6) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_q12.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for (szindex = 0; szindex < zones.PrendreNbZone(); ++szindex)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), szindex) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[szindex].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << _q12[szindex] << output.Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_q12 << str << endl;
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					pValeur[n] = _q12[output._uhrhOutputIndex[n]];
 			}
 		}
 
@@ -1268,33 +1148,17 @@ namespace HYDROTEL
 		{
 			if (_netCdf_q23 != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_q23->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_q23[idx+i] = _q23[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]];
+					pLigne[i] = _q23[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]];
 			}
 			else
 			{
-				ostringstream oss;
-				oss.str("");
-			
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(6) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_q23.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for (szindex = 0; szindex < zones.PrendreNbZone(); ++szindex)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), szindex) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[szindex].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << _q23[szindex] << output.Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_q23 << str << endl;
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					pValeur[n] = _q23[output._uhrhOutputIndex[n]];
 			}
 		}
 
@@ -1380,7 +1244,7 @@ namespace HYDROTEL
 
 	void BV3C1::Termine()
 	{
-		string str1, str2;
+		string str;
 
 		_pourcentage_eau.clear();
 		_pourcentage_impermeable.clear();
@@ -1394,6 +1258,8 @@ namespace HYDROTEL
 		_mm.clear();
 		_nn.clear();
 
+		for(auto milieu_humide : _milieu_humide_isole)
+			delete milieu_humide;
 		_milieu_humide_isole.clear();
 
 		for (auto iter = _milieu_humide_result.begin(); iter != _milieu_humide_result.end(); iter++)
@@ -1406,153 +1272,135 @@ namespace HYDROTEL
 		{
 			if (_netCdf_theta1 != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "bilanvertical-bv3c-theta1.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "theta1.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "bilanvertical-bv3c-theta1", _netCdf_theta1, "[0-1]", "Teneur en eau de la couche 1");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "theta1", _netCdf_theta1, "[0-1]", "Teneur en eau de la couche 1");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_theta1->Ferme();
+				delete _netCdf_theta1;
+				_netCdf_theta1 = NULL;
 
-				delete [] _netCdf_theta1;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_theta1.close();
+				_fichier_theta1.Ferme();
 		}
 
 		if (output.SauvegardeTheta2())
 		{
 			if (_netCdf_theta2 != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "bilanvertical-bv3c-theta2.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "theta2.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "bilanvertical-bv3c-theta2", _netCdf_theta2, "[0-1]", "Teneur en eau de la couche 2");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "theta2", _netCdf_theta2, "[0-1]", "Teneur en eau de la couche 2");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_theta2->Ferme();
+				delete _netCdf_theta2;
+				_netCdf_theta2 = NULL;
 
-				delete [] _netCdf_theta2;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_theta2.close();
+				_fichier_theta2.Ferme();
 		}
 
 		if (output.SauvegardeTheta3())
 		{
 			if (_netCdf_theta3 != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "bilanvertical-bv3c-theta3.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "theta3.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "bilanvertical-bv3c-theta3", _netCdf_theta3, "[0-1]", "Teneur en eau de la couche 3");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "theta3", _netCdf_theta3, "[0-1]", "Teneur en eau de la couche 3");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_theta3->Ferme();
+				delete _netCdf_theta3;
+				_netCdf_theta3 = NULL;
 
-				delete [] _netCdf_theta3;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_theta3.close();
+				_fichier_theta3.Ferme();
 		}
 
 		if (output.SauvegardeEtr1())
 		{
 			if (_netCdf_etr1 != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "bilanvertical-bv3c-etr1.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "etr1.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "bilanvertical-bv3c-etr1", _netCdf_etr1, "mm", "Evapotranspiration reelle de la couche 1");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "etr1", _netCdf_etr1, "mm", "Evapotranspiration reelle de la couche 1");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_etr1->Ferme();
+				delete _netCdf_etr1;
+				_netCdf_etr1 = NULL;
 
-				delete [] _netCdf_etr1;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_etr1.close();
+				_fichier_etr1.Ferme();
 		}
 
 		if (output.SauvegardeEtr2())
 		{
 			if (_netCdf_etr2 != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "bilanvertical-bv3c-etr2.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "etr2.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "bilanvertical-bv3c-etr2", _netCdf_etr2, "mm", "Evapotranspiration reelle de la couche 2");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "etr2", _netCdf_etr2, "mm", "Evapotranspiration reelle de la couche 2");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_etr2->Ferme();
+				delete _netCdf_etr2;
+				_netCdf_etr2 = NULL;
 
-				delete [] _netCdf_etr2;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_etr2.close();
+				_fichier_etr2.Ferme();
 		}
 
 		if (output.SauvegardeEtr3())
 		{
 			if (_netCdf_etr3 != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "bilanvertical-bv3c-etr3.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "etr3.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "bilanvertical-bv3c-etr3", _netCdf_etr3, "mm", "Evapotranspiration reelle de la couche 3");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "etr3", _netCdf_etr3, "mm", "Evapotranspiration reelle de la couche 3");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_etr3->Ferme();
+				delete _netCdf_etr3;
+				_netCdf_etr3 = NULL;
 
-				delete [] _netCdf_etr3;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_etr3.close();
+				_fichier_etr3.Ferme();
 		}
 
 		if (output.SauvegardeEtrTotal())
 		{
 			if (_netCdf_etr_total != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "bilanvertical-bv3c-etr_total.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "etr_total.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "bilanvertical-bv3c-etr_total", _netCdf_etr_total, "mm", "Evapotranspiration reelle totale");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "etr_total", _netCdf_etr_total, "mm", "Evapotranspiration reelle totale");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_etr_total->Ferme();
+				delete _netCdf_etr_total;
+				_netCdf_etr_total = NULL;
 
-				delete [] _netCdf_etr_total;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_etr_total.close();
+				_fichier_etr_total.Ferme();
 		}
 
 		if (output.SauvegardeQ12())
 		{
 			if (_netCdf_q12 != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "bilanvertical-bv3c-q12.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "q12.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "bilanvertical-bv3c-q12", _netCdf_q12, "mm/pdt", "Ecoulement vertical de la couche 1 a 2");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "q12", _netCdf_q12, "mm/pdt", "Ecoulement vertical de la couche 1 a 2");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_q12->Ferme();
+				delete _netCdf_q12;
+				_netCdf_q12 = NULL;
 
-				delete [] _netCdf_q12;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_q12.close();
+				_fichier_q12.Ferme();
 		}
 
 		if (output.SauvegardeQ23())
 		{
 			if (_netCdf_q23 != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "bilanvertical-bv3c-q23.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "q23.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "bilanvertical-bv3c-q23", _netCdf_q23, "mm/pdt", "Ecoulement vertical de la couche 2 a 3");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "q23", _netCdf_q23, "mm/pdt", "Ecoulement vertical de la couche 2 a 3");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_q23->Ferme();
+				delete _netCdf_q23;
+				_netCdf_q23 = NULL;
 
-				delete [] _netCdf_q23;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_q23.close();
+				_fichier_q23.Ferme();
 		}
 
 		if(m_wetfichier.is_open())
@@ -1632,6 +1480,8 @@ namespace HYDROTEL
 
 	void BV3C1::TriCoucheOct97(ZONE& zone, size_t index_zone, float pinf, float& ruis, float& q2, float& q3, float& dtc)
 	{
+		ETAT_ZONES& etat_zones = _sim_hyd.PrendreZones().PrendreEtat();
+
 		int pas_de_temps = _sim_hyd.PrendrePasDeTemps();
 		float fpas_de_temps = static_cast<float>(pas_de_temps);
 
@@ -1653,13 +1503,13 @@ namespace HYDROTEL
 		size_t tsol2 = typesol.PrendreIndexCouche2(index_zone);
 		size_t tsol3 = typesol.PrendreIndexCouche3(index_zone);
 
-		float k1 = ConductiviteHydrolique(zone._theta1, typeSolCouche1, tsol1);
-		float k2 = ConductiviteHydrolique(zone._theta2, typeSolCouche2, tsol2);
-		float k3 = ConductiviteHydrolique(zone._theta3, typeSolCouche3, tsol3);
+		float k1 = ConductiviteHydrolique(etat_zones._theta1[index_zone], typeSolCouche1, tsol1);
+		float k2 = ConductiviteHydrolique(etat_zones._theta2[index_zone], typeSolCouche2, tsol2);
+		float k3 = ConductiviteHydrolique(etat_zones._theta3[index_zone], typeSolCouche3, tsol3);
 
-		float psi1 = CalculePsi(zone._theta1, typeSolCouche1, tsol1);
-		float psi2 = CalculePsi(zone._theta2, typeSolCouche2, tsol2);
-		float psi3 = CalculePsi(zone._theta3, typeSolCouche3, tsol3);
+		float psi1 = CalculePsi(etat_zones._theta1[index_zone], typeSolCouche1, tsol1);
+		float psi2 = CalculePsi(etat_zones._theta2[index_zone], typeSolCouche2, tsol2);
+		float psi3 = CalculePsi(etat_zones._theta3[index_zone], typeSolCouche3, tsol3);
 
 		float k12 = max(k1, k2);
 		float k23 = max(k2, k3);
@@ -1671,7 +1521,7 @@ namespace HYDROTEL
 		qq12 = k12* (2.0f * (psi2 - psi1) / (z11 + z22) + 1.0f);		// m/h  (*m2 2D horizontal)
 		qq23 = k23* (2.0f * (psi3 - psi2) / (z22 + z33) + 1.0f);		// m/h  (*m2 2D horizontal)
 		q2 = k2 * sin(atan(pte)) * z22;									// m2/h (*m  1D horizontal)
-		q3 = krec * z33 * zone._theta3;									// m2/h (*m  1D horizontal)
+		q3 = krec * z33 * etat_zones._theta3[index_zone];									// m2/h (*m  1D horizontal)
 
 		// si le modele de temperature du sol a ete simule, on met a jour selon la profondeur du gel simule		
 		fProfondeur = zone.PrendreProfondeurGel();
@@ -1700,7 +1550,7 @@ namespace HYDROTEL
 					if(fTempo >= 0.5f)
 						fTempo = 0.5f;
 
-					q3 = fTempo * krec * z33 * zone._theta3;														// m2/h (*m  1D horizontal)
+					q3 = fTempo * krec * z33 * etat_zones._theta3[index_zone];														// m2/h (*m  1D horizontal)
 				}
 			}
 		}		
@@ -1725,9 +1575,9 @@ namespace HYDROTEL
 		float q23z = qq23 / z22;
 		float q2s = q2 / z22;
 
-		float theta1 = zone._theta1;
-		float theta2 = zone._theta2;
-		float theta3 = zone._theta3;
+		float theta1 = etat_zones._theta1[index_zone];
+		float theta2 = etat_zones._theta2[index_zone];
+		float theta3 = etat_zones._theta3[index_zone];
 
 		// determination du pas de temps interne a BV3C
 		float fCin = _cin[index_zone];
@@ -1952,9 +1802,9 @@ namespace HYDROTEL
 			}
 		}
 
-		zone._theta1 = theta1;
-		zone._theta2 = theta2;
-		zone._theta3 = theta3;
+		etat_zones._theta1[index_zone] = theta1;
+		etat_zones._theta2[index_zone] = theta2;
+		etat_zones._theta3[index_zone] = theta3;
 
 		// il faut conserver la somme des lames transitees sur le pas de temps externe
 		float q12 = _q12[index_zone];
@@ -1969,6 +1819,8 @@ namespace HYDROTEL
 
 	void BV3C1::CalculeRuisselement(ZONE& zone, size_t index_zone, float& pinf, float& ruis)
 	{
+		ETAT_ZONES& etat_zones = _sim_hyd.PrendreZones().PrendreEtat();
+
 		float apport = zone.PrendreApport();
 
 		if (apport > 0.0f)
@@ -1985,7 +1837,7 @@ namespace HYDROTEL
 				pinf = 0.0f;
 			else
 			{
-				if (zone._theta1 == typesol.PrendreThetas())
+				if (etat_zones._theta1[index_zone] == typesol.PrendreThetas())
 					pinf = 0.0f;
 				else if (prec > ks) 
 					pinf = ks;
@@ -2002,9 +1854,31 @@ namespace HYDROTEL
 		}
 	}
 
+	void BV3C1::CalculeFacteurExtinction(int annee, int jour_julien)
+	{
+		OCCUPATION_SOL& occupation_sol = _sim_hyd.PrendreOccupationSol();
+		vector<size_t>& index_zones = _sim_hyd.PrendreZonesSimules();
+
+		const size_t nb_classe = _index_autres.size();
+
+		_facteur_extinction.resize(index_zones.size() * nb_classe);
+
+		for (size_t index = 0; index < index_zones.size(); ++index)
+		{
+			float des = _des[index_zones[index]];
+
+			for (size_t n = 0; n < nb_classe; ++n)
+				_facteur_extinction[index * nb_classe + n] = exp(-des * occupation_sol.PrendreIndiceFoliaire(_index_autres[n], jour_julien));
+		}
+
+		_annee_facteur_extinction = annee;
+		_jour_facteur_extinction = jour_julien;
+	}
+
 	void BV3C1::CalculeEtr()
 	{
 		ZONES& zones = _sim_hyd.PrendreZones();
+		ETAT_ZONES& etat_zones = zones.PrendreEtat();
 
 		OCCUPATION_SOL& occupation_sol = _sim_hyd.PrendreOccupationSol();
 		PROPRIETE_HYDROLIQUES& propriete_hydroliques = _sim_hyd.PrendreProprieteHydrotliques();
@@ -2013,6 +1887,8 @@ namespace HYDROTEL
 
 		vector<size_t> index_zones = _sim_hyd.PrendreZonesSimules();
 
+		if (date_courante.PrendreAnnee() != _annee_facteur_extinction || date_courante.PrendreJourJulien() != _jour_facteur_extinction)
+			CalculeFacteurExtinction(date_courante.PrendreAnnee(), date_courante.PrendreJourJulien());
 
 		for (size_t index = 0; index < index_zones.size(); ++index)
 		{
@@ -2020,6 +1896,8 @@ namespace HYDROTEL
 
 			ZONE& zone = zones[index_zone];
 
+			const float* facteur_extinction = _facteur_extinction.data() + index * _index_autres.size();
+
 			float etr1 = 0.0f;
 			float etr2 = 0.0f;
 			float etr3 = 0.0f;
@@ -2033,14 +1911,13 @@ namespace HYDROTEL
 				if (etp > 0.0f)
 				{
 					float z = occupation_sol.PrendreProfondeurRacinaire(*iter, date_courante.PrendreJourJulien());
-					float indice_foliaire = occupation_sol.PrendreIndiceFoliaire(*iter, date_courante.PrendreJourJulien());
 
-					float evapo = etp * exp(-_des[index_zone] * indice_foliaire);
+					float evapo = etp * facteur_extinction[iter - begin(_index_autres)];
 
 					if(typesol.PrendreThetacc() <= 0.0f || typesol.PrendreThetapf() <= 0.0f)
 						throw ERREUR_LECTURE_FICHIER("PARAMETRES PROPRIETES HYDRAULIQUE INVALIDE");
 
-					float ftheta = min(max(zones[index_zone]._theta1 - typesol.PrendreThetapf(), 0.0f) / (typesol.PrendreThetacc() - typesol.PrendreThetapf()), 1.0f);
+					float ftheta = min(max(etat_zones._theta1[index_zone] - typesol.PrendreThetapf(), 0.0f) / (typesol.PrendreThetacc() - typesol.PrendreThetapf()), 1.0f);
 					float kas = ((1.0f - exp(-typesol.PrendreAlpha() * ftheta)) / (1.0f - 2.0f * exp(-typesol.PrendreAlpha()) + exp(-typesol.PrendreAlpha() * ftheta)));
 					
 					float esnu = (_coef_assech[index_zone] * kas) * evapo;
@@ -2084,7 +1961,7 @@ namespace HYDROTEL
 
 					if (z > 0.0f)
 					{
-						float theta = (zones[index_zone]._theta1 * dz1 + zones[index_zone]._theta2 * dz2 + zones[index_zone]._theta3 * dz3) / z;
+						float theta = (etat_zones._theta1[index_zone] * dz1 + etat_zones._theta2[index_zone] * dz2 + etat_zones._theta3[index_zone] * dz3) / z;
 
 						ftheta = min(max(theta - typesol.PrendreThetapf(), 0.0f) / (typesol.PrendreThetacc() - typesol.PrendreThetapf()), 1.0f);
 						float kat = (float)((1.0f - exp(-typesol.PrendreAlpha() * ftheta)) / (1.0f - 2.0f * exp(-typesol.PrendreAlpha()) + exp(-typesol.PrendreAlpha() * ftheta)));
@@ -2094,9 +1971,9 @@ namespace HYDROTEL
 						// repartition entre les couches de l'etr
 						if ((theta * z) != 0.0f)
 						{
-							etr1 += tp * (zones[index_zone]._theta1 * dz1) / (theta * z);
-							etr2 += tp * (zones[index_zone]._theta2 * dz2) / (theta * z);
-							etr3 += tp * (zones[index_zone]._theta3 * dz3) / (theta * z);
+							etr1 += tp * (etat_zones._theta1[index_zone] * dz1) / (theta * z);
+							etr2 += tp * (etat_zones._theta2[index_zone] * dz2) / (theta * z);
+							etr3 += tp * (etat_zones._theta3[index_zone] * dz3) / (theta * z);
 						}
 					}
 
@@ -2206,8 +2083,8 @@ namespace HYDROTEL
 
 		fichier.close();
 
-		//lecture des parametres pour les milieux humides isoles
-		if(_sim_hyd._bSimuleMHIsole)
+		//lecture des parametres pour les milieux humides isoles; lus une seule fois (fichier distinct, non modifie par la calibration)
+		if(_sim_hyd._bSimuleMHIsole && _milieu_humide_isole.empty())
 			LectureMilieuHumideIsole();
 	}
 
@@ -2300,8 +2177,8 @@ namespace HYDROTEL
 		if(!bOK)
 			throw ERREUR_LECTURE_FICHIER( "FICHIER PARAMETRES GLOBAL; BV3C; " + _sim_hyd._nomFichierParametresGlobal, 0, "Parametres sous-modele BV3C");
 
-		//lecture des parametres pour les milieux humides isoles
-		if(_sim_hyd._bSimuleMHIsole)
+		//lecture des parametres pour les milieux humides isoles; lus une seule fois (fichier distinct, non modifie par la calibration)
+		if(_sim_hyd._bSimuleMHIsole && _milieu_humide_isole.empty())
 			LectureMilieuHumideIsole();
 	}
 
@@ -2455,4 +2332,43 @@ namespace HYDROTEL
 		return _date_sauvegarde_etat;
 	}
 
+
+	void BV3C1::SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const
+	{
+		etat.Ecrit(_q12);
+		etat.Ecrit(_q23);
+
+		//milieux humides isoles
+		etat.Ecrit(_milieu_humide_isole.size());
+
+		for(size_t index_zone=0; index_zone<_milieu_humide_isole.size(); index_zone++)
+		{
+			if(_milieu_humide_isole[index_zone])
+				etat.Ecrit(_milieu_humide_isole[index_zone]->GetWetvol());
+		}
+	}
+
+	void BV3C1::LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur)
+	{
+		lecteur.Lit(_q12);
+		lecteur.Lit(_q23);
+
+		//milieux humides isoles
+		size_t nb;
+		float wetvol;
+
+		lecteur.Lit(nb);
+		if(nb != _milieu_humide_isole.size())
+			throw ERREUR("In-memory state: BV3C1: isolated wetlands do not match the simulation.");
+
+		for(size_t index_zone=0; index_zone<_milieu_humide_isole.size(); index_zone++)
+		{
+			if(_milieu_humide_isole[index_zone])
+			{
+				lecteur.Lit(wetvol);
+				_milieu_humide_isole[index_zone]->SetWetvol(wetvol);
+			}
+		}
+	}
+
 }
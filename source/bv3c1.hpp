@@ -54,6 +54,12 @@ namespace HYDROTEL
 
 		virtual void SauvegardeParametres();
 
+		virtual void InitialiseParametres();
+
+		virtual void SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const;
+
+		virtual void LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur);
+
 		virtual void ChangeNbParams(const ZONES& zones);
 
 		/// change le % de saturation initial de la couche1
@@ -119,15 +125,15 @@ namespace HYDROTEL
 		DATE_HEURE PrendreDateHeureSauvegardeEtat() const;
 
 		//NetCDF	//results are kept in memory while running and are saved at the end of the simulation
-		float*				_netCdf_theta1;	//[time*stations]
-		float*				_netCdf_theta2;
-		float*				_netCdf_theta3;
-		float*				_netCdf_etr1;
-		float*				_netCdf_etr2;
-		float*				_netCdf_etr3;
-		float*				_netCdf_etr_total;
-		float*				_netCdf_q12;
-		float*				_netCdf_q23;
+		OUTPUT_NETCDF*		_netCdf_theta1;
+		OUTPUT_NETCDF*		_netCdf_theta2;
+		OUTPUT_NETCDF*		_netCdf_theta3;
+		OUTPUT_NETCDF*		_netCdf_etr1;
+		OUTPUT_NETCDF*		_netCdf_etr2;
+		OUTPUT_NETCDF*		_netCdf_etr3;
+		OUTPUT_NETCDF*		_netCdf_etr_total;
+		OUTPUT_NETCDF*		_netCdf_q12;
+		OUTPUT_NETCDF*		_netCdf_q23;
 		//
 
 	private:
@@ -135,6 +141,7 @@ namespace HYDROTEL
 		float CalculePsi(float theta, PROPRIETE_HYDROLIQUE& typesol, size_t index_sol);
 
 		void CalculeEtr();
+		void CalculeFacteurExtinction(int annee, int jour_julien);
 		void CalculeRuisselement(ZONE& zone, size_t index_zone, float& pinf, float& ruis);		
 		void TriCoucheOct97(ZONE& zone, size_t index_zone, float pinf, float& ruis, float& q2, float& q3, float& dtc);
 
@@ -154,6 +161,10 @@ namespace HYDROTEL
 		std::vector<float> _cin;
 		std::vector<float> _coef_assech;
 
+		std::vector<float> _facteur_extinction;			//exp(-des * indice foliaire) du jour [index zone simulee * nb classe autres + classe]
+		int _annee_facteur_extinction;
+		int _jour_facteur_extinction;
+
 		// variable pour lecture/ecriture de l'etat
 
 		std::string _nom_fichier_lecture_etat;
@@ -166,18 +177,18 @@ namespace HYDROTEL
 
 		// variables de simulation
 
-		std::ofstream _fichier_theta1;
-		std::ofstream _fichier_theta2;
-		std::ofstream _fichier_theta3;
+		OUTPUT_CSV _fichier_theta1;
+		OUTPUT_CSV _fichier_theta2;
+		OUTPUT_CSV _fichier_theta3;
 
-		std::ofstream _fichier_etr1;
-		std::ofstream _fichier_etr2;
-		std::ofstream _fichier_etr3;
+		OUTPUT_CSV _fichier_etr1;
+		OUTPUT_CSV _fichier_etr2;
+		OUTPUT_CSV _fichier_etr3;
 		
-		std::ofstream _fichier_etr_total;
+		OUTPUT_CSV _fichier_etr_total;
 
-		std::ofstream _fichier_q12;
-		std::ofstream _fichier_q23;
+		OUTPUT_CSV _fichier_q12;
+		OUTPUT_CSV _fichier_q23;
 
 		std::vector<float> _pourcentage_eau;
 		std::vector<float> _pourcentage_impermeable;
@@ -22,6 +22,7 @@
 
 #include "constantes.hpp"
 #include "erreur.hpp"
+#include "etat_binaire.hpp"
 #include "util.hpp"
 #include "version.hpp"
 
@@ -41,6 +42,9 @@ namespace HYDROTEL
 		_sauvegarde_etat = false;
 		_sauvegarde_tous_etat = false;
 
+		_annee_facteur_extinction = -1;
+		_jour_facteur_extinction = -1;
+
 		_netCdf_theta1 = NULL;
 		_netCdf_theta2 = NULL;
 		_netCdf_theta3 = NULL;
@@ -55,6 +59,30 @@ namespace HYDROTEL
 
 	BV3C2::~BV3C2()
 	{
+		//fichiers netcdf non fermes par Termine (exception); OUTPUT_NETCDF ecrit les pas de temps deja calcules
+		if(_netCdf_theta1 != NULL)
+			delete _netCdf_theta1;
+		if(_netCdf_theta2 != NULL)
+			delete _netCdf_theta2;
+		if(_netCdf_theta3 != NULL)
+			delete _netCdf_theta3;
+		if(_netCdf_etr1 != NULL)
+			delete _netCdf_etr1;
+		if(_netCdf_etr2 != NULL)
+			delete _netCdf_etr2;
+		if(_netCdf_etr3 != NULL)
+			delete _netCdf_etr3;
+		if(_netCdf_etr_total != NULL)
+			delete _netCdf_etr_total;
+		if(_netCdf_q12 != NULL)
+			delete _netCdf_q12;
+		if(_netCdf_q23 != NULL)
+			delete _netCdf_q23;
+		if(_netCdf_qRecharge != NULL)
+			delete _netCdf_qRecharge;
+
+		for(auto milieu_humide : _milieu_humide_isole)
+			delete milieu_humide;
 	}
 
 	float BV3C2::PrendreTheta1Initial(size_t index_zone) const
@@ -154,6 +182,37 @@ namespace HYDROTEL
 
 	void BV3C2::LectureEtat(DATE_HEURE date_courante)
 	{
+		TRACE_PERFORMANCE trace("BV3C2::LectureEtat");
+
+		if(ETAT_BINAIRE::EstBinaire(_nom_fichier_lecture_etat))
+		{
+			ETAT_BINAIRE etat;
+			etat.Lecture(_nom_fichier_lecture_etat, 3);
+
+			ZONES& zones = _sim_hyd.PrendreZones();
+			ETAT_ZONES& etat_zones = zones.PrendreEtat();
+			vector<size_t> index_ligne = etat.AssocieIndex(zones, _sim_hyd.PrendreZonesSimules(), "BILAN_VERTICAL; fichier etat BV3C");
+
+			for(size_t ligne=0; ligne<index_ligne.size(); ligne++)
+			{
+				const size_t index_zone = index_ligne[ligne];
+
+				if(index_zone != string::npos)
+				{
+					const double* valeurs = etat.PrendreLigne(ligne);
+
+					etat_zones._theta1[index_zone] = static_cast<float>(valeurs[0]);
+					etat_zones._theta2[index_zone] = static_cast<float>(valeurs[1]);
+					etat_zones._theta3[index_zone] = static_cast<float>(valeurs[2]);
+
+					if(_milieu_humide_isole.size() != 0 && _milieu_humide_isole[index_zone] && etat.PrendreNbColonne() >= 4)
+						_milieu_humide_isole[index_zone]->SetWetvol(static_cast<float>(valeurs[3]));
+				}
+			}
+
+			return;
+		}
+
 		ifstream fichier(_nom_fichier_lecture_etat);
 		if (!fichier)
 			throw ERREUR_LECTURE_FICHIER("BILAN_VERTICAL; fichier etat BV3C; " + _nom_fichier_lecture_etat);
@@ -169,6 +228,7 @@ namespace HYDROTEL
 		getline_mod(fichier, ligne);	//colums descriptions
 
 		ZONES& zones = _sim_hyd.PrendreZones();
+		ETAT_ZONES& etat_zones = zones.PrendreEtat();
 
 		while(fichier.good())
 		{
@@ -182,9 +242,9 @@ namespace HYDROTEL
 				{
 					index_zone = _sim_hyd.PrendreZones().IdentVersIndex(iIdent);
 
-					zones[index_zone]._theta1 = valeurs[1];
-					zones[index_zone]._theta2 = valeurs[2];
-					zones[index_zone]._theta3 = valeurs[3];
+					etat_zones._theta1[index_zone] = valeurs[1];
+					etat_zones._theta2[index_zone] = valeurs[2];
+					etat_zones._theta3[index_zone] = valeurs[3];
 
 					if(_milieu_humide_isole.size() != 0 && _milieu_humide_isole[index_zone] && valeurs.size() >= 5)
 						_milieu_humide_isole[index_zone]->SetWetvol(valeurs[4]);
@@ -203,6 +263,8 @@ namespace HYDROTEL
 
 	void BV3C2::SauvegardeEtat(DATE_HEURE date_courante) const
 	{
+		TRACE_PERFORMANCE trace("BV3C2::SauvegardeEtat");
+
 		BOOST_ASSERT(_repertoire_ecriture_etat.size() != 0);
 
 		date_courante.AdditionHeure( _sim_hyd.PrendrePasDeTemps() );
@@ -224,7 +286,32 @@ namespace HYDROTEL
 			        << setw(2) << date_courante.PrendreMois() 
 			        << setw(2) << date_courante.PrendreJour() 
 			        << setw(2) << date_courante.PrendreHeure() 
-					<< ".csv";
+					<< _sim_hyd._output.ExtensionFichiersEtats();
+
+		if(_sim_hyd._output._bFichiersEtatsBinaire)
+		{
+			ZONES& zones = _sim_hyd.PrendreZones();
+			ETAT_ZONES& etat_zones = zones.PrendreEtat();
+			ETAT_BINAIRE etat;
+
+			etat.Initialise(PrendreNomSousModele(), date_courante, { "THETA 1", "THETA 2", "THETA 3", "MH WETVOL" }, _sim_hyd.PrendreZonesSimules().size());
+
+			for(size_t index_zone : _sim_hyd.PrendreZonesSimules())
+			{
+				double* valeurs = etat.AjouteLigne(zones[index_zone].PrendreIdent());
+
+				valeurs[0] = etat_zones._theta1[index_zone];
+				valeurs[1] = etat_zones._theta2[index_zone];
+				valeurs[2] = etat_zones._theta3[index_zone];
+
+				valeurs[3] = -999.0;
+				if(_milieu_humide_isole.size() != 0 && _milieu_humide_isole[index_zone])
+					valeurs[3] = _milieu_humide_isole[index_zone]->GetWetvol();
+			}
+
+			etat.Sauvegarde(nom_fichier.str());
+			return;
+		}
 
 		ofstream fichier(nom_fichier.str());
 		if (!fichier)
@@ -239,6 +326,7 @@ namespace HYDROTEL
 		fichier << "UHRH" << sSep << "THETA 1" << sSep << "THETA 2" << sSep << "THETA 3" << sSep << "MH WETVOL" << endl;
 
 		ZONES& zones = _sim_hyd.PrendreZones();
+		ETAT_ZONES& etat_zones = zones.PrendreEtat();
 
 		float fVal;
 
@@ -256,9 +344,9 @@ namespace HYDROTEL
 
 				oss << setprecision(12) << setiosflags(ios::fixed);
 
-				oss << zones[index_zone]._theta1 << sSep;
-				oss << zones[index_zone]._theta2 << sSep;
-				oss << zones[index_zone]._theta3 << sSep;
+				oss << etat_zones._theta1[index_zone] << sSep;
+				oss << etat_zones._theta2[index_zone] << sSep;
+				oss << etat_zones._theta3[index_zone] << sSep;
 				
 				fVal = -999.0f;
 				if(_milieu_humide_isole.size() != 0 && _milieu_humide_isole[index_zone])
@@ -274,34 +362,22 @@ namespace HYDROTEL
 	}
 
 
-	void BV3C2::Initialise()
+	void BV3C2::InitialiseParametres()
 	{
-		_corrections_reserve_sol = _sim_hyd.PrendreCorrections().PrendreCorrectionsReserveSol();
-		_corrections_saturation_sol = _sim_hyd.PrendreCorrections().PrendreCorrectionsSaturationReserveSol();
-
-		OUTPUT& output = _sim_hyd.PrendreOutput();
-		ZONES& zones = _sim_hyd.PrendreZones();
-
-		const size_t nb_zone = zones.PrendreNbZone();
+		const size_t nb_zone = _sim_hyd.PrendreZones().PrendreNbZone();
 
 		auto& occupation_sol = _sim_hyd.PrendreOccupationSol();
-		auto& propriete_hydroliques = _sim_hyd.PrendreProprieteHydrotliques();
-
-		const size_t nb_propriete_hydrolique = propriete_hydroliques.PrendreNb();
 
-		vector<size_t> index_autres;
+		_index_autres.clear();
 		for (size_t index = 0; index < occupation_sol.PrendreNbClasse(); ++index)
 		{
 			if (find(begin(_index_eaux), end(_index_eaux), index) == end(_index_eaux) &&
 				find(begin(_index_impermeables), end(_index_impermeables), index) == end(_index_impermeables))
 			{
-				index_autres.push_back(index);
+				_index_autres.push_back(index);
 			}
 		}
 
-		index_autres.shrink_to_fit();
-		_index_autres.swap(index_autres);
-
 		// calcul pourcentage des classes integrees
 
 		_pourcentage_eau.resize(nb_zone, 0);
@@ -329,6 +405,29 @@ namespace HYDROTEL
 		_pourcentage_autre.resize(nb_zone, 0);
 		for (size_t index_zone = 0; index_zone < nb_zone; ++index_zone)
 			_pourcentage_autre[index_zone] = max(1.0f - (_pourcentage_impermeable[index_zone] + _pourcentage_eau[index_zone]), 0.0f);
+	}
+
+
+	void BV3C2::Initialise()
+	{
+		_corrections_reserve_sol = _sim_hyd.PrendreCorrections().PrendreCorrectionsReserveSol();
+		_corrections_saturation_sol = _sim_hyd.PrendreCorrections().PrendreCorrectionsSaturationReserveSol();
+
+		OUTPUT& output = _sim_hyd.PrendreOutput();
+		ZONES& zones = _sim_hyd.PrendreZones();
+		ETAT_ZONES& etat_zones = zones.PrendreEtat();
+
+		const size_t nb_zone = zones.PrendreNbZone();
+
+		auto& propriete_hydroliques = _sim_hyd.PrendreProprieteHydrotliques();
+
+		const size_t nb_propriete_hydrolique = propriete_hydroliques.PrendreNb();
+
+		_facteur_extinction.clear();
+		_annee_facteur_extinction = -1;
+		_jour_facteur_extinction = -1;
+
+		InitialiseParametres();
 
 		_q12.resize(nb_zone);
 		_q23.resize(nb_zone);
@@ -351,9 +450,9 @@ namespace HYDROTEL
 		{
 			size_t index_zone = index_zones[index];
 
-			zones[index_zone]._theta1 = _theta1_initial[index_zone] * propriete_hydroliques.PrendreProprieteHydroliqueCouche1(index_zone).PrendreThetas();
-			zones[index_zone]._theta2 = _theta2_initial[index_zone] * propriete_hydroliques.PrendreProprieteHydroliqueCouche2(index_zone).PrendreThetas();
-			zones[index_zone]._theta3 = _theta3_initial[index_zone] * propriete_hydroliques.PrendreProprieteHydroliqueCouche3(index_zone).PrendreThetas();
+			etat_zones._theta1[index_zone] = _theta1_initial[index_zone] * propriete_hydroliques.PrendreProprieteHydroliqueCouche1(index_zone).PrendreThetas();
+			etat_zones._theta2[index_zone] = _theta2_initial[index_zone] * propriete_hydroliques.PrendreProprieteHydroliqueCouche2(index_zone).PrendreThetas();
+			etat_zones._theta3[index_zone] = _theta3_initial[index_zone] * propriete_hydroliques.PrendreProprieteHydroliqueCouche3(index_zone).PrendreThetas();
 		}
 
 		//initialisation milieux humides isoles
@@ -419,320 +518,230 @@ namespace HYDROTEL
 		if (output.SauvegardeTheta1())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_theta1 = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_theta1 = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "theta1.nc"), true, "theta1", "[0-1]", "Teneur en eau de la couche 1");
 			else
 			{
 				string nom_fichier_theta1( Combine(_sim_hyd.PrendreRepertoireResultat(), "theta1.csv") );
-				_fichier_theta1.open(nom_fichier_theta1);
-				_fichier_theta1 << "Teneur en eau de la couche 1 (0-1)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+				_fichier_theta1.Ouvre(output, nom_fichier_theta1, true, output._nbDigit_ratio);
+				_fichier_theta1.Entete() << "Teneur en eau de la couche 1 (0-1)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_theta1 << str << endl;
+				_fichier_theta1.Entete() << str << endl;
 			}
 		}
 
 		if (output.SauvegardeTheta2())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_theta2 = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_theta2 = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "theta2.nc"), true, "theta2", "[0-1]", "Teneur en eau de la couche 2");
 			else
 			{
 				string nom_fichier_theta2( Combine(_sim_hyd.PrendreRepertoireResultat(), "theta2.csv") );
-				_fichier_theta2.open(nom_fichier_theta2);
-				_fichier_theta2 << "Teneur en eau de la couche 2 (0-1)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+				_fichier_theta2.Ouvre(output, nom_fichier_theta2, true, output._nbDigit_ratio);
+				_fichier_theta2.Entete() << "Teneur en eau de la couche 2 (0-1)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 			
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 			
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_theta2 << str << endl;
+				_fichier_theta2.Entete() << str << endl;
 			}
 		}
 
 		if (output.SauvegardeTheta3())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_theta3 = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_theta3 = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "theta3.nc"), true, "theta3", "[0-1]", "Teneur en eau de la couche 3");
 			else
 			{
 				string nom_fichier_theta3( Combine(_sim_hyd.PrendreRepertoireResultat(), "theta3.csv") );
-				_fichier_theta3.open(nom_fichier_theta3);
-				_fichier_theta3 << "Teneur en eau de la couche 3 (0-1)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+				_fichier_theta3.Ouvre(output, nom_fichier_theta3, true, output._nbDigit_ratio);
+				_fichier_theta3.Entete() << "Teneur en eau de la couche 3 (0-1)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 			
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 			
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_theta3 << str << endl;
+				_fichier_theta3.Entete() << str << endl;
 			}
 		}
 
 		if (output.SauvegardeEtr1())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_etr1 = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_etr1 = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "etr1.nc"), true, "etr1", "mm", "Evapotranspiration reelle de la couche 1");
 			else
 			{
 				string nom_fichier_etr1( Combine(_sim_hyd.PrendreRepertoireResultat(), "etr1.csv") );
-				_fichier_etr1.open(nom_fichier_etr1);
-				_fichier_etr1 << "vapotranspiration relle de la couche 1 (mm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+				_fichier_etr1.Ouvre(output, nom_fichier_etr1, true, output._nbDigit_mm);
+				_fichier_etr1.Entete() << "vapotranspiration relle de la couche 1 (mm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 			
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 			
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_etr1 << str << endl;
+				_fichier_etr1.Entete() << str << endl;
 			}
 		}
 
 		if (output.SauvegardeEtr2())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_etr2 = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_etr2 = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "etr2.nc"), true, "etr2", "mm", "Evapotranspiration reelle de la couche 2");
 			else
 			{
 				string nom_fichier_etr2( Combine(_sim_hyd.PrendreRepertoireResultat(), "etr2.csv") );
-				_fichier_etr2.open(nom_fichier_etr2);
-				_fichier_etr2 << "vapotranspiration relle de la couche 2 (mm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+				_fichier_etr2.Ouvre(output, nom_fichier_etr2, true, output._nbDigit_mm);
+				_fichier_etr2.Entete() << "vapotranspiration relle de la couche 2 (mm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 			
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 			
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_etr2 << str << endl;
+				_fichier_etr2.Entete() << str << endl;
 			}
 		}
 
 		if (output.SauvegardeEtr3())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_etr3 = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_etr3 = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "etr3.nc"), true, "etr3", "mm", "Evapotranspiration reelle de la couche 3");
 			else
 			{
 				string nom_fichier_etr3( Combine(_sim_hyd.PrendreRepertoireResultat(), "etr3.csv") );
-				_fichier_etr3.open(nom_fichier_etr3);
-				_fichier_etr3 << "vapotranspiration relle de la couche 3 (mm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+				_fichier_etr3.Ouvre(output, nom_fichier_etr3, true, output._nbDigit_mm);
+				_fichier_etr3.Entete() << "vapotranspiration relle de la couche 3 (mm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 			
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 			
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_etr3 << str << endl;
+				_fichier_etr3.Entete() << str << endl;
 			}
 		}
 
 		if (output.SauvegardeEtrTotal())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_etr_total = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_etr_total = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "etr_total.nc"), true, "etr_total", "mm", "Evapotranspiration reelle totale");
 			else
 			{
 				string nom_fichier_etr_total( Combine(_sim_hyd.PrendreRepertoireResultat(), "etr_total.csv") );
-				_fichier_etr_total.open(nom_fichier_etr_total);
-				_fichier_etr_total << "vapotranspiration relle totale (mm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+				_fichier_etr_total.Ouvre(output, nom_fichier_etr_total, true, output._nbDigit_mm);
+				_fichier_etr_total.Entete() << "vapotranspiration relle totale (mm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 			
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 			
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_etr_total << str << endl;
+				_fichier_etr_total.Entete() << str << endl;
 			}
 		}
 
 		if (output.SauvegardeQ12())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_q12 = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_q12 = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "q12.nc"), true, "q12", "mm", "Ecoulement vertical de la couche 1 a 2");
 			else
 			{
 				string nom_fichier( Combine(_sim_hyd.PrendreRepertoireResultat(), "q12.csv") );
-				_fichier_q12.open(nom_fichier);
-				_fichier_q12 << "coulement vertical de la couche 1  2 (mm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+				_fichier_q12.Ouvre(output, nom_fichier, true, output._nbDigit_mm);
+				_fichier_q12.Entete() << "coulement vertical de la couche 1  2 (mm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 			
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 			
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_q12 << str << endl;
+				_fichier_q12.Entete() << str << endl;
 			}
 		}
 
 		if (output.SauvegardeQ23())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_q23 = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_q23 = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "q23.nc"), true, "q23", "mm", "Ecoulement vertical de la couche 2 a 3");
 			else
 			{
 				string nom_fichier( Combine(_sim_hyd.PrendreRepertoireResultat(), "q23.csv") );
-				_fichier_q23.open(nom_fichier);
-				_fichier_q23 << "coulement vertical de la couche 2  3 (mm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+				_fichier_q23.Ouvre(output, nom_fichier, true, output._nbDigit_mm);
+				_fichier_q23.Entete() << "coulement vertical de la couche 2  3 (mm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 			
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 			
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_q23 << str << endl;
+				_fichier_q23.Entete() << str << endl;
 			}
 		}
 
 		if (output._qRecharge)
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_qRecharge = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_qRecharge = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "qrecharge.nc"), true, "qrecharge", "mm", "Recharge sous-terrain");
 			else
 			{
 				string nom_fichier( Combine(_sim_hyd.PrendreRepertoireResultat(), "qRecharge.csv") );
-				_fichier_qRecharge.open(nom_fichier);
-				_fichier_qRecharge << "Recharge sous-terrain (mm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+				_fichier_qRecharge.Ouvre(output, nom_fichier, true, output._nbDigit_mm);
+				_fichier_qRecharge.Entete() << "Recharge sous-terrain (mm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_qRecharge << str << endl;
+				_fichier_qRecharge.Entete() << str << endl;
 			}
 		}
 
@@ -907,6 +916,7 @@ namespace HYDROTEL
 
 		OCCUPATION_SOL& occupation_sol = _sim_hyd.PrendreOccupationSol();
 		ZONES& zones = _sim_hyd.PrendreZones();
+		ETAT_ZONES& etat_zones = zones.PrendreEtat();
 
 		size_t szindex;
 		int iCurrentYear, iCurrentMonth, iCurrentDay, iCurrentHour, index;
@@ -960,22 +970,22 @@ namespace HYDROTEL
 						float saturationCouche2 = typeSolCouche2.PrendreThetas();
 						float saturationCouche3 = typeSolCouche3.PrendreThetas();
 
-						zones[index_zone]._theta3 = (correction->PrendreCoefficientMultiplicatif() * 
-							(zones[index_zone].PrendreZ11() * zones[index_zone]._theta1 + zones[index_zone].PrendreZ22() * zones[index_zone]._theta2 + zones[index_zone].PrendreZ33() * zones[index_zone]._theta3) - 
-							(zones[index_zone].PrendreZ11() * zones[index_zone]._theta1 + zones[index_zone].PrendreZ22() * zones[index_zone]._theta2)) / zones[index_zone].PrendreZ33();
+						etat_zones._theta3[index_zone] = (correction->PrendreCoefficientMultiplicatif() * 
+							(zones[index_zone].PrendreZ11() * etat_zones._theta1[index_zone] + zones[index_zone].PrendreZ22() * etat_zones._theta2[index_zone] + zones[index_zone].PrendreZ33() * etat_zones._theta3[index_zone]) - 
+							(zones[index_zone].PrendreZ11() * etat_zones._theta1[index_zone] + zones[index_zone].PrendreZ22() * etat_zones._theta2[index_zone])) / zones[index_zone].PrendreZ33();
 
-						if (zones[index_zone]._theta3 > saturationCouche3)
+						if (etat_zones._theta3[index_zone] > saturationCouche3)
 						{
-							zones[index_zone]._theta2 += (zones[index_zone]._theta3 - saturationCouche3) * zones[index_zone].PrendreZ33() / zones[index_zone].PrendreZ22();
-							zones[index_zone]._theta3 = saturationCouche3;
+							etat_zones._theta2[index_zone] += (etat_zones._theta3[index_zone] - saturationCouche3) * zones[index_zone].PrendreZ33() / zones[index_zone].PrendreZ22();
+							etat_zones._theta3[index_zone] = saturationCouche3;
 						
-							if (zones[index_zone]._theta2 > saturationCouche2)
+							if (etat_zones._theta2[index_zone] > saturationCouche2)
 							{
-								zones[index_zone]._theta1 += (zones[index_zone]._theta2 - saturationCouche2) * zones[index_zone].PrendreZ22() / zones[index_zone].PrendreZ11();
-								zones[index_zone]._theta2 = saturationCouche2;
+								etat_zones._theta1[index_zone] += (etat_zones._theta2[index_zone] - saturationCouche2) * zones[index_zone].PrendreZ22() / zones[index_zone].PrendreZ11();
+								etat_zones._theta2[index_zone] = saturationCouche2;
 							
-								if (zones[index_zone]._theta1 > saturationCouche1)
-									zones[index_zone]._theta1 = saturationCouche1;
+								if (etat_zones._theta1[index_zone] > saturationCouche1)
+									etat_zones._theta1[index_zone] = saturationCouche1;
 							}
 						}
 					}
@@ -1024,9 +1034,9 @@ namespace HYDROTEL
 						float saturationCouche2 = typeSolCouche2.PrendreThetas();
 						float saturationCouche3 = typeSolCouche3.PrendreThetas();
 
-						zones[index_zone]._theta1 = correction->PrendreCoeffSaturationCouche1() * saturationCouche1;
-						zones[index_zone]._theta2 = correction->PrendreCoeffSaturationCouche2() * saturationCouche2;
-						zones[index_zone]._theta3 = correction->PrendreCoeffSaturationCouche3() * saturationCouche3;
+						etat_zones._theta1[index_zone] = correction->PrendreCoeffSaturationCouche1() * saturationCouche1;
+						etat_zones._theta2[index_zone] = correction->PrendreCoeffSaturationCouche2() * saturationCouche2;
+						etat_zones._theta3[index_zone] = correction->PrendreCoeffSaturationCouche3() * saturationCouche3;
 					}
 				}
 			}
@@ -1034,21 +1044,10 @@ namespace HYDROTEL
 
 		//calcule
 
-		int iIndexZone;
+		//chaque uhrh est independante; le resultat est identique peu importe le nombre de thread
+		#pragma omp parallel for num_threads(_sim_hyd.PrendreNbThread()) schedule(dynamic, 64)
 		for (index = 0; index < nb_zone_simule; ++index)
-		{
-			iIndexZone = static_cast<int>(index_zones[index]);
-
-			//if(date_courante.PrendreAnnee() == 2011 && date_courante.PrendreMois() == 4 && date_courante.PrendreJour() == 17 && iIndexZone == 4)
-			//	iIndexZone=iIndexZone;
-
-			//_idxIter = 0;
-			
-			CalculeUHRH(iIndexZone);
-			
-			//if(_idxIter > _idxIterMax)
-			//	_idxIterMax = _idxIter;
-		}
+			CalculeUHRH(static_cast<int>(index_zones[index]));
 
 		//sauvegarde des variables intermediaires
 
@@ -1088,38 +1087,25 @@ namespace HYDROTEL
 
 		//
 
-		size_t i, idx;
+		size_t i;
+		float* pLigne;
 		string str;
 
 		if(output.SauvegardeTheta1())
 		{
 			if (_netCdf_theta1 != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_theta1->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_theta1[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]]._theta1;
+					pLigne[i] = etat_zones._theta1[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]];
 			}
 			else
 			{
-				oss.str("");			
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(output._nbDigit_ratio) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_theta1.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for (szindex = 0; szindex < zones.PrendreNbZone(); ++szindex)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), szindex) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[szindex].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[szindex]._theta1 << output.Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_theta1 << str << endl;
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					pValeur[n] = etat_zones._theta1[output._uhrhOutputIndex[n]];
 			}
 		}
 
@@ -1127,31 +1113,17 @@ namespace HYDROTEL
 		{
 			if (_netCdf_theta2 != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_theta2->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_theta2[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]]._theta2;
+					pLigne[i] = etat_zones._theta2[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]];
 			}
 			else
 			{
-				oss.str("");			
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(output._nbDigit_ratio) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_theta2.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for (szindex = 0; szindex < zones.PrendreNbZone(); ++szindex)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), szindex) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[szindex].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[szindex]._theta2 << output.Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_theta2 << str << endl;
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					pValeur[n] = etat_zones._theta2[output._uhrhOutputIndex[n]];
 			}
 		}
 
@@ -1159,31 +1131,17 @@ namespace HYDROTEL
 		{
 			if (_netCdf_theta3 != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_theta3->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_theta3[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]]._theta3;
+					pLigne[i] = etat_zones._theta3[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]];
 			}
 			else
 			{
-				oss.str("");			
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(output._nbDigit_ratio) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_theta3.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for (szindex = 0; szindex < zones.PrendreNbZone(); ++szindex)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), szindex) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[szindex].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[szindex]._theta3 << output.Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_theta3 << str << endl;
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					pValeur[n] = etat_zones._theta3[output._uhrhOutputIndex[n]];
 			}
 		}
 
@@ -1191,31 +1149,17 @@ namespace HYDROTEL
 		{
 			if (_netCdf_etr1 != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_etr1->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_etr1[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreEtr1();
+					pLigne[i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreEtr1();
 			}
 			else
 			{
-				oss.str("");			
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(output._nbDigit_mm) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_etr1.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for (szindex = 0; szindex < zones.PrendreNbZone(); ++szindex)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), szindex) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[szindex].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[szindex].PrendreEtr1() << output.Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_etr1 << str << endl;
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					pValeur[n] = zones[output._uhrhOutputIndex[n]].PrendreEtr1();
 			}
 		}
 
@@ -1223,31 +1167,17 @@ namespace HYDROTEL
 		{
 			if (_netCdf_etr2 != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_etr2->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_etr2[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreEtr2();
+					pLigne[i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreEtr2();
 			}
 			else
 			{
-				oss.str("");			
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(output._nbDigit_mm) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_etr2.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for (szindex = 0; szindex < zones.PrendreNbZone(); ++szindex)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), szindex) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[szindex].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[szindex].PrendreEtr2() << output.Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_etr2 << str << endl;
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					pValeur[n] = zones[output._uhrhOutputIndex[n]].PrendreEtr2();
 			}
 		}
 
@@ -1255,31 +1185,17 @@ namespace HYDROTEL
 		{
 			if (_netCdf_etr3 != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_etr3->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_etr3[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreEtr3();
+					pLigne[i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreEtr3();
 			}
 			else
 			{
-				oss.str("");			
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(output._nbDigit_mm) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_etr3.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for (szindex = 0; szindex < zones.PrendreNbZone(); ++szindex)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), szindex) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[szindex].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[szindex].PrendreEtr3() << output.Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_etr3 << str << endl;
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					pValeur[n] = zones[output._uhrhOutputIndex[n]].PrendreEtr3();
 			}
 		}
 
@@ -1287,31 +1203,17 @@ namespace HYDROTEL
 		{
 			if (_netCdf_etr_total != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_etr_total->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_etr_total[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreEtrTotal();
+					pLigne[i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreEtrTotal();
 			}
 			else
 			{
-				oss.str("");			
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(output._nbDigit_mm) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_etr_total.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for (szindex = 0; szindex < zones.PrendreNbZone(); ++szindex)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), szindex) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[szindex].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[szindex].PrendreEtrTotal() << output.Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_etr_total << str << endl;
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					pValeur[n] = zones[output._uhrhOutputIndex[n]].PrendreEtrTotal();
 			}
 		}
 
@@ -1319,31 +1221,21 @@ namespace HYDROTEL
 		{
 			if (_netCdf_q12 != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_q12->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_q12[idx+i] = _q12[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]] * 1000.0f;	//m -> mm
+					pLigne[i] = _q12[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]] * 1000.0f;	//m -> mm
 			}
 			else
 			{
-				oss.str("");			
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(output._nbDigit_mm) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_q12.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for (szindex = 0; szindex < zones.PrendreNbZone(); ++szindex)
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
 				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), szindex) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[szindex].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << _q12[szindex] * 1000.0f << output.Separator();	//m -> mm
-						}
-					}
+					szindex = output._uhrhOutputIndex[n];
+
+					pValeur[n] = _q12[szindex] * 1000.0f;	//m -> mm
 				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_q12 << str << endl;
 			}
 		}
 
@@ -1351,31 +1243,21 @@ namespace HYDROTEL
 		{
 			if (_netCdf_q23 != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_q23->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_q23[idx+i] = _q23[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]] * 1000.0f;	//m -> mm
+					pLigne[i] = _q23[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]] * 1000.0f;	//m -> mm
 			}
 			else
 			{
-				oss.str("");			
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(output._nbDigit_mm) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_q23.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for (szindex = 0; szindex < zones.PrendreNbZone(); ++szindex)
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
 				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), szindex) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[szindex].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << _q23[szindex] * 1000.0f << output.Separator();	//m -> mm
-						}
-					}
+					szindex = output._uhrhOutputIndex[n];
+
+					pValeur[n] = _q23[szindex] * 1000.0f;	//m -> mm
 				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_q23 << str << endl;
 			}
 		}
 
@@ -1383,31 +1265,21 @@ namespace HYDROTEL
 		{
 			if (_netCdf_qRecharge != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_qRecharge->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_qRecharge[idx+i] = _qRecharge[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]] * 1000.0f;	//m -> mm
+					pLigne[i] = _qRecharge[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]] * 1000.0f;	//m -> mm
 			}
 			else
 			{
-				oss.str("");
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(output._nbDigit_mm) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_qRecharge.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for (szindex = 0; szindex < zones.PrendreNbZone(); ++szindex)
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
 				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), szindex) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[szindex].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << _qRecharge[szindex] * 1000.0f << output.Separator();	//m -> mm
-						}
-					}
-				}
+					szindex = output._uhrhOutputIndex[n];
 
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_qRecharge << str << endl;
+					pValeur[n] = _qRecharge[szindex] * 1000.0f;	//m -> mm
+				}
 			}
 		}
 
@@ -1531,7 +1403,7 @@ namespace HYDROTEL
 
 	void BV3C2::Termine()
 	{
-		string str1, str2;
+		string str;
 
 		for (auto iter = _milieu_humide_result.begin(); iter != _milieu_humide_result.end(); iter++)
 			delete iter->second;
@@ -1542,170 +1414,150 @@ namespace HYDROTEL
 		{
 			if (_netCdf_theta1 != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "bilanvertical-bv3c-theta1.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "theta1.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "bilanvertical-bv3c-theta1", _netCdf_theta1, "[0-1]", "Teneur en eau de la couche 1");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "theta1", _netCdf_theta1, "[0-1]", "Teneur en eau de la couche 1");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_theta1->Ferme();
+				delete _netCdf_theta1;
+				_netCdf_theta1 = NULL;
 
-				delete [] _netCdf_theta1;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_theta1.close();
+				_fichier_theta1.Ferme();
 		}
 
 		if (output.SauvegardeTheta2())
 		{
 			if (_netCdf_theta2 != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "bilanvertical-bv3c-theta2.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "theta2.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "bilanvertical-bv3c-theta2", _netCdf_theta2, "[0-1]", "Teneur en eau de la couche 2");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "theta2", _netCdf_theta2, "[0-1]", "Teneur en eau de la couche 2");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_theta2->Ferme();
+				delete _netCdf_theta2;
+				_netCdf_theta2 = NULL;
 
-				delete [] _netCdf_theta2;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_theta2.close();
+				_fichier_theta2.Ferme();
 		}
 
 		if (output.SauvegardeTheta3())
 		{
 			if (_netCdf_theta3 != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "bilanvertical-bv3c-theta3.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "theta3.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "bilanvertical-bv3c-theta3", _netCdf_theta3, "[0-1]", "Teneur en eau de la couche 3");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "theta3", _netCdf_theta3, "[0-1]", "Teneur en eau de la couche 3");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_theta3->Ferme();
+				delete _netCdf_theta3;
+				_netCdf_theta3 = NULL;
 
-				delete [] _netCdf_theta3;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_theta3.close();
+				_fichier_theta3.Ferme();
 		}
 
 		if (output.SauvegardeEtr1())
 		{
 			if (_netCdf_etr1 != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "bilanvertical-bv3c-etr1.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "etr1.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "bilanvertical-bv3c-etr1", _netCdf_etr1, "mm", "Evapotranspiration reelle de la couche 1");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "etr1", _netCdf_etr1, "mm", "Evapotranspiration reelle de la couche 1");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_etr1->Ferme();
+				delete _netCdf_etr1;
+				_netCdf_etr1 = NULL;
 
-				delete [] _netCdf_etr1;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_etr1.close();
+				_fichier_etr1.Ferme();
 		}
 
 		if (output.SauvegardeEtr2())
 		{
 			if (_netCdf_etr2 != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "bilanvertical-bv3c-etr2.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "etr2.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "bilanvertical-bv3c-etr2", _netCdf_etr2, "mm", "Evapotranspiration reelle de la couche 2");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "etr2", _netCdf_etr2, "mm", "Evapotranspiration reelle de la couche 2");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_etr2->Ferme();
+				delete _netCdf_etr2;
+				_netCdf_etr2 = NULL;
 
-				delete [] _netCdf_etr2;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_etr2.close();
+				_fichier_etr2.Ferme();
 		}
 
 		if (output.SauvegardeEtr3())
 		{
 			if (_netCdf_etr3 != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "bilanvertical-bv3c-etr3.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "etr3.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "bilanvertical-bv3c-etr3", _netCdf_etr3, "mm", "Evapotranspiration reelle de la couche 3");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "etr3", _netCdf_etr3, "mm", "Evapotranspiration reelle de la couche 3");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_etr3->Ferme();
+				delete _netCdf_etr3;
+				_netCdf_etr3 = NULL;
 
-				delete [] _netCdf_etr3;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_etr3.close();
+				_fichier_etr3.Ferme();
 		}
 
 		if (output.SauvegardeEtrTotal())
 		{
 			if (_netCdf_etr_total != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "bilanvertical-bv3c-etr_total.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "etr_total.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "bilanvertical-bv3c-etr_total", _netCdf_etr_total, "mm", "Evapotranspiration reelle totale");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "etr_total", _netCdf_etr_total, "mm", "Evapotranspiration reelle totale");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_etr_total->Ferme();
+				delete _netCdf_etr_total;
+				_netCdf_etr_total = NULL;
 
-				delete [] _netCdf_etr_total;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_etr_total.close();
+				_fichier_etr_total.Ferme();
 		}
 
 		if (output.SauvegardeQ12())
 		{
 			if (_netCdf_q12 != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "bilanvertical-bv3c-q12.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "q12.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "bilanvertical-bv3c-q12", _netCdf_q12, "mm/pdt", "Ecoulement vertical de la couche 1 a 2");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "q12", _netCdf_q12, "mm", "Ecoulement vertical de la couche 1 a 2");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_q12->Ferme();
+				delete _netCdf_q12;
+				_netCdf_q12 = NULL;
 
-				delete [] _netCdf_q12;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_q12.close();
+				_fichier_q12.Ferme();
 		}
 
 		if (output.SauvegardeQ23())
 		{
 			if (_netCdf_q23 != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "bilanvertical-bv3c-q23.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "q23.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "bilanvertical-bv3c-q23", _netCdf_q23, "mm/pdt", "Ecoulement vertical de la couche 2 a 3");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "q23", _netCdf_q23, "mm", "Ecoulement vertical de la couche 2 a 3");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_q23->Ferme();
+				delete _netCdf_q23;
+				_netCdf_q23 = NULL;
 
-				delete [] _netCdf_q23;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_q23.close();
+				_fichier_q23.Ferme();
 		}
 
 		if (output._qRecharge)
 		{
 			if (_netCdf_qRecharge != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "bilanvertical-bv3c-qrecharge.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "qrecharge.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "bilanvertical-bv3c-qrecharge", _netCdf_qrecharge, "mm/pdt", "Recharge sous-terrain");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "qrecharge", _netCdf_qRecharge, "mm", "Recharge sous-terrain");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_qRecharge->Ferme();
+				delete _netCdf_qRecharge;
+				_netCdf_qRecharge = NULL;
 
-				delete [] _netCdf_qRecharge;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_qRecharge.close();
+				_fichier_qRecharge.Ferme();
 		}
 
 		if(output._q23SumYearly)
@@ -1722,17 +1574,8 @@ namespace HYDROTEL
 				ofs << "q23 somme annuelle (mm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "annee\\uhrh" << output.Separator();
 
 				oss.str("");			
-				for(index=0; index!=_sim_hyd.PrendreZones().PrendreNbZone(); index++)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), _sim_hyd.PrendreZones()[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << _sim_hyd.PrendreZones()[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}			
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << _sim_hyd.PrendreZones()[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 				str = oss.str();
 				if(str.length() != 0)
 					str = str.substr(0, str.length()-1); //enleve le dernier separateur
@@ -1743,16 +1586,11 @@ namespace HYDROTEL
 					oss.str("");			
 					oss << _iQ23SumYearStart+x << output.Separator() << setprecision(output._nbDigit_mm) << setiosflags(ios::fixed);
 
-					for(index=0; index!=_sim_hyd.PrendreZones().PrendreNbZone(); index++)
+					for (size_t n = 0; n < output._uhrhOutputNb; ++n)
 					{
-						if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-						{
-							if (output._bSauvegardeTous || 
-								find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), _sim_hyd.PrendreZones()[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-							{
-								oss << _q23_sum[index][x] * 1000.0f << output.Separator();	//m -> mm
-							}
-						}
+						index = output._uhrhOutputIndex[n];
+
+						oss << _q23_sum[index][x] * 1000.0f << output.Separator();	//m -> mm
 					}
 			
 					str = oss.str();
@@ -1840,6 +1678,8 @@ namespace HYDROTEL
 
 	void BV3C2::TriCoucheOct97(ZONE& zone, size_t index_zone, float pinf, float& ruis, float& q2, float& q3, float& dtc)
 	{
+		ETAT_ZONES& etat_zones = _sim_hyd.PrendreZones().PrendreEtat();
+
 		int pas_de_temps = _sim_hyd.PrendrePasDeTemps();
 		float fpas_de_temps = static_cast<float>(pas_de_temps);
 
@@ -1861,13 +1701,13 @@ namespace HYDROTEL
 		size_t tsol2 = typesol.PrendreIndexCouche2(index_zone);
 		size_t tsol3 = typesol.PrendreIndexCouche3(index_zone);
 
-		float k1 = ConductiviteHydrolique(zone._theta1, typeSolCouche1, tsol1);
-		float k2 = ConductiviteHydrolique(zone._theta2, typeSolCouche2, tsol2);
-		float k3 = ConductiviteHydrolique(zone._theta3, typeSolCouche3, tsol3);
+		float k1 = ConductiviteHydrolique(etat_zones._theta1[index_zone], typeSolCouche1, tsol1);
+		float k2 = ConductiviteHydrolique(etat_zones._theta2[index_zone], typeSolCouche2, tsol2);
+		float k3 = ConductiviteHydrolique(etat_zones._theta3[index_zone], typeSolCouche3, tsol3);
 
-		float psi1 = CalculePsi(zone._theta1, typeSolCouche1, tsol1);
-		float psi2 = CalculePsi(zone._theta2, typeSolCouche2, tsol2);
-		float psi3 = CalculePsi(zone._theta3, typeSolCouche3, tsol3);
+		float psi1 = CalculePsi(etat_zones._theta1[index_zone], typeSolCouche1, tsol1);
+		float psi2 = CalculePsi(etat_zones._theta2[index_zone], typeSolCouche2, tsol2);
+		float psi3 = CalculePsi(etat_zones._theta3[index_zone], typeSolCouche3, tsol3);
 
 		float k12 = max(k1, k2);
 		float k23 = max(k2, k3);
@@ -1879,7 +1719,7 @@ namespace HYDROTEL
 		qq12 = k12* (2.0f * (psi2 - psi1) / (z11 + z22) + 1.0f);		// m/h  (*m2 2D horizontal)
 		qq23 = k23* (2.0f * (psi3 - psi2) / (z22 + z33) + 1.0f);		// m/h  (*m2 2D horizontal)
 		q2 = k2 * sin(atan(pte)) * z22;									// m2/h (*m  1D horizontal)
-		q3 = krec * z33 * zone._theta3;									// m2/h (*m  1D horizontal)
+		q3 = krec * z33 * etat_zones._theta3[index_zone];									// m2/h (*m  1D horizontal)
 
 		// si le modele de temperature du sol a ete simule, on met a jour selon la profondeur du gel simule		
 		fProfondeur = zone.PrendreProfondeurGel();
@@ -1908,7 +1748,7 @@ namespace HYDROTEL
 					if(fTempo >= 0.5f)
 						fTempo = 0.5f;
 
-					q3 = fTempo * krec * z33 * zone._theta3;														// m2/h (*m  1D horizontal)
+					q3 = fTempo * krec * z33 * etat_zones._theta3[index_zone];														// m2/h (*m  1D horizontal)
 				}
 			}
 		}		
@@ -1933,9 +1773,9 @@ namespace HYDROTEL
 		float q23z = qq23 / z22;
 		float q2s = q2 / z22;
 
-		float theta1 = zone._theta1;
-		float theta2 = zone._theta2;
-		float theta3 = zone._theta3;
+		float theta1 = etat_zones._theta1[index_zone];
+		float theta2 = etat_zones._theta2[index_zone];
+		float theta3 = etat_zones._theta3[index_zone];
 
 		// determination du pas de temps interne a BV3C
 		float fCin = _cin[index_zone];
@@ -2157,9 +1997,9 @@ namespace HYDROTEL
 			}
 		}
 
-		zone._theta1 = theta1;
-		zone._theta2 = theta2;
-		zone._theta3 = theta3;
+		etat_zones._theta1[index_zone] = theta1;
+		etat_zones._theta2[index_zone] = theta2;
+		etat_zones._theta3[index_zone] = theta3;
 
 		// il faut conserver la somme des lames transitees sur le pas de temps externe
 		float q12 = _q12[index_zone];
@@ -2174,6 +2014,8 @@ namespace HYDROTEL
 
 	void BV3C2::CalculeRuisselement(ZONE& zone, size_t index_zone, float& pinf, float& ruis)
 	{
+		ETAT_ZONES& etat_zones = _sim_hyd.PrendreZones().PrendreEtat();
+
 		float apport = zone.PrendreApport() + static_cast<float>(zone.PrendreApportGlacier());
 
 		if (apport > 0.0f)
@@ -2190,7 +2032,7 @@ namespace HYDROTEL
 				pinf = 0.0f;
 			else
 			{
-				if (zone._theta1 == typesol.PrendreThetas())
+				if (etat_zones._theta1[index_zone] == typesol.PrendreThetas())
 					pinf = 0.0f;
 				else if (prec > ks) 
 					pinf = ks;
@@ -2208,6 +2050,27 @@ namespace HYDROTEL
 	}
 
 
+	void BV3C2::CalculeFacteurExtinction(int annee, int jour_julien)
+	{
+		OCCUPATION_SOL& occupation_sol = _sim_hyd.PrendreOccupationSol();
+		vector<size_t>& index_zones = _sim_hyd.PrendreZonesSimules();
+
+		const size_t nb_classe = _index_autres.size();
+
+		_facteur_extinction.resize(index_zones.size() * nb_classe);
+
+		for (size_t index = 0; index < index_zones.size(); ++index)
+		{
+			float des = _des[index_zones[index]];
+
+			for (size_t n = 0; n < nb_classe; ++n)
+				_facteur_extinction[index * nb_classe + n] = exp(-des * occupation_sol.PrendreIndiceFoliaire(_index_autres[n], jour_julien));
+		}
+
+		_annee_facteur_extinction = annee;
+		_jour_facteur_extinction = jour_julien;
+	}
+
 	void BV3C2::CalculeEtr()
 	{
 		PROPRIETE_HYDROLIQUES& propriete_hydroliques = _sim_hyd.PrendreProprieteHydrotliques();
@@ -2215,13 +2078,15 @@ namespace HYDROTEL
 		vector<size_t> index_zones = _sim_hyd.PrendreZonesSimules();
 		DATE_HEURE date_courante = _sim_hyd.PrendreDateCourante();
 		ZONES& zones = _sim_hyd.PrendreZones();
+		ETAT_ZONES& etat_zones = zones.PrendreEtat();
 
 		PROPRIETE_HYDROLIQUE pHydro;
 		ZONE* pZone;
 		vector<size_t>::iterator iter;
 		size_t index, nbZone, index_zone;
 		float etrTotal, etpTotal, fractionAutres, etr1, etr2, etr3, etp;
-		float z, indice_foliaire, evapo, ftheta, kas, esnu, dz1, dz2, dz3, z1, z2, z3;
+		const float* facteur_extinction;
+		float z, evapo, ftheta, kas, esnu, dz1, dz2, dz3, z1, z2, z3;
 		float theta, kat, tp;
 		bool bPeriodeIrrigation;
 		int iJourCourant;
@@ -2236,6 +2101,9 @@ namespace HYDROTEL
 		iJourCourant = date_courante.PrendreJourJulien();
 		nbZone = index_zones.size();
 
+		if(date_courante.PrendreAnnee() != _annee_facteur_extinction || iJourCourant != _jour_facteur_extinction)
+			CalculeFacteurExtinction(date_courante.PrendreAnnee(), iJourCourant);
+
 		for(index=0; index!=nbZone; index++)
 		{
 			index_zone = index_zones[index];
@@ -2248,6 +2116,8 @@ namespace HYDROTEL
 
 			pHydro = propriete_hydroliques.PrendreProprieteHydroliqueCouche1(index_zone);
 
+			facteur_extinction = _facteur_extinction.data() + index * _index_autres.size();
+
 			for(iter=begin(_index_autres); iter!=end(_index_autres); iter++)
 			{
 				etp = pZone->PrendreEtp(*iter) / 1000.0f;	//mm -> m
@@ -2255,14 +2125,13 @@ namespace HYDROTEL
 				if(etp > 0.0f)
 				{
 					z = occupation_sol.PrendreProfondeurRacinaire(*iter, iJourCourant);
-					indice_foliaire = occupation_sol.PrendreIndiceFoliaire(*iter, iJourCourant);
 
-					evapo = etp * exp(-_des[index_zone] * indice_foliaire);
+					evapo = etp * facteur_extinction[iter - begin(_index_autres)];
 
 					if(pHydro.PrendreThetacc() <= 0.0f || pHydro.PrendreThetapf() <= 0.0f)
 						throw ERREUR_LECTURE_FICHIER("PARAMETRES PROPRIETES HYDRAULIQUE INVALIDE");
 
-					ftheta = min( max(zones[index_zone]._theta1 - pHydro.PrendreThetapf(), 0.0f) / (pHydro.PrendreThetacc() - pHydro.PrendreThetapf()), 1.0f );
+					ftheta = min( max(etat_zones._theta1[index_zone] - pHydro.PrendreThetapf(), 0.0f) / (pHydro.PrendreThetacc() - pHydro.PrendreThetapf()), 1.0f );
 					kas = (1.0f - exp(-pHydro.PrendreAlpha() * ftheta)) / (1.0f - 2.0f * exp(-pHydro.PrendreAlpha()) + exp(-pHydro.PrendreAlpha() * ftheta));					
 					
 					esnu = (_coef_assech[index_zone] * kas) * evapo;					
@@ -2305,7 +2174,7 @@ namespace HYDROTEL
 
 					if(z > 0.0f)
 					{
-						theta = (zones[index_zone]._theta1 * dz1 + zones[index_zone]._theta2 * dz2 + zones[index_zone]._theta3 * dz3) / z;
+						theta = (etat_zones._theta1[index_zone] * dz1 + etat_zones._theta2[index_zone] * dz2 + etat_zones._theta3[index_zone] * dz3) / z;
 						ftheta = min( max(theta - pHydro.PrendreThetapf(), 0.0f) / (pHydro.PrendreThetacc() - pHydro.PrendreThetapf()), 1.0f );
 
 						kat = (1.0f - exp(-pHydro.PrendreAlpha() * ftheta)) / (1.0f - 2.0f * exp(-pHydro.PrendreAlpha()) + exp(-pHydro.PrendreAlpha() * ftheta));
@@ -2314,9 +2183,9 @@ namespace HYDROTEL
 						//repartition de l'etr entre les couches
 						if(theta * z != 0.0f)
 						{
-							etr1+= tp * (zones[index_zone]._theta1 * dz1) / (theta * z);
-							etr2+= tp * (zones[index_zone]._theta2 * dz2) / (theta * z);
-							etr3+= tp * (zones[index_zone]._theta3 * dz3) / (theta * z);
+							etr1+= tp * (etat_zones._theta1[index_zone] * dz1) / (theta * z);
+							etr2+= tp * (etat_zones._theta2[index_zone] * dz2) / (theta * z);
+							etr3+= tp * (etat_zones._theta3[index_zone] * dz3) / (theta * z);
 						}
 					}
 				}
@@ -2526,8 +2395,8 @@ namespace HYDROTEL
 			throw ERREUR("Error reading BV3C parameters: " + PrendreNomFichierParametres());
 		}
 
-		//lecture des parametres pour les milieux humides isoles
-		if(_sim_hyd._bSimuleMHIsole)
+		//lecture des parametres pour les milieux humides isoles; lus une seule fois (fichier distinct, non modifie par la calibration)
+		if(_sim_hyd._bSimuleMHIsole && _milieu_humide_isole.empty())
 			LectureMilieuHumideIsole();
 	}
 
@@ -2650,8 +2519,8 @@ namespace HYDROTEL
 		if(!bOK)
 			throw ERREUR_LECTURE_FICHIER( "FICHIER PARAMETRES GLOBAL; BV3C; " + _sim_hyd._nomFichierParametresGlobal, 0, "Parametres sous-modele BV3C");
 
-		//lecture des parametres pour les milieux humides isoles
-		if(_sim_hyd._bSimuleMHIsole)
+		//lecture des parametres pour les milieux humides isoles; lus une seule fois (fichier distinct, non modifie par la calibration)
+		if(_sim_hyd._bSimuleMHIsole && _milieu_humide_isole.empty())
 			LectureMilieuHumideIsole();
 	}
 
@@ -2882,4 +2751,51 @@ namespace HYDROTEL
 		return _date_sauvegarde_etat;
 	}
 
+
+	void BV3C2::SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const
+	{
+		etat.Ecrit(_q12);
+		etat.Ecrit(_q23);
+		etat.Ecrit(_qRecharge);
+
+		etat.Ecrit(_q23_sum);
+		etat.Ecrit(_iQ23SumYearCurrent);
+
+		//milieux humides isoles
+		etat.Ecrit(_milieu_humide_isole.size());
+
+		for(size_t index_zone=0; index_zone<_milieu_humide_isole.size(); index_zone++)
+		{
+			if(_milieu_humide_isole[index_zone])
+				etat.Ecrit(_milieu_humide_isole[index_zone]->GetWetvol());
+		}
+	}
+
+	void BV3C2::LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur)
+	{
+		lecteur.Lit(_q12);
+		lecteur.Lit(_q23);
+		lecteur.Lit(_qRecharge);
+
+		lecteur.Lit(_q23_sum);
+		lecteur.Lit(_iQ23SumYearCurrent);
+
+		//milieux humides isoles
+		size_t nb;
+		float wetvol;
+
+		lecteur.Lit(nb);
+		if(nb != _milieu_humide_isole.size())
+			throw ERREUR("In-memory state: BV3C2: isolated wetlands do not match the simulation.");
+
+		for(size_t index_zone=0; index_zone<_milieu_humide_isole.size(); index_zone++)
+		{
+			if(_milieu_humide_isole[index_zone])
+			{
+				lecteur.Lit(wetvol);
+				_milieu_humide_isole[index_zone]->SetWetvol(wetvol);
+			}
+		}
+	}
+
 }
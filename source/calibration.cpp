@@ -0,0 +1,508 @@
+//
+// HYDROTEL a spatially distributed hydrological model
+// Copyright (C) 2013 INRS Eau Terre Environnement
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+// USA
+//
+
+#include "calibration.hpp"
+
+#include "constantes.hpp"
+#include "erreur.hpp"
+#include "sous_modele.hpp"
+#include "statistiques.hpp"
+#include "util.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+
+#include <boost/algorithm/string/case_conv.hpp>
+
+
+using namespace std;
+
+
+namespace HYDROTEL
+{
+
+	CALIBRATION::CALIBRATION(SIM_HYD& sim_hyd, const string& nom_fichier)
+		: _sim_hyd(sim_hyd)
+		, _nom_fichier(nom_fichier)
+	{
+		_algorithme = "DDS";
+		_nb_evaluation = 100;
+		_germe = 1;
+		_perturbation = 0.2;
+		_fonction_objectif = "NASH";
+		_signe = 1.0;
+	}
+
+	CALIBRATION::~CALIBRATION()
+	{
+	}
+
+
+	//format du fichier (cle;valeur), suivi de la liste des parametres calibres:
+	//	ALGORITHME;DDS
+	//	NB EVALUATIONS;500
+	//	GERME;1
+	//	PERTURBATION;0.2
+	//	FONCTION OBJECTIF;NASH		(NASH, KGE 2009, KGE 2012, NASH-LOG, NASH-M, RCEQM, BIAIS ABSOLUE)
+	//	TRONCONS;1;5				(optionnel; defaut: tous les troncons de stats.txt)
+	//	SOUS MODELE;PARAMETRE;MIN;MAX
+	//	BV3C1;COEFFICIENT DE RECESSION;0.0000001;0.00001
+	void CALIBRATION::Lecture()
+	{
+		vector<string> valeurs;
+		string nom_fichier, ligne, cle;
+		size_t index, no_ligne;
+		bool bParametres;
+
+		nom_fichier = _nom_fichier;
+		if(!Racine(nom_fichier))
+			nom_fichier = Combine(_sim_hyd.PrendreRepertoireSimulation(), nom_fichier);
+
+		if(_sim_hyd._fichierParametreGlobal)
+			throw ERREUR("Calibration: the global parameters file (parametres_sous_modeles.csv) is not supported; use the submodels parameters files.");
+
+		ifstream fichier(nom_fichier);
+		if(!fichier)
+			throw ERREUR_LECTURE_FICHIER(nom_fichier);
+
+		_fichiers.clear();
+		_parametres.clear();
+		_troncons.clear();
+
+		bParametres = false;
+		no_ligne = 0;
+
+		while(!fichier.eof())
+		{
+			getline_mod(fichier, ligne);
+			++no_ligne;
+
+			SplitString2(valeurs, ligne, ";", true);
+			if(valeurs.empty())
+				continue;
+
+			cle = boost::algorithm::to_upper_copy(valeurs[0]);
+
+			if(bParametres)
+			{
+				if(valeurs.size() < 4)
+					throw ERREUR_LECTURE_FICHIER(nom_fichier, static_cast<int>(no_ligne), "expected: submodel;parameter;min;max");
+
+				SOUS_MODELE* sous_modele = _sim_hyd.RechercheSousModele(valeurs[0]);
+				if(sous_modele == nullptr)
+					throw ERREUR_LECTURE_FICHIER(nom_fichier, static_cast<int>(no_ligne), "submodel is not used by the simulation: " + valeurs[0]);
+
+				for(index=0; index<_fichiers.size() && _fichiers[index].sous_modele != sous_modele; index++);
+
+				if(index == _fichiers.size())
+				{
+					FICHIER_PARAMETRES fp;
+
+					fp.sous_modele = sous_modele;
+					fp.nom_fichier_original = sous_modele->PrendreNomFichierParametres();
+					fp.nom_fichier_calibration = Combine(Combine(_sim_hyd.PrendreRepertoireResultat(), "calibration"), PrendreFilename(fp.nom_fichier_original));
+
+					ifstream fichier_parametres(fp.nom_fichier_original);
+					if(!fichier_parametres)
+						throw ERREUR_LECTURE_FICHIER(fp.nom_fichier_original);
+
+					while(!fichier_parametres.eof())
+					{
+						getline_mod(fichier_parametres, ligne);
+						fp.lignes.push_back(ligne);
+					}
+
+					_fichiers.push_back(fp);
+				}
+
+				PARAMETRE parametre;
+
+				parametre.nom = valeurs[1];
+				parametre.min = string_to_double(valeurs[2]);
+				parametre.max = string_to_double(valeurs[3]);
+				parametre.fichier = index;
+
+				if(!(parametre.min < parametre.max))
+					throw ERREUR_LECTURE_FICHIER(nom_fichier, static_cast<int>(no_ligne), "min must be less than max");
+
+				LectureColonne(parametre);
+
+				_parametres.push_back(parametre);
+				continue;
+			}
+
+			if(valeurs.size() < 2 && cle != "SOUS MODELE" && cle != "TRONCONS")
+				throw ERREUR_LECTURE_FICHIER(nom_fichier, static_cast<int>(no_ligne), "missing value");
+
+			if(cle == "ALGORITHME")
+				_algorithme = boost::algorithm::to_upper_copy(valeurs[1]);
+			else if(cle == "NB EVALUATIONS")
+				_nb_evaluation = static_cast<size_t>(max(1, string_to_int(valeurs[1])));
+			else if(cle == "GERME")
+				_germe = static_cast<unsigned int>(string_to_int(valeurs[1]));
+			else if(cle == "PERTURBATION")
+				_perturbation = string_to_double(valeurs[1]);
+			else if(cle == "FONCTION OBJECTIF")
+				_fonction_objectif = boost::algorithm::to_upper_copy(valeurs[1]);
+			else if(cle == "TRONCONS")
+			{
+				for(index=1; index<valeurs.size(); index++)
+					_troncons.push_back(string_to_int(valeurs[index]));
+			}
+			else if(cle == "SOUS MODELE")
+				bParametres = true;
+			else
+				throw ERREUR_LECTURE_FICHIER(nom_fichier, static_cast<int>(no_ligne), "unknown key: " + valeurs[0]);
+		}
+
+		fichier.close();
+
+		if(_algorithme != "DDS")
+			throw ERREUR("Calibration: unsupported algorithm: " + _algorithme + " (supported: DDS).");
+
+		if(_fonction_objectif == "NASH" || _fonction_objectif == "KGE 2009" || _fonction_objectif == "KGE 2012" || 
+			_fonction_objectif == "NASH-LOG" || _fonction_objectif == "NASH-M")
+		{
+			_signe = 1.0;
+		}
+		else if(_fonction_objectif == "RCEQM" || _fonction_objectif == "BIAIS ABSOLUE")
+			_signe = -1.0;
+		else
+			throw ERREUR("Calibration: unsupported objective function: " + _fonction_objectif);
+
+		if(_parametres.empty())
+			throw ERREUR("Calibration: no parameter to calibrate: " + nom_fichier);
+	}
+
+
+	//recherche la colonne du parametre dans le fichier de parametres du sous modele
+	//la valeur est appliquee aux lignes qui suivent l'entete (jusqu'a la premiere ligne vide),
+	//ou a la valeur de la ligne si le parametre est une cle (cle;valeur)
+	void CALIBRATION::LectureColonne(PARAMETRE& parametre)
+	{
+		const FICHIER_PARAMETRES& fp = _fichiers[parametre.fichier];
+		vector<string> valeurs;
+		string nom, str;
+		size_t x, y;
+
+		nom = boost::algorithm::to_upper_copy(parametre.nom);
+
+		for(x=0; x<fp.lignes.size(); x++)
+		{
+			SplitString2(valeurs, fp.lignes[x], ";", false);
+
+			for(y=0; y<valeurs.size(); y++)
+			{
+				str = boost::algorithm::to_upper_copy(valeurs[y]);
+				if(str == nom || TrimString(str.substr(0, str.find('('))) == nom)	//le nom peut etre donne sans l'unite
+					break;
+			}
+
+			if(y != valeurs.size())
+				break;
+		}
+
+		if(x == fp.lignes.size())
+			throw ERREUR("Calibration: parameter not found in file " + fp.nom_fichier_original + ": " + parametre.nom);
+
+		parametre.lignes.clear();
+
+		if(y == 0 && valeurs.size() > 1 && !valeurs[1].empty() && valeurs[1].find_first_not_of("0123456789.-+eE") == string::npos)
+		{
+			//cle;valeur
+			parametre.colonne = 1;
+			parametre.lignes.push_back(x);
+		}
+		else
+		{
+			parametre.colonne = y;
+
+			for(++x; x<fp.lignes.size() && !TrimString(fp.lignes[x]).empty(); x++)
+			{
+				SplitString2(valeurs, fp.lignes[x], ";", false);
+				if(valeurs.size() > parametre.colonne)
+					parametre.lignes.push_back(x);
+			}
+		}
+
+		if(parametre.lignes.empty())
+			throw ERREUR("Calibration: no value for parameter in file " + fp.nom_fichier_original + ": " + parametre.nom);
+
+		//valeur initiale: premiere valeur du fichier, ramenee dans l'intervalle
+		SplitString2(valeurs, fp.lignes[parametre.lignes[0]], ";", false);
+		parametre.valeur_initiale = min(parametre.max, max(parametre.min, string_to_double(valeurs[parametre.colonne])));
+	}
+
+
+	//ecrit une copie modifiee des fichiers de parametres et les relit par les sous modeles
+	void CALIBRATION::AppliqueParametres(const vector<double>& valeurs)
+	{
+		vector<vector<string>> lignes(_fichiers.size());
+		vector<string> colonnes;
+		ostringstream oss;
+		size_t x, y, z;
+
+		for(x=0; x<_fichiers.size(); x++)
+			lignes[x] = _fichiers[x].lignes;
+
+		for(x=0; x<_parametres.size(); x++)
+		{
+			const PARAMETRE& parametre = _parametres[x];
+
+			oss.str("");
+			oss << setprecision(10) << valeurs[x];
+
+			for(y=0; y<parametre.lignes.size(); y++)
+			{
+				string& ligne = lignes[parametre.fichier][parametre.lignes[y]];
+
+				SplitString(colonnes, ligne, ";", false, false);
+				colonnes[parametre.colonne] = oss.str();
+
+				ligne = colonnes[0];
+				for(z=1; z<colonnes.size(); z++)
+					ligne+= ";" + colonnes[z];
+			}
+		}
+
+		for(x=0; x<_fichiers.size(); x++)
+		{
+			const FICHIER_PARAMETRES& fp = _fichiers[x];
+
+			ofstream fichier(fp.nom_fichier_calibration);
+			if(!fichier)
+				throw ERREUR_ECRITURE_FICHIER(fp.nom_fichier_calibration);
+
+			for(y=0; y<lignes[x].size(); y++)
+				fichier << lignes[x][y] << endl;
+
+			fichier.close();
+			if(fichier.fail())
+				throw ERREUR_ECRITURE_FICHIER(fp.nom_fichier_calibration);
+
+			fp.sous_modele->ChangeNomFichierParametres(fp.nom_fichier_calibration);
+			fp.sous_modele->LectureParametres();
+		}
+	}
+
+
+	double CALIBRATION::Evalue(const vector<double>& valeurs, double& objectif)
+	{
+		vector<STATISTIQUES::RESULTAT> resultats;
+		DATE_HEURE date_fin;
+		size_t x, nb;
+		float valeur;
+
+		AppliqueParametres(valeurs);
+
+		//variables derivees des parametres (sans reinitialiser les sous modeles), puis etat initial
+		for(x=0; x<_fichiers.size(); x++)
+			_fichiers[x].sous_modele->InitialiseParametres();
+
+		_sim_hyd.LectureEtatMemoire(_etat_initial);
+
+		date_fin = _sim_hyd.PrendreDateFin();
+
+		do
+		{
+			_sim_hyd.Calcule();
+		}
+		while(_sim_hyd.PrendreDateCourante() < date_fin);
+
+		_sim_hyd.PrendreStatistiques()->CalculeResultats(resultats);
+
+		objectif = 0.0;
+		nb = 0;
+
+		for(x=0; x<resultats.size(); x++)
+		{
+			if(!_troncons.empty() && find(begin(_troncons), end(_troncons), resultats[x].ident) == end(_troncons))
+				continue;
+
+			if(resultats[x].somme_obs == VALEUR_MANQUANTE)
+				continue;	//troncon sans observation
+
+			if(_fonction_objectif == "NASH")
+				valeur = resultats[x].nash;
+			else if(_fonction_objectif == "KGE 2009")
+				valeur = resultats[x].kge_2009;
+			else if(_fonction_objectif == "KGE 2012")
+				valeur = resultats[x].kge_2012;
+			else if(_fonction_objectif == "NASH-LOG")
+				valeur = resultats[x].nash_log;
+			else if(_fonction_objectif == "NASH-M")
+				valeur = resultats[x].nash_mod;
+			else if(_fonction_objectif == "RCEQM")
+				valeur = resultats[x].ecart2;
+			else
+				valeur = resultats[x].biais_absolue;
+
+			if(valeur == VALEUR_MANQUANTE || !isfinite(valeur))
+			{
+				objectif = VALEUR_MANQUANTE;
+				return -numeric_limits<double>::max();
+			}
+
+			objectif+= valeur;
+			++nb;
+		}
+
+		if(nb == 0)
+			throw ERREUR("Calibration: no observed flows for the evaluated reaches (stats.txt).");
+
+		objectif/= nb;
+
+		return _signe * objectif;
+	}
+
+
+	void CALIBRATION::Execute()
+	{
+		vector<double> meilleur, essai;
+		vector<bool> selection(_parametres.size());
+		double critere, meilleur_critere, objectif, meilleur_objectif, probabilite, etendue;
+		size_t i, x, nb_selection;
+		string nom_fichier;
+		ostringstream oss;
+
+		if(_sim_hyd.PrendreStatistiques() == nullptr)
+			throw ERREUR("Calibration: the file stats.txt (reach;hydrometric station) is required in the simulation folder.");
+
+		CreeRepertoire(Combine(_sim_hyd.PrendreRepertoireResultat(), "calibration"));
+
+		//etat initial de la simulation (apres SIM_HYD::Initialise)
+		_sim_hyd.SauvegardeEtatMemoire(_etat_initial);
+
+		nom_fichier = Combine(_sim_hyd.PrendreRepertoireResultat(), "calibration.csv");
+		string sep = _sim_hyd.PrendreOutput().Separator();
+
+		ofstream fichier(nom_fichier);
+		if(!fichier)
+			throw ERREUR_ECRITURE_FICHIER(nom_fichier);
+
+		fichier << "evaluation";
+		for(x=0; x<_parametres.size(); x++)
+			fichier << sep << _fichiers[_parametres[x].fichier].sous_modele->PrendreNomSousModele() << " " << _parametres[x].nom;
+		fichier << sep << _fonction_objectif << sep << "meilleur " << _fonction_objectif << endl;
+
+		mt19937 generateur(_germe);
+		uniform_real_distribution<double> uniforme(0.0, 1.0);
+		normal_distribution<double> normale(0.0, 1.0);
+		uniform_int_distribution<size_t> choix(0, _parametres.size() - 1);
+
+		//solution initiale: valeurs des fichiers de parametres
+		meilleur.resize(_parametres.size());
+		for(x=0; x<_parametres.size(); x++)
+			meilleur[x] = _parametres[x].valeur_initiale;
+
+		meilleur_critere = Evalue(meilleur, meilleur_objectif);
+
+		for(i=1; i<=_nb_evaluation; i++)
+		{
+			if(i == 1)
+			{
+				essai = meilleur;
+				critere = meilleur_critere;
+				objectif = meilleur_objectif;
+			}
+			else
+			{
+				//DDS: le nombre de parametres perturbes diminue avec le nombre d'evaluations
+				probabilite = 1.0 - log(static_cast<double>(i - 1)) / log(static_cast<double>(_nb_evaluation));
+
+				essai = meilleur;
+				nb_selection = 0;
+
+				for(x=0; x<_parametres.size(); x++)
+				{
+					selection[x] = uniforme(generateur) < probabilite;
+					if(selection[x])
+						++nb_selection;
+				}
+
+				if(nb_selection == 0)
+					selection[choix(generateur)] = true;
+
+				for(x=0; x<_parametres.size(); x++)
+				{
+					if(!selection[x])
+						continue;
+
+					const PARAMETRE& parametre = _parametres[x];
+
+					etendue = parametre.max - parametre.min;
+					essai[x] = meilleur[x] + _perturbation * etendue * normale(generateur);
+
+					//reflexion aux bornes
+					if(essai[x] < parametre.min)
+					{
+						essai[x] = parametre.min + (parametre.min - essai[x]);
+						if(essai[x] > parametre.max)
+							essai[x] = parametre.min;
+					}
+					else if(essai[x] > parametre.max)
+					{
+						essai[x] = parametre.max - (essai[x] - parametre.max);
+						if(essai[x] < parametre.min)
+							essai[x] = parametre.max;
+					}
+				}
+
+				critere = Evalue(essai, objectif);
+
+				if(critere >= meilleur_critere)
+				{
+					meilleur = essai;
+					meilleur_critere = critere;
+					meilleur_objectif = objectif;
+				}
+			}
+
+			fichier << i;
+			for(x=0; x<essai.size(); x++)
+				fichier << sep << setprecision(10) << essai[x];
+			fichier << sep << objectif << sep << meilleur_objectif << endl;
+
+			std::cout << "\r" << "Calibration: evaluation " << i << "/" << _nb_evaluation << "   " << _fonction_objectif << " " << meilleur_objectif << "          " << flush;
+		}
+
+		fichier.close();
+		if(fichier.fail())
+			throw ERREUR_ECRITURE_FICHIER(nom_fichier);
+
+		std::cout << endl;
+
+		//simulation finale avec les meilleurs parametres; les fichiers de parametres du repertoire calibration les conservent
+		Evalue(meilleur, meilleur_objectif);
+
+		for(x=0; x<_fichiers.size(); x++)
+			_fichiers[x].sous_modele->ChangeNomFichierParametres(_fichiers[x].nom_fichier_original);
+
+		oss << "Calibration: best " << _fonction_objectif << " = " << meilleur_objectif << " (" << _nb_evaluation << " evaluations)";
+		HYDROTEL::Log("");
+		HYDROTEL::Log(oss.str());
+	}
+
+}
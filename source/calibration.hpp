@@ -0,0 +1,103 @@
+//
+// HYDROTEL a spatially distributed hydrological model
+// Copyright (C) 2013 INRS Eau Terre Environnement
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+// USA
+//
+
+#ifndef CALIBRATION_H_INCLUDED
+#define CALIBRATION_H_INCLUDED
+
+
+#include "sim_hyd.hpp"
+#include "etat_memoire.hpp"
+
+
+namespace HYDROTEL
+{
+
+	class SOUS_MODELE;
+
+	//calibration des parametres des sous modeles (methode DDS: Dynamically Dimensioned Search, Tolson & Shoemaker 2007)
+	//le projet est lu et initialise une seule fois; chaque evaluation repart de l'etat initial copie en memoire
+	//et les debits simules sont evalues par les statistiques (stats.txt) sans ecriture de fichier de sortie
+	class CALIBRATION
+	{
+	public:
+		CALIBRATION(SIM_HYD& sim_hyd, const std::string& nom_fichier);
+
+		~CALIBRATION();
+
+		/// lecture du fichier de calibration et des fichiers de parametres des sous modeles calibres
+		void Lecture();
+
+		/// execute la calibration; doit etre appele apres SIM_HYD::Initialise
+		/// la simulation est laissee a la date de fin avec les meilleurs parametres, prete pour SIM_HYD::Termine
+		void Execute();
+
+	private:
+
+		//fichier de parametres d'un sous modele calibre
+		struct FICHIER_PARAMETRES
+		{
+			SOUS_MODELE*				sous_modele;
+			std::string					nom_fichier_original;
+			std::string					nom_fichier_calibration;	//copie modifiee dans le repertoire de resultat
+			std::vector<std::string>	lignes;
+		};
+
+		//parametre calibre; la valeur est appliquee a toutes les lignes (uhrh/troncon) de la colonne
+		struct PARAMETRE
+		{
+			std::string					nom;
+			double						min;
+			double						max;
+
+			size_t						fichier;		//index dans _fichiers
+			size_t						colonne;
+			std::vector<size_t>			lignes;			//index des lignes modifiees
+
+			double						valeur_initiale;
+		};
+
+		void LectureColonne(PARAMETRE& parametre);
+
+		//applique les valeurs des parametres aux sous modeles
+		void AppliqueParametres(const std::vector<double>& valeurs);
+
+		//simulation complete a partir de l'etat initial; retourne le critere (plus grand est meilleur)
+		double Evalue(const std::vector<double>& valeurs, double& objectif);
+
+		SIM_HYD& _sim_hyd;
+		std::string _nom_fichier;
+
+		std::string _algorithme;
+		size_t _nb_evaluation;
+		unsigned int _germe;
+		double _perturbation;
+		std::string _fonction_objectif;
+		double _signe;									//1: maximise, -1: minimise
+		std::vector<int> _troncons;						//troncons evalues (vide: tous les troncons de stats.txt)
+
+		std::vector<FICHIER_PARAMETRES> _fichiers;
+		std::vector<PARAMETRE> _parametres;
+
+		ETAT_MEMOIRE _etat_initial;
+	};
+
+}
+
+#endif
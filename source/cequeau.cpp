@@ -21,6 +21,7 @@
 #include "cequeau.hpp"
 
 #include "erreur.hpp"
+#include "etat_binaire.hpp"
 #include "util.hpp"
 #include "version.hpp"
 #include "constantes.hpp"
@@ -42,6 +43,8 @@ namespace HYDROTEL
 
 	CEQUEAU::~CEQUEAU()
 	{
+		for(auto milieu_humide : _milieu_humide_isole)
+			delete milieu_humide;
 	}
 
 	void CEQUEAU::ChangeNbParams(const ZONES& zones)
@@ -74,10 +77,9 @@ namespace HYDROTEL
 		_init_lacma.resize(nb_zone, 250.0f);
 	}
 
-	void CEQUEAU::Initialise()
+	void CEQUEAU::InitialiseParametres()
 	{
-		ZONES& zones = _sim_hyd.PrendreZones();
-		const size_t nb_zone = zones.PrendreNbZone();
+		const size_t nb_zone = _sim_hyd.PrendreZones().PrendreNbZone();
 		auto& occupation_sol = _sim_hyd.PrendreOccupationSol();
 
 		// calcul pourcentage des classes integrees
@@ -117,6 +119,14 @@ namespace HYDROTEL
 
 			_frfor[index_zone] = pourcentage;
 		}
+	}
+
+	void CEQUEAU::Initialise()
+	{
+		ZONES& zones = _sim_hyd.PrendreZones();
+		size_t index_zone;
+
+		InitialiseParametres();
 
 		//initialisation milieux humides isoles
 		vector<size_t> index_zones = _sim_hyd.PrendreZonesSimules();
@@ -662,8 +672,8 @@ namespace HYDROTEL
 
 			fichier.close();
 
-			//lecture des parametres pour les milieux humides isoles
-			if(_sim_hyd._bSimuleMHIsole)
+			//lecture des parametres pour les milieux humides isoles; lus une seule fois (fichier distinct, non modifie par la calibration)
+			if(_sim_hyd._bSimuleMHIsole && _milieu_humide_isole.empty())
 				LectureMilieuHumideIsole();
 		}
 	}
@@ -782,8 +792,8 @@ namespace HYDROTEL
 		if(!bOK)
 			throw ERREUR_LECTURE_FICHIER( "FICHIER PARAMETRES GLOBAL; CEQUEAU; " + _sim_hyd._nomFichierParametresGlobal, 0, "Parametres sous-modele CEQUEAU");
 
-		//lecture des parametres pour les milieux humides isoles
-		if(_sim_hyd._bSimuleMHIsole)
+		//lecture des parametres pour les milieux humides isoles; lus une seule fois (fichier distinct, non modifie par la calibration)
+		if(_sim_hyd._bSimuleMHIsole && _milieu_humide_isole.empty())
 			LectureMilieuHumideIsole();
 	}
 
@@ -1026,6 +1036,35 @@ namespace HYDROTEL
 
 	void CEQUEAU::LectureEtat(DATE_HEURE date_courante)
 	{
+		TRACE_PERFORMANCE trace("CEQUEAU::LectureEtat");
+
+		if(ETAT_BINAIRE::EstBinaire(_nom_fichier_lecture_etat))
+		{
+			ETAT_BINAIRE etat;
+			etat.Lecture(_nom_fichier_lecture_etat, 3);
+
+			vector<size_t> index_ligne = etat.AssocieIndex(_sim_hyd.PrendreZones(), _sim_hyd.PrendreZonesSimules(), "BILAN_VERTICAL; fichier etat CEQUEAU");
+
+			for(size_t ligne=0; ligne<index_ligne.size(); ligne++)
+			{
+				const size_t index_zone = index_ligne[ligne];
+
+				if(index_zone != string::npos)
+				{
+					const double* valeurs = etat.PrendreLigne(ligne);
+
+					_sol[index_zone] = static_cast<float>(valeurs[0]);
+					_nappe[index_zone] = static_cast<float>(valeurs[1]);
+					_lacma[index_zone] = static_cast<float>(valeurs[2]);
+
+					if(_milieu_humide_isole.size() != 0 && _milieu_humide_isole[index_zone] && etat.PrendreNbColonne() >= 4)
+						_milieu_humide_isole[index_zone]->SetWetvol(static_cast<float>(valeurs[3]));
+				}
+			}
+
+			return;
+		}
+
 		ifstream fichier(_nom_fichier_lecture_etat);
 		if (!fichier)
 			throw ERREUR_LECTURE_FICHIER("BILAN_VERTICAL; fichier etat CEQUEAU; " + _nom_fichier_lecture_etat);
@@ -1073,6 +1112,8 @@ namespace HYDROTEL
 
 	void CEQUEAU::SauvegardeEtat(DATE_HEURE date_courante) const
 	{
+		TRACE_PERFORMANCE trace("CEQUEAU::SauvegardeEtat");
+
 		BOOST_ASSERT(_repertoire_ecriture_etat.size() != 0);
 
 		date_courante.AdditionHeure( _sim_hyd.PrendrePasDeTemps() );
@@ -1095,7 +1136,31 @@ namespace HYDROTEL
 			        << setw(2) << date_courante.PrendreMois() 
 			        << setw(2) << date_courante.PrendreJour() 
 			        << setw(2) << date_courante.PrendreHeure() 
-					<< ".csv";
+					<< _sim_hyd._output.ExtensionFichiersEtats();
+
+		if(_sim_hyd._output._bFichiersEtatsBinaire)
+		{
+			ZONES& zones = _sim_hyd.PrendreZones();
+			ETAT_BINAIRE etat;
+
+			etat.Initialise(PrendreNomSousModele(), date_courante, { "SOL (mm)", "NAPPE (mm)", "EAU (mm)", "MH WETVOL" }, _sim_hyd.PrendreZonesSimules().size());
+
+			for(size_t index_zone : _sim_hyd.PrendreZonesSimules())
+			{
+				double* valeurs = etat.AjouteLigne(zones[index_zone].PrendreIdent());
+
+				valeurs[0] = _sol[index_zone];
+				valeurs[1] = _nappe[index_zone];
+				valeurs[2] = _lacma[index_zone];
+
+				valeurs[3] = -999.0;
+				if(_milieu_humide_isole.size() != 0 && _milieu_humide_isole[index_zone])
+					valeurs[3] = _milieu_humide_isole[index_zone]->GetWetvol();
+			}
+
+			etat.Sauvegarde(nom_fichier.str());
+			return;
+		}
 
 		ofstream fichier(nom_fichier.str());
 		if (!fichier)
@@ -1142,4 +1207,45 @@ namespace HYDROTEL
 		fichier.close();
 	}
 
+
+	void CEQUEAU::SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const
+	{
+		etat.Ecrit(_sol);
+		etat.Ecrit(_nappe);
+		etat.Ecrit(_lacma);
+
+		//milieux humides isoles
+		etat.Ecrit(_milieu_humide_isole.size());
+
+		for(size_t index_zone=0; index_zone<_milieu_humide_isole.size(); index_zone++)
+		{
+			if(_milieu_humide_isole[index_zone])
+				etat.Ecrit(_milieu_humide_isole[index_zone]->GetWetvol());
+		}
+	}
+
+	void CEQUEAU::LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur)
+	{
+		lecteur.Lit(_sol);
+		lecteur.Lit(_nappe);
+		lecteur.Lit(_lacma);
+
+		//milieux humides isoles
+		size_t nb;
+		float wetvol;
+
+		lecteur.Lit(nb);
+		if(nb != _milieu_humide_isole.size())
+			throw ERREUR("In-memory state: CEQUEAU: isolated wetlands do not match the simulation.");
+
+		for(size_t index_zone=0; index_zone<_milieu_humide_isole.size(); index_zone++)
+		{
+			if(_milieu_humide_isole[index_zone])
+			{
+				lecteur.Lit(wetvol);
+				_milieu_humide_isole[index_zone]->SetWetvol(wetvol);
+			}
+		}
+	}
+
 }
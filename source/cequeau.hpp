@@ -47,6 +47,12 @@ namespace HYDROTEL
 
 		virtual void SauvegardeParametres();
 
+		virtual void InitialiseParametres();
+
+		virtual void SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const;
+
+		virtual void LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur);
+
 		virtual void ChangeNbParams(const ZONES& zones);	//initialisation des vecteurs et valeurs par defaut
 
 
@@ -82,6 +82,9 @@ namespace HYDROTEL
 	const float		CHALEUR_LATENTE_VAPORISATION			= 2.45f;				// MJ/kg
 	const float		CHALEUR_SPECIFIQUE_A_PRESSION_CONSTANTE	= 0.001013f;			// MJ/kg/dC
 
+	const unsigned int	TAILLE_BLOC_HDF5					= 8760;					// nb pas de temps par bloc de lecture des donnees meteo hdf5 (defaut)
+	const size_t		TAILLE_TAMPON_NETCDF				= 16777216;				// nb valeurs max. du tampon de lecture des donnees meteo netcdf (64 Mo)
+
 }
 
 #endif
@@ -22,6 +22,7 @@
 
 #include "constantes.hpp"
 #include "erreur.hpp"
+#include "etat_binaire.hpp"
 #include "moyenne_3_stations1.hpp"
 #include "moyenne_3_stations2.hpp"
 #include "station_neige.hpp"
@@ -742,17 +743,8 @@ namespace HYDROTEL
 
 			oss.str("");
 
-			for (idx=0; idx!=zones.PrendreNbZone(); idx++)
-			{
-				if(_bUhrhIndexSimule[idx])
-				{
-					if (output._bSauvegardeTous || 
-						find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[idx].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-					{
-						oss << zones[idx].PrendreIdent() << output.Separator();
-					}
-				}
-			}
+			for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+				oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 			
 			str = oss.str();
 			str = str.substr(0, str.length()-1); //enleve le dernier separateur
@@ -765,18 +757,13 @@ namespace HYDROTEL
 
 			oss.str("");
 
-			for (idx=0; idx!=zones.PrendreNbZone(); idx++)
+			for (size_t n = 0; n < output._uhrhOutputNb; ++n)
 			{
-				if(_bUhrhIndexSimule[idx])
-				{
-					if (output._bSauvegardeTous || 
-						find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[idx].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-					{
-						j = _bandePourcentageM1[idx].size();	//nb bande
-						for(i=0; i!=j; i++)
-							oss << zones[idx].PrendreIdent() << "-" << i+1 << output.Separator();
-					}
-				}
+				idx = output._uhrhOutputIndex[n];
+
+				j = _bandePourcentageM1[idx].size();	//nb bande
+				for(i=0; i!=j; i++)
+					oss << zones[idx].PrendreIdent() << "-" << i+1 << output.Separator();
 			}
 
 			str = oss.str();
@@ -793,17 +780,8 @@ namespace HYDROTEL
 
 			oss.str("");
 
-			for (idx=0; idx!=zones.PrendreNbZone(); idx++)
-			{
-				if(_bUhrhIndexSimule[idx])
-				{
-					if (output._bSauvegardeTous || 
-						find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[idx].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-					{
-						oss << zones[idx].PrendreIdent() << output.Separator();
-					}
-				}
-			}
+			for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+				oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 			
 			str = oss.str();
 			str = str.substr(0, str.length()-1); //enleve le dernier separateur
@@ -819,17 +797,8 @@ namespace HYDROTEL
 
 			oss.str("");
 
-			for (idx=0; idx!=zones.PrendreNbZone(); idx++)
-			{
-				if(_bUhrhIndexSimule[idx])
-				{
-					if (output._bSauvegardeTous || 
-						find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[idx].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-					{
-						oss << zones[idx].PrendreIdent() << output.Separator();
-					}
-				}
-			}
+			for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+				oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 			
 			str = oss.str();
 			str = str.substr(0, str.length()-1); //enleve le dernier separateur
@@ -1066,8 +1035,7 @@ namespace HYDROTEL
 
 					if(_sim_hyd.PrendreDateCourante().PrendreAnnee() == _sim_hyd.PrendreDateDebut().PrendreAnnee())		//seulement pour la 1ere annee sinon le fichier output est trop volumineux
 					{
-						if(output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zone.PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
+						if(output._vUhrhOutput[index_zone])
 						{
 							oss.str("");
 							oss << _sim_hyd.PrendreDateCourante() << output.Separator();
@@ -1114,8 +1082,7 @@ namespace HYDROTEL
 
 					if(_sim_hyd.PrendreDateCourante().PrendreAnnee() == _sim_hyd.PrendreDateDebut().PrendreAnnee())		//seulement pour la 1ere annee sinon le fichier output est trop volumineux
 					{
-						if(output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zone.PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
+						if(output._vUhrhOutput[index_zone])
 						{
 							oss.str("");
 							oss << _sim_hyd.PrendreDateCourante() << output.Separator();
@@ -1162,8 +1129,7 @@ namespace HYDROTEL
 
 					if(_sim_hyd.PrendreDateCourante().PrendreAnnee() == _sim_hyd.PrendreDateDebut().PrendreAnnee())		//seulement pour la 1ere annee sinon le fichier output est trop volumineux
 					{
-						if(output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zone.PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
+						if(output._vUhrhOutput[index_zone])
 						{
 							oss.str("");
 							oss << _sim_hyd.PrendreDateCourante() << output.Separator();
@@ -1361,38 +1327,33 @@ namespace HYDROTEL
 			if(output.SauvegardeAlbedoNeige())	//fichier albedo_neige.csv
 				ossAN << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(6) << setiosflags(ios::fixed);
 
-			for(index=0; index!=zones.PrendreNbZone(); index++)
+			for (size_t n = 0; n < output._uhrhOutputNb; ++n)
 			{
-				if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-				{
-					if(output._bSauvegardeTous || 
-						find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-					{
-						if(output.SauvegardeCouvertNival())
-						{
-							ossCN << zones[index].PrendreCouvertNival() << output.Separator();	//equivalent en eau du couvert nival	//mm
+				index = output._uhrhOutputIndex[n];
 
-							nbBande = _bandePourcentageM1[index].size();
-							for(idxBande=0; idxBande!=nbBande; idxBande++)
-							{
-								dSuperficieTotalBande = _bandeSuperficieM1[index][idxBande] + _bandeSuperficieM2[index][idxBande] + _bandeSuperficieM3[index][idxBande];
-								dPourcentM1 = _bandeSuperficieM1[index][idxBande] / dSuperficieTotalBande;
-								dPourcentM2 = _bandeSuperficieM2[index][idxBande] / dSuperficieTotalBande;
-								dPourcentM3 = _bandeSuperficieM3[index][idxBande] / dSuperficieTotalBande;
-
-								dVal = dPourcentM1 * _stock_conifers[index][idxBande] + dPourcentM2 * _stock_feuillus[index][idxBande] + dPourcentM3 * _stock_decouver[index][idxBande];
-								dVal*= 1000.0;	//[m] -> [mm]
-								ossCNB << dVal << output.Separator();	//equivalent en eau du couvert nival de la bande	//mm
-							}
-						}
-
-						if(output.SauvegardeHauteurNeige())
-							ossHN << zones[index].PrendreHauteurCouvertNival() << output.Separator();	//m
+				if(output.SauvegardeCouvertNival())
+				{
+					ossCN << zones[index].PrendreCouvertNival() << output.Separator();	//equivalent en eau du couvert nival	//mm
 
-						if(output.SauvegardeAlbedoNeige())
-							ossAN << zones[index].PrendreAlbedoNeige() << output.Separator();
+					nbBande = _bandePourcentageM1[index].size();
+					for(idxBande=0; idxBande!=nbBande; idxBande++)
+					{
+						dSuperficieTotalBande = _bandeSuperficieM1[index][idxBande] + _bandeSuperficieM2[index][idxBande] + _bandeSuperficieM3[index][idxBande];
+						dPourcentM1 = _bandeSuperficieM1[index][idxBande] / dSuperficieTotalBande;
+						dPourcentM2 = _bandeSuperficieM2[index][idxBande] / dSuperficieTotalBande;
+						dPourcentM3 = _bandeSuperficieM3[index][idxBande] / dSuperficieTotalBande;
+
+						dVal = dPourcentM1 * _stock_conifers[index][idxBande] + dPourcentM2 * _stock_feuillus[index][idxBande] + dPourcentM3 * _stock_decouver[index][idxBande];
+						dVal*= 1000.0;	//[m] -> [mm]
+						ossCNB << dVal << output.Separator();	//equivalent en eau du couvert nival de la bande	//mm
 					}
 				}
+
+				if(output.SauvegardeHauteurNeige())
+					ossHN << zones[index].PrendreHauteurCouvertNival() << output.Separator();	//m
+
+				if(output.SauvegardeAlbedoNeige())
+					ossAN << zones[index].PrendreAlbedoNeige() << output.Separator();
 			}
 
 			if(output.SauvegardeCouvertNival())
@@ -2583,6 +2544,53 @@ namespace HYDROTEL
 
 	void DEGRE_JOUR_BANDE::LectureEtat(DATE_HEURE date_courante)
 	{
+		TRACE_PERFORMANCE trace("DEGRE_JOUR_BANDE::LectureEtat");
+
+		if(ETAT_BINAIRE::EstBinaire(_nom_fichier_lecture_etat))
+		{
+			ETAT_BINAIRE etat;
+			etat.Lecture(_nom_fichier_lecture_etat, 16);
+
+			vector<size_t> index_ligne = etat.AssocieIndex(_sim_hyd.PrendreZones(), _sim_hyd.PrendreZonesSimules(), "FONTE_NEIGE; fichier etat DEGRE_JOUR_BANDE");
+
+			for(size_t ligne=0; ligne<index_ligne.size(); ligne++)
+			{
+				const size_t index_zone = index_ligne[ligne];
+
+				if(index_zone != string::npos)
+				{
+					const double* valeurs = etat.PrendreLigne(ligne);
+
+					//colonne 0: no de bande (base 1)
+					const size_t idxBande = static_cast<size_t>(valeurs[0]) - 1;
+					if(valeurs[0] < 1.0 || idxBande >= _stock_conifers[index_zone].size())
+						throw ERREUR_LECTURE_FICHIER("FONTE_NEIGE; fichier etat DEGRE_JOUR_BANDE; " + _nom_fichier_lecture_etat);
+
+					_stock_conifers[index_zone][idxBande] = valeurs[1];
+					_stock_feuillus[index_zone][idxBande] = valeurs[2];
+					_stock_decouver[index_zone][idxBande] = valeurs[3];
+
+					_hauteur_conifers[index_zone][idxBande] = valeurs[4];
+					_hauteur_feuillus[index_zone][idxBande] = valeurs[5];
+					_hauteur_decouver[index_zone][idxBande] = valeurs[6];
+
+					_chaleur_conifers[index_zone][idxBande] = valeurs[7];
+					_chaleur_feuillus[index_zone][idxBande] = valeurs[8];
+					_chaleur_decouver[index_zone][idxBande] = valeurs[9];
+
+					_eau_retenu_conifers[index_zone][idxBande] = valeurs[10];
+					_eau_retenu_feuillus[index_zone][idxBande] = valeurs[11];
+					_eau_retenu_decouver[index_zone][idxBande] = valeurs[12];
+
+					_albedo_conifers[index_zone][idxBande] = valeurs[13];
+					_albedo_feuillus[index_zone][idxBande] = valeurs[14];
+					_albedo_decouver[index_zone][idxBande] = valeurs[15];
+				}
+			}
+
+			return;
+		}
+
 		ifstream fichier(_nom_fichier_lecture_etat);
 		if (!fichier)
 			throw ERREUR_LECTURE_FICHIER("FONTE_NEIGE; fichier etat DEGRE_JOUR_BANDE; " + _nom_fichier_lecture_etat);
@@ -2674,6 +2682,8 @@ namespace HYDROTEL
 
 	void DEGRE_JOUR_BANDE::SauvegardeEtat(DATE_HEURE date_courante) const
 	{
+		TRACE_PERFORMANCE trace("DEGRE_JOUR_BANDE::SauvegardeEtat");
+
 		BOOST_ASSERT(_repertoire_ecriture_etat.size() != 0);
 
 		date_courante.AdditionHeure( _sim_hyd.PrendrePasDeTemps() );
@@ -2695,7 +2705,59 @@ namespace HYDROTEL
 			        << setw(2) << date_courante.PrendreMois() 
 			        << setw(2) << date_courante.PrendreJour() 
 			        << setw(2) << date_courante.PrendreHeure() 
-					<< ".csv";
+					<< _sim_hyd._output.ExtensionFichiersEtats();
+
+		if(_sim_hyd._output._bFichiersEtatsBinaire)
+		{
+			ZONES& zones = _sim_hyd.PrendreZones();
+			ETAT_BINAIRE etat;
+			size_t nbLigne = 0;
+
+			for(size_t index_zone : _sim_hyd.PrendreZonesSimules())
+				nbLigne+= _bandePourcentageM1[index_zone].size();
+
+			//une ligne par bande
+			etat.Initialise(PrendreNomSousModele(), date_courante, 
+				{ "BANDE", 
+				  "STOCK CONIFERS", "STOCK FEUILLUS", "STOCK DECOUVERT", 
+				  "HAUTEUR CONIFERS", "HAUTEUR FEUILLUS", "HAUTEUR DECOUVERT", 
+				  "CHALEUR CONIFERS", "CHALEUR FEUILLUS", "CHALEUR DECOUVERT", 
+				  "EAU RETENUE CONIFERS", "EAU RETENUE FEUILLUS", "EAU RETENUE DECOUVERT", 
+				  "ALBEDO CONIFERS", "ALBEDO FEUILLUS", "ALBEDO DECOUVERT" }, nbLigne);
+
+			for(size_t index_zone : _sim_hyd.PrendreZonesSimules())
+			{
+				for(size_t idxBande=0; idxBande!=_bandePourcentageM1[index_zone].size(); idxBande++)
+				{
+					double* valeurs = etat.AjouteLigne(zones[index_zone].PrendreIdent());
+
+					valeurs[0] = static_cast<double>(idxBande+1);
+
+					valeurs[1] = _stock_conifers[index_zone][idxBande];
+					valeurs[2] = _stock_feuillus[index_zone][idxBande];
+					valeurs[3] = _stock_decouver[index_zone][idxBande];
+
+					valeurs[4] = _hauteur_conifers[index_zone][idxBande];
+					valeurs[5] = _hauteur_feuillus[index_zone][idxBande];
+					valeurs[6] = _hauteur_decouver[index_zone][idxBande];
+
+					valeurs[7] = _chaleur_conifers[index_zone][idxBande];
+					valeurs[8] = _chaleur_feuillus[index_zone][idxBande];
+					valeurs[9] = _chaleur_decouver[index_zone][idxBande];
+
+					valeurs[10] = _eau_retenu_conifers[index_zone][idxBande];
+					valeurs[11] = _eau_retenu_feuillus[index_zone][idxBande];
+					valeurs[12] = _eau_retenu_decouver[index_zone][idxBande];
+
+					valeurs[13] = _albedo_conifers[index_zone][idxBande];
+					valeurs[14] = _albedo_feuillus[index_zone][idxBande];
+					valeurs[15] = _albedo_decouver[index_zone][idxBande];
+				}
+			}
+
+			etat.Sauvegarde(nom_fichier.str());
+			return;
+		}
 
 		ofstream fichier(nom_fichier.str());
 		if (!fichier)
@@ -3221,4 +3283,51 @@ namespace HYDROTEL
 		return _date_sauvegarde_etat;
 	}
 
+
+	void DEGRE_JOUR_BANDE::SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const
+	{
+		etat.Ecrit(_stock_conifers);
+		etat.Ecrit(_stock_feuillus);
+		etat.Ecrit(_stock_decouver);
+
+		etat.Ecrit(_hauteur_conifers);
+		etat.Ecrit(_hauteur_feuillus);
+		etat.Ecrit(_hauteur_decouver);
+
+		etat.Ecrit(_chaleur_conifers);
+		etat.Ecrit(_chaleur_feuillus);
+		etat.Ecrit(_chaleur_decouver);
+
+		etat.Ecrit(_eau_retenu_conifers);
+		etat.Ecrit(_eau_retenu_feuillus);
+		etat.Ecrit(_eau_retenu_decouver);
+
+		etat.Ecrit(_albedo_conifers);
+		etat.Ecrit(_albedo_feuillus);
+		etat.Ecrit(_albedo_decouver);
+	}
+
+	void DEGRE_JOUR_BANDE::LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur)
+	{
+		lecteur.Lit(_stock_conifers);
+		lecteur.Lit(_stock_feuillus);
+		lecteur.Lit(_stock_decouver);
+
+		lecteur.Lit(_hauteur_conifers);
+		lecteur.Lit(_hauteur_feuillus);
+		lecteur.Lit(_hauteur_decouver);
+
+		lecteur.Lit(_chaleur_conifers);
+		lecteur.Lit(_chaleur_feuillus);
+		lecteur.Lit(_chaleur_decouver);
+
+		lecteur.Lit(_eau_retenu_conifers);
+		lecteur.Lit(_eau_retenu_feuillus);
+		lecteur.Lit(_eau_retenu_decouver);
+
+		lecteur.Lit(_albedo_conifers);
+		lecteur.Lit(_albedo_feuillus);
+		lecteur.Lit(_albedo_decouver);
+	}
+
 }
@@ -61,6 +61,10 @@ namespace HYDROTEL
 
 		virtual void SauvegardeParametres();
 
+		virtual void SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const;
+
+		virtual void LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur);
+
 		/// retourne le taux de fonte (mm/jour) 
 		double PrendreTauxFonte(size_t index_zone) const;
 
@@ -1077,4 +1077,19 @@ namespace HYDROTEL
 		}
 	}
 
+
+	void DEGRE_JOUR_GLACIER::SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const
+	{
+		etat.Ecrit(_vol_m1);
+		etat.Ecrit(_stock_m1);
+		etat.Ecrit(_apport_m1);
+	}
+
+	void DEGRE_JOUR_GLACIER::LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur)
+	{
+		lecteur.Lit(_vol_m1);
+		lecteur.Lit(_stock_m1);
+		lecteur.Lit(_apport_m1);
+	}
+
 }
@@ -47,6 +47,10 @@ namespace HYDROTEL
 
 		virtual void		SauvegardeParametres();
 
+		virtual void SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const;
+
+		virtual void LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur);
+
 		virtual void		ChangeNbParams(const ZONES& zones);
 
 		void				ChangeIndexOccupationM1(const std::vector<size_t>& index);
@@ -22,6 +22,7 @@
 
 #include "constantes.hpp"
 #include "erreur.hpp"
+#include "etat_binaire.hpp"
 #include "moyenne_3_stations1.hpp"
 #include "moyenne_3_stations2.hpp"
 #include "station_neige.hpp"
@@ -67,43 +68,20 @@ namespace HYDROTEL
 
 	DEGRE_JOUR_MODIFIE::~DEGRE_JOUR_MODIFIE()
 	{
+		//fichiers netcdf non fermes par Termine (exception); OUTPUT_NETCDF ecrit les pas de temps deja calcules
+		if(_netCdf_couvertnival != NULL)
+			delete _netCdf_couvertnival;
+		if(_netCdf_hauteurneige != NULL)
+			delete _netCdf_hauteurneige;
+		if(_netCdf_albedoneige != NULL)
+			delete _netCdf_albedoneige;
 	}
 
-	void DEGRE_JOUR_MODIFIE::Initialise()
+	void DEGRE_JOUR_MODIFIE::InitialiseParametres()
 	{
-		_corrections_neige_au_sol = _sim_hyd.PrendreCorrections().PrendreCorrectionsNeigeAuSol();
-
-		ZONES& zones = _sim_hyd.PrendreZones();
-
-		const size_t nb_zone = zones.PrendreNbZone();
-
-		_ce1.resize(nb_zone, 0);
-		_ce0.resize(nb_zone, 0);
-		_tsn.resize(nb_zone, 0);
-
-		_stock_feuillus.resize(nb_zone, 0);
-		_stock_conifers.resize(nb_zone, 0);
-		_stock_decouver.resize(nb_zone, 0);
-
-		_hauteur_feuillus.resize(nb_zone, 0);
-		_hauteur_conifers.resize(nb_zone, 0);
-		_hauteur_decouver.resize(nb_zone, 0);
+		const size_t nb_zone = _sim_hyd.PrendreZones().PrendreNbZone();
 
-		_chaleur_feuillus.resize(nb_zone, 0);
-		_chaleur_conifers.resize(nb_zone, 0);
-		_chaleur_decouver.resize(nb_zone, 0);
-
-		_eau_retenu_feuillus.resize(nb_zone, 0);
-		_eau_retenu_conifers.resize(nb_zone, 0);
-		_eau_retenu_decouver.resize(nb_zone, 0);
-
-		_albedo_feuillus.resize(nb_zone, 0.8f);
-		_albedo_conifers.resize(nb_zone, 0.8f);
-		_albedo_decouver.resize(nb_zone, 0.8f);
-
-		//_methode_albedo.resize(nb_zone, 0);
-
-		auto occupation_sol = _sim_hyd.PrendreOccupationSol();
+		auto& occupation_sol = _sim_hyd.PrendreOccupationSol();
 
 		_pourcentage_feuillus.resize(nb_zone, 0);
 		for (size_t index_zone = 0; index_zone < nb_zone; ++index_zone)
@@ -139,6 +117,43 @@ namespace HYDROTEL
 			if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index_zone) != end(_sim_hyd.PrendreZonesSimules()))
 				_pourcentage_autres[index_zone] = max(1.0f - _pourcentage_feuillus[index_zone] - _pourcentage_conifers[index_zone], 0.0f);
 		}
+	}
+
+	void DEGRE_JOUR_MODIFIE::Initialise()
+	{
+		_corrections_neige_au_sol = _sim_hyd.PrendreCorrections().PrendreCorrectionsNeigeAuSol();
+
+		ZONES& zones = _sim_hyd.PrendreZones();
+
+		const size_t nb_zone = zones.PrendreNbZone();
+
+		_ce1.resize(nb_zone, 0);
+		_ce0.resize(nb_zone, 0);
+		_tsn.resize(nb_zone, 0);
+
+		_stock_feuillus.resize(nb_zone, 0);
+		_stock_conifers.resize(nb_zone, 0);
+		_stock_decouver.resize(nb_zone, 0);
+
+		_hauteur_feuillus.resize(nb_zone, 0);
+		_hauteur_conifers.resize(nb_zone, 0);
+		_hauteur_decouver.resize(nb_zone, 0);
+
+		_chaleur_feuillus.resize(nb_zone, 0);
+		_chaleur_conifers.resize(nb_zone, 0);
+		_chaleur_decouver.resize(nb_zone, 0);
+
+		_eau_retenu_feuillus.resize(nb_zone, 0);
+		_eau_retenu_conifers.resize(nb_zone, 0);
+		_eau_retenu_decouver.resize(nb_zone, 0);
+
+		_albedo_feuillus.resize(nb_zone, 0.8f);
+		_albedo_conifers.resize(nb_zone, 0.8f);
+		_albedo_decouver.resize(nb_zone, 0.8f);
+
+		//_methode_albedo.resize(nb_zone, 0);
+
+		InitialiseParametres();
 
 		for (size_t index_zone = 0; index_zone < nb_zone; ++index_zone)
 		{
@@ -162,6 +177,8 @@ namespace HYDROTEL
 			}
 		}
 
+		InitialiseIndiceRadiation();
+
 		const PROJECTION& projection = zones.PrendreProjection();
 
 		// ponderations et lecture des donnees des stations de neige
@@ -473,32 +490,23 @@ namespace HYDROTEL
 		if (_pOutput->SauvegardeCouvertNival())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_couvertnival = new float[_sim_hyd._lNbPasTempsSim*_pOutput->_uhrhOutputNb];
+				_netCdf_couvertnival = _pOutput->CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "couvert_nival.nc"), true, "couvert_nival", "mm", "Equivalent en eau du couvert nival");
 			else
 			{
 				string sFile( Combine(_sim_hyd.PrendreRepertoireResultat(), "couvert_nival.csv") );
-				_fichier_couvert_nival.open(sFile);
-				_fichier_couvert_nival << "Couvert nival (EEN) (mm)" << _pOutput->Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << _pOutput->Separator();
+				_fichier_couvert_nival.Ouvre(*_pOutput, sFile, true, _pOutput->_nbDigit_mm);
+				_fichier_couvert_nival.Entete() << "Couvert nival (EEN) (mm)" << _pOutput->Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << _pOutput->Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (_pOutput->_bSauvegardeTous ||
-							find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << _pOutput->Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < _pOutput->_uhrhOutputNb; ++n)
+					oss << zones[_pOutput->_uhrhOutputIndex[n]].PrendreIdent() << _pOutput->Separator();
 			
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_couvert_nival << str << endl;
+				_fichier_couvert_nival.Entete() << str << endl;
 			}
 		}
 
@@ -506,32 +514,23 @@ namespace HYDROTEL
 		if (_pOutput->SauvegardeHauteurNeige())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_hauteurneige = new float[_sim_hyd._lNbPasTempsSim*_pOutput->_uhrhOutputNb];
+				_netCdf_hauteurneige = _pOutput->CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "hauteur_neige.nc"), true, "hauteur_neige", "m", "Hauteur du couvert nival");
 			else
 			{
 				string sFile( Combine(_sim_hyd.PrendreRepertoireResultat(), "hauteur_neige.csv") );
-				_fichier_hauteur_neige.open(sFile);
-				_fichier_hauteur_neige << "Hauteur couvert nival (m)" << _pOutput->Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << _pOutput->Separator();
+				_fichier_hauteur_neige.Ouvre(*_pOutput, sFile, true, _pOutput->_nbDigit_m);
+				_fichier_hauteur_neige.Entete() << "Hauteur couvert nival (m)" << _pOutput->Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << _pOutput->Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (_pOutput->_bSauvegardeTous ||
-							find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << _pOutput->Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < _pOutput->_uhrhOutputNb; ++n)
+					oss << zones[_pOutput->_uhrhOutputIndex[n]].PrendreIdent() << _pOutput->Separator();
 			
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_hauteur_neige << str << endl;
+				_fichier_hauteur_neige.Entete() << str << endl;
 			}
 		}
 
@@ -539,32 +538,23 @@ namespace HYDROTEL
 		if (_pOutput->SauvegardeAlbedoNeige())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_albedoneige = new float[_sim_hyd._lNbPasTempsSim*_pOutput->_uhrhOutputNb];
+				_netCdf_albedoneige = _pOutput->CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "albedo_neige.nc"), true, "albedo_neige", "[0-1]", "Albedo de la neige");
 			else
 			{
 				string sFile( Combine(_sim_hyd.PrendreRepertoireResultat(), "albedo_neige.csv") );
-				_fichier_albedo_neige.open(sFile);
-				_fichier_albedo_neige << "Albedo neige (0-1)" << _pOutput->Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << _pOutput->Separator();
+				_fichier_albedo_neige.Ouvre(*_pOutput, sFile, true, _pOutput->_nbDigit_ratio);
+				_fichier_albedo_neige.Entete() << "Albedo neige (0-1)" << _pOutput->Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << _pOutput->Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (_pOutput->_bSauvegardeTous ||
-							find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << _pOutput->Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < _pOutput->_uhrhOutputNb; ++n)
+					oss << zones[_pOutput->_uhrhOutputIndex[n]].PrendreIdent() << _pOutput->Separator();
 			
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_albedo_neige << str << endl;
+				_fichier_albedo_neige.Entete() << str << endl;
 			}
 		}
 
@@ -809,8 +799,8 @@ namespace HYDROTEL
 			}
 		}
 
-		size_t i, idx;
-		string str;
+		size_t i;
+		float* pLigne;
 		float stock_moyen;
 
 		//fichier couvert_nival.csv
@@ -818,7 +808,7 @@ namespace HYDROTEL
 		{
 			if (_netCdf_couvertnival != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _pOutput->_uhrhOutputNb;
+				pLigne = _netCdf_couvertnival->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_pOutput->_uhrhOutputNb; i++)
 				{
@@ -826,35 +816,23 @@ namespace HYDROTEL
 						_pourcentage_autres[_pOutput->_uhrhOutputIndex[i]] * _stock_decouver[_pOutput->_uhrhOutputIndex[i]] +
 						_pourcentage_feuillus[_pOutput->_uhrhOutputIndex[i]] * _stock_feuillus[_pOutput->_uhrhOutputIndex[i]]) * 1000.0f;	//equivalent en eau du couvert nival	//m -> mm
 
-					_netCdf_couvertnival[idx+i] = stock_moyen;
+					pLigne[i] = stock_moyen;
 				}
 			}
 			else
 			{
-				ostringstream oss;
-				oss.str("");
-			
-				oss << _sim_hyd.PrendreDateCourante() << _pOutput->Separator() << setprecision(_pOutput->_nbDigit_mm) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_couvert_nival.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
+				for (size_t n = 0; n < _pOutput->_uhrhOutputNb; ++n)
 				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (_pOutput->_bSauvegardeTous || 
-							find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
-						{
-							stock_moyen = ( _pourcentage_conifers[index] * _stock_conifers[index] + 
-								_pourcentage_autres[index] * _stock_decouver[index] + 
-								_pourcentage_feuillus[index] * _stock_feuillus[index] ) * 1000.0f;	//equivalent en eau du couvert nival	//m -> mm
+					size_t index = _pOutput->_uhrhOutputIndex[n];
 
-							oss << stock_moyen << _pOutput->Separator();
-						}
-					}
+					stock_moyen = ( _pourcentage_conifers[index] * _stock_conifers[index] + 
+						_pourcentage_autres[index] * _stock_decouver[index] + 
+						_pourcentage_feuillus[index] * _stock_feuillus[index] ) * 1000.0f;	//equivalent en eau du couvert nival	//m -> mm
+
+					pValeur[n] = stock_moyen;
 				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_couvert_nival << str << endl;
 			}
 		}
 
@@ -863,34 +841,22 @@ namespace HYDROTEL
 		{
 			if (_netCdf_hauteurneige != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _pOutput->_uhrhOutputNb;
+				pLigne = _netCdf_hauteurneige->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_pOutput->_uhrhOutputNb; i++)
-					_netCdf_hauteurneige[idx+i] = zones[_pOutput->_uhrhOutputIndex[i]].PrendreHauteurCouvertNival();	//m;
+					pLigne[i] = zones[_pOutput->_uhrhOutputIndex[i]].PrendreHauteurCouvertNival();	//m;
 			}
 			else
 			{
-				ostringstream oss;
-				oss.str("");
-			
-				oss << _sim_hyd.PrendreDateCourante() << _pOutput->Separator() << setprecision(_pOutput->_nbDigit_m) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_hauteur_neige.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
+				for (size_t n = 0; n < _pOutput->_uhrhOutputNb; ++n)
 				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (_pOutput->_bSauvegardeTous || 
-							find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
-						{
-							float hauteurNeige = zones[index].PrendreHauteurCouvertNival();	//m
-							oss << hauteurNeige << _pOutput->Separator();
-						}
-					}
+					size_t index = _pOutput->_uhrhOutputIndex[n];
+
+					float hauteurNeige = zones[index].PrendreHauteurCouvertNival();	//m
+					pValeur[n] = hauteurNeige;
 				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_hauteur_neige << str << endl;
 			}
 		}
 
@@ -899,34 +865,22 @@ namespace HYDROTEL
 		{
 			if (_netCdf_albedoneige != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _pOutput->_uhrhOutputNb;
+				pLigne = _netCdf_albedoneige->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_pOutput->_uhrhOutputNb; i++)
-					_netCdf_albedoneige[idx+i] = zones[_pOutput->_uhrhOutputIndex[i]].PrendreAlbedoNeige();
+					pLigne[i] = zones[_pOutput->_uhrhOutputIndex[i]].PrendreAlbedoNeige();
 			}
 			else
 			{
-				ostringstream oss;
-				oss.str("");
-			
-				oss << _sim_hyd.PrendreDateCourante() << _pOutput->Separator() << setprecision(_pOutput->_nbDigit_ratio) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_albedo_neige.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
+				for (size_t n = 0; n < _pOutput->_uhrhOutputNb; ++n)
 				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (_pOutput->_bSauvegardeTous || 
-							find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
-						{
-							float fVal = zones[index].PrendreAlbedoNeige();		//0-1
-							oss << fVal << _pOutput->Separator();
-						}
-					}
+					size_t index = _pOutput->_uhrhOutputIndex[n];
+
+					float fVal = zones[index].PrendreAlbedoNeige();		//0-1
+					pValeur[n] = fVal;
 				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_albedo_neige << str << endl;
 			}
 		}
 
@@ -940,7 +894,7 @@ namespace HYDROTEL
 
 	void DEGRE_JOUR_MODIFIE::Termine()
 	{
-		string str1, str2;
+		string str;
 
 		_ce1.clear();
 		_ce0.clear();
@@ -972,51 +926,45 @@ namespace HYDROTEL
 		{
 			if (_netCdf_couvertnival != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "fonte_neige-degre_jour_mod-couvert_nival.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "couvert_nival.nc");
-				//str2 = _pOutput->SauvegardeOutputNetCDF(str1, true, "fonte_neige-degre_jour_mod-couvert_nival", _netCdf_couvertnival, "mm", "Equivalent en eau du couvert nival");
-				str2 = _pOutput->SauvegardeOutputNetCDF(str1, true, "couvert_nival", _netCdf_couvertnival, "mm", "Equivalent en eau du couvert nival");
-				if(str2 != "")
-					throw ERREUR(str2);
-
-				delete [] _netCdf_couvertnival;
+				str = _netCdf_couvertnival->Ferme();
+				delete _netCdf_couvertnival;
+				_netCdf_couvertnival = NULL;
+
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_couvert_nival.close();
+				_fichier_couvert_nival.Ferme();
 		}
 
 		if (_pOutput->SauvegardeHauteurNeige())
 		{
 			if (_netCdf_hauteurneige != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "fonte_neige-degre_jour_mod-hauteur_neige.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "hauteur_neige.nc");
-				//str2 = _pOutput->SauvegardeOutputNetCDF(str1, true, "fonte_neige-degre_jour_mod-hauteur_neige", _netCdf_hauteurneige, "m", "Hauteur du couvert nival");
-				str2 = _pOutput->SauvegardeOutputNetCDF(str1, true, "hauteur_neige", _netCdf_hauteurneige, "m", "Hauteur du couvert nival");
-				if(str2 != "")
-					throw ERREUR(str2);
-
-				delete [] _netCdf_hauteurneige;
+				str = _netCdf_hauteurneige->Ferme();
+				delete _netCdf_hauteurneige;
+				_netCdf_hauteurneige = NULL;
+
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_hauteur_neige.close();
+				_fichier_hauteur_neige.Ferme();
 		}
 
 		if (_pOutput->SauvegardeAlbedoNeige())
 		{
 			if (_netCdf_albedoneige != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "fonte_neige-degre_jour_mod-albedo_neige.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "albedo_neige.nc");
-				//str2 = _pOutput->SauvegardeOutputNetCDF(str1, true, "fonte_neige-degre_jour_mod-albedo_neige", _netCdf_albedoneige, "[0-1]", "Albedo de la neige");
-				str2 = _pOutput->SauvegardeOutputNetCDF(str1, true, "albedo_neige", _netCdf_albedoneige, "[0-1]", "Albedo de la neige");
-				if(str2 != "")
-					throw ERREUR(str2);
-
-				delete [] _netCdf_albedoneige;
+				str = _netCdf_albedoneige->Ferme();
+				delete _netCdf_albedoneige;
+				_netCdf_albedoneige = NULL;
+
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_albedo_neige.close();
+				_fichier_albedo_neige.Ferme();
 		}
 
 		_maj_feuillus.clear();
@@ -1027,33 +975,76 @@ namespace HYDROTEL
 	}
 
 
-	void DEGRE_JOUR_MODIFIE::CalculIndiceRadiation(DATE_HEURE date_heure, unsigned short pas_de_temps, ZONE& zone, size_t index_zone)
+	void DEGRE_JOUR_MODIFIE::InitialiseIndiceRadiation()
 	{
 		const double i0 = dCONSTANTE_SOLAIRE;	// constante solaire en Watt/m2.
-		const double w = 15.0 / dRAD1;	// vitesse angulaire de la rotation de la terre
 
-		double theta, theta1, alpha, i_j1, i_j2, jour, heure, e2, i_e2, decli, duree_hor, duree_pte, tampon;
-		double t1_pte, t2_pte, t1_pte_sim, t2_pte_sim, t1_hor_sim, t2_hor_sim, t1, t2, dIndiceRadiation;
+		ZONES& zones = _sim_hyd.PrendreZones();
+
+		double theta, theta1, jour, e2, decli;
+		size_t index_zone, index;
 
-		theta = zone.PrendreCentroide().PrendreY() / dRAD1;
-		theta1 = _ce1[index_zone] / dRAD1;
-		alpha = _ce0[index_zone] / dRAD1;
+		// termes ne dependant que du jour julien
+		_radiation_jour.resize(366);
 
-		jour = static_cast<double>(date_heure.PrendreJourJulien());
-		heure = static_cast<double>(date_heure.PrendreHeure());
+		for (index = 0; index < _radiation_jour.size(); ++index)
+		{
+			jour = static_cast<double>(index + 1);
 
-		// calcul du vecteur radian
-		e2 = pow(1.0 - dEXENTRICITE_ORBITE_TERRESTRE * cos((jour - 4.0) / dDEG1), 2.0);
-		i_e2 = i0 / e2;
+			// calcul du vecteur radian
+			e2 = pow(1.0 - dEXENTRICITE_ORBITE_TERRESTRE * cos((jour - 4.0) / dDEG1), 2.0);
+			_radiation_jour[index].i_e2 = 3600.0 * (i0 / e2);
 
-		// calcul de la declinaison
-		decli = 0.410152374218 * sin((jour - 80.25) / dDEG1);
+			// calcul de la declinaison
+			decli = 0.410152374218 * sin((jour - 80.25) / dDEG1);
+
+			_radiation_jour[index].sin_decli = sin(decli);
+			_radiation_jour[index].cos_decli = cos(decli);
+			_radiation_jour[index].tan_decli = tan(decli);
+		}
+
+		// termes ne dependant que de la geometrie de la zone
+		_radiation_zone.resize(zones.PrendreNbZone());
+
+		for (index_zone = 0; index_zone < _radiation_zone.size(); ++index_zone)
+		{
+			RADIATION_ZONE& radiation = _radiation_zone[index_zone];
+
+			theta = zones[index_zone].PrendreCentroide().PrendreY() / dRAD1;
+			theta1 = _ce1[index_zone] / dRAD1;
+
+			radiation.sin_theta = sin(theta);
+			radiation.cos_theta = cos(theta);
+			radiation.tan_theta = tan(theta);
+			radiation.sin_theta1 = sin(theta1);
+			radiation.cos_theta1 = cos(theta1);
+			radiation.tan_theta1 = tan(theta1);
+			radiation.alpha = _ce0[index_zone] / dRAD1;
+
+			radiation.jour_julien = -1;
+		}
+
+		_radiation_jour_pas = -1;
+		_radiation_heure_pas = -1;
+	}
+
+
+	void DEGRE_JOUR_MODIFIE::CalculIndiceRadiationJour(size_t index_zone, int jour_julien)
+	{
+		const double w = 15.0 / dRAD1;	// vitesse angulaire de la rotation de la terre
+
+		const RADIATION_JOUR& radiation_jour = _radiation_jour[jour_julien - 1];
+		RADIATION_ZONE& radiation = _radiation_zone[index_zone];
+
+		double alpha, i_j1, i_j2, duree_hor, duree_pte, tampon, t1_pte, t2_pte, t1_hor, t2_hor;
+
+		alpha = radiation.alpha;
 
 		duree_hor = 0.0;
 		duree_pte = 0.0;
 
 		// demi-duree du jour sur une surface horizontale
-		tampon = -tan(theta) * tan(decli);
+		tampon = -radiation.tan_theta * radiation_jour.tan_decli;
 		if (tampon > 1.0)
 			duree_hor = 0.0;
 		else if (tampon < -1.0)
@@ -1062,7 +1053,7 @@ namespace HYDROTEL
 			duree_hor = acos(tampon) / w;
 
 		// duree du jour sur une surface en pente
-		tampon = -tan(theta1) * tan(decli);
+		tampon = -radiation.tan_theta1 * radiation_jour.tan_decli;
 		if (tampon > 1.0)
 			duree_pte = 0.0;
 		else if (tampon < -1.0)
@@ -1079,71 +1070,154 @@ namespace HYDROTEL
 		if (t2_pte > duree_hor)
 			t2_pte = duree_hor;
 
-		// Si le pas de temps de la simulation (en heure) est inferieur a 24h
-		// alors il ne suffit pas de calculer pour une surface en pente la duree du
-		// jour, le leve et le couche du soleil. Mais il faut inclure seulement les
-		// heures qu'on simule.
+		t1_hor = -duree_hor;
+		t2_hor = duree_hor;
 
-		//calculs pour un pas de temps de 24h
+		radiation.duree_hor = duree_hor;
+		radiation.t1_pte = t1_pte;
+		radiation.t2_pte = t2_pte;
+
+		radiation.k_hor = 1.0 / w * radiation.cos_theta * radiation_jour.cos_decli;
+		radiation.k_pte = 1.0 / w * radiation.cos_theta1 * radiation_jour.cos_decli;
 
-		t1_pte_sim = t1_pte;
-		t2_pte_sim = t2_pte;
-		t1_hor_sim = -duree_hor;
-		t2_hor_sim = duree_hor;
+		radiation.sin_t1_hor = sin(w * t1_hor);
+		radiation.sin_t2_hor = sin(w * t2_hor);
+		radiation.sin_t1_pte = sin(w * t1_pte + alpha);
+		radiation.sin_t2_pte = sin(w * t2_pte + alpha);
 
-		i_j1 = 0.0;
-		i_j2 = 0.0;
+		//calculs pour un pas de temps de 24h
 
 		// calcul de l'ensoleillement d'une surface horizontale
-		if (t1_hor_sim > t2_hor_sim) 
+		if (t1_hor > t2_hor) 
 			i_j1 = 0.0;
 		else
-			i_j1 = 3600.0 * i_e2 * ((t2_hor_sim - t1_hor_sim) * sin(theta) * sin(decli) + 1.0 / w * cos(theta) * cos(decli) * (sin(w * t2_hor_sim) - sin(w * t1_hor_sim)));
+			i_j1 = radiation_jour.i_e2 * ((t2_hor - t1_hor) * radiation.sin_theta * radiation_jour.sin_decli + radiation.k_hor * (radiation.sin_t2_hor - radiation.sin_t1_hor));
 
 		// calcul de l'ensoleillement d'une surface en pente
-		if (t1_pte_sim > t2_pte_sim) 
+		if (t1_pte > t2_pte) 
 			i_j2 = 0.0;
 		else
-			i_j2 = 3600.0 * i_e2 * ((t2_pte_sim - t1_pte_sim) * sin(theta1) * sin(decli) + 1.0 / w * cos(theta1)*cos(decli) * (sin(w * t2_pte_sim + alpha) - sin(w * t1_pte_sim + alpha)));
+			i_j2 = radiation_jour.i_e2 * ((t2_pte - t1_pte) * radiation.sin_theta1 * radiation_jour.sin_decli + radiation.k_pte * (radiation.sin_t2_pte - radiation.sin_t1_pte));
 
-		dIndiceRadiation = i_j1 != 0.0 ? fabs(i_j2 / i_j1) : 1.0;
+		radiation.i_j2 = i_j2;
+		radiation.indice_radiation = i_j1 != 0.0 ? fabs(i_j2 / i_j1) : 1.0;
+
+		radiation.jour_julien = jour_julien;
+	}
+
+
+	void DEGRE_JOUR_MODIFIE::CalculIndiceRadiation(DATE_HEURE date_heure, unsigned short pas_de_temps, ZONE& zone, size_t index_zone)
+	{
+		const double w = 15.0 / dRAD1;	// vitesse angulaire de la rotation de la terre
+
+		double i_j1, i_j2, t1_pte_sim, t2_pte_sim, t1_hor_sim, t2_hor_sim, sin_t1_hor, sin_t2_hor, sin_t1_pte, sin_t2_pte, dIndiceRadiation;
+		int jour_julien, heure;
+
+		jour_julien = date_heure.PrendreJourJulien();
+
+		RADIATION_ZONE& radiation = _radiation_zone[index_zone];
+
+		if (radiation.jour_julien != jour_julien)
+			CalculIndiceRadiationJour(index_zone, jour_julien);
 
-		if (pas_de_temps != 24)
+		if (pas_de_temps == 24)
 		{
-			//calculs pour un pas de temps infrieur  24h
+			zone._dRayonnementSolaire = max(0.0, radiation.i_j2);
+			zone._dDureeJour = max(0.0, radiation.duree_hor - -radiation.duree_hor);
+			zone._dIndiceRadiation = radiation.indice_radiation;
 
-			double dIndiceRadiation24H = dIndiceRadiation; 
+			zone.ChangeRayonnementSolaire(max(0.0f, static_cast<float>(radiation.i_j2)));
+			zone.ChangeDureeJour(max(0.0f, static_cast<float>(radiation.duree_hor - -radiation.duree_hor)));
+			zone.ChangeIndiceRadiation(static_cast<float>(radiation.indice_radiation));
+			return;
+		}
 
-			t1 = heure - 12.0;
-			t2 = heure + static_cast<double>(pas_de_temps) - 12.0;
+		// Si le pas de temps de la simulation (en heure) est inferieur a 24h
+		// alors il ne suffit pas de calculer pour une surface en pente la duree du
+		// jour, le leve et le couche du soleil. Mais il faut inclure seulement les
+		// heures qu'on simule.
 
-			t1_pte_sim = max(t1, t1_pte);
-			t2_pte_sim = min(t2, t2_pte);
+		const RADIATION_JOUR& radiation_jour = _radiation_jour[jour_julien - 1];
 
-			t1_hor_sim = max(t1, -duree_hor);
-			t2_hor_sim = min(t2, duree_hor);
+		heure = date_heure.PrendreHeure();
 
-			i_j1 = 0.0;
-			i_j2 = 0.0;
+		if (jour_julien != _radiation_jour_pas || heure != _radiation_heure_pas)
+		{
+			_radiation_t1 = static_cast<double>(heure) - 12.0;
+			_radiation_t2 = static_cast<double>(heure) + static_cast<double>(pas_de_temps) - 12.0;
 
-			// calcul de l'ensoleillement d'une surface horizontale
-			if (t1_hor_sim > t2_hor_sim) 
-				i_j1 = 0.0;
-			else
-				i_j1 = 3600.0 * i_e2 * ((t2_hor_sim - t1_hor_sim) * sin(theta) * sin(decli) + 1.0 / w * cos(theta) * cos(decli) * (sin(w * t2_hor_sim) - sin(w * t1_hor_sim)));
+			_radiation_w_t1 = w * _radiation_t1;
+			_radiation_w_t2 = w * _radiation_t2;
 
-			// calcul de l'ensoleillement d'une surface en pente
-			if (t1_pte_sim > t2_pte_sim) 
-				i_j2 = 0.0;
-			else
-				i_j2 = 3600.0 * i_e2 * ((t2_pte_sim - t1_pte_sim) * sin(theta1) * sin(decli) + 1.0 / w * cos(theta1)*cos(decli) * (sin(w * t2_pte_sim + alpha) - sin(w * t1_pte_sim + alpha)));
+			_radiation_sin_t1 = sin(_radiation_w_t1);
+			_radiation_sin_t2 = sin(_radiation_w_t2);
+
+			_radiation_jour_pas = jour_julien;
+			_radiation_heure_pas = heure;
+		}
 
-			dIndiceRadiation = i_j1 != 0.0 ? fabs(i_j2 / i_j1) : 1.0;
+		// bornes du pas de temps (std::max/std::min) et sinus correspondants
+		if (_radiation_t1 < radiation.t1_pte)
+		{
+			t1_pte_sim = radiation.t1_pte;
+			sin_t1_pte = radiation.sin_t1_pte;
+		}
+		else
+		{
+			t1_pte_sim = _radiation_t1;
+			sin_t1_pte = sin(_radiation_w_t1 + radiation.alpha);
+		}
 
-			if(dIndiceRadiation24H < dIndiceRadiation)
-				dIndiceRadiation = dIndiceRadiation24H;
+		if (radiation.t2_pte < _radiation_t2)
+		{
+			t2_pte_sim = radiation.t2_pte;
+			sin_t2_pte = radiation.sin_t2_pte;
+		}
+		else
+		{
+			t2_pte_sim = _radiation_t2;
+			sin_t2_pte = sin(_radiation_w_t2 + radiation.alpha);
+		}
+
+		if (_radiation_t1 < -radiation.duree_hor)
+		{
+			t1_hor_sim = -radiation.duree_hor;
+			sin_t1_hor = radiation.sin_t1_hor;
+		}
+		else
+		{
+			t1_hor_sim = _radiation_t1;
+			sin_t1_hor = _radiation_sin_t1;
 		}
 
+		if (radiation.duree_hor < _radiation_t2)
+		{
+			t2_hor_sim = radiation.duree_hor;
+			sin_t2_hor = radiation.sin_t2_hor;
+		}
+		else
+		{
+			t2_hor_sim = _radiation_t2;
+			sin_t2_hor = _radiation_sin_t2;
+		}
+
+		// calcul de l'ensoleillement d'une surface horizontale
+		if (t1_hor_sim > t2_hor_sim) 
+			i_j1 = 0.0;
+		else
+			i_j1 = radiation_jour.i_e2 * ((t2_hor_sim - t1_hor_sim) * radiation.sin_theta * radiation_jour.sin_decli + radiation.k_hor * (sin_t2_hor - sin_t1_hor));
+
+		// calcul de l'ensoleillement d'une surface en pente
+		if (t1_pte_sim > t2_pte_sim) 
+			i_j2 = 0.0;
+		else
+			i_j2 = radiation_jour.i_e2 * ((t2_pte_sim - t1_pte_sim) * radiation.sin_theta1 * radiation_jour.sin_decli + radiation.k_pte * (sin_t2_pte - sin_t1_pte));
+
+		dIndiceRadiation = i_j1 != 0.0 ? fabs(i_j2 / i_j1) : 1.0;
+
+		if (radiation.indice_radiation < dIndiceRadiation)
+			dIndiceRadiation = radiation.indice_radiation;
+
 		zone._dRayonnementSolaire = max(0.0, i_j2);
 		zone._dDureeJour = max(0.0, t2_hor_sim - t1_hor_sim);
 		zone._dIndiceRadiation = dIndiceRadiation;
@@ -2134,6 +2208,48 @@ namespace HYDROTEL
 
 	void DEGRE_JOUR_MODIFIE::LectureEtat(DATE_HEURE date_courante)
 	{
+		TRACE_PERFORMANCE trace("DEGRE_JOUR_MODIFIE::LectureEtat");
+
+		if(ETAT_BINAIRE::EstBinaire(_nom_fichier_lecture_etat))
+		{
+			ETAT_BINAIRE etat;
+			etat.Lecture(_nom_fichier_lecture_etat, 15);
+
+			vector<size_t> index_ligne = etat.AssocieIndex(_sim_hyd.PrendreZones(), _sim_hyd.PrendreZonesSimules(), "FONTE_NEIGE; fichier etat DEGRE_JOUR_MODIFIE");
+
+			for(size_t ligne=0; ligne<index_ligne.size(); ligne++)
+			{
+				const size_t index_zone = index_ligne[ligne];
+
+				if(index_zone != string::npos)
+				{
+					const double* valeurs = etat.PrendreLigne(ligne);
+
+					_stock_conifers[index_zone] = static_cast<float>(valeurs[0]);
+					_stock_feuillus[index_zone] = static_cast<float>(valeurs[1]);
+					_stock_decouver[index_zone] = static_cast<float>(valeurs[2]);
+
+					_hauteur_conifers[index_zone] = static_cast<float>(valeurs[3]);
+					_hauteur_feuillus[index_zone] = static_cast<float>(valeurs[4]);
+					_hauteur_decouver[index_zone] = static_cast<float>(valeurs[5]);
+
+					_chaleur_conifers[index_zone] = static_cast<float>(valeurs[6]);
+					_chaleur_feuillus[index_zone] = static_cast<float>(valeurs[7]);
+					_chaleur_decouver[index_zone] = static_cast<float>(valeurs[8]);
+
+					_eau_retenu_conifers[index_zone] = static_cast<float>(valeurs[9]);
+					_eau_retenu_feuillus[index_zone] = static_cast<float>(valeurs[10]);
+					_eau_retenu_decouver[index_zone] = static_cast<float>(valeurs[11]);
+
+					_albedo_conifers[index_zone] = static_cast<float>(valeurs[12]);
+					_albedo_feuillus[index_zone] = static_cast<float>(valeurs[13]);
+					_albedo_decouver[index_zone] = static_cast<float>(valeurs[14]);
+				}
+			}
+
+			return;
+		}
+
 		ifstream fichier(_nom_fichier_lecture_etat);
 		if (!fichier)
 			throw ERREUR_LECTURE_FICHIER("FONTE_NEIGE; fichier etat DEGRE_JOUR_MODIFIE; " + _nom_fichier_lecture_etat);
@@ -2195,6 +2311,8 @@ namespace HYDROTEL
 
 	void DEGRE_JOUR_MODIFIE::SauvegardeEtat(DATE_HEURE date_courante) const
 	{
+		TRACE_PERFORMANCE trace("DEGRE_JOUR_MODIFIE::SauvegardeEtat");
+
 		BOOST_ASSERT(_repertoire_ecriture_etat.size() != 0);
 
 		date_courante.AdditionHeure( _sim_hyd.PrendrePasDeTemps() );
@@ -2216,7 +2334,48 @@ namespace HYDROTEL
 			        << setw(2) << date_courante.PrendreMois() 
 			        << setw(2) << date_courante.PrendreJour() 
 			        << setw(2) << date_courante.PrendreHeure() 
-					<< ".csv";
+					<< _pOutput->ExtensionFichiersEtats();
+
+		if(_pOutput->_bFichiersEtatsBinaire)
+		{
+			ZONES& zones = _sim_hyd.PrendreZones();
+			ETAT_BINAIRE etat;
+
+			etat.Initialise(PrendreNomSousModele(), date_courante, 
+				{ "STOCK CONIFERS", "STOCK FEUILLUS", "STOCK DECOUVERT", 
+				  "HAUTEUR CONIFERS", "HAUTEUR FEUILLUS", "HAUTEUR DECOUVERT", 
+				  "CHALEUR CONIFERS", "CHALEUR FEUILLUS", "CHALEUR DECOUVERT", 
+				  "EAU RETENUE CONIFERS", "EAU RETENUE FEUILLUS", "EAU RETENUE DECOUVERT", 
+				  "ALBEDO CONIFERS", "ALBEDO FEUILLUS", "ALBEDO DECOUVERT" }, _sim_hyd.PrendreZonesSimules().size());
+
+			for(size_t index_zone : _sim_hyd.PrendreZonesSimules())
+			{
+				double* valeurs = etat.AjouteLigne(zones[index_zone].PrendreIdent());
+
+				valeurs[0] = _stock_conifers[index_zone];
+				valeurs[1] = _stock_feuillus[index_zone];
+				valeurs[2] = _stock_decouver[index_zone];
+
+				valeurs[3] = _hauteur_conifers[index_zone];
+				valeurs[4] = _hauteur_feuillus[index_zone];
+				valeurs[5] = _hauteur_decouver[index_zone];
+
+				valeurs[6] = _chaleur_conifers[index_zone];
+				valeurs[7] = _chaleur_feuillus[index_zone];
+				valeurs[8] = _chaleur_decouver[index_zone];
+
+				valeurs[9] = _eau_retenu_conifers[index_zone];
+				valeurs[10] = _eau_retenu_feuillus[index_zone];
+				valeurs[11] = _eau_retenu_decouver[index_zone];
+
+				valeurs[12] = _albedo_conifers[index_zone];
+				valeurs[13] = _albedo_feuillus[index_zone];
+				valeurs[14] = _albedo_decouver[index_zone];
+			}
+
+			etat.Sauvegarde(nom_fichier.str());
+			return;
+		}
 
 		ofstream fichier(nom_fichier.str());
 		if (!fichier)
@@ -2719,4 +2878,51 @@ namespace HYDROTEL
 		return _date_sauvegarde_etat;
 	}
 
+
+	void DEGRE_JOUR_MODIFIE::SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const
+	{
+		etat.Ecrit(_stock_conifers);
+		etat.Ecrit(_stock_feuillus);
+		etat.Ecrit(_stock_decouver);
+
+		etat.Ecrit(_hauteur_conifers);
+		etat.Ecrit(_hauteur_feuillus);
+		etat.Ecrit(_hauteur_decouver);
+
+		etat.Ecrit(_chaleur_conifers);
+		etat.Ecrit(_chaleur_feuillus);
+		etat.Ecrit(_chaleur_decouver);
+
+		etat.Ecrit(_eau_retenu_conifers);
+		etat.Ecrit(_eau_retenu_feuillus);
+		etat.Ecrit(_eau_retenu_decouver);
+
+		etat.Ecrit(_albedo_conifers);
+		etat.Ecrit(_albedo_feuillus);
+		etat.Ecrit(_albedo_decouver);
+	}
+
+	void DEGRE_JOUR_MODIFIE::LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur)
+	{
+		lecteur.Lit(_stock_conifers);
+		lecteur.Lit(_stock_feuillus);
+		lecteur.Lit(_stock_decouver);
+
+		lecteur.Lit(_hauteur_conifers);
+		lecteur.Lit(_hauteur_feuillus);
+		lecteur.Lit(_hauteur_decouver);
+
+		lecteur.Lit(_chaleur_conifers);
+		lecteur.Lit(_chaleur_feuillus);
+		lecteur.Lit(_chaleur_decouver);
+
+		lecteur.Lit(_eau_retenu_conifers);
+		lecteur.Lit(_eau_retenu_feuillus);
+		lecteur.Lit(_eau_retenu_decouver);
+
+		lecteur.Lit(_albedo_conifers);
+		lecteur.Lit(_albedo_feuillus);
+		lecteur.Lit(_albedo_decouver);
+	}
+
 }
@@ -61,6 +61,12 @@ namespace HYDROTEL
 
 		virtual void SauvegardeParametres();
 
+		virtual void InitialiseParametres();
+
+		virtual void SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const;
+
+		virtual void LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur);
+
 		/// retourne le taux de fonte (mm/jour) 
 		float PrendreTauxFonte(size_t index_zone) const;
 
@@ -145,6 +151,10 @@ namespace HYDROTEL
 
 	private:
 
+		void InitialiseIndiceRadiation();
+
+		void CalculIndiceRadiationJour(size_t index_zone, int jour_julien);
+
 		void CalculIndiceRadiation(DATE_HEURE date_heure, unsigned short pas_de_temps, ZONE& zone, size_t index_zone);
 
 		float ConductiviteNeige(float densite);
@@ -238,14 +248,61 @@ namespace HYDROTEL
 		MOYENNE_3_STATIONS1*	_pMoy3station1;		//
 		MOYENNE_3_STATIONS2*	_pMoy3station2;		//
 
-		std::ofstream		_fichier_couvert_nival;
-		std::ofstream		_fichier_hauteur_neige;
-		std::ofstream		_fichier_albedo_neige;
+		OUTPUT_CSV			_fichier_couvert_nival;
+		OUTPUT_CSV			_fichier_hauteur_neige;
+		OUTPUT_CSV			_fichier_albedo_neige;
 
 		std::vector<float> _ce1;
 		std::vector<float> _ce0;
 		std::vector<float> _tsn;
 
+		// indice de radiation; termes constants calcules a l'initialisation, termes journaliers recalcules au changement de jour
+
+		struct RADIATION_JOUR			//par jour julien
+		{
+			double i_e2;				//3600 * i0 / e2
+			double sin_decli;
+			double cos_decli;
+			double tan_decli;
+		};
+
+		struct RADIATION_ZONE
+		{
+			double sin_theta;			//surface horizontale
+			double cos_theta;
+			double tan_theta;
+			double sin_theta1;			//surface en pente
+			double cos_theta1;
+			double tan_theta1;
+			double alpha;
+
+			int jour_julien;			//jour des termes journaliers (-1 si non calcules)
+
+			double duree_hor;			//demi-duree du jour sur une surface horizontale
+			double t1_pte;				//leve et couche du soleil pour une surface en pente
+			double t2_pte;
+			double k_hor;				//1 / w * cos(theta) * cos(decli)
+			double k_pte;				//1 / w * cos(theta1) * cos(decli)
+			double sin_t1_hor;			//sin(w * -duree_hor)
+			double sin_t2_hor;			//sin(w * duree_hor)
+			double sin_t1_pte;			//sin(w * t1_pte + alpha)
+			double sin_t2_pte;			//sin(w * t2_pte + alpha)
+			double i_j2;				//ensoleillement 24h d'une surface en pente
+			double indice_radiation;	//indice 24h
+		};
+
+		std::vector<RADIATION_JOUR> _radiation_jour;	//[jour julien - 1]
+		std::vector<RADIATION_ZONE> _radiation_zone;	//[index zone]
+
+		int _radiation_jour_pas;		//pas de temps des termes _radiation_t1...
+		int _radiation_heure_pas;
+		double _radiation_t1;
+		double _radiation_t2;
+		double _radiation_w_t1;			//w * t1
+		double _radiation_w_t2;
+		double _radiation_sin_t1;		//sin(w * t1)
+		double _radiation_sin_t2;
+
 		std::vector<float> _stock_feuillus;		//stock (en eau) de neige [m]
 		std::vector<float> _stock_conifers;		//stock (en eau) de neige [m]
 		std::vector<float> _stock_decouver;		//stock (en eau) de neige [m]
@@ -276,9 +333,9 @@ namespace HYDROTEL
 
 		OUTPUT*				_pOutput;
 
-		float*				_netCdf_couvertnival;
-		float*				_netCdf_hauteurneige;
-		float*				_netCdf_albedoneige;
+		OUTPUT_NETCDF*		_netCdf_couvertnival;
+		OUTPUT_NETCDF*		_netCdf_hauteurneige;
+		OUTPUT_NETCDF*		_netCdf_albedoneige;
 	};
 
 }
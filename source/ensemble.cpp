@@ -0,0 +1,317 @@
+//
+// HYDROTEL a spatially distributed hydrological model
+// Copyright (C) 2013 INRS Eau Terre Environnement
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+// USA
+//
+
+#include "ensemble.hpp"
+
+#include "erreur.hpp"
+#include "util.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include <boost/algorithm/string/case_conv.hpp>
+
+#if !defined(_WIN64) && !defined(_WIN32)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+
+using namespace std;
+
+
+namespace HYDROTEL
+{
+
+	ENSEMBLE::ENSEMBLE(SIM_HYD& sim_hyd, const string& nom_fichier)
+		: _sim_hyd(sim_hyd)
+		, _nom_fichier(nom_fichier)
+	{
+	}
+
+	ENSEMBLE::~ENSEMBLE()
+	{
+	}
+
+
+	//format du fichier: une ligne par membre; le dossier relatif est combine au repertoire du projet
+	//	MEMBRE;01;meteo/prevision/membre01
+	//	MEMBRE;02;meteo/prevision/membre02
+	void ENSEMBLE::Lecture()
+	{
+		vector<string> valeurs;
+		string nom_fichier, ligne, cle;
+		size_t no_ligne;
+
+		nom_fichier = _nom_fichier;
+		if(!Racine(nom_fichier))
+			nom_fichier = Combine(_sim_hyd.PrendreRepertoireSimulation(), nom_fichier);
+
+		ifstream fichier(nom_fichier);
+		if(!fichier)
+			throw ERREUR_LECTURE_FICHIER(nom_fichier);
+
+		_membres.clear();
+		no_ligne = 0;
+
+		while(!fichier.eof())
+		{
+			getline_mod(fichier, ligne);
+			++no_ligne;
+
+			SplitString2(valeurs, ligne, ";", true);
+			if(valeurs.empty())
+				continue;
+
+			cle = boost::algorithm::to_upper_copy(valeurs[0]);
+
+			if(cle != "MEMBRE" || valeurs.size() < 3)
+				throw ERREUR_LECTURE_FICHIER(nom_fichier, static_cast<int>(no_ligne), "expected: MEMBRE;name;grids folder");
+
+			MEMBRE membre;
+
+			membre.nom = valeurs[1];
+			membre.repertoire = valeurs[2];
+
+			if(!Racine(membre.repertoire))
+				membre.repertoire = Combine(_sim_hyd.PrendreRepertoireProjet(), membre.repertoire);
+
+			if(!RepertoireExiste(membre.repertoire))
+				throw ERREUR_LECTURE_FICHIER(nom_fichier, static_cast<int>(no_ligne), "grids folder not found: " + membre.repertoire);
+
+			_membres.push_back(membre);
+		}
+
+		fichier.close();
+
+		if(_membres.empty())
+			throw ERREUR("Ensemble forecast: no member: " + nom_fichier);
+	}
+
+
+	void ENSEMBLE::Execute()
+	{
+		DATE_HEURE date_prevision;
+		size_t index_membre, nb_processus;
+		int nb_thread;
+
+		if(!_sim_hyd._bSimulePrevision)
+			throw ERREUR("Ensemble forecast: the simulation does not use weather forecast grids (FICHIER GRILLE PREVISION).");
+
+		//en mode lecture de l'interpolation, SIM_HYD::Calcule ne lit pas les grilles de prevision: tous les membres donneraient les memes debits
+		if(_sim_hyd._bLectInterpolation)
+			throw ERREUR("Ensemble forecast: the interpolation submodel is in read mode (LECTURE INTERPOLATION DONNEES); the forecast grids of the members would not be used.");
+
+		CreeRepertoire(Combine(_sim_hyd.PrendreRepertoireResultat(), "ensemble"));
+
+		date_prevision = _sim_hyd._grille_prevision._date_debut_prevision;
+
+		//periode commune (donnees observees) jusqu'au debut des previsions
+		while(_sim_hyd.PrendreDateCourante() < date_prevision)
+			_sim_hyd.Calcule();
+
+		_sim_hyd.SauvegardeEtatMemoire(_etat_prevision);
+
+		nb_thread = _sim_hyd.PrendreNbThread();
+		nb_processus = min(static_cast<size_t>(nb_thread), _membres.size());
+
+#if defined(_WIN64) || defined(_WIN32)
+		nb_processus = 1;
+#endif
+
+		if(nb_processus > 1)
+		{
+			//un membre par processus a la fois; chaque processus est sequentiel (le parallelisme est celui des membres)
+			_sim_hyd._nbThread = 1;
+
+			ExecuteProcessus(nb_processus);
+
+			_sim_hyd._nbThread = nb_thread;
+		}
+		else
+		{
+			for(index_membre=0; index_membre<_membres.size(); index_membre++)
+				SimuleMembre(index_membre);
+		}
+
+		std::cout << endl;
+
+		HYDROTEL::Log("");
+		HYDROTEL::Log("Ensemble forecast: " + to_string(_membres.size()) + " members simulated (" + to_string(nb_processus) + " process)");
+	}
+
+
+	//le processus courant et nb_processus-1 processus enfants (fork) simulent les membres index, index + nb_processus, ...
+	//les enfants partagent les donnees du projet deja lues (copie a l'ecriture); seul l'etat modifie par la simulation est duplique
+	void ENSEMBLE::ExecuteProcessus(size_t nb_processus)
+	{
+#if defined(_WIN64) || defined(_WIN32)
+		(void)nb_processus;
+		throw ERREUR("Ensemble forecast: concurrent members are not available on this platform.");
+#else
+		vector<pid_t> processus;
+		size_t index_processus, index_membre, nb_echec;
+		int statut;
+		pid_t pid;
+
+		std::cout << flush;		//les tampons non vides seraient dupliques dans les enfants
+
+		for(index_processus=1; index_processus<nb_processus; index_processus++)
+		{
+			pid = fork();
+
+			if(pid == -1)
+				break;
+
+			if(pid == 0)
+			{
+				statut = 0;
+
+				try
+				{
+					for(index_membre=index_processus; index_membre<_membres.size(); index_membre+= nb_processus)
+						SimuleMembre(index_membre);
+				}
+				catch(const exception& ex)
+				{
+					std::cout << endl << "Ensemble forecast: " << ex.what() << endl;
+					statut = 1;
+				}
+
+				std::cout << flush;
+				_exit(statut);
+			}
+
+			processus.push_back(pid);
+		}
+
+		//membres des processus qui n'ont pu etre crees: simules par le processus courant
+		string erreur;
+
+		try
+		{
+			for(index_membre=0; index_membre<_membres.size(); index_membre++)
+			{
+				if(index_membre % nb_processus == 0 || index_membre % nb_processus > processus.size())
+					SimuleMembre(index_membre);
+			}
+		}
+		catch(const exception& ex)
+		{
+			erreur = ex.what();
+		}
+
+		nb_echec = 0;
+
+		for(index_processus=0; index_processus<processus.size(); index_processus++)
+		{
+			if(waitpid(processus[index_processus], &statut, 0) == -1 || !WIFEXITED(statut) || WEXITSTATUS(statut) != 0)
+				++nb_echec;
+		}
+
+		if(!erreur.empty())
+			throw ERREUR(erreur);
+
+		if(nb_echec != 0)
+			throw ERREUR("Ensemble forecast: " + to_string(nb_echec) + " member process(es) failed; see the messages above.");
+#endif
+	}
+
+
+	void ENSEMBLE::SimuleMembre(size_t index_membre)
+	{
+		OUTPUT& output = _sim_hyd.PrendreOutput();
+		TRONCONS& troncons = _sim_hyd.PrendreTroncons();
+		const MEMBRE& membre = _membres[index_membre];
+		DATE_HEURE date_fin;
+		vector<float> debits;
+		size_t nb_pas, n;
+
+		std::cout << "\r" << "Ensemble forecast: member " << (index_membre + 1) << "/" << _membres.size() << " (" << membre.nom << ")          " << flush;
+
+		date_fin = _sim_hyd.PrendreDateFin();
+
+		_sim_hyd.LectureEtatMemoire(_etat_prevision);
+		_sim_hyd._grille_prevision.ChangeRepertoireGrilles(membre.repertoire);
+
+		nb_pas = 0;
+
+		while(_sim_hyd.PrendreDateCourante() < date_fin)
+		{
+			_sim_hyd.Calcule();
+
+			for(n=0; n<output._tronconOutputNb; n++)
+				debits.push_back(troncons[output._tronconOutputIndex[n]]->PrendreDebitAvalMoyen());
+
+			++nb_pas;
+		}
+
+		SauvegardeDebits(membre, debits, nb_pas);
+	}
+
+
+	void ENSEMBLE::SauvegardeDebits(const MEMBRE& membre, const vector<float>& debits, size_t nb_pas)
+	{
+		OUTPUT& output = _sim_hyd.PrendreOutput();
+		string nom_fichier, sep;
+		DATE_HEURE date;
+		size_t pas, n;
+
+		nom_fichier = Combine(Combine(_sim_hyd.PrendreRepertoireResultat(), "ensemble"), "debit_aval_" + membre.nom + ".csv");
+		sep = output.Separator();
+
+		ofstream fichier(nom_fichier);
+		if(!fichier)
+			throw ERREUR_ECRITURE_FICHIER(nom_fichier);
+
+		fichier << "Dbit en aval du tronon (m3/s)" << sep << "MEMBRE " << membre.nom << endl;
+		fichier << "date heure\\troncon" << sep;
+		for(n=0; n<output._tronconOutputNb; n++)
+		{
+			fichier << output._tronconOutputIDs[n];
+			if(n != output._tronconOutputNb - 1)
+				fichier << sep;
+		}
+		fichier << endl;
+
+		fichier << setprecision(output._nbDigit_m3s) << setiosflags(ios::fixed);
+
+		date = _sim_hyd._grille_prevision._date_debut_prevision;
+
+		for(pas=0; pas<nb_pas; pas++)
+		{
+			fichier << date;
+
+			for(n=0; n<output._tronconOutputNb; n++)
+				fichier << sep << debits[pas * output._tronconOutputNb + n];
+
+			fichier << endl;
+
+			date.AdditionHeure(_sim_hyd.PrendrePasDeTemps());
+		}
+
+		fichier.close();
+		if(fichier.fail())
+			throw ERREUR_ECRITURE_FICHIER(nom_fichier);
+	}
+
+}
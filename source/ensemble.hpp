@@ -0,0 +1,79 @@
+//
+// HYDROTEL a spatially distributed hydrological model
+// Copyright (C) 2013 INRS Eau Terre Environnement
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+// USA
+//
+
+#ifndef ENSEMBLE_H_INCLUDED
+#define ENSEMBLE_H_INCLUDED
+
+
+#include "sim_hyd.hpp"
+#include "etat_memoire.hpp"
+
+
+namespace HYDROTEL
+{
+
+	//prevision d'ensemble (GRILLE_PREVISION): les membres sont simules dans le meme processus a partir de l'etat
+	//commun a la date de debut des previsions; le projet (zones, troncons, hgm, parametres, donnees meteo) n'est lu qu'une fois
+	//avec -t <n> (n > 1), n membres sont simules en meme temps par des processus enfants (fork) qui partagent ces donnees
+	//en copie a l'ecriture; chaque processus a son propre etat de simulation (restaure de l'etat commun) et ses grilles de prevision
+	//sous Windows (pas de fork), les membres sont simules l'un apres l'autre
+	class ENSEMBLE
+	{
+	public:
+		ENSEMBLE(SIM_HYD& sim_hyd, const std::string& nom_fichier);
+
+		~ENSEMBLE();
+
+		/// lecture du fichier des membres (MEMBRE;nom;dossier des grilles)
+		void Lecture();
+
+		/// simule la periode commune puis les membres (en parallele si plus d'un thread); doit etre appele apres SIM_HYD::Initialise
+		/// refuse le mode lecture de l'interpolation (les grilles de prevision ne seraient pas lues)
+		/// la simulation est laissee a la date de fin d'un membre, prete pour SIM_HYD::Termine
+		void Execute();
+
+	private:
+
+		struct MEMBRE
+		{
+			std::string				nom;
+			std::string				repertoire;		//dossier des fichiers de grilles du membre
+		};
+
+		//simule les membres repartis entre nb_processus processus (le processus courant et des enfants)
+		void ExecuteProcessus(size_t nb_processus);
+
+		//simule un membre a partir de l'etat commun et sauvegarde ses debits
+		void SimuleMembre(size_t index_membre);
+
+		//debits aval des troncons de sortie (output.csv) pour un membre
+		void SauvegardeDebits(const MEMBRE& membre, const std::vector<float>& debits, size_t nb_pas);
+
+		SIM_HYD& _sim_hyd;
+		std::string _nom_fichier;
+
+		std::vector<MEMBRE> _membres;
+
+		ETAT_MEMOIRE _etat_prevision;		//etat commun a la date de debut des previsions
+	};
+
+}
+
+#endif
@@ -0,0 +1,279 @@
+//
+// HYDROTEL a spatially distributed hydrological model
+// Copyright (C) 2013 INRS Eau Terre Environnement
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+// USA
+//
+
+#include "etat_binaire.hpp"
+
+#include "erreur.hpp"
+#include "troncons.hpp"
+#include "zones.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+#include <boost/assert.hpp>
+
+
+using namespace std;
+
+
+namespace HYDROTEL
+{
+
+	namespace
+	{
+		const char ETAT_SIGNATURE[8] = { 'H', 'Y', 'D', 'E', 'T', 'A', 'T', 'B' };
+		const uint32_t ETAT_VERSION = 1;
+
+		const size_t TAILLE_NOM = 32;		//nom de colonne; termine par 0
+
+		//fichier binaire: entete, noms des colonnes (char[TAILLE_NOM]), identifiants (int32) [nb ligne], valeurs (double) [nb ligne * nb colonne]
+		struct ENTETE_ETAT
+		{
+			char			signature[8];
+			uint32_t		version;
+			uint32_t		nb_colonne;
+			uint64_t		nb_ligne;
+			uint16_t		annee;
+			uint16_t		mois;
+			uint16_t		jour;
+			uint16_t		heure;
+			char			sous_modele[64];
+		};
+	}
+
+
+	ETAT_BINAIRE::ETAT_BINAIRE()
+	{
+	}
+
+	ETAT_BINAIRE::~ETAT_BINAIRE()
+	{
+	}
+
+	void ETAT_BINAIRE::Initialise(const string& sous_modele, const DATE_HEURE& date_heure, const vector<string>& colonnes, size_t nb_ligne)
+	{
+		_sous_modele = sous_modele;
+		_date_heure = date_heure;
+		_colonnes = colonnes;
+
+		_idents.clear();
+		_idents.reserve(nb_ligne);
+
+		_valeurs.clear();
+		_valeurs.reserve(nb_ligne * colonnes.size());
+	}
+
+	double* ETAT_BINAIRE::AjouteLigne(int ident)
+	{
+		_idents.push_back(static_cast<int32_t>(ident));
+		_valeurs.resize(_valeurs.size() + _colonnes.size(), 0.0);
+
+		return _valeurs.data() + _valeurs.size() - _colonnes.size();
+	}
+
+	void ETAT_BINAIRE::Sauvegarde(const string& nom_fichier) const
+	{
+		ENTETE_ETAT entete;
+
+		memset(&entete, 0, sizeof(entete));
+		memcpy(entete.signature, ETAT_SIGNATURE, sizeof(ETAT_SIGNATURE));
+		entete.version = ETAT_VERSION;
+		entete.nb_colonne = static_cast<uint32_t>(_colonnes.size());
+		entete.nb_ligne = _idents.size();
+		entete.annee = _date_heure.PrendreAnnee();
+		entete.mois = _date_heure.PrendreMois();
+		entete.jour = _date_heure.PrendreJour();
+		entete.heure = _date_heure.PrendreHeure();
+		_sous_modele.copy(entete.sous_modele, sizeof(entete.sous_modele) - 1);
+
+		vector<char> noms(_colonnes.size() * TAILLE_NOM, 0);
+		for(size_t i=0; i<_colonnes.size(); i++)
+			_colonnes[i].copy(noms.data() + i * TAILLE_NOM, TAILLE_NOM - 1);
+
+		ofstream fichier(nom_fichier, ios::binary | ios::trunc);
+		if (!fichier)
+			throw ERREUR_ECRITURE_FICHIER(nom_fichier);
+
+		fichier.write(reinterpret_cast<const char*>(&entete), sizeof(entete));
+		fichier.write(noms.data(), static_cast<streamsize>(noms.size()));
+		fichier.write(reinterpret_cast<const char*>(_idents.data()), static_cast<streamsize>(_idents.size() * sizeof(int32_t)));
+		fichier.write(reinterpret_cast<const char*>(_valeurs.data()), static_cast<streamsize>(_valeurs.size() * sizeof(double)));
+		fichier.close();
+
+		if (!fichier)
+			throw ERREUR_ECRITURE_FICHIER(nom_fichier);
+	}
+
+	void ETAT_BINAIRE::Lecture(const string& nom_fichier, size_t nb_colonne_min)
+	{
+		ifstream fichier(nom_fichier, ios::binary | ios::ate);
+		if (!fichier)
+			throw ERREUR_LECTURE_FICHIER(nom_fichier);
+
+		const size_t taille = static_cast<size_t>(fichier.tellg());
+		fichier.seekg(0);
+
+		vector<char> donnees(taille);
+		if (taille != 0 && !fichier.read(donnees.data(), static_cast<streamsize>(taille)))
+			throw ERREUR_LECTURE_FICHIER(nom_fichier);
+
+		fichier.close();
+
+		ENTETE_ETAT entete;
+
+		if (taille < sizeof(ENTETE_ETAT))
+			throw ERREUR_LECTURE_FICHIER(nom_fichier, 0, "invalid binary state file");
+
+		memcpy(&entete, donnees.data(), sizeof(entete));
+
+		if (memcmp(entete.signature, ETAT_SIGNATURE, sizeof(ETAT_SIGNATURE)) != 0)
+			throw ERREUR_LECTURE_FICHIER(nom_fichier, 0, "invalid binary state file");
+
+		if (entete.version != ETAT_VERSION)
+			throw ERREUR_LECTURE_FICHIER(nom_fichier, 0, "unsupported binary state file version");
+
+		const size_t nb_colonne = entete.nb_colonne;
+		const size_t nb_ligne = static_cast<size_t>(entete.nb_ligne);
+
+		if (nb_colonne < nb_colonne_min)
+			throw ERREUR_LECTURE_FICHIER(nom_fichier, 0, "missing columns in binary state file");
+
+		if (taille != sizeof(ENTETE_ETAT) + nb_colonne * TAILLE_NOM + nb_ligne * sizeof(int32_t) + nb_ligne * nb_colonne * sizeof(double))
+			throw ERREUR_LECTURE_FICHIER(nom_fichier, 0, "invalid binary state file size");
+
+		const char* pos = donnees.data() + sizeof(ENTETE_ETAT);
+
+		_nom_fichier = nom_fichier;
+		_sous_modele.assign(entete.sous_modele, strnlen(entete.sous_modele, sizeof(entete.sous_modele)));
+		_date_heure = DATE_HEURE(entete.annee, entete.mois, entete.jour, entete.heure);
+
+		_colonnes.resize(nb_colonne);
+		for(size_t i=0; i<nb_colonne; i++, pos+= TAILLE_NOM)
+			_colonnes[i].assign(pos, strnlen(pos, TAILLE_NOM));
+
+		_idents.resize(nb_ligne);
+		if (nb_ligne != 0)
+			memcpy(_idents.data(), pos, nb_ligne * sizeof(int32_t));
+		pos+= nb_ligne * sizeof(int32_t);
+
+		_valeurs.resize(nb_ligne * nb_colonne);
+		if (!_valeurs.empty())
+			memcpy(_valeurs.data(), pos, _valeurs.size() * sizeof(double));
+	}
+
+	bool ETAT_BINAIRE::EstBinaire(const string& nom_fichier)
+	{
+		char signature[sizeof(ETAT_SIGNATURE)];
+
+		ifstream fichier(nom_fichier, ios::binary);
+		if (!fichier || !fichier.read(signature, sizeof(signature)))
+			return false;
+
+		return memcmp(signature, ETAT_SIGNATURE, sizeof(ETAT_SIGNATURE)) == 0;
+	}
+
+	vector<size_t> ETAT_BINAIRE::AssocieIndex(ZONES& zones, const vector<size_t>& index_simules, const string& description) const
+	{
+		vector<int> idents(index_simules.size());
+
+		for(size_t i=0; i<index_simules.size(); i++)
+			idents[i] = zones[index_simules[i]].PrendreIdent();
+
+		return AssocieIndex(idents, index_simules, description);
+	}
+
+	vector<size_t> ETAT_BINAIRE::AssocieIndex(TRONCONS& troncons, const vector<size_t>& index_simules, const string& description) const
+	{
+		vector<int> idents(index_simules.size());
+
+		for(size_t i=0; i<index_simules.size(); i++)
+			idents[i] = troncons[index_simules[i]]->PrendreIdent();
+
+		return AssocieIndex(idents, index_simules, description);
+	}
+
+	vector<size_t> ETAT_BINAIRE::AssocieIndex(const vector<int>& idents, const vector<size_t>& index, const string& description) const
+	{
+		BOOST_ASSERT(idents.size() == index.size());
+
+		unordered_map<int, size_t> ident_vers_position;
+		ident_vers_position.reserve(idents.size());
+
+		for(size_t i=0; i<idents.size(); i++)
+			ident_vers_position[idents[i]] = i;
+
+		vector<size_t> index_ligne(_idents.size(), string::npos);
+		vector<char> trouve(idents.size(), 0);
+		size_t nb_trouve = 0;
+
+		for(size_t ligne=0; ligne<_idents.size(); ligne++)
+		{
+			auto it = ident_vers_position.find(_idents[ligne]);
+			if(it != ident_vers_position.end())
+			{
+				index_ligne[ligne] = index[it->second];
+
+				if(!trouve[it->second])
+				{
+					trouve[it->second] = 1;
+					++nb_trouve;
+				}
+			}
+		}
+
+		if(nb_trouve != idents.size())
+			throw ERREUR_LECTURE_FICHIER(description + "; id mismatch; " + _nom_fichier);
+
+		return index_ligne;
+	}
+
+	string ETAT_BINAIRE::PrendreSousModele() const
+	{
+		return _sous_modele;
+	}
+
+	DATE_HEURE ETAT_BINAIRE::PrendreDateHeure() const
+	{
+		return _date_heure;
+	}
+
+	size_t ETAT_BINAIRE::PrendreNbLigne() const
+	{
+		return _idents.size();
+	}
+
+	size_t ETAT_BINAIRE::PrendreNbColonne() const
+	{
+		return _colonnes.size();
+	}
+
+	int ETAT_BINAIRE::PrendreIdent(size_t ligne) const
+	{
+		return _idents[ligne];
+	}
+
+	const double* ETAT_BINAIRE::PrendreLigne(size_t ligne) const
+	{
+		return _valeurs.data() + ligne * _colonnes.size();
+	}
+
+}
@@ -0,0 +1,93 @@
+//
+// HYDROTEL a spatially distributed hydrological model
+// Copyright (C) 2013 INRS Eau Terre Environnement
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+// USA
+//
+
+#ifndef ETAT_BINAIRE_H_INCLUDED
+#define ETAT_BINAIRE_H_INCLUDED
+
+
+#include "date_heure.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace HYDROTEL
+{
+
+	class TRONCONS;
+	class ZONES;
+
+	//fichier d'etat binaire d'un sous-modele (alternative aux fichiers d'etat csv, conserves pour l'echange)
+	//entete versionne, noms des colonnes, index des identifiants (zones ou troncons), valeurs [nb ligne * nb colonne]
+	//le fichier est ecrit et relu en un seul bloc, sans formatage des valeurs
+	class ETAT_BINAIRE
+	{
+	public:
+		ETAT_BINAIRE();
+		~ETAT_BINAIRE();
+
+		//prepare l'ecriture de nb_ligne lignes
+		void Initialise(const std::string& sous_modele, const DATE_HEURE& date_heure, const std::vector<std::string>& colonnes, size_t nb_ligne);
+
+		//ajoute une ligne et retourne ses valeurs a remplir [nb colonne]
+		double* AjouteLigne(int ident);
+
+		void Sauvegarde(const std::string& nom_fichier) const;
+
+		//verifie la signature, la version, la taille du fichier et le nb de colonnes (minimum)
+		void Lecture(const std::string& nom_fichier, size_t nb_colonne_min);
+
+		//vrai si le fichier debute par la signature des fichiers d'etat binaires
+		static bool EstBinaire(const std::string& nom_fichier);
+
+		//retourne l'index de la zone (ou du troncon) simulee de chaque ligne; npos si l'element n'est pas simule
+		//plusieurs lignes peuvent avoir le meme identifiant (ex: bandes d'altitude)
+		//leve une exception si un element simule est absent du fichier
+		std::vector<size_t> AssocieIndex(ZONES& zones, const std::vector<size_t>& index_simules, const std::string& description) const;
+		std::vector<size_t> AssocieIndex(TRONCONS& troncons, const std::vector<size_t>& index_simules, const std::string& description) const;
+
+		std::string PrendreSousModele() const;
+
+		DATE_HEURE PrendreDateHeure() const;
+
+		size_t PrendreNbLigne() const;
+
+		size_t PrendreNbColonne() const;
+
+		int PrendreIdent(size_t ligne) const;
+
+		const double* PrendreLigne(size_t ligne) const;
+
+	private:
+		std::vector<size_t> AssocieIndex(const std::vector<int>& idents, const std::vector<size_t>& index, const std::string& description) const;
+
+		std::string					_nom_fichier;
+		std::string					_sous_modele;
+		DATE_HEURE					_date_heure;
+
+		std::vector<std::string>	_colonnes;
+		std::vector<int32_t>		_idents;		//[ligne]
+		std::vector<double>			_valeurs;		//[ligne * nb colonne]
+	};
+
+}
+
+#endif
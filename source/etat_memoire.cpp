@@ -0,0 +1,109 @@
+//
+// HYDROTEL a spatially distributed hydrological model
+// Copyright (C) 2013 INRS Eau Terre Environnement
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+// USA
+//
+
+#include "etat_memoire.hpp"
+
+
+using namespace std;
+
+
+namespace HYDROTEL
+{
+
+	ETAT_MEMOIRE::ETAT_MEMOIRE()
+	{
+	}
+
+	ETAT_MEMOIRE::~ETAT_MEMOIRE()
+	{
+	}
+
+	void ETAT_MEMOIRE::Efface()
+	{
+		_donnees.clear();
+	}
+
+	DATE_HEURE ETAT_MEMOIRE::PrendreDateHeure() const
+	{
+		return _date;
+	}
+
+	void ETAT_MEMOIRE::ChangeDateHeure(const DATE_HEURE& date_heure)
+	{
+		_date = date_heure;
+	}
+
+	size_t ETAT_MEMOIRE::PrendreTaille() const
+	{
+		return _donnees.size();
+	}
+
+	void ETAT_MEMOIRE::Ecrit(const string& valeur)
+	{
+		Ecrit(valeur.size());
+		if(!valeur.empty())
+			Ajoute(valeur.data(), valeur.size());
+	}
+
+	void ETAT_MEMOIRE::Ajoute(const void* pDonnees, size_t taille)
+	{
+		size_t position;
+
+		position = _donnees.size();
+		_donnees.resize(position + taille);
+		memcpy(_donnees.data() + position, pDonnees, taille);
+	}
+
+
+	LECTEUR_ETAT_MEMOIRE::LECTEUR_ETAT_MEMOIRE(const ETAT_MEMOIRE& etat)
+		: _etat(etat)
+		, _position(0)
+	{
+	}
+
+	LECTEUR_ETAT_MEMOIRE::~LECTEUR_ETAT_MEMOIRE()
+	{
+	}
+
+	void LECTEUR_ETAT_MEMOIRE::Lit(string& valeur)
+	{
+		size_t nb;
+
+		Lit(nb);
+		valeur.resize(nb);
+		if(nb != 0)
+			Extrait(&valeur[0], nb);
+	}
+
+	bool LECTEUR_ETAT_MEMOIRE::Termine() const
+	{
+		return _position == _etat._donnees.size();
+	}
+
+	void LECTEUR_ETAT_MEMOIRE::Extrait(void* pDonnees, size_t taille)
+	{
+		if(taille > _etat._donnees.size() - _position)
+			throw ERREUR("In-memory state: invalid or incompatible state (read past end of data).");
+
+		memcpy(pDonnees, _etat._donnees.data() + _position, taille);
+		_position+= taille;
+	}
+
+}
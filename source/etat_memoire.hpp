@@ -0,0 +1,140 @@
+//
+// HYDROTEL a spatially distributed hydrological model
+// Copyright (C) 2013 INRS Eau Terre Environnement
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+// USA
+//
+
+#ifndef ETAT_MEMOIRE_H_INCLUDED
+#define ETAT_MEMOIRE_H_INCLUDED
+
+
+#include "date_heure.hpp"
+#include "erreur.hpp"
+
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+
+namespace HYDROTEL
+{
+
+	//copie en memoire de l'etat d'une simulation (variables d'etat de tous les sous-modeles) a une date donnee
+	//les valeurs sont copiees telles quelles (memcpy), sans formatage ni relecture de fichier
+	class ETAT_MEMOIRE
+	{
+	public:
+		ETAT_MEMOIRE();
+		~ETAT_MEMOIRE();
+
+		void Efface();
+
+		DATE_HEURE PrendreDateHeure() const;
+
+		void ChangeDateHeure(const DATE_HEURE& date_heure);
+
+		/// taille des donnees (octets)
+		size_t PrendreTaille() const;
+
+		template<typename T> void Ecrit(const T& valeur)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "ETAT_MEMOIRE::Ecrit: type non copiable");
+			Ajoute(&valeur, sizeof(T));
+		}
+
+		template<typename T> void Ecrit(const std::vector<T>& valeurs)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "ETAT_MEMOIRE::Ecrit: type non copiable");
+
+			Ecrit(valeurs.size());
+			if(!valeurs.empty())
+				Ajoute(valeurs.data(), valeurs.size() * sizeof(T));
+		}
+
+		template<typename T> void Ecrit(const std::vector<std::vector<T>>& valeurs)
+		{
+			Ecrit(valeurs.size());
+			for(size_t i=0; i<valeurs.size(); i++)
+				Ecrit(valeurs[i]);
+		}
+
+		void Ecrit(const std::string& valeur);
+
+	private:
+		friend class LECTEUR_ETAT_MEMOIRE;
+
+		void Ajoute(const void* pDonnees, size_t taille);
+
+		std::vector<char>	_donnees;
+		DATE_HEURE			_date;
+	};
+
+
+	//lecture sequentielle d'un ETAT_MEMOIRE, dans l'ordre d'ecriture
+	//l'etat n'est pas modifie; plusieurs lecteurs peuvent lire le meme etat en parallele
+	class LECTEUR_ETAT_MEMOIRE
+	{
+	public:
+		LECTEUR_ETAT_MEMOIRE(const ETAT_MEMOIRE& etat);
+		~LECTEUR_ETAT_MEMOIRE();
+
+		template<typename T> void Lit(T& valeur)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "LECTEUR_ETAT_MEMOIRE::Lit: type non copiable");
+			Extrait(&valeur, sizeof(T));
+		}
+
+		template<typename T> void Lit(std::vector<T>& valeurs)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "LECTEUR_ETAT_MEMOIRE::Lit: type non copiable");
+
+			size_t nb;
+
+			Lit(nb);
+			valeurs.resize(nb);
+			if(nb != 0)
+				Extrait(valeurs.data(), nb * sizeof(T));
+		}
+
+		template<typename T> void Lit(std::vector<std::vector<T>>& valeurs)
+		{
+			size_t nb;
+
+			Lit(nb);
+			valeurs.resize(nb);
+			for(size_t i=0; i<nb; i++)
+				Lit(valeurs[i]);
+		}
+
+		void Lit(std::string& valeur);
+
+		/// vrai si toutes les donnees ont ete lues
+		bool Termine() const;
+
+	private:
+		void Extrait(void* pDonnees, size_t taille);
+
+		const ETAT_MEMOIRE&	_etat;
+		size_t				_position;
+
+		LECTEUR_ETAT_MEMOIRE& operator= (const LECTEUR_ETAT_MEMOIRE&); //pour eviter warning C4512 sous vc
+	};
+
+}
+
+#endif
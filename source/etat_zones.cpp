@@ -0,0 +1,175 @@
+//
+// HYDROTEL a spatially distributed hydrological model
+// Copyright (C) 2013 INRS Eau Terre Environnement
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+// USA
+//
+
+#include "etat_zones.hpp"
+
+#include "constantes.hpp"
+#include "erreur.hpp"
+
+
+namespace HYDROTEL 
+{
+
+	ETAT_ZONES::ETAT_ZONES()
+		: _nb_zone(0)
+		, _nb_classe_etp(0)
+	{
+	}
+
+	ETAT_ZONES::~ETAT_ZONES()
+	{
+	}
+
+	void ETAT_ZONES::Redimensionne(size_t nb_zone)
+	{
+		_nb_zone = nb_zone;
+		_nb_classe_etp = 0;
+
+		_tmin.assign(nb_zone, VALEUR_MANQUANTE);
+		_tmax.assign(nb_zone, VALEUR_MANQUANTE);
+		_tmin_jour.assign(nb_zone, VALEUR_MANQUANTE);
+		_tmax_jour.assign(nb_zone, VALEUR_MANQUANTE);
+		_pluie.assign(nb_zone, VALEUR_MANQUANTE);
+		_neige.assign(nb_zone, VALEUR_MANQUANTE);
+
+		_couvert_nival.assign(nb_zone, 0.0f);
+		_hauteur_couvert_nival.assign(nb_zone, 0.0f);
+		_albedo_neige.assign(nb_zone, 0.0f);
+		_apport.assign(nb_zone, 0.0f);
+
+		_etp.clear();
+
+		_etr1.assign(nb_zone, VALEUR_MANQUANTE);
+		_etr2.assign(nb_zone, VALEUR_MANQUANTE);
+		_etr3.assign(nb_zone, VALEUR_MANQUANTE);
+
+		_surf.assign(nb_zone, VALEUR_MANQUANTE);
+		_hypo.assign(nb_zone, VALEUR_MANQUANTE);
+		_base.assign(nb_zone, VALEUR_MANQUANTE);
+
+		_theta1.assign(nb_zone, VALEUR_MANQUANTE);
+		_theta2.assign(nb_zone, VALEUR_MANQUANTE);
+		_theta3.assign(nb_zone, VALEUR_MANQUANTE);
+
+		_ecoulement_surf.assign(nb_zone, 0.0f);
+		_ecoulement_hypo.assign(nb_zone, 0.0f);
+		_ecoulement_base.assign(nb_zone, 0.0f);
+		_apport_lateral_uhrh.assign(nb_zone, VALEUR_MANQUANTE);
+	}
+
+	void ETAT_ZONES::ChangeNbClasseEtp(size_t nb_classe)
+	{
+		if (nb_classe == _nb_classe_etp && _etp.size() == _nb_zone * nb_classe)
+			return;
+
+		_nb_classe_etp = nb_classe;
+		_etp.assign(_nb_zone * nb_classe, VALEUR_MANQUANTE);
+	}
+
+	size_t ETAT_ZONES::PrendreNbZone() const
+	{
+		return _nb_zone;
+	}
+
+	size_t ETAT_ZONES::PrendreNbClasseEtp() const
+	{
+		return _nb_classe_etp;
+	}
+
+	void ETAT_ZONES::SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const
+	{
+		etat.Ecrit(_nb_zone);
+		etat.Ecrit(_nb_classe_etp);
+
+		etat.Ecrit(_tmin);
+		etat.Ecrit(_tmax);
+		etat.Ecrit(_tmin_jour);
+		etat.Ecrit(_tmax_jour);
+		etat.Ecrit(_pluie);
+		etat.Ecrit(_neige);
+
+		etat.Ecrit(_couvert_nival);
+		etat.Ecrit(_hauteur_couvert_nival);
+		etat.Ecrit(_albedo_neige);
+		etat.Ecrit(_apport);
+
+		etat.Ecrit(_etp);
+
+		etat.Ecrit(_etr1);
+		etat.Ecrit(_etr2);
+		etat.Ecrit(_etr3);
+
+		etat.Ecrit(_surf);
+		etat.Ecrit(_hypo);
+		etat.Ecrit(_base);
+
+		etat.Ecrit(_theta1);
+		etat.Ecrit(_theta2);
+		etat.Ecrit(_theta3);
+
+		etat.Ecrit(_ecoulement_surf);
+		etat.Ecrit(_ecoulement_hypo);
+		etat.Ecrit(_ecoulement_base);
+		etat.Ecrit(_apport_lateral_uhrh);
+	}
+
+	void ETAT_ZONES::LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur)
+	{
+		size_t nb_zone;
+
+		lecteur.Lit(nb_zone);
+		if(nb_zone != _nb_zone)
+			throw ERREUR("In-memory state: number of zones does not match the simulation.");
+
+		lecteur.Lit(_nb_classe_etp);
+
+		lecteur.Lit(_tmin);
+		lecteur.Lit(_tmax);
+		lecteur.Lit(_tmin_jour);
+		lecteur.Lit(_tmax_jour);
+		lecteur.Lit(_pluie);
+		lecteur.Lit(_neige);
+
+		lecteur.Lit(_couvert_nival);
+		lecteur.Lit(_hauteur_couvert_nival);
+		lecteur.Lit(_albedo_neige);
+		lecteur.Lit(_apport);
+
+		lecteur.Lit(_etp);
+
+		lecteur.Lit(_etr1);
+		lecteur.Lit(_etr2);
+		lecteur.Lit(_etr3);
+
+		lecteur.Lit(_surf);
+		lecteur.Lit(_hypo);
+		lecteur.Lit(_base);
+
+		lecteur.Lit(_theta1);
+		lecteur.Lit(_theta2);
+		lecteur.Lit(_theta3);
+
+		lecteur.Lit(_ecoulement_surf);
+		lecteur.Lit(_ecoulement_hypo);
+		lecteur.Lit(_ecoulement_base);
+		lecteur.Lit(_apport_lateral_uhrh);
+	}
+
+}
@@ -0,0 +1,99 @@
+//
+// HYDROTEL a spatially distributed hydrological model
+// Copyright (C) 2013 INRS Eau Terre Environnement
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+// USA
+//
+
+#ifndef ETAT_ZONES_H_INCLUDED
+#define ETAT_ZONES_H_INCLUDED
+
+
+#include "etat_memoire.hpp"
+
+#include <cstddef>
+#include <vector>
+
+
+namespace HYDROTEL 
+{
+
+	//variables d'etat des zones par pas de temps, stockees par variable (un tableau contigu par variable, indexe par l'index de la zone)
+	//les accesseurs de ZONE lisent et ecrivent dans ces tableaux; les sous-modeles peuvent aussi les parcourir directement
+	class ETAT_ZONES
+	{
+	public:
+		ETAT_ZONES();
+		~ETAT_ZONES();
+
+		/// initialise les tableaux pour le nombre de zone
+		void Redimensionne(size_t nb_zone);
+
+		/// change le nombre de classe d'etp (tableau _etp: [index zone * nb classe + index classe])
+		void ChangeNbClasseEtp(size_t nb_classe);
+
+		size_t PrendreNbZone() const;
+
+		size_t PrendreNbClasseEtp() const;
+
+		/// copie les tableaux dans l'etat en memoire
+		void SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const;
+
+		/// restaure les tableaux (le nombre de zone doit correspondre)
+		void LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur);
+
+	public:
+
+		std::vector<float>		_tmin;					//C
+		std::vector<float>		_tmax;					//C
+		std::vector<float>		_tmin_jour;				//C
+		std::vector<float>		_tmax_jour;				//C
+		std::vector<float>		_pluie;					//mm
+		std::vector<float>		_neige;					//hauteur de precipitation en mm de neige
+
+		std::vector<float>		_couvert_nival;			//equivalent de la neige en eau //mm
+		std::vector<float>		_hauteur_couvert_nival;	//m
+		std::vector<float>		_albedo_neige;			//0-1
+		std::vector<float>		_apport;				//mm	//neige, pluie
+
+		std::vector<float>		_etp;					//mm	//pour chaque classe d'occupation du sol
+
+		std::vector<float>		_etr1;					//mm
+		std::vector<float>		_etr2;					//mm
+		std::vector<float>		_etr3;					//mm
+
+		std::vector<float>		_surf;					//mm
+		std::vector<float>		_hypo;					//mm
+		std::vector<float>		_base;					//mm
+
+		std::vector<float>		_theta1;				//teneur en eau couche 1 pour le pas de temps courant
+		std::vector<float>		_theta2;				//teneur en eau couche 2 pour le pas de temps courant
+		std::vector<float>		_theta3;				//teneur en eau couche 3 pour le pas de temps courant
+
+		std::vector<float>		_ecoulement_surf;		//ecoulement vers le troncon (surface) (m3/s)
+		std::vector<float>		_ecoulement_hypo;		//ecoulement vers le troncon (hypo) (m3/s)
+		std::vector<float>		_ecoulement_base;		//ecoulement vers le troncon (base) (m3/s)
+		std::vector<float>		_apport_lateral_uhrh;	//apport lateral du uhrh vers le troncon (m3/s)
+
+	private:
+
+		size_t		_nb_zone;
+		size_t		_nb_classe_etp;
+	};
+
+}
+
+#endif
@@ -41,6 +41,9 @@ namespace HYDROTEL
 
 	EVAPOTRANSPIRATION::~EVAPOTRANSPIRATION()
 	{
+		//fichiers netcdf non fermes par Termine (exception); OUTPUT_NETCDF ecrit les pas de temps deja calcules
+		if(_netCdf_etp != NULL)
+			delete _netCdf_etp;
 	}
 
 	void EVAPOTRANSPIRATION::ChangeNbParams(const ZONES& zones)
@@ -99,34 +102,25 @@ namespace HYDROTEL
 		if (_sim_hyd.PrendreOutput().SauvegardeEtp())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_etp = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_etp = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "etp.nc"), true, "etp", "mm", "Evapotranspiration potentielle");
 			else
 			{
 				string nom_fichier( Combine(_sim_hyd.PrendreRepertoireResultat(), "etp.csv") );
 
-				_fichier_etp.open(nom_fichier);
+				_fichier_etp.Ouvre(_sim_hyd.PrendreOutput(), nom_fichier, true, _sim_hyd.PrendreOutput()._nbDigit_mm);
 
-				_fichier_etp << "vapotranspiration potentielle total (mm)" << _sim_hyd.PrendreOutput().Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
+				_fichier_etp.Entete() << "vapotranspiration potentielle total (mm)" << _sim_hyd.PrendreOutput().Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (_sim_hyd.PrendreOutput()._bSauvegardeTous || 
-							find(begin(_sim_hyd.PrendreOutput()._vIdTronconSelect), end(_sim_hyd.PrendreOutput()._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(_sim_hyd.PrendreOutput()._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < _sim_hyd.PrendreOutput()._uhrhOutputNb; ++n)
+					oss << zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[n]].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
 
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_etp << str << endl;
+				_fichier_etp.Entete() << str << endl;
 			}
 		}
 	}
@@ -134,7 +128,6 @@ namespace HYDROTEL
 
 	void EVAPOTRANSPIRATION::Calcule()
 	{
-		string str;
 
 		if (_sim_hyd.PrendreOutput().SauvegardeEtp())
 		{
@@ -142,35 +135,20 @@ namespace HYDROTEL
 
 			if (_netCdf_etp != NULL)
 			{
-				size_t i, idx;
+				size_t i;
+				float* pLigne;
 
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_etp->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_etp[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreEtpTotal();
+					pLigne[i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreEtpTotal();
 			}
 			else
 			{
-				ostringstream oss;
-				oss.str("");
-			
-				oss << _sim_hyd.PrendreDateCourante() << _sim_hyd.PrendreOutput().Separator() << setprecision(_sim_hyd.PrendreOutput()._nbDigit_mm) << setiosflags(ios::fixed);
-
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (_sim_hyd.PrendreOutput()._bSauvegardeTous || 
-							find(begin(_sim_hyd.PrendreOutput()._vIdTronconSelect), end(_sim_hyd.PrendreOutput()._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(_sim_hyd.PrendreOutput()._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreEtpTotal() << _sim_hyd.PrendreOutput().Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_etp << str << endl;
+				double* pValeur = _fichier_etp.Ligne(_sim_hyd.PrendreDateCourante());
+
+				for (size_t n = 0; n < _sim_hyd.PrendreOutput()._uhrhOutputNb; ++n)
+					pValeur[n] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[n]].PrendreEtpTotal();
 			}
 		}
 	}
@@ -178,23 +156,21 @@ namespace HYDROTEL
 
 	void EVAPOTRANSPIRATION::Termine()
 	{
-		string str1, str2;
+		string str;
 
 		if (_sim_hyd.PrendreOutput().SauvegardeEtp())
 		{
 			if (_netCdf_etp != NULL)
 			{
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "evapotranspiration-etp.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "etp.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "evapotranspiration-etp", _netCdf_etp, "mm", "Evapotranspiration potentielle");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "etp", _netCdf_etp, "mm", "Evapotranspiration potentielle");
-				if(str2 != "")
-					throw ERREUR(str2);
-
-				delete [] _netCdf_etp;
+				str = _netCdf_etp->Ferme();
+				delete _netCdf_etp;
+				_netCdf_etp = NULL;
+
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_etp.close();
+				_fichier_etp.Ferme();
 		}
 	}
 
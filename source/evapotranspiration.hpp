@@ -23,6 +23,8 @@
 
 
 #include "sous_modele.hpp"
+#include "output_netcdf.hpp"
+#include "output_csv.hpp"
 
 #include <fstream>
 
@@ -52,7 +54,7 @@ namespace HYDROTEL
 
 		//NetCDF	
 		//results are kept in memory while running and are saved at the end of the simulation
-		float*				_netCdf_etp;	//[time*stations]
+		OUTPUT_NETCDF*		_netCdf_etp;
 		//
 
 	protected:
@@ -61,7 +63,7 @@ namespace HYDROTEL
 		std::vector<float> _coefficients_multiplicatif;
 
 	private:
-		std::ofstream _fichier_etp;
+		OUTPUT_CSV _fichier_etp;
 	};
 
 }
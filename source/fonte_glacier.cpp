@@ -61,53 +61,35 @@ namespace HYDROTEL
 		if (output.SauvegardeApportGlacier())
 		{
 			string nom_fichier( Combine(_sim_hyd.PrendreRepertoireResultat(), "glacier-apport.csv") );
-			_fichier_out1.open(nom_fichier);
-			_fichier_out1 << "Apport fonte glacier (mm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+			_fichier_out1.Ouvre(output, nom_fichier, true, output._nbDigit_mm);
+			_fichier_out1.Entete() << "Apport fonte glacier (mm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 			ostringstream oss;
 			oss.str("");
 				
-			for (size_t index = 0; index < _nbZone; ++index)
-			{
-				if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-				{
-					if (output._bSauvegardeTous || 
-						find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-					{
-						oss << zones[index].PrendreIdent() << output.Separator();
-					}
-				}
-			}
+			for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+				oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 
 			str = oss.str();
 			str = str.substr(0, str.length()-1); //enleve le dernier separateur
-			_fichier_out1 << str << endl;
+			_fichier_out1.Entete() << str << endl;
 		}
 
 		if (output._eau_glacier)
 		{
 			string nom_fichier( Combine(_sim_hyd.PrendreRepertoireResultat(), "glacier-eau.csv") );
-			_fichier_out2.open(nom_fichier);
-			_fichier_out2 << "Equivalent en eau glacier (m)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+			_fichier_out2.Ouvre(output, nom_fichier, true, output._nbDigit_m);
+			_fichier_out2.Entete() << "Equivalent en eau glacier (m)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 			ostringstream oss;
 			oss.str("");
 
-			for (size_t index = 0; index < _nbZone; ++index)
-			{
-				if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-				{
-					if (output._bSauvegardeTous || 
-						find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-					{
-						oss << zones[index].PrendreIdent() << output.Separator();
-					}
-				}
-			}
+			for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+				oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 
 			str = oss.str();
 			str = str.substr(0, str.length()-1); //enleve le dernier separateur
-			_fichier_out2 << str << endl;
+			_fichier_out2.Entete() << str << endl;
 		}
 	}
 
@@ -117,51 +99,24 @@ namespace HYDROTEL
 		ZONES& zones = _sim_hyd.PrendreZones();
 		OUTPUT& output = _sim_hyd.PrendreOutput();
 
-		string str;
+		double* pValeur1;
+		double* pValeur2;
 		size_t index;
 
 		if (output.SauvegardeApportGlacier() || output._eau_glacier)
 		{
-			ostringstream oss;
-			oss.str("");
+			pValeur1 = output.SauvegardeApportGlacier() ? _fichier_out1.Ligne(_sim_hyd.PrendreDateCourante()) : NULL;
+			pValeur2 = output._eau_glacier ? _fichier_out2.Ligne(_sim_hyd.PrendreDateCourante()) : NULL;	//fichier eau_glacier.csv	//equivalent en eau de la glace [m]
 
-			ostringstream oss2;
-			oss2.str("");
-			
-			if(output.SauvegardeApportGlacier())
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(output._nbDigit_mm) << setiosflags(ios::fixed);
-
-			if(output._eau_glacier)
-				oss2 << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(output._nbDigit_m) << setiosflags(ios::fixed);
-
-			for (index=0; index<_nbZone; index++)
-			{
-				if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-				{
-					if (output._bSauvegardeTous || 
-						find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-					{
-						if(output.SauvegardeApportGlacier())
-							oss << zones[index].PrendreApportGlacier() << output.Separator();
-
-						if(output._eau_glacier)
-							oss2 << zones[index].PrendreEauGlacier() << output.Separator();
-					}
-				}
-			}
-			
-			if(output.SauvegardeApportGlacier())
+			for (size_t n = 0; n < output._uhrhOutputNb; ++n)
 			{
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_out1 << str << endl;
-			}
+				index = output._uhrhOutputIndex[n];
 
-			if(output._eau_glacier)	//fichier eau_glacier.csv	//equivalent en eau de la glace [m]
-			{
-				str = oss2.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_out2 << str << endl;
+				if(pValeur1 != NULL)
+					pValeur1[n] = zones[index].PrendreApportGlacier();
+
+				if(pValeur2 != NULL)
+					pValeur2[n] = zones[index].PrendreEauGlacier();
 			}
 		}
 	}
@@ -172,10 +127,10 @@ namespace HYDROTEL
 		OUTPUT& output = _sim_hyd.PrendreOutput();
 
 		if (output.SauvegardeApportGlacier())
-			_fichier_out1.close();
+			_fichier_out1.Ferme();
 
 		if (output._eau_glacier)
-			_fichier_out2.close();
+			_fichier_out2.Ferme();
 	}
 
 }
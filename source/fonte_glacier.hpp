@@ -23,6 +23,7 @@
 
 
 #include "sous_modele.hpp"
+#include "output_csv.hpp"
 
 #include <fstream>
 
@@ -48,8 +49,8 @@ namespace HYDROTEL
 		std::string				_nom_fichier_out1;
 
 	private:
-		std::ofstream			_fichier_out1;	//apport glacier [mm]
-		std::ofstream			_fichier_out2;	//equivalent en eau de la glace [m]
+		OUTPUT_CSV				_fichier_out1;	//apport glacier [mm]
+		OUTPUT_CSV				_fichier_out2;	//equivalent en eau de la glace [m]
 
 		size_t					_nbZone;
 	};
@@ -42,6 +42,9 @@ namespace HYDROTEL
 
 	FONTE_NEIGE::~FONTE_NEIGE()
 	{
+		//fichiers netcdf non fermes par Termine (exception); OUTPUT_NETCDF ecrit les pas de temps deja calcules
+		if(_netCdf_apport != NULL)
+			delete _netCdf_apport;
 	}
 
 
@@ -50,35 +53,26 @@ namespace HYDROTEL
 		if (_sim_hyd.PrendreOutput().SauvegardeApport())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_apport = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_apport = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "apport.nc"), true, "apport", "mm", "Apport de la fonte de neige et de la pluie");
 			else
 			{
 				string nom_fichier( Combine(_sim_hyd.PrendreRepertoireResultat(), "apport.csv") );
-				_fichier_apport.open(nom_fichier);
+				_fichier_apport.Ouvre(_sim_hyd.PrendreOutput(), nom_fichier, true, _sim_hyd.PrendreOutput()._nbDigit_mm);
 
 				ZONES& zones = _sim_hyd.PrendreZones();
 
-				_fichier_apport << "Apport fonte neige et pluie (mm)" << _sim_hyd.PrendreOutput().Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
+				_fichier_apport.Entete() << "Apport fonte neige et pluie (mm)" << _sim_hyd.PrendreOutput().Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
 
 				string str;
 				ostringstream oss;
 				oss.str("");
 
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (_sim_hyd.PrendreOutput()._bSauvegardeTous || 
-							find(begin(_sim_hyd.PrendreOutput()._vIdTronconSelect), end(_sim_hyd.PrendreOutput()._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(_sim_hyd.PrendreOutput()._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < _sim_hyd.PrendreOutput()._uhrhOutputNb; ++n)
+					oss << zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[n]].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
 
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_apport << str << endl;
+				_fichier_apport.Entete() << str << endl;
 			}
 		}
 	}
@@ -86,7 +80,6 @@ namespace HYDROTEL
 
 	void FONTE_NEIGE::Calcule()
 	{
-		string str;
 
 		if (_sim_hyd.PrendreOutput().SauvegardeApport())
 		{
@@ -94,35 +87,20 @@ namespace HYDROTEL
 
 			if (_netCdf_apport != NULL)
 			{
-				size_t i, idx;
+				size_t i;
+				float* pLigne;
 
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_apport->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_apport[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreApport();
+					pLigne[i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreApport();
 			}
 			else
 			{
-				ostringstream oss;
-				oss.str("");
-			
-				oss << _sim_hyd.PrendreDateCourante() << _sim_hyd.PrendreOutput().Separator() << setprecision(_sim_hyd.PrendreOutput()._nbDigit_mm) << setiosflags(ios::fixed);
-
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (_sim_hyd.PrendreOutput()._bSauvegardeTous || 
-							find(begin(_sim_hyd.PrendreOutput()._vIdTronconSelect), end(_sim_hyd.PrendreOutput()._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(_sim_hyd.PrendreOutput()._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreApport() << _sim_hyd.PrendreOutput().Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_apport << str << endl;
+				double* pValeur = _fichier_apport.Ligne(_sim_hyd.PrendreDateCourante());
+
+				for (size_t n = 0; n < _sim_hyd.PrendreOutput()._uhrhOutputNb; ++n)
+					pValeur[n] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[n]].PrendreApport();
 			}
 		}
 	}
@@ -134,19 +112,17 @@ namespace HYDROTEL
 		{
 			if (_netCdf_apport != NULL)
 			{
-				string str1, str2;
+				string str;
 
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "fonte_neige-apport.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "apport.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "fonte_neige-apport", _netCdf_apport, "mm", "Apport de la fonte de neige et de la pluie");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "apport", _netCdf_apport, "mm", "Apport de la fonte de neige et de la pluie");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_apport->Ferme();
+				delete _netCdf_apport;
+				_netCdf_apport = NULL;
 
-				delete [] _netCdf_apport;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_apport.close();
+				_fichier_apport.Ferme();
 		}
 	}
 
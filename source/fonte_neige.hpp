@@ -23,6 +23,8 @@
 
 
 #include "sous_modele.hpp"
+#include "output_netcdf.hpp"
+#include "output_csv.hpp"
 
 #include <fstream>
 
@@ -49,10 +51,10 @@ namespace HYDROTEL
 		std::string			_nom_fichier_hauteur_neige;
 		std::string			_nom_fichier_albedo_neige;
 
-		float*				_netCdf_apport;
+		OUTPUT_NETCDF*		_netCdf_apport;
 
 	private:
-		std::ofstream _fichier_apport;
+		OUTPUT_CSV _fichier_apport;
 	};
 
 }
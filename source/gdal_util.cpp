@@ -136,6 +136,30 @@ namespace HYDROTEL
 	}
 
 
+	void ReadGeoTIFF_float(const string& nom_fichier, int ligne, int colonne, int nb_ligne, int nb_colonne, float* valeurs)
+	{
+		GDALDataset* dataset = (GDALDataset*)(GDALOpen(nom_fichier.c_str(), GA_ReadOnly));
+		if (dataset == nullptr)
+			throw ERREUR_LECTURE_FICHIER(nom_fichier);
+
+		if(colonne + nb_colonne > dataset->GetRasterXSize() || ligne + nb_ligne > dataset->GetRasterYSize())
+		{
+			GDALClose((GDALDatasetH)dataset);
+			throw ERREUR_LECTURE_FICHIER(nom_fichier + ": dimension de la grille invalide");
+		}
+
+		GDALRasterBand* band = dataset->GetRasterBand(1);
+
+		if(band->RasterIO(GF_Read, colonne, ligne, nb_colonne, nb_ligne, valeurs, nb_colonne, nb_ligne, GDT_Float32, 0, 0) != CE_None)
+		{
+			GDALClose((GDALDatasetH)dataset);
+			throw ERREUR_LECTURE_FICHIER(": RasterIO: " + nom_fichier);
+		}
+
+		GDALClose((GDALDatasetH)dataset);
+	}
+
+
 	RASTER<int> ReadGeoTIFF_int(const string& nom_fichier)
 	{
 		GDALDataset* dataset = (GDALDataset*)(GDALOpen(nom_fichier.c_str(), GA_ReadOnly));
@@ -35,6 +35,9 @@ namespace HYDROTEL
 
 	RASTER<float> ReadGeoTIFF_float(const std::string& nom_fichier);
 
+	//lecture d'une fenetre (ligne, colonne: coin superieur gauche) de la premiere bande; valeurs[nb_ligne * nb_colonne]
+	void ReadGeoTIFF_float(const std::string& nom_fichier, int ligne, int colonne, int nb_ligne, int nb_colonne, float* valeurs);
+
 	RASTER<int> ReadGeoTIFF_int(const std::string& nom_fichier);
 
 	void Polygonize(const std::string& src, const std::string& dst, const std::string& mask);
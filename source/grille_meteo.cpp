@@ -36,6 +36,8 @@ namespace HYDROTEL
 	GRILLE_METEO::GRILLE_METEO(SIM_HYD& sim_hyd)
 		: INTERPOLATION_DONNEES(sim_hyd, "GRILLE")
 	{
+		_iFenetreLigne = _iFenetreColonne = 0;
+		_iFenetreNbLigne = _iFenetreNbColonne = 0;
 	}
 
 	GRILLE_METEO::~GRILLE_METEO()
@@ -100,6 +102,8 @@ namespace HYDROTEL
 			SauvegardeAltitude();
 		}
 
+		InitialiseFenetre();
+
 		INTERPOLATION_DONNEES::Initialise();
 	}
 
@@ -115,6 +119,9 @@ namespace HYDROTEL
 
 	void GRILLE_METEO::Termine()
 	{
+		if(_lectureSuivante.valid())
+			_lectureSuivante.wait();
+
 		INTERPOLATION_DONNEES::Termine();
 	}
 
@@ -675,100 +682,231 @@ namespace HYDROTEL
 	
 	
 	//------------------------------------------------------------------------------------------------
-	void GRILLE_METEO::RepartieDonnees()
+	void GRILLE_METEO::InitialiseFenetre()
 	{
-		string sString, sString2;
-		int iIdent, indexcell;
+		string sPath;
+		int iIdent, indexcell, nbCol, nbRow, row, col, rowMin, rowMax, colMin, colMax;
+		size_t index, x;
 
 		ZONES& zones = _sim_hyd.PrendreZones();
 
-		vector<size_t> index_zones = _sim_hyd.PrendreZonesSimules();
+		const vector<size_t>& index_zones = _sim_hyd.PrendreZonesSimules();
 
-		size_t index_zone, row, col, nbCol;
-		float tmin, tmax, pluie, neige, tmin_jour, tmax_jour, fAltitude, fDiffAlt, fDensiteNeige, fVal, fValGrille;
+		FormatePathFichierGrille(_sim_hyd.PrendreDateDebut(), sPath);
+		sPath+= ".tmin";
 
-		vector<RASTER<float>> grilleTMin;
-		vector<RASTER<float>> grilleTMax;
+		GDALDataset* dataset = (GDALDataset*)(GDALOpen(sPath.c_str(), GA_ReadOnly));
+		if(dataset == nullptr)
+			throw ERREUR("INTERPOLATION DONNEES; GRILLE; erreur de lecture du fichier; " + sPath);
 
-		vector<RASTER<float>> grillePluie;
-		vector<RASTER<float>> grilleNeige;
+		nbCol = dataset->GetRasterXSize();
+		nbRow = dataset->GetRasterYSize();
 
-		vector<RASTER<float>> grillePrecipTot;
-		
-		//if(_sim_hyd.PrendrePasDeTemps() == 24)
+		GDALClose((GDALDatasetH)dataset);
+
+		//bornes des cellules referencees
+		rowMin = nbRow;
+		colMin = nbCol;
+		rowMax = colMax = -1;
 
-		FormatePathFichierGrilleCourant(sString);
+		for (index = 0; index < index_zones.size(); ++index)
+		{
+			iIdent = zones[index_zones[index]].PrendreIdent();
+
+			for (auto iter = begin(_mapPonderation[iIdent]); iter != end(_mapPonderation[iIdent]); iter++)
+			{
+				indexcell = iter->first;
+				row = indexcell / nbCol;
+				col = indexcell % nbCol;
+
+				if(row >= nbRow)
+					throw ERREUR("INTERPOLATION DONNEES; GRILLE; ponderation invalide; cellule hors de la grille meteo; " + sPath);
+
+				rowMin = min(rowMin, row);
+				rowMax = max(rowMax, row);
+				colMin = min(colMin, col);
+				colMax = max(colMax, col);
+			}
+		}
+
+		if(rowMax < 0)
+		{
+			//aucune cellule referencee
+			rowMin = rowMax = colMin = colMax = 0;
+		}
+
+		_iFenetreLigne = rowMin;
+		_iFenetreColonne = colMin;
+		_iFenetreNbLigne = rowMax - rowMin + 1;
+		_iFenetreNbColonne = colMax - colMin + 1;
+
+		//ponderations indexees dans la fenetre
+		_vPonderationDebut.assign(index_zones.size() + 1, 0);
+		_vPonderationCellule.clear();
+		_vPonderationValeur.clear();
+		_vPonderationAltitude.clear();
+
+		for (index = 0; index < index_zones.size(); ++index)
+		{
+			iIdent = zones[index_zones[index]].PrendreIdent();
+
+			_vPonderationDebut[index] = _vPonderationCellule.size();
+
+			for (auto iter = begin(_mapPonderation[iIdent]); iter != end(_mapPonderation[iIdent]); iter++)
+			{
+				indexcell = iter->first;
+				row = indexcell / nbCol - _iFenetreLigne;
+				col = indexcell % nbCol - _iFenetreColonne;
+
+				x = static_cast<size_t>(row) * static_cast<size_t>(_iFenetreNbColonne) + static_cast<size_t>(col);
+				_vPonderationCellule.push_back(x);
+				_vPonderationValeur.push_back(static_cast<float>(iter->second));
+
+				auto iterAlt = _mapAltitudes.find(indexcell);
+				_vPonderationAltitude.push_back(iterAlt != _mapAltitudes.end() ? static_cast<float>(iterAlt->second) : 0.0f);
+			}
+		}
+
+		_vPonderationDebut[index_zones.size()] = _vPonderationCellule.size();
+
+		_grilleCourante.sPath.clear();
+		_grilleSuivante.sPath.clear();
+	}
+
+
+	//------------------------------------------------------------------------------------------------
+	void GRILLE_METEO::LectureGrilleJour(const string& sPath, GRILLE_JOUR& grille) const
+	{
+		TRACE_PERFORMANCE trace("GRILLE_METEO::LectureGrilleJour");
+
+		string sString;
+		size_t nb;
+
+		nb = static_cast<size_t>(_iFenetreNbLigne) * static_cast<size_t>(_iFenetreNbColonne);
+
+		grille.vTMin.resize(nb);
+		grille.vTMax.resize(nb);
+		grille.vPluie.resize(nb);
+		grille.vNeige.resize(_bUseTotalPrecip ? 0 : nb);
 
 		try{
 
 		if(_bUseTotalPrecip)
 		{
-			sString2 = sString + ".prcp";
-			grillePrecipTot.push_back(ReadGeoTIFF_float(sString2));
+			sString = sPath + ".prcp";
+			ReadGeoTIFF_float(sString, _iFenetreLigne, _iFenetreColonne, _iFenetreNbLigne, _iFenetreNbColonne, grille.vPluie.data());
 		}
 		else
 		{
-			sString2 = sString + ".pluie";
-			grillePluie.push_back(ReadGeoTIFF_float(sString2));
+			sString = sPath + ".pluie";
+			ReadGeoTIFF_float(sString, _iFenetreLigne, _iFenetreColonne, _iFenetreNbLigne, _iFenetreNbColonne, grille.vPluie.data());
 
-			sString2 = sString + ".neige";
-			grilleNeige.push_back(ReadGeoTIFF_float(sString2));
+			sString = sPath + ".neige";
+			ReadGeoTIFF_float(sString, _iFenetreLigne, _iFenetreColonne, _iFenetreNbLigne, _iFenetreNbColonne, grille.vNeige.data());
 		}
 
-		sString2 = sString + ".tmin";
-		grilleTMin.push_back(ReadGeoTIFF_float(sString2));
+		sString = sPath + ".tmin";
+		ReadGeoTIFF_float(sString, _iFenetreLigne, _iFenetreColonne, _iFenetreNbLigne, _iFenetreNbColonne, grille.vTMin.data());
+
+		sString = sPath + ".tmax";
+		ReadGeoTIFF_float(sString, _iFenetreLigne, _iFenetreColonne, _iFenetreNbLigne, _iFenetreNbColonne, grille.vTMax.data());
 
-		sString2 = sString + ".tmax";
-		grilleTMax.push_back(ReadGeoTIFF_float(sString2));
-		
 		}
 		catch(...)
 		{
-			throw ERREUR("INTERPOLATION DONNEES; GRILLE; erreur de lecture du fichier; " + sString2);
+			throw ERREUR("INTERPOLATION DONNEES; GRILLE; erreur de lecture du fichier; " + sString);
+		}
+	}
+
+
+	//------------------------------------------------------------------------------------------------
+	void GRILLE_METEO::RepartieDonnees()
+	{
+		string sString;
+		DATE_HEURE date, dateSuivante;
+		size_t x, y;
+
+		ZONES& zones = _sim_hyd.PrendreZones();
+
+		const vector<size_t>& index_zones = _sim_hyd.PrendreZonesSimules();
+
+		size_t index_zone, cell;
+		float tmin, tmax, pluie, neige, tmin_jour, tmax_jour, fAltitude, fDiffAlt, fDensiteNeige, fVal, fValGrille, fPonderation;
+
+		//les grilles sont journalieres; elles sont lues une seule fois par jour
+		date = _sim_hyd.PrendreDateCourante();
+		FormatePathFichierGrille(date, sString);
+
+		if(sString != _grilleCourante.sPath)
+		{
+			if(_lectureSuivante.valid())
+			{
+				if(_grilleSuivante.sPath == sString)
+				{
+					_lectureSuivante.get();	//relance l'erreur de lecture s'il y a lieu
+					swap(_grilleCourante, _grilleSuivante);
+				}
+				else
+					_lectureSuivante.wait();
+			}
+
+			if(sString != _grilleCourante.sPath)
+			{
+				_grilleCourante.sPath.clear();
+				LectureGrilleJour(sString, _grilleCourante);
+				_grilleCourante.sPath = sString;
+			}
+
+			//lecture anticipee des grilles du jour suivant pendant le calcul des pas de temps du jour courant
+			dateSuivante = DATE_HEURE(date.PrendreAnnee(), date.PrendreMois(), date.PrendreJour(), 0) + 24;
+			if(dateSuivante < _sim_hyd.PrendreDateFin())
+			{
+				FormatePathFichierGrille(dateSuivante, _grilleSuivante.sPath);
+				_lectureSuivante = async(launch::async, [this] { LectureGrilleJour(_grilleSuivante.sPath, _grilleSuivante); });
+			}
 		}
 
-		nbCol = grilleTMin[0].PrendreNbColonne();
+		const GRILLE_JOUR& grille = _grilleCourante;
+
 		for (size_t index = 0; index < index_zones.size(); ++index)
 		{
 			index_zone = index_zones[index];
 
 			ZONE& zone = zones[index_zone];
-			iIdent = zone.PrendreIdent();
 			fAltitude = zone.PrendreAltitude();
 
 			tmin = tmax = pluie = neige = tmin_jour = tmax_jour = 0.0f;
 
-			for (auto iter2 = begin(_mapPonderation[iIdent]); iter2 != end(_mapPonderation[iIdent]); iter2++)
+			for (x = _vPonderationDebut[index], y = _vPonderationDebut[index+1]; x < y; x++)
 			{
-				indexcell = iter2->first;
-				row = static_cast<size_t>(indexcell / nbCol);
-				col = indexcell % nbCol;
+				cell = _vPonderationCellule[x];
+				fPonderation = _vPonderationValeur[x];
 
-				fDiffAlt = fAltitude - static_cast<float>(_mapAltitudes[indexcell]);
+				fDiffAlt = fAltitude - _vPonderationAltitude[x];
 
-				if(grilleTMin[0](row, col) > VALEUR_MANQUANTE)
-					tmin+= (grilleTMin[0](row, col) + PrendreGradientTemperature(index_zone) * fDiffAlt / 100.0f) * static_cast<float>(iter2->second);	//iter2->second -> ponderation
+				if(grille.vTMin[cell] > VALEUR_MANQUANTE)
+					tmin+= (grille.vTMin[cell] + PrendreGradientTemperature(index_zone) * fDiffAlt / 100.0f) * fPonderation;
 
-				if(grilleTMax[0](row, col) > VALEUR_MANQUANTE)
-					tmax+= (grilleTMax[0](row, col) + PrendreGradientTemperature(index_zone) * fDiffAlt / 100.0f) * static_cast<float>(iter2->second);	//iter2->second -> ponderation
+				if(grille.vTMax[cell] > VALEUR_MANQUANTE)
+					tmax+= (grille.vTMax[cell] + PrendreGradientTemperature(index_zone) * fDiffAlt / 100.0f) * fPonderation;
 
 				if(_bUseTotalPrecip)
 				{
-					if(grillePrecipTot[0](row, col) > VALEUR_MANQUANTE)
+					if(grille.vPluie[cell] > VALEUR_MANQUANTE)
 					{
-						fValGrille = grillePrecipTot[0](row, col);
-						fVal = (fValGrille * static_cast<float>(iter2->second) * (1.0f + PrendreGradientPrecipitation(index_zone) / 100.0f * fDiffAlt));	//iter2->second -> ponderation
+						fValGrille = grille.vPluie[cell];
+						fVal = (fValGrille * fPonderation * (1.0f + PrendreGradientPrecipitation(index_zone) / 100.0f * fDiffAlt));
 
 						pluie+= fVal;
 					}
 				}
 				else
 				{
-					if(grillePluie[0](row, col) > VALEUR_MANQUANTE)
-						pluie+= (grillePluie[0](row, col) * static_cast<float>(iter2->second) * (1.0f + PrendreGradientPrecipitation(index_zone) / 100.0f * fDiffAlt));	//iter2->second -> ponderation
+					if(grille.vPluie[cell] > VALEUR_MANQUANTE)
+						pluie+= (grille.vPluie[cell] * fPonderation * (1.0f + PrendreGradientPrecipitation(index_zone) / 100.0f * fDiffAlt));
 
-					if(grilleNeige[0](row, col) > VALEUR_MANQUANTE)
-						neige+= (grilleNeige[0](row, col) * static_cast<float>(iter2->second) * (1.0f + PrendreGradientPrecipitation(index_zone) / 100.0f * fDiffAlt));	//iter2->second -> ponderation
+					if(grille.vNeige[cell] > VALEUR_MANQUANTE)
+						neige+= (grille.vNeige[cell] * fPonderation * (1.0f + PrendreGradientPrecipitation(index_zone) / 100.0f * fDiffAlt));
 				}
 
 				//if (tmin_jour_station > VALEUR_MANQUANTE)
@@ -805,13 +943,19 @@ namespace HYDROTEL
 
 
 	void GRILLE_METEO::FormatePathFichierGrilleCourant(string& sPath)
+	{
+		FormatePathFichierGrille(_sim_hyd.PrendreDateCourante(), sPath);
+	}
+
+
+	void GRILLE_METEO::FormatePathFichierGrille(const DATE_HEURE& date, string& sPath) const
 	{
 		ostringstream oss;
 
 		sPath = _sPathFichierGrille + "/" + _sPrefixeNomFichier;
-		oss << _sim_hyd.PrendreDateCourante().PrendreAnnee() << "_";
-		oss << setfill('0') << setw(2) << _sim_hyd.PrendreDateCourante().PrendreMois() << "_";
-		oss << setfill('0') << setw(2) << _sim_hyd.PrendreDateCourante().PrendreJour() << "_";
+		oss << date.PrendreAnnee() << "_";
+		oss << setfill('0') << setw(2) << date.PrendreMois() << "_";
+		oss << setfill('0') << setw(2) << date.PrendreJour() << "_";
 
 		//if(_sim_hyd.PrendrePasDeTemps() == 24)
 			oss << "24h";
@@ -24,6 +24,10 @@
 
 #include "interpolation_donnees.hpp"
 
+#include <future>
+#include <string>
+#include <vector>
+
 
 namespace HYDROTEL
 {
@@ -64,6 +68,8 @@ namespace HYDROTEL
 
 		void FormatePathFichierGrilleCourant(std::string& sPath);
 
+		void FormatePathFichierGrille(const DATE_HEURE& date, std::string& sPath) const;
+
 		//model parameters
 		std::vector<float>					_gradient_precipitations;	// mm/100m
 		std::vector<float>					_gradient_temperature;		// C/100m
@@ -71,6 +77,16 @@ namespace HYDROTEL
 
 	private:
 
+		//valeurs de la fenetre des grilles meteo d'une journee
+		struct GRILLE_JOUR
+		{
+			std::string			sPath;
+			std::vector<float>	vTMin;
+			std::vector<float>	vTMax;
+			std::vector<float>	vPluie;		//pluie ou precipitation totale (.prcp)
+			std::vector<float>	vNeige;
+		};
+
 		void LectureParametresFichierGlobal();
 
 		bool LecturePonderation();
@@ -81,6 +97,9 @@ namespace HYDROTEL
 		void CalculeAltitude();
 		void SauvegardeAltitude();
 
+		void InitialiseFenetre();
+		void LectureGrilleJour(const std::string& sPath, GRILLE_JOUR& grille) const;
+
 		void RepartieDonnees();
 		void PassagePluieNeige();
 
@@ -91,6 +110,22 @@ namespace HYDROTEL
 
 		std::map<int, std::map<int, double>>		_mapPonderation;
 		std::map<int, double>						_mapAltitudes;
+
+		//fenetre des cellules referencees par les zones simulees (seule region lue dans les grilles)
+		int											_iFenetreLigne;
+		int											_iFenetreColonne;
+		int											_iFenetreNbLigne;
+		int											_iFenetreNbColonne;
+
+		//ponderations des zones simulees [index PrendreZonesSimules()]; cellules indexees dans la fenetre
+		std::vector<size_t>							_vPonderationDebut;		//[nb zone simulee + 1]
+		std::vector<size_t>							_vPonderationCellule;
+		std::vector<float>							_vPonderationValeur;
+		std::vector<float>							_vPonderationAltitude;	//altitude de la cellule
+
+		GRILLE_JOUR									_grilleCourante;
+		GRILLE_JOUR									_grilleSuivante;
+		std::future<void>							_lectureSuivante;		//lecture anticipee de _grilleSuivante
 	};
 
 }
@@ -613,6 +613,8 @@ namespace HYDROTEL
 	//------------------------------------------------------------------------------------------------
 	void GRILLE_PREVISION::RepartieDonnees()
 	{
+		TRACE_PERFORMANCE trace("GRILLE_PREVISION::RepartieDonnees");
+
 		string sString, sString2;
 		int iIdent, indexcell;
 
@@ -736,6 +738,23 @@ namespace HYDROTEL
 	}
 
 
+	//------------------------------------------------------------------------------------------------
+	string GRILLE_PREVISION::PrendreRepertoireGrilles() const
+	{
+		return _sPathFichierGrille;
+	}
+
+
+	//------------------------------------------------------------------------------------------------
+	void GRILLE_PREVISION::ChangeRepertoireGrilles(const string& sPath)
+	{
+		if(!RepertoireExiste(sPath))
+			throw ERREUR("GRILLE_PREVISION; le dossier specifie pour les grilles de donnees est invalide; " + sPath);
+
+		_sPathFichierGrille = sPath;
+	}
+
+
 	//------------------------------------------------------------------------------------------------
 	void GRILLE_PREVISION::FormatePathFichierGrilleCourant(string& sPath)
 	{
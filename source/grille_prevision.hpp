@@ -48,6 +48,10 @@ namespace HYDROTEL
 
 		void FormatePathFichierGrilleCourant(std::string& sPath);
 
+		//dossier des fichiers de grilles; change le membre lu pour une prevision d'ensemble
+		std::string PrendreRepertoireGrilles() const;
+		void ChangeRepertoireGrilles(const std::string& sPath);
+
 		std::string									_sPathFichierParam;
 		
 		DATE_HEURE									_date_debut_prevision;
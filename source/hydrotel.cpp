@@ -19,9 +19,11 @@
 //
 
 #include "gdal_util.hpp"
+#include "calibration.hpp"
+#include "constantes.hpp"
+#include "ensemble.hpp"
 #include "mise_a_jour.hpp"
 #include "erreur.hpp"
-#include "statistiques.hpp"
 #include "util.hpp"
 #include "version.hpp"
 
@@ -39,7 +41,7 @@ using namespace HYDROTEL;
 
 void displayHelp()
 {
-	std::cout << "hydrotel [-h/i/g/mr/n/u/v] [<project filename>] [-c/d/lp/r/s] [-t <nb thread>] [-l <log filename>]" << endl;
+	std::cout << "hydrotel [-h/i/g/mr/n/u/v] [<project filename>] [-c/d/lp/r/s] [-t <nb thread>] [-hb <nb time steps>] [-l <log filename>] [-cal <calibration filename>] [-ens <ensemble filename>]" << endl;
 	std::cout << endl;
 
 	std::cout << " <project filename>          Run the simulation currently selected in the project file (*.csv)." << endl;
@@ -48,16 +50,33 @@ void displayHelp()
 	std::cout << " -c (-skipcharvalidation)    Skip validation of input files characters." << endl;
 	std::cout << "                             USAGE: hydrotel <hydrotel project filename> -c" << endl;
 	std::cout << endl;
+	std::cout << " -cal (-calibration)         Calibrate the submodels parameters listed in the calibration file (DDS algorithm)." << endl;
+	std::cout << "                             USAGE: hydrotel <hydrotel project filename> -cal <calibration filename>" << endl;
+	std::cout << "                             The project is read once; each evaluation restarts from the in-memory initial state." << endl;
+	std::cout << "                             Requires stats.txt in the simulation folder. Output variables are not saved." << endl;
+	std::cout << "                             Results: calibration.csv and the best parameters files (calibration folder)." << endl;
+	std::cout << endl;
 	std::cout << " -d (-display)               Display simulation progress." << endl;
 	std::cout << "                             USAGE: hydrotel <hydrotel project filename> -d" << endl;
 	std::cout << "                             This option can slow down the execution time of simulations." << endl;
 	std::cout << endl;
+	std::cout << " -ens (-ensemble)            Ensemble forecast: simulate each weather forecast grids member (GRILLE PREVISION)" << endl;
+	std::cout << "                             in the same process, from the common state at the forecast start date." << endl;
+	std::cout << "                             With -t <n>, n members run at the same time (one process each, Linux). Not available with LECTURE INTERPOLATION DONNEES." << endl;
+	std::cout << "                             USAGE: hydrotel <hydrotel project filename> -ens <ensemble filename>" << endl;
+	std::cout << "                             Ensemble file: one line per member: MEMBRE;<member name>;<grids folder>" << endl;
+	std::cout << "                             Results: ensemble/debit_aval_<member name>.csv (output.csv reaches). Output variables are not saved." << endl;
+	std::cout << endl;
 	std::cout << " -g (-hgm)                   Generate hgm file (geomorphological hydrograph)." << endl;
 	std::cout << "                             USAGE: hydrotel -g <hydrotel project filename> <water depth (m)> <new hgm filename> [-t <nb thread>]" << endl;
 	std::cout << endl;
 	std::cout << " -h (-help)                  Display help." << endl;
 	std::cout << "                             USAGE: hydrotel -h" << endl;
 	std::cout << endl;
+	std::cout << " -hb (-hdf5block)            Number of time steps read per block from HDF5 weather data files (default: " << TAILLE_BLOC_HDF5 << ")." << endl;
+	std::cout << "                             USAGE: hydrotel <hydrotel project filename> -hb <nb time steps>" << endl;
+	std::cout << "                             Larger blocks use more memory and reduce the number of file reads." << endl;
+	std::cout << endl;
 	std::cout << " -i (-info)                  Save connectivity and RHHUs informations in the `project-info` folder." << endl;
 	std::cout << "                             USAGE: hydrotel -i <hydrotel project filename>" << endl;
 	std::cout << endl;
@@ -69,6 +88,9 @@ void displayHelp()
 	std::cout << "                             Times are expressed in seconds, except in minutes if total duration is greater than 10 minutes." << endl;
 	std::cout << "                             To force output in seconds, use -lps or -logperformancesec." << endl;
 	std::cout << "                             To force output in minutes, use -lpm or -logperformancemin." << endl;
+	std::cout << "                             To also save a trace of reads, submodels, output writes, withdrawals and states," << endl;
+	std::cout << "                             use -lpt or -logperformancetrace (add per-reach routing: -lptd or -logperformancetracedetail)." << endl;
+	std::cout << "                             Trace files: Chrome trace json (chrome://tracing, Perfetto) and csv of per-step timings." << endl;
 	std::cout << endl;
 	std::cout << " -mr (-modreach)             Modify river reach type." << endl;
 	std::cout << "                             USAGE: hydrotel -mr <reach id> <new reach type> [param] <hydrotel project filename>" << endl;
@@ -100,7 +122,8 @@ void displayHelp()
 	std::cout << "                             This option can be used to speed up the initialization step of a" << endl;
 	std::cout << "                             simulation when there is no missing data in source weather dataset." << endl;
 	std::cout << endl;
-	std::cout << " -t (-thread)                Number of threads to use for hgm computation." << endl;
+	std::cout << " -t (-thread)                Number of threads to use for hgm computation, vertical water budget (BV3C1/BV3C2)," << endl;
+	std::cout << "                             river routing (ONDE CINEMATIQUE MODIFIEE) and thiessen weightings (THIESSEN2)." << endl;
 	std::cout << "                             USAGE: hydrotel [-g] <hydrotel project filename> [...] -t <nb thread>" << endl;
 	std::cout << "                             <nb thread> value of 0 will use the maximum number of available threads." << endl;
 	std::cout << endl;
@@ -132,7 +155,10 @@ int main(int argc, char* argv[])
 	float lame;
 	bool bAutoInverseTMinTmax, bDisplay, bStationInterpolation, bSkipCharacterValidation, bGenereBdPrelev;
 	bool bLogPerformance, bLogPerfForceUnit;
-	int nbThread, iLogPerfUnit, ret, n;
+	int nbThread, iLogPerfUnit, iLogPerfTrace, ret, n;
+	long long lTailleBlocHdf5;
+	string sNomFichierCalibration;
+	string sNomFichierEnsemble;
 
 	std::unique_ptr<SIM_HYD> sim_hyd;
 
@@ -140,6 +166,8 @@ int main(int argc, char* argv[])
 
 	nbThread = 1;	//default: use only 1 thread
 
+	lTailleBlocHdf5 = TAILLE_BLOC_HDF5;
+
 	ret = 0;
 
 	str = argv[0];
@@ -164,6 +192,7 @@ int main(int argc, char* argv[])
 	bGenereBdPrelev = false;
 	bLogPerformance = false;
 	iLogPerfUnit = 1; //seconds
+	iLogPerfTrace = 0;
 	bLogPerfForceUnit = false;
 
 	if (argc == 1)
@@ -199,10 +228,18 @@ int main(int argc, char* argv[])
 			{
 				if (option.compare("-lp") == 0 || option.compare("-logperformance") == 0 || 
 					option.compare("-lps") == 0 || option.compare("-logperformancesec") == 0 || 
-					option.compare("-lpm") == 0 || option.compare("-logperformancemin") == 0)
+					option.compare("-lpm") == 0 || option.compare("-logperformancemin") == 0 || 
+					option.compare("-lpt") == 0 || option.compare("-logperformancetrace") == 0 || 
+					option.compare("-lptd") == 0 || option.compare("-logperformancetracedetail") == 0)
 				{
 					bLogPerformance = true;
 
+					if(option.compare("-lpt") == 0 || option.compare("-logperformancetrace") == 0)
+						iLogPerfTrace = max(iLogPerfTrace, 1);
+
+					if(option.compare("-lptd") == 0 || option.compare("-logperformancetracedetail") == 0)
+						iLogPerfTrace = 2;	//with per-reach routing
+
 					if(option.compare("-lpm") == 0 || option.compare("-logperformancemin") == 0)
 						iLogPerfUnit = 2;	//minutes
 					
@@ -253,15 +290,80 @@ int main(int argc, char* argv[])
 									}
 									else
 									{
-										if (option.compare("-generebdprelevements") == 0)
-											bGenereBdPrelev = true;
+										if (option.compare("-hb") == 0 || option.compare("-hdf5block") == 0)
+										{
+											if (n + 1 == argc)
+											{
+												std::cout << "Missing parameter <nb time steps>" << endl << endl;
+												displayHelp();
+												ret = 1;
+											}
+											else
+											{
+												str = argv[n + 1];
+												unrecognizedParamException.push_back(str);
+
+												iss.clear();
+												iss.str(str);
+												iss >> lTailleBlocHdf5;
+
+												if (iss.fail() || lTailleBlocHdf5 < 1)
+												{
+													std::cout << "Parameter <nb time steps> is invalid: \"" << argv[n + 1] << "\": must be greater or equal 1" << endl;
+													ret = 1;
+												}
+											}
+										}
 										else
 										{
-											if(n != 1)
+											if (option.compare("-generebdprelevements") == 0)
+												bGenereBdPrelev = true;
+											else
 											{
-												str = argv[n];
-												if(std::find(std::begin(unrecognizedParamException), std::end(unrecognizedParamException), str) == std::end(unrecognizedParamException))
-													unrecognizedParam.push_back(option);
+												if (option.compare("-cal") == 0 || option.compare("-calibration") == 0)
+												{
+													if (n + 1 == argc)
+													{
+														std::cout << "Missing parameter <calibration filename>" << endl << endl;
+														displayHelp();
+														ret = 1;
+													}
+													else
+													{
+														sNomFichierCalibration = argv[n + 1];
+														unrecognizedParamException.push_back(sNomFichierCalibration);
+
+														std::replace(sNomFichierCalibration.begin(), sNomFichierCalibration.end(), '\\', '/');
+													}
+												}
+												else
+												{
+													if (option.compare("-ens") == 0 || option.compare("-ensemble") == 0)
+													{
+														if (n + 1 == argc)
+														{
+															std::cout << "Missing parameter <ensemble filename>" << endl << endl;
+															displayHelp();
+															ret = 1;
+														}
+														else
+														{
+															sNomFichierEnsemble = argv[n + 1];
+															unrecognizedParamException.push_back(sNomFichierEnsemble);
+
+															std::replace(sNomFichierEnsemble.begin(), sNomFichierEnsemble.end(), '\\', '/');
+														}
+													}
+													else
+													{
+														if(n != 1)
+														{
+															str = argv[n];
+															if(std::find(std::begin(unrecognizedParamException), std::end(unrecognizedParamException), str) == std::end(unrecognizedParamException))
+																unrecognizedParam.push_back(option);
+														}
+													}
+												}
 											}
 										}
 									}
@@ -522,6 +624,9 @@ int main(int argc, char* argv[])
 							sim_hyd->_logPerformance._iUnit = iLogPerfUnit;
 							sim_hyd->_logPerformance._bForceUnit = bLogPerfForceUnit;
 
+							if(iLogPerfTrace != 0)
+								sim_hyd->_logPerformance.EnableTrace(iLogPerfTrace);
+
 							sim_hyd->_logPerformance.AddStep(sLogExecution, false);	//log start of execution
 							sim_hyd->_logPerformance.AddStep("Project: " + str);
 
@@ -534,6 +639,7 @@ int main(int argc, char* argv[])
 						sim_hyd->_nbThread = nbThread;
 						sim_hyd->_bAutoInverseTMinTMax = bAutoInverseTMinTmax;
 						sim_hyd->_bStationInterpolation = bStationInterpolation;
+						sim_hyd->_lTailleBlocHdf5 = static_cast<size_t>(lTailleBlocHdf5);
 						sim_hyd->_bSkipCharacterValidation = bSkipCharacterValidation;
 
 						HYDROTEL::Log("Reading simulation data...   " + GetCurrentTimeStr());
@@ -541,6 +647,12 @@ int main(int argc, char* argv[])
 						sim_hyd->ChangeNomFichier(str);
 						sim_hyd->Lecture();
 
+						if(!sNomFichierCalibration.empty() && !sNomFichierEnsemble.empty())
+							throw ERREUR("Options -cal (-calibration) and -ens (-ensemble) cannot be used together.");
+
+						if(!sNomFichierCalibration.empty() || !sNomFichierEnsemble.empty())
+							sim_hyd->PrendreOutput().DesactiveSorties();	//les evaluations/membres ne sauvegardent aucune variable de sortie
+
 						if(_log && _nom_fichier_log.find('/') == string::npos)
 							_nom_fichier_log = sim_hyd->PrendreRepertoireSimulation() + "/" + _nom_fichier_log; //save log file to simulation folder if only filename without path is specified
 
@@ -581,18 +693,39 @@ int main(int argc, char* argv[])
 							sim_hyd->_logPerformance.AddStep("Simulation start");
 						}
 
-						do
+						if(!sNomFichierCalibration.empty())
 						{
-							if(bDisplay)
-							{
-								date_courante = sim_hyd->PrendreDateCourante();
-								std::cout << date_courante << '\r' << flush;
-							}
+							CALIBRATION calibration(*sim_hyd, sNomFichierCalibration);
+
+							calibration.Lecture();
+							calibration.Execute();
+
+							date_courante = sim_hyd->PrendreDateCourante();
+						}
+						else if(!sNomFichierEnsemble.empty())
+						{
+							ENSEMBLE ensemble(*sim_hyd, sNomFichierEnsemble);
+
+							ensemble.Lecture();
+							ensemble.Execute();
 
-							sim_hyd->Calcule();
 							date_courante = sim_hyd->PrendreDateCourante();
-						} 
-						while(date_courante < date_fin);
+						}
+						else
+						{
+							do
+							{
+								if(bDisplay)
+								{
+									date_courante = sim_hyd->PrendreDateCourante();
+									std::cout << date_courante << '\r' << flush;
+								}
+
+								sim_hyd->Calcule();
+								date_courante = sim_hyd->PrendreDateCourante();
+							} 
+							while(date_courante < date_fin);
+						}
 
 						if(sim_hyd->_bLogPerf)
 						{
@@ -612,21 +745,6 @@ int main(int argc, char* argv[])
 						if(sim_hyd->_bLogPerf)
 							sim_hyd->_logPerformance.EndStep(idx, boost::chrono::high_resolution_clock::now());
 
-						if(!sim_hyd->_outputCDF)	//le calcul des statistiques n'est pas adapt aux netCDF
-						{
-							string nom_fichier_stats = Combine(sim_hyd->PrendreRepertoireSimulation(), "stats.txt");
-							if(FichierExiste(nom_fichier_stats))
-							{
-								if(sim_hyd->_acheminement_riviere)
-								{
-									std::cout << endl << "Computing statistics...   " << GetCurrentTimeStr() << flush;
-									HYDROTEL::_listLog.push_back("Computing statistics...   " + GetCurrentTimeStr());
-
-									STATISTIQUES stats(*sim_hyd, nom_fichier_stats);
-								}
-							}
-						}
-
 						std::cout << endl;
 
 						std::time(&end);
@@ -653,7 +771,9 @@ int main(int argc, char* argv[])
 
 							sim_hyd->_logPerformance.AddStep("Program execution end");
 
-							str = sim_hyd->PrendreRepertoireSimulation() + "/log-performance-" + GetCurrentTimeStrForFile() + ".txt";
+							str2 = GetCurrentTimeStrForFile();
+
+							str = sim_hyd->PrendreRepertoireSimulation() + "/log-performance-" + str2 + ".txt";
 							if(!sim_hyd->_logPerformance.SaveFile(str))
 								HYDROTEL::Log(sim_hyd->_logPerformance._sErr);
 							else
@@ -661,6 +781,20 @@ int main(int argc, char* argv[])
 								HYDROTEL::Log("Performance log file saved: " + str);
 								HYDROTEL::Log("");
 							}
+
+							if(iLogPerfTrace != 0)
+							{
+								str = sim_hyd->PrendreRepertoireSimulation() + "/log-performance-trace-" + str2 + ".json";
+								str3 = sim_hyd->PrendreRepertoireSimulation() + "/log-performance-steps-" + str2 + ".csv";
+
+								if(!sim_hyd->_logPerformance.SaveTrace(str, str3))
+									HYDROTEL::Log(sim_hyd->_logPerformance._sErr);
+								else
+								{
+									HYDROTEL::Log("Performance trace files saved: " + str + ", " + str3);
+									HYDROTEL::Log("");
+								}
+							}
 						}
 					}
 				}
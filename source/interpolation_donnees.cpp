@@ -48,6 +48,19 @@ namespace HYDROTEL
 
 	INTERPOLATION_DONNEES::~INTERPOLATION_DONNEES()
 	{
+		//fichiers netcdf non fermes par Termine (exception); OUTPUT_NETCDF ecrit les pas de temps deja calcules
+		if(_netCdf_tmin != NULL)
+			delete _netCdf_tmin;
+		if(_netCdf_tmax != NULL)
+			delete _netCdf_tmax;
+		if(_netCdf_tminjour != NULL)
+			delete _netCdf_tminjour;
+		if(_netCdf_tmaxjour != NULL)
+			delete _netCdf_tmaxjour;
+		if(_netCdf_pluie != NULL)
+			delete _netCdf_pluie;
+		if(_netCdf_neige != NULL)
+			delete _netCdf_neige;
 	}
 
 
@@ -71,66 +84,66 @@ namespace HYDROTEL
 			if (output.SauvegardeTMin())
 			{
 				if (_sim_hyd._outputCDF)
-					_netCdf_tmin = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+					_netCdf_tmin = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "tmin.nc"), true, "tmin", "C", "Temperature minimum");
 				else
 				{
-					_fichier_tmin.open( Combine(_sim_hyd.PrendreRepertoireResultat(), "tmin.csv") );
-					_fichier_tmin << "Temprature minimum (C);" << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
+					_fichier_tmin.Ouvre(output, Combine(_sim_hyd.PrendreRepertoireResultat(), "tmin.csv"), true, output._nbDigit_dC);
+					_fichier_tmin.Entete() << "Temprature minimum (C);" << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
 				}
 			}
 
 			if (output.SauvegardeTMinJour())
 			{
 				if (_sim_hyd._outputCDF)
-					_netCdf_tminjour = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+					_netCdf_tminjour = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "tminjour.nc"), true, "tminjour", "C", "Temperature minimum journaliere");
 				else
 				{
-					_fichier_tmin_jour.open( Combine(_sim_hyd.PrendreRepertoireResultat(), "tmin_jour.csv") );
-					_fichier_tmin_jour << "Temprature minimum journalire (C);" << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
+					_fichier_tmin_jour.Ouvre(output, Combine(_sim_hyd.PrendreRepertoireResultat(), "tmin_jour.csv"), true, output._nbDigit_dC);
+					_fichier_tmin_jour.Entete() << "Temprature minimum journalire (C);" << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
 				}
 			}
 
 			if (output.SauvegardeTMax())
 			{
 				if (_sim_hyd._outputCDF)
-					_netCdf_tmax = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+					_netCdf_tmax = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "tmax.nc"), true, "tmax", "C", "Temperature maximum");
 				else
 				{
-					_fichier_tmax.open( Combine(_sim_hyd.PrendreRepertoireResultat(), "tmax.csv") );
-					_fichier_tmax << "Temprature maximum (C);" << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )"<< endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
+					_fichier_tmax.Ouvre(output, Combine(_sim_hyd.PrendreRepertoireResultat(), "tmax.csv"), true, output._nbDigit_dC);
+					_fichier_tmax.Entete() << "Temprature maximum (C);" << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )"<< endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
 				}
 			}
 
 			if (output.SauvegardeTMaxJour())
 			{
 				if (_sim_hyd._outputCDF)
-					_netCdf_tmaxjour = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+					_netCdf_tmaxjour = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "tmaxjour.nc"), true, "tmaxjour", "C", "Temperature maximum journaliere");
 				else
 				{
-					_fichier_tmax_jour.open( Combine(_sim_hyd.PrendreRepertoireResultat(), "tmax_jour.csv") );
-					_fichier_tmax_jour << "Temprature maximum journalire (C);" << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )"<< endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
+					_fichier_tmax_jour.Ouvre(output, Combine(_sim_hyd.PrendreRepertoireResultat(), "tmax_jour.csv"), true, output._nbDigit_dC);
+					_fichier_tmax_jour.Entete() << "Temprature maximum journalire (C);" << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )"<< endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
 				}
 			}
 
 			if (output.SauvegardePluie())
 			{
 				if (_sim_hyd._outputCDF)
-					_netCdf_pluie = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+					_netCdf_pluie = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "pluie.nc"), true, "pluie", "mm", "Precipitation pluie");
 				else
 				{
-					_fichier_pluie.open( Combine(_sim_hyd.PrendreRepertoireResultat(), "pluie.csv") );
-					_fichier_pluie << "Prcipitation pluie (mm);" << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )"<< endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
+					_fichier_pluie.Ouvre(output, Combine(_sim_hyd.PrendreRepertoireResultat(), "pluie.csv"), true, output._nbDigit_mm_interpolation);
+					_fichier_pluie.Entete() << "Prcipitation pluie (mm);" << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )"<< endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
 				}
 			}
 
 			if (output.SauvegardeNeige())
 			{
 				if (_sim_hyd._outputCDF)
-					_netCdf_neige = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+					_netCdf_neige = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "neige.nc"), true, "neige", "mm", "Pecipitation neige (EEN)");
 				else
 				{
-					_fichier_neige.open( Combine(_sim_hyd.PrendreRepertoireResultat(), "neige.csv") );
-					_fichier_neige << "Prcipitation neige (EEN) (mm);" << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )"<< endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
+					_fichier_neige.Ouvre(output, Combine(_sim_hyd.PrendreRepertoireResultat(), "neige.csv"), true, output._nbDigit_mm_interpolation);
+					_fichier_neige.Entete() << "Prcipitation neige (EEN) (mm);" << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )"<< endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
 				}
 			}
 
@@ -150,74 +163,69 @@ namespace HYDROTEL
 				ostringstream oss6;
 				oss6.str("");
 
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
 				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-								find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							if (output.SauvegardeTMin())
-								oss1 << zones[index].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
+					size_t index = output._uhrhOutputIndex[n];
+
+					if (output.SauvegardeTMin())
+						oss1 << zones[index].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
 
-							if (output.SauvegardeTMax())
-								oss2 << zones[index].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
+					if (output.SauvegardeTMax())
+						oss2 << zones[index].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
 
-							if (output.SauvegardePluie())
-								oss3 << zones[index].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
+					if (output.SauvegardePluie())
+						oss3 << zones[index].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
 
-							if (output.SauvegardeNeige())
-								oss4 << zones[index].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
+					if (output.SauvegardeNeige())
+						oss4 << zones[index].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
 
-							if (output.SauvegardeTMinJour())
-								oss5 << zones[index].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
+					if (output.SauvegardeTMinJour())
+						oss5 << zones[index].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
 
-							if (output.SauvegardeTMaxJour())
-								oss6 << zones[index].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
-						}
-					}
+					if (output.SauvegardeTMaxJour())
+						oss6 << zones[index].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
 				}
 
 				if (output.SauvegardeTMin())
 				{
 					str = oss1.str();
 					str = str.substr(0, str.length()-1); //enleve le dernier separateur
-					_fichier_tmin << str << endl;
+					_fichier_tmin.Entete() << str << endl;
 				}
 
 				if (output.SauvegardeTMax())
 				{
 					str = oss2.str();
 					str = str.substr(0, str.length()-1); //enleve le dernier separateur
-					_fichier_tmax << str << endl;
+					_fichier_tmax.Entete() << str << endl;
 				}
 
 				if (output.SauvegardePluie())
 				{
 					str = oss3.str();
 					str = str.substr(0, str.length()-1); //enleve le dernier separateur
-					_fichier_pluie << str << endl;
+					_fichier_pluie.Entete() << str << endl;
 				}
 
 				if (output.SauvegardeNeige())
 				{
 					str = oss4.str();
 					str = str.substr(0, str.length()-1); //enleve le dernier separateur
-					_fichier_neige << str << endl;
+					_fichier_neige.Entete() << str << endl;
 				}
 
 				if (output.SauvegardeTMinJour())
 				{
 					str = oss5.str();
 					str = str.substr(0, str.length()-1); //enleve le dernier separateur
-					_fichier_tmin_jour << str << endl;
+					_fichier_tmin_jour.Entete() << str << endl;
 				}
 
 				if (output.SauvegardeTMaxJour())
 				{
 					str = oss6.str();
 					str = str.substr(0, str.length()-1); //enleve le dernier separateur
-					_fichier_tmax_jour << str << endl;
+					_fichier_tmax_jour.Entete() << str << endl;
 				}
 			}
 		}
@@ -226,9 +234,10 @@ namespace HYDROTEL
 
 	void INTERPOLATION_DONNEES::Calcule()
 	{
-		ostringstream oss;
-		size_t index, i, idx;
-		float densite, tmoy, neige;
+		size_t index, i;
+		float densite, tmoy;
+		float *pTMin, *pTMax, *pTMinJour, *pTMaxJour, *pPluie, *pNeige;
+		double *pTMinCsv, *pTMaxCsv, *pTMinJourCsv, *pTMaxJourCsv, *pPluieCsv, *pNeigeCsv;
 
 		DATE_HEURE date_courante = _sim_hyd.PrendreDateCourante();
 		unsigned short pas_de_temps = _sim_hyd.PrendrePasDeTemps();
@@ -244,26 +253,31 @@ namespace HYDROTEL
 
 			if(_sim_hyd._outputCDF)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pTMin = (_netCdf_tmin != NULL) ? _netCdf_tmin->Ligne(_sim_hyd._lPasTempsCourantIndex) : NULL;
+				pTMax = (_netCdf_tmax != NULL) ? _netCdf_tmax->Ligne(_sim_hyd._lPasTempsCourantIndex) : NULL;
+				pTMinJour = (_netCdf_tminjour != NULL) ? _netCdf_tminjour->Ligne(_sim_hyd._lPasTempsCourantIndex) : NULL;
+				pTMaxJour = (_netCdf_tmaxjour != NULL) ? _netCdf_tmaxjour->Ligne(_sim_hyd._lPasTempsCourantIndex) : NULL;
+				pPluie = (_netCdf_pluie != NULL) ? _netCdf_pluie->Ligne(_sim_hyd._lPasTempsCourantIndex) : NULL;
+				pNeige = (_netCdf_neige != NULL) ? _netCdf_neige->Ligne(_sim_hyd._lPasTempsCourantIndex) : NULL;
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
 				{
-					if (_netCdf_tmin != NULL)
-						_netCdf_tmin[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreTMin();
+					if (pTMin != NULL)
+						pTMin[i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreTMin();
 					
-					if (_netCdf_tmax != NULL)
-						_netCdf_tmax[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreTMax();
+					if (pTMax != NULL)
+						pTMax[i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreTMax();
 
-					if (_netCdf_tminjour != NULL)
-						_netCdf_tminjour[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreTMinJournaliere();
+					if (pTMinJour != NULL)
+						pTMinJour[i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreTMinJournaliere();
 
-					if (_netCdf_tmaxjour != NULL)
-						_netCdf_tmaxjour[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreTMaxJournaliere();
+					if (pTMaxJour != NULL)
+						pTMaxJour[i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreTMaxJournaliere();
 
-					if (_netCdf_pluie != NULL)
-						_netCdf_pluie[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendrePluie();
+					if (pPluie != NULL)
+						pPluie[i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendrePluie();
 
-					if (_netCdf_neige != NULL)
+					if (pNeige != NULL)
 					{
 						//transforme la neige en equivalent en eau					
 						if (pas_de_temps == 1)
@@ -274,71 +288,39 @@ namespace HYDROTEL
 							densite = CalculDensiteNeige(tmoy) / DENSITE_EAU;
 						}
 
-						_netCdf_neige[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreNeige() * densite;
+						pNeige[i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreNeige() * densite;
 					}
 				}
 			}
 			else
 			{
-				if (output.SauvegardeTMin())
-					_fichier_tmin << date_courante << _sim_hyd.PrendreOutput().Separator();
+				pTMinCsv = output.SauvegardeTMin() ? _fichier_tmin.Ligne(date_courante) : NULL;
+				pTMaxCsv = output.SauvegardeTMax() ? _fichier_tmax.Ligne(date_courante) : NULL;
+				pTMinJourCsv = output.SauvegardeTMinJour() ? _fichier_tmin_jour.Ligne(date_courante) : NULL;
+				pTMaxJourCsv = output.SauvegardeTMaxJour() ? _fichier_tmax_jour.Ligne(date_courante) : NULL;
+				pPluieCsv = output.SauvegardePluie() ? _fichier_pluie.Ligne(date_courante) : NULL;
+				pNeigeCsv = output.SauvegardeNeige() ? _fichier_neige.Ligne(date_courante) : NULL;
 
-				if (output.SauvegardeTMax())
-					_fichier_tmax << date_courante << _sim_hyd.PrendreOutput().Separator();
+				for (i=0; i<output._uhrhOutputNb; i++)
+				{
+					index = output._uhrhOutputIndex[i];
 
-				if (output.SauvegardePluie())
-					_fichier_pluie << date_courante << _sim_hyd.PrendreOutput().Separator();
+					if (pTMinCsv != NULL)
+						pTMinCsv[i] = zones[index].PrendreTMin();
 
-				if (output.SauvegardeNeige())
-					_fichier_neige << date_courante << _sim_hyd.PrendreOutput().Separator();
+					if (pTMaxCsv != NULL)
+						pTMaxCsv[i] = zones[index].PrendreTMax();
 
-				if (output.SauvegardeTMinJour())
-					_fichier_tmin_jour << date_courante << _sim_hyd.PrendreOutput().Separator();
+					if (pTMinJourCsv != NULL)
+						pTMinJourCsv[i] = zones[index].PrendreTMinJournaliere();
 
-				if (output.SauvegardeTMaxJour())
-					_fichier_tmax_jour << date_courante << _sim_hyd.PrendreOutput().Separator();
+					if (pTMaxJourCsv != NULL)
+						pTMaxJourCsv[i] = zones[index].PrendreTMaxJournaliere();
 
-				string str;
-				ostringstream oss1;
-				oss1.str("");
-				ostringstream oss2;
-				oss2.str("");
-				ostringstream oss3;
-				oss3.str("");
-				ostringstream oss4;
-				oss4.str("");
-				ostringstream oss5;
-				oss5.str("");
-				ostringstream oss6;
-				oss6.str("");
-		
-				for (i=0; i<_sim_hyd._outputNbZone; i++)
-				{
-					index = _sim_hyd._vOutputIndexZone[i];
+					if (pPluieCsv != NULL)
+						pPluieCsv[i] = zones[index].PrendrePluie();
 
-					if (output.SauvegardeTMin())
-					{
-						oss.str("");
-						//oss << setprecision(9) << setiosflags(ios::fixed) << zones[index].PrendreTMin();
-						oss << setprecision(_sim_hyd.PrendreOutput()._nbDigit_dC) << setiosflags(ios::fixed) << zones[index].PrendreTMin();
-						oss1 << oss.str() << _sim_hyd.PrendreOutput().Separator();
-					}
-	
-					if (output.SauvegardeTMax())
-					{
-						oss.str("");
-						oss << setprecision(_sim_hyd.PrendreOutput()._nbDigit_dC) << setiosflags(ios::fixed) << zones[index].PrendreTMax();
-						oss2 << oss.str() << _sim_hyd.PrendreOutput().Separator();
-					}
-	
-					if (output.SauvegardePluie())
-					{
-						oss.str("");
-						oss << setprecision(_sim_hyd.PrendreOutput()._nbDigit_mm_interpolation) << setiosflags(ios::fixed) << zones[index].PrendrePluie();
-						oss3 << oss.str() << _sim_hyd.PrendreOutput().Separator();
-					}
-			
-					if (output.SauvegardeNeige())
+					if (pNeigeCsv != NULL)
 					{
 						//transforme la neige en equivalent en eau
 						if (pas_de_temps == 1)
@@ -349,68 +331,8 @@ namespace HYDROTEL
 							densite = CalculDensiteNeige(tmoy) / DENSITE_EAU;
 						}
 
-						neige = zones[index].PrendreNeige() * densite;
-
-						oss.str("");
-						oss << setprecision(_sim_hyd.PrendreOutput()._nbDigit_mm_interpolation) << setiosflags(ios::fixed) << neige;
-						oss4 << oss.str() << _sim_hyd.PrendreOutput().Separator();
-					}
-
-					if (output.SauvegardeTMinJour())
-					{
-						oss.str("");
-						oss << setprecision(_sim_hyd.PrendreOutput()._nbDigit_dC) << setiosflags(ios::fixed) << zones[index].PrendreTMinJournaliere();
-						oss5 << oss.str() << _sim_hyd.PrendreOutput().Separator();
+						pNeigeCsv[i] = zones[index].PrendreNeige() * densite;
 					}
-
-					if (output.SauvegardeTMaxJour())
-					{
-						oss.str("");
-						oss << setprecision(_sim_hyd.PrendreOutput()._nbDigit_dC) << setiosflags(ios::fixed) << zones[index].PrendreTMaxJournaliere();
-						oss6 << oss.str() << _sim_hyd.PrendreOutput().Separator();
-					}
-				}
-
-				if (output.SauvegardeTMin())
-				{
-					str = oss1.str();
-					str = str.substr(0, str.length()-1); //enleve le dernier separateur
-					_fichier_tmin << str << endl;
-				}
-
-				if (output.SauvegardeTMax())
-				{
-					str = oss2.str();
-					str = str.substr(0, str.length()-1); //enleve le dernier separateur
-					_fichier_tmax << str << endl;
-				}
-
-				if (output.SauvegardePluie())
-				{
-					str = oss3.str();
-					str = str.substr(0, str.length()-1); //enleve le dernier separateur
-					_fichier_pluie << str << endl;
-				}
-
-				if (output.SauvegardeNeige())
-				{
-					str = oss4.str();
-					str = str.substr(0, str.length()-1); //enleve le dernier separateur
-					_fichier_neige << str << endl;
-				}
-
-				if (output.SauvegardeTMinJour())
-				{
-					str = oss5.str();
-					str = str.substr(0, str.length()-1); //enleve le dernier separateur
-					_fichier_tmin_jour << str << endl;
-				}
-
-				if (output.SauvegardeTMaxJour())
-				{
-					str = oss6.str();
-					str = str.substr(0, str.length()-1); //enleve le dernier separateur
-					_fichier_tmax_jour << str << endl;
 				}
 			}
 		}
@@ -421,7 +343,7 @@ namespace HYDROTEL
 	{
 		if(_bSauvegarde)
 		{
-			string str1, str2;
+			string str;
 
 			OUTPUT& output = _sim_hyd.PrendreOutput();
 
@@ -429,102 +351,90 @@ namespace HYDROTEL
 			{
 				if (_netCdf_tmin != NULL)
 				{
-					//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "interpolation-tmin.nc");
-					str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "tmin.nc");
-					//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "interpolation-tmin", _netCdf_tmin, "C", "Temperature minimum");
-					str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "tmin", _netCdf_tmin, "C", "Temperature minimum");
-					if(str2 != "")
-						throw ERREUR(str2);
-
-					delete [] _netCdf_tmin;
+					str = _netCdf_tmin->Ferme();
+					delete _netCdf_tmin;
+					_netCdf_tmin = NULL;
+
+					if(str != "")
+						throw ERREUR(str);
 				}
 				else
-					_fichier_tmin.close();
+					_fichier_tmin.Ferme();
 			}
 
 			if (output.SauvegardeTMax())
 			{
 				if (_netCdf_tmax != NULL)
 				{
-					//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "interpolation-tmax.nc");
-					str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "tmax.nc");
-					//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "interpolation-tmax", _netCdf_tmax, "C", "Temperature maximum");
-					str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "tmax", _netCdf_tmax, "C", "Temperature maximum");
-					if(str2 != "")
-						throw ERREUR(str2);
-
-					delete [] _netCdf_tmax;
+					str = _netCdf_tmax->Ferme();
+					delete _netCdf_tmax;
+					_netCdf_tmax = NULL;
+
+					if(str != "")
+						throw ERREUR(str);
 				}
 				else
-					_fichier_tmax.close();
+					_fichier_tmax.Ferme();
 			}
 
 			if (output.SauvegardePluie())
 			{
 				if (_netCdf_pluie != NULL)
 				{
-					//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "interpolation-pluie.nc");
-					str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "pluie.nc");
-					//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "interpolation-pluie", _netCdf_pluie, "mm", "Precipitation pluie");
-					str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "pluie", _netCdf_pluie, "mm", "Precipitation pluie");
-					if(str2 != "")
-						throw ERREUR(str2);
-
-					delete [] _netCdf_pluie;
+					str = _netCdf_pluie->Ferme();
+					delete _netCdf_pluie;
+					_netCdf_pluie = NULL;
+
+					if(str != "")
+						throw ERREUR(str);
 				}
 				else
-					_fichier_pluie.close();
+					_fichier_pluie.Ferme();
 			}
 
 			if (output.SauvegardeNeige())
 			{
 				if (_netCdf_neige != NULL)
 				{
-					//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "interpolation-neige.nc");
-					str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "neige.nc");
-					//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "interpolation-neige", _netCdf_neige, "mm", "Pecipitation neige (EEN)");
-					str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "neige", _netCdf_neige, "mm", "Pecipitation neige (EEN)");
-					if(str2 != "")
-						throw ERREUR(str2);
-
-					delete [] _netCdf_neige;
+					str = _netCdf_neige->Ferme();
+					delete _netCdf_neige;
+					_netCdf_neige = NULL;
+
+					if(str != "")
+						throw ERREUR(str);
 				}
 				else
-					_fichier_neige.close();
+					_fichier_neige.Ferme();
 			}
 
 			if (output.SauvegardeTMinJour())
 			{
 				if (_netCdf_tminjour != NULL)
 				{
-					//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "interpolation-tminjour.nc");
-					str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "tminjour.nc");
-					//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "interpolation-tminjour", _netCdf_tminjour, "C", "Temperature minimum journaliere");
-					str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "tminjour", _netCdf_tminjour, "C", "Temperature minimum journaliere");
-					if(str2 != "")
-						throw ERREUR(str2);
-
-					delete [] _netCdf_tminjour;
+					str = _netCdf_tminjour->Ferme();
+					delete _netCdf_tminjour;
+					_netCdf_tminjour = NULL;
+
+					if(str != "")
+						throw ERREUR(str);
 				}
 				else
-					_fichier_tmin_jour.close();
+					_fichier_tmin_jour.Ferme();
 			}
 
 			if (output.SauvegardeTMaxJour())
 			{
 				if (_netCdf_tmaxjour != NULL)
 				{
-					//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "interpolation-tmaxjour.nc");
-					str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "tmaxjour.nc");
-					//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "interpolation-tmaxjour", _netCdf_tmaxjour, "C", "Temperature maximum journaliere");
-					str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "tmaxjour", _netCdf_tmaxjour, "C", "Temperature maximum journaliere");
-					if(str2 != "")
-						throw ERREUR(str2);
-
-					delete [] _netCdf_tmaxjour;
+					str = _netCdf_tmaxjour->Ferme();
+					delete _netCdf_tmaxjour;
+					_netCdf_tmaxjour = NULL;
+
+					if(str != "")
+						throw ERREUR(str);
 				}
 				else
-					_fichier_tmax_jour.close();
+					_fichier_tmax_jour.Ferme();
 			}
 		}
 	}
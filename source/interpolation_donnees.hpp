@@ -23,6 +23,8 @@
 
 
 #include "sous_modele.hpp"
+#include "output_netcdf.hpp"
+#include "output_csv.hpp"
 
 #include <fstream>
 #include <vector>
@@ -53,23 +55,23 @@ namespace HYDROTEL
 
 		bool		_bSauvegarde;
 
-		float*				_netCdf_tmin;
-		float*				_netCdf_tmax;
-		float*				_netCdf_tminjour;
-		float*				_netCdf_tmaxjour;
-		float*				_netCdf_pluie;
-		float*				_netCdf_neige;
+		OUTPUT_NETCDF*		_netCdf_tmin;
+		OUTPUT_NETCDF*		_netCdf_tmax;
+		OUTPUT_NETCDF*		_netCdf_tminjour;
+		OUTPUT_NETCDF*		_netCdf_tmaxjour;
+		OUTPUT_NETCDF*		_netCdf_pluie;
+		OUTPUT_NETCDF*		_netCdf_neige;
 
 	private:
 		void AppliquerCorrections(DATE_HEURE date);
 
-		std::ofstream _fichier_tmin;
-		std::ofstream _fichier_tmax;
-		std::ofstream _fichier_pluie;
-		std::ofstream _fichier_neige;
+		OUTPUT_CSV _fichier_tmin;
+		OUTPUT_CSV _fichier_tmax;
+		OUTPUT_CSV _fichier_pluie;
+		OUTPUT_CSV _fichier_neige;
 
-		std::ofstream _fichier_tmin_jour;
-		std::ofstream _fichier_tmax_jour;
+		OUTPUT_CSV _fichier_tmin_jour;
+		OUTPUT_CSV _fichier_tmax_jour;
 
 		std::vector<CORRECTION*> _corrections_pluie;
 		std::vector<CORRECTION*> _corrections_neige;
@@ -23,6 +23,7 @@
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <map>
 
 
 using namespace std;
@@ -31,11 +32,23 @@ using namespace std;
 namespace HYDROTEL
 {
 
+	LOG_PERFORMANCE* LOG_PERFORMANCE::_pTrace = nullptr;
+
+	namespace
+	{
+		std::atomic<unsigned int> _uiTraceInstance(0);
+	}
+
+
 	LOG_PERFORMANCE::LOG_PERFORMANCE()
 	{
 		_iUnit = 1;
 		_bForceUnit = false;
 
+		_iTraceLevel = 0;
+		_lTraceStep = std::string::npos;
+		_uiTraceId = 0;
+
 		_nbSecInterpolation = 0.0;
 		_nbSecFonteNeige = 0.0;
 		_nbSecFonteGlacier = 0.0;
@@ -44,11 +57,18 @@ namespace HYDROTEL
 		_nbSecBilanVertical = 0.0;
 		_nbSecRuissellement = 0.0;
 		_nbSecAcheminement = 0.0;
+
+		_nbStep = 0;
+		_nbZone = 0;
+		_nbReach = 0;
+		_nbReachSubstep = 0;
 	}
 
 
 	LOG_PERFORMANCE::~LOG_PERFORMANCE()
 	{
+		if(_pTrace == this)
+			_pTrace = nullptr;
 	}
 
 
@@ -242,6 +262,42 @@ namespace HYDROTEL
 
 			file << endl;
 
+			//throughput	//zone-steps/s for the zone submodels, reach-substeps/s for routing
+			if(_nbStep != 0 && _nbZone != 0)
+			{
+				double dNbZoneStep = static_cast<double>(_nbZone) * static_cast<double>(_nbStep);
+
+				oss.str("");
+				oss << "Throughput (" << _nbZone << " zones, " << _nbReach << " reaches, " << _nbStep << " time steps):";
+				file << oss.str() << endl;
+
+				file << endl;
+
+				if(_nbSecInterpolation != 0.0)
+					file << "   Weather interpolation:           " << GetThroughputString(dNbZoneStep, _nbSecInterpolation) << " zone-steps/s." << endl;
+				if(_nbSecFonteNeige != 0.0)
+					file << "   Snow cover evolution:            " << GetThroughputString(dNbZoneStep, _nbSecFonteNeige) << " zone-steps/s." << endl;
+				if(_nbSecFonteGlacier != 0.0)
+					file << "   Glacier melt:                    " << GetThroughputString(dNbZoneStep, _nbSecFonteGlacier) << " zone-steps/s." << endl;
+				if(_nbSecTempSol != 0.0)
+					file << "   Soil temp/Frost depth:           " << GetThroughputString(dNbZoneStep, _nbSecTempSol) << " zone-steps/s." << endl;
+				if(_nbSecETP != 0.0)
+					file << "   Potential evp:                   " << GetThroughputString(dNbZoneStep, _nbSecETP) << " zone-steps/s." << endl;
+				if(_nbSecBilanVertical != 0.0)
+					file << "   Vertical water balance:          " << GetThroughputString(dNbZoneStep, _nbSecBilanVertical) << " zone-steps/s." << endl;
+				if(_nbSecRuissellement != 0.0)
+					file << "   Flow towards network (runoff):   " << GetThroughputString(dNbZoneStep, _nbSecRuissellement) << " zone-steps/s." << endl;
+				if(_nbSecAcheminement != 0.0)
+				{
+					if(_nbReachSubstep != 0)
+						file << "   Flow in the network (routing):   " << GetThroughputString(static_cast<double>(_nbReachSubstep), _nbSecAcheminement) << " reach-substeps/s." << endl;
+					else
+						file << "   Flow in the network (routing):   " << GetThroughputString(static_cast<double>(_nbReach) * static_cast<double>(_nbStep), _nbSecAcheminement) << " reach-steps/s." << endl;
+				}
+
+				file << endl;
+			}
+
 			//post-processing
 			ms_double = _tpPostEnd - _tpPostBegin;
 			dVal = ms_double.count() / 1000.0;
@@ -273,6 +329,200 @@ namespace HYDROTEL
 	}
 
 
+	void LOG_PERFORMANCE::EnableTrace(int iLevel)
+	{
+		_iTraceLevel = iLevel;
+		_uiTraceId = ++_uiTraceInstance;
+		_tpTraceBegin = boost::chrono::steady_clock::now();
+
+		_pTrace = (iLevel > 0) ? this : nullptr;
+	}
+
+
+	TRACE_THREAD* LOG_PERFORMANCE::GetTraceThread()
+	{
+		thread_local unsigned int uiInstance = 0;
+		thread_local TRACE_THREAD* pThread = nullptr;
+
+		if(uiInstance != _uiTraceId)
+		{
+			lock_guard<mutex> lock(_mutexTrace);
+
+			_listTraceThread.push_back(unique_ptr<TRACE_THREAD>(new TRACE_THREAD));
+
+			pThread = _listTraceThread.back().get();
+			pThread->iId = static_cast<int>(_listTraceThread.size()) - 1;
+			pThread->uiDepth = 0;
+
+			uiInstance = _uiTraceId;
+		}
+
+		return pThread;
+	}
+
+
+	bool LOG_PERFORMANCE::SaveTrace(string sPathJson, string sPathCsv)
+	{
+		boost::chrono::duration<double, boost::micro> us_double;
+		ofstream file;
+		size_t i, j, k;
+		bool bFirst;
+
+		_sErr = "";
+
+		lock_guard<mutex> lock(_mutexTrace);
+
+		try{
+
+		//chrome trace: complete events ("X"), one tid per thread; nesting is given by the time intervals
+		file.open(sPathJson, ios_base::trunc);
+		if(!file.is_open())
+			_sErr = "error creating file: " + sPathJson;
+		else
+		{
+			file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << endl;
+			bFirst = true;
+
+			for(i=0; i!=_listTraceThread.size(); i++)
+			{
+				const TRACE_THREAD& thread = *_listTraceThread[i];
+
+				if(!bFirst)
+					file << "," << endl;
+				bFirst = false;
+
+				file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread.iId << ",\"args\":{\"name\":\"thread " << thread.iId << "\"}}";
+
+				for(j=0; j!=thread.listEvent.size(); j++)
+				{
+					const TRACE_EVENT& ev = thread.listEvent[j];
+
+					file << "," << endl;
+
+					us_double = ev.tpBegin - _tpTraceBegin;
+					file << "{\"name\":\"" << ev.sName << "\",\"cat\":\"hydrotel\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread.iId 
+						<< ",\"ts\":" << setprecision(3) << setiosflags(ios::fixed) << us_double.count();
+
+					us_double = ev.tpEnd - ev.tpBegin;
+					file << ",\"dur\":" << us_double.count();
+
+					file << ",\"args\":{\"depth\":" << ev.uiDepth;
+					if(ev.lStep != string::npos)
+						file << ",\"step\":" << ev.lStep;
+
+					file << "}}";
+				}
+			}
+
+			file << endl << "]}" << endl;
+			file.close();
+		}
+
+		if(_sErr != "")
+			return false;
+
+		//per-step timings: one column per event name (ms, cumulated over threads and calls)
+		map<string, size_t> mapColumn;
+		vector<string> listName;
+		map<size_t, vector<double>> mapStep;
+
+		for(i=0; i!=_listTraceThread.size(); i++)
+		{
+			for(j=0; j!=_listTraceThread[i]->listEvent.size(); j++)
+			{
+				const TRACE_EVENT& ev = _listTraceThread[i]->listEvent[j];
+
+				auto itCol = mapColumn.find(ev.sName);
+				if(itCol == mapColumn.end())
+				{
+					itCol = mapColumn.insert(make_pair(string(ev.sName), listName.size())).first;
+					listName.push_back(ev.sName);
+				}
+
+				vector<double>& row = mapStep[ev.lStep];
+				if(row.size() < listName.size())
+					row.resize(listName.size(), 0.0);
+
+				us_double = ev.tpEnd - ev.tpBegin;
+				row[itCol->second]+= us_double.count() / 1000.0;
+			}
+		}
+
+		file.open(sPathCsv, ios_base::trunc);
+		if(!file.is_open())
+			_sErr = "error creating file: " + sPathCsv;
+		else
+		{
+			file << "step";
+			for(k=0; k!=listName.size(); k++)
+				file << ";" << listName[k] << " (ms)";
+			file << endl;
+
+			file << setprecision(3) << setiosflags(ios::fixed);
+
+			for(auto iter=mapStep.begin(); iter!=mapStep.end(); iter++)
+			{
+				if(iter->first == string::npos)
+					file << "-";	//outside simulation loop (reading, initialization, post-processing)
+				else
+					file << iter->first;
+
+				for(k=0; k!=listName.size(); k++)
+					file << ";" << (k < iter->second.size() ? iter->second[k] : 0.0);
+				file << endl;
+			}
+
+			file.close();
+		}
+
+		}
+		catch(...)
+		{
+			if(file && file.is_open())
+				file.close();
+			_sErr = "error writing trace files: " + sPathJson;
+		}
+
+		return (_sErr == "");
+	}
+
+
+	TRACE_PERFORMANCE::TRACE_PERFORMANCE(const char* sName, bool bDetail)
+	{
+		_pLog = LOG_PERFORMANCE::_pTrace;
+
+		if(_pLog == nullptr || (bDetail && _pLog->_iTraceLevel < 2))
+		{
+			_pLog = nullptr;
+			return;
+		}
+
+		_pThread = _pLog->GetTraceThread();
+		_sName = sName;
+		_lStep = _pLog->_lTraceStep;
+
+		++_pThread->uiDepth;
+		_tpBegin = boost::chrono::steady_clock::now();
+	}
+
+
+	TRACE_PERFORMANCE::~TRACE_PERFORMANCE()
+	{
+		if(_pLog == nullptr)
+			return;
+
+		TRACE_EVENT ev;
+
+		ev.tpEnd = boost::chrono::steady_clock::now();
+		ev.tpBegin = _tpBegin;
+		ev.sName = _sName;
+		ev.lStep = _lStep;
+		ev.uiDepth = --_pThread->uiDepth;
+
+		_pThread->listEvent.push_back(ev);
+	}
+
+
 	//Return string in seconds or minutes depending selected output unit
 	string LOG_PERFORMANCE::GetTimeValueString(double dTimeValSec)
 	{
@@ -286,4 +536,14 @@ namespace HYDROTEL
 		return oss.str();
 	}
 
+
+	string LOG_PERFORMANCE::GetThroughputString(double dNbUnit, double dTimeValSec)
+	{
+		ostringstream oss;
+
+		oss << setprecision(0) << setiosflags(ios::fixed) << (dNbUnit / dTimeValSec);
+
+		return oss.str();
+	}
+
 }
@@ -24,6 +24,9 @@
 
 #include "log-performance.hpp"
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 
@@ -33,6 +36,26 @@
 namespace HYDROTEL
 {
 
+	//timed interval recorded by a TRACE_PERFORMANCE scope
+	struct TRACE_EVENT
+	{
+		const char*												sName;			//string literal
+		size_t													lStep;			//simulation time step index (npos: outside simulation loop)
+		unsigned int											uiDepth;		//nesting level in the thread
+		boost::chrono::steady_clock::time_point					tpBegin;
+		boost::chrono::steady_clock::time_point					tpEnd;
+	};
+
+
+	//events of one thread; written only by the owner thread
+	struct TRACE_THREAD
+	{
+		int														iId;
+		unsigned int											uiDepth;
+		std::vector<TRACE_EVENT>								listEvent;
+	};
+
+
 	class LOG_PERFORMANCE
 	{
 
@@ -49,6 +72,20 @@ namespace HYDROTEL
 
 		bool	SaveFile(std::string sPathFile);
 
+		//enable scoped tracing (TRACE_PERFORMANCE) for this instance	//iLevel: 1=steps, submodels, reads, writes, withdrawals, states	//2=also per-reach routing
+		void	EnableTrace(int iLevel);
+
+		//export events to Chrome trace JSON (chrome://tracing, Perfetto) and per-step timings to csv (ms cumulated over threads)
+		bool	SaveTrace(std::string sPathJson, std::string sPathCsv);
+
+		//thread buffer of the calling thread; created on first use
+		TRACE_THREAD*	GetTraceThread();
+
+		static LOG_PERFORMANCE*									_pTrace;		//instance receiving the trace events, nullptr if tracing is disabled
+
+		int														_iTraceLevel;	//0=disabled
+		std::atomic<size_t>										_lTraceStep;	//current simulation time step index (set by SIM_HYD::Calcule)
+
 
 		std::string												_sErr;
 
@@ -64,6 +101,12 @@ namespace HYDROTEL
 		double													_nbSecRuissellement;
 		double													_nbSecAcheminement;
 
+		//throughput	//set by SIM_HYD and the routing submodel
+		size_t													_nbStep;			//simulated time steps
+		size_t													_nbZone;			//simulated zones (uhrh)
+		size_t													_nbReach;			//simulated reaches
+		size_t													_nbReachSubstep;	//reaches x internal routing time steps, cumulated (0 if not provided by the routing submodel)
+
 		boost::chrono::steady_clock::time_point					_tpInitAndSimBegin;
 		boost::chrono::steady_clock::time_point					_tpInitAndSimEnd;
 
@@ -84,12 +127,37 @@ namespace HYDROTEL
 
 		std::string GetTimeValueString(double dTimeValSec);		//return string in seconds or minutes depending selected output unit
 
+		std::string GetThroughputString(double dNbUnit, double dTimeValSec);	//return units per second
+
 
 		std::vector<std::string>								_listStr;				//log file content
 
 		std::vector<boost::chrono::steady_clock::time_point>      _listTimePointBegin;    //time point at the beginning of the step (according to _listStr)
 		std::vector<boost::chrono::steady_clock::time_point>      _listTimePointEnd;		//time point at the end of the step (according to _listStr)
 
+		unsigned int											_uiTraceId;				//identify this instance in the thread_local cache of GetTraceThread
+		boost::chrono::steady_clock::time_point					_tpTraceBegin;
+
+		std::mutex												_mutexTrace;
+		std::vector<std::unique_ptr<TRACE_THREAD>>				_listTraceThread;
+
+	};
+
+
+	//scoped timer; records an event in the thread buffer of LOG_PERFORMANCE::_pTrace when tracing is enabled
+	//bDetail: fine grained event (per-reach), recorded only with trace level 2
+	class TRACE_PERFORMANCE
+	{
+	public:
+		TRACE_PERFORMANCE(const char* sName, bool bDetail = false);
+		~TRACE_PERFORMANCE();
+
+	private:
+		LOG_PERFORMANCE*										_pLog;			//nullptr if not recorded
+		TRACE_THREAD*											_pThread;
+		const char*												_sName;
+		size_t													_lStep;
+		boost::chrono::steady_clock::time_point					_tpBegin;
 	};
 
 }
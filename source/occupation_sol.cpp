@@ -494,6 +494,8 @@ namespace HYDROTEL
 					_indices_folieres[index].valeur[n] = valeurs(index, n);
 			}
 
+			ConstruitTableJour(_indices_folieres, _indices_folieres_jour);
+
 			_annee_courante_indices_folieres = annee;
 		}
 	}
@@ -525,6 +527,8 @@ namespace HYDROTEL
 					_profondeurs_racinaires[index].valeur[n] = valeurs(index, n);
 			}
 
+			ConstruitTableJour(_profondeurs_racinaires, _profondeurs_racinaires_jour);
+
 			_annee_courante_profondeurs_racinaires = annee;
 		}
 	}
@@ -598,62 +602,64 @@ namespace HYDROTEL
 		_albedo.clear();
 		_hauteur_vegetation.clear();
 
+		_indices_folieres_jour.clear();
+		_profondeurs_racinaires_jour.clear();
+
 		_annee_courante_indices_folieres = -1;
 		_annee_courante_profondeurs_racinaires = -1;
 		_annee_courante_albedo = -1;
 		_annee_courante_hauteur_vegetation = -1;
 	}
 
-	float OCCUPATION_SOL::PrendreIndiceFoliaire(size_t index, int jour_julien)
+	float OCCUPATION_SOL::InterpoleInformation(const vector<INFORMATION>& informations, size_t index, int jour_julien)
 	{
-		BOOST_ASSERT(jour_julien >= 1 && jour_julien <= 366);
-
 		size_t index2 = 0;
 
-		while (index2 < _indices_folieres.size() && jour_julien > _indices_folieres[index2].jour_julien)
+		while (index2 < informations.size() && jour_julien > informations[index2].jour_julien)
 			++index2;
 
-		if (index2 == _indices_folieres.size())
+		if (index2 == informations.size())
 			--index2;
 		
-		if (jour_julien == _indices_folieres[index2].jour_julien)
-			return _indices_folieres[index2].valeur[index];
+		if (jour_julien == informations[index2].jour_julien || index2 == 0)
+			return informations[index2].valeur[index];
 
 		size_t index1 = index2 - 1;
 
 		return max(0.0f, 
 			InterpolationLineaire(
-				static_cast<float>(_indices_folieres[index1].jour_julien), 
-				_indices_folieres[index1].valeur[index], 
-				static_cast<float>(_indices_folieres[index2].jour_julien), 
-				_indices_folieres[index2].valeur[index], 
+				static_cast<float>(informations[index1].jour_julien), 
+				informations[index1].valeur[index], 
+				static_cast<float>(informations[index2].jour_julien), 
+				informations[index2].valeur[index], 
 				static_cast<float>(jour_julien)));
 	}
 
-	float OCCUPATION_SOL::PrendreProfondeurRacinaire(size_t index, int jour_julien)
+	void OCCUPATION_SOL::ConstruitTableJour(const vector<INFORMATION>& informations, vector<float>& table)
 	{
-		BOOST_ASSERT(jour_julien >= 1 && jour_julien <= 366);
+		const size_t nb_classe = PrendreNbClasse();
 
-		size_t index2 = 0;
+		table.resize(366 * nb_classe);
 
-		while (index2 < _profondeurs_racinaires.size() && jour_julien > _profondeurs_racinaires[index2].jour_julien)
-			++index2;
+		for (int jour = 1; jour <= 366; ++jour)
+		{
+			for (size_t n = 0; n < nb_classe; ++n)
+				table[static_cast<size_t>(jour - 1) * nb_classe + n] = InterpoleInformation(informations, n, jour);
+		}
+	}
 
-		if (index2 == _profondeurs_racinaires.size())
-			--index2;
-		
-		if (jour_julien == _profondeurs_racinaires[index2].jour_julien)
-			return _profondeurs_racinaires[index2].valeur[index];
+	float OCCUPATION_SOL::PrendreIndiceFoliaire(size_t index, int jour_julien)
+	{
+		BOOST_ASSERT(jour_julien >= 1 && jour_julien <= 366);
 
-		size_t index1 = index2 - 1;
+		return _indices_folieres_jour[static_cast<size_t>(jour_julien - 1) * PrendreNbClasse() + index];
+	}
 
-		return max(0.0f, 
-			InterpolationLineaire(
-			static_cast<float>(_profondeurs_racinaires[index1].jour_julien), 
-			_profondeurs_racinaires[index1].valeur[index], 
-			static_cast<float>(_profondeurs_racinaires[index2].jour_julien), 
-			_profondeurs_racinaires[index2].valeur[index], 
-			static_cast<float>(jour_julien)));
+	float OCCUPATION_SOL::PrendreProfondeurRacinaire(size_t index, int jour_julien)
+	{
+		BOOST_ASSERT(jour_julien >= 1 && jour_julien <= 366);
+
+		return _profondeurs_racinaires_jour[static_cast<size_t>(jour_julien - 1) * PrendreNbClasse() + index];
 	}
 
 	float OCCUPATION_SOL::PrendreAlbedo(size_t index, int jour_julien)
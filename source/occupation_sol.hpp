@@ -103,6 +103,12 @@ namespace HYDROTEL
 			std::vector<float> valeur;
 		};
 
+		// interpole la valeur de la classe pour le jour julien (1 a 366)
+		static float InterpoleInformation(const std::vector<INFORMATION>& informations, size_t index, int jour_julien);
+
+		// construit la table journaliere [(jour julien - 1) * nb classe + classe] de l'annee lue
+		void ConstruitTableJour(const std::vector<INFORMATION>& informations, std::vector<float>& table);
+
 		std::string _nom_fichier;
 
 		std::string _nom_fichier_indices_folieres;
@@ -118,6 +124,10 @@ namespace HYDROTEL
 		std::vector<INFORMATION> _albedo;
 		std::vector<INFORMATION> _hauteur_vegetation;
 
+		// tables journalieres (366 jours) de l'annee courante
+		std::vector<float> _indices_folieres_jour;
+		std::vector<float> _profondeurs_racinaires_jour;
+
 		int _annee_courante_indices_folieres;
 		int _annee_courante_profondeurs_racinaires;
 		int _annee_courante_albedo;
@@ -22,14 +22,19 @@
 
 #include "constantes.hpp"
 #include "erreur.hpp"
+#include "etat_binaire.hpp"
 #include "util.hpp"
 #include "version.hpp"
 
+#include <cstring>
 #include <fstream>
 #include <regex>
 #include <omp.h>
 
 #include <boost/algorithm/string/case_conv.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 #include <boost/thread/thread.hpp>
 
 
@@ -39,6 +44,50 @@ using namespace std;
 namespace HYDROTEL
 {
 
+	namespace
+	{
+		const char HGM_SIGNATURE[8] = { 'H', 'G', 'M', 'B', 'I', 'N', 'A', 'I' };
+		const uint32_t HGM_VERSION = 1;
+
+		//fichier binaire: entete, index forets (uint64), index eaux (uint64), hgm_manning[nb_zone], distri (float) [nb_zone * nb_debit]
+		struct ENTETE_HGM
+		{
+			char			signature[8];
+			uint32_t		version;
+			uint32_t		pas_de_temps;
+			uint64_t		taille_source;		//octets du fichier texte
+			int64_t			date_source;		//date de modification du fichier texte (time_t)
+			double			lame;
+			uint64_t		nb_foret;
+			uint64_t		nb_eau;
+			uint64_t		nb_zone;
+			uint64_t		nb_debit;
+		};
+
+		bool PrendreInfoSource(const string& nom_fichier, uint64_t& taille, int64_t& date)
+		{
+			boost::system::error_code ec;
+
+			taille = static_cast<uint64_t>(boost::filesystem::file_size(nom_fichier, ec));
+			if (ec)
+				return false;
+
+			date = static_cast<int64_t>(boost::filesystem::last_write_time(nom_fichier, ec));
+			return !ec;
+		}
+
+		//formate la valeur comme dans le fichier texte et retourne la valeur relue
+		double FormateReel(double valeur, string& texte)
+		{
+			ostringstream oss;
+			oss << valeur;
+			texte = oss.str();
+
+			return string_to_double(texte);
+		}
+	}
+
+
 	ONDE_CINEMATIQUE::ONDE_CINEMATIQUE(SIM_HYD& sim_hyd)
 		: RUISSELEMENT_SURFACE(sim_hyd, "ONDE CINEMATIQUE")
 	{
@@ -48,7 +97,10 @@ namespace HYDROTEL
 		_sauvegarde_tous_etat = false;
 
 		_lame = 0.006f;
+		_lame_hgm = 0.0;
 		_nb_debit = 0;
+
+		_debut_debits = 0;
 	}
 
 
@@ -154,6 +206,30 @@ namespace HYDROTEL
 
 	void ONDE_CINEMATIQUE::LectureEtat(DATE_HEURE date_courante)
 	{
+		TRACE_PERFORMANCE trace("ONDE_CINEMATIQUE::LectureEtat");
+
+		if(ETAT_BINAIRE::EstBinaire(_nom_fichier_lecture_etat))
+		{
+			LectureEtatBinaire(_nom_fichier_lecture_etat, _oc_zone);
+
+			if(_nom_fichier_lecture_etat.length() >= 15)
+			{
+				const string prefixes[] = { "surf_", "hypo_", "base_" };
+				vector<oc_zone>* oc[] = { &_oc_surf, &_oc_hypo, &_oc_base };
+
+				for(size_t i=0; i<3; i++)
+				{
+					string nom = _nom_fichier_lecture_etat;
+					nom.insert(nom.length()-14, prefixes[i]);
+
+					if(boost::filesystem::exists(nom))
+						LectureEtatBinaire(nom, *oc[i]);
+				}
+			}
+
+			return;
+		}
+
 		//_oc_zone
 		ifstream fichier(_nom_fichier_lecture_etat);
 		if (!fichier)
@@ -191,7 +267,7 @@ namespace HYDROTEL
 					}
 
 					for (size_t index = 0; index < _nb_debit; ++index)
-						_oc_zone[index_zone].debits[index] = valeurs[index+1];
+						_oc_zone[index_zone].debits[(_debut_debits + index) % _nb_debit] = valeurs[index+1];
 
 					vValidation.push_back(iIdent);
 				}
@@ -244,7 +320,7 @@ namespace HYDROTEL
 							}
 
 							for (size_t index = 0; index < _nb_debit; ++index)
-								_oc_surf[index_zone].debits[index] = valeurs[index+1];
+								_oc_surf[index_zone].debits[(_debut_debits + index) % _nb_debit] = valeurs[index+1];
 
 							vValidation.push_back(iIdent);
 						}
@@ -298,7 +374,7 @@ namespace HYDROTEL
 							}
 
 							for (size_t index = 0; index < _nb_debit; ++index)
-								_oc_hypo[index_zone].debits[index] = valeurs[index+1];
+								_oc_hypo[index_zone].debits[(_debut_debits + index) % _nb_debit] = valeurs[index+1];
 
 							vValidation.push_back(iIdent);
 						}
@@ -353,7 +429,7 @@ namespace HYDROTEL
 							}
 
 							for (size_t index = 0; index < _nb_debit; ++index)
-								_oc_base[index_zone].debits[index] = valeurs[index+1];
+								_oc_base[index_zone].debits[(_debut_debits + index) % _nb_debit] = valeurs[index+1];
 
 							vValidation.push_back(iIdent);
 						}
@@ -371,6 +447,8 @@ namespace HYDROTEL
 
 	void ONDE_CINEMATIQUE::SauvegardeEtat(DATE_HEURE date_courante) const
 	{
+		TRACE_PERFORMANCE trace("ONDE_CINEMATIQUE::SauvegardeEtat");
+
 		BOOST_ASSERT(_repertoire_ecriture_etat.size() != 0);
 
 		date_courante.AdditionHeure( _sim_hyd.PrendrePasDeTemps() );
@@ -384,6 +462,32 @@ namespace HYDROTEL
 		if(!RepertoireExiste(_repertoire_ecriture_etat))
 			CreeRepertoire(_repertoire_ecriture_etat);
 
+		if(_sim_hyd._output._bFichiersEtatsBinaire)
+		{
+			const string prefixes[] = { "", "surf_", "hypo_", "base_" };
+			const vector<oc_zone>* oc[] = { &_oc_zone, &_oc_surf, &_oc_hypo, &_oc_base };
+
+			for(size_t i=0; i<4; i++)
+			{
+				nom_fichier.str("");
+				nom_fichier << _repertoire_ecriture_etat;
+				if(_repertoire_ecriture_etat[_repertoire_ecriture_etat.size()-1] != '/')
+					nom_fichier << "/";
+
+				nom_fichier << setfill('0') 
+					<< "ruisselement_surface_" << prefixes[i] 
+					<< setw(4) << date_courante.PrendreAnnee() 
+					<< setw(2) << date_courante.PrendreMois() 
+					<< setw(2) << date_courante.PrendreJour() 
+					<< setw(2) << date_courante.PrendreHeure() 
+					<< _sim_hyd._output.ExtensionFichiersEtats();
+
+				SauvegardeEtatBinaire(nom_fichier.str(), *oc[i], date_courante);
+			}
+
+			return;
+		}
+
 		ZONES& zones = _sim_hyd.PrendreZones();
 		nbSimuler = _sim_hyd.PrendreZonesSimules().size();
 
@@ -425,7 +529,7 @@ namespace HYDROTEL
 				oss << setprecision(21) << setiosflags(ios::fixed);
 
 				for (size_t index = 0; index < _nb_debit; ++index)
-					oss << _oc_zone[index_zone].debits[index] << sSep;
+					oss << _oc_zone[index_zone].debits[(_debut_debits + index) % _nb_debit] << sSep;
 
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
@@ -475,7 +579,7 @@ namespace HYDROTEL
 				oss << setprecision(21) << setiosflags(ios::fixed);
 
 				for (size_t index = 0; index < _nb_debit; ++index)
-					oss << _oc_surf[index_zone].debits[index] << sSep;
+					oss << _oc_surf[index_zone].debits[(_debut_debits + index) % _nb_debit] << sSep;
 
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
@@ -525,7 +629,7 @@ namespace HYDROTEL
 				oss << setprecision(21) << setiosflags(ios::fixed);
 
 				for (size_t index = 0; index < _nb_debit; ++index)
-					oss << _oc_hypo[index_zone].debits[index] << sSep;
+					oss << _oc_hypo[index_zone].debits[(_debut_debits + index) % _nb_debit] << sSep;
 
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
@@ -575,7 +679,7 @@ namespace HYDROTEL
 				oss << setprecision(21) << setiosflags(ios::fixed);
 
 				for (size_t index = 0; index < _nb_debit; ++index)
-					oss << _oc_base[index_zone].debits[index] << sSep;
+					oss << _oc_base[index_zone].debits[(_debut_debits + index) % _nb_debit] << sSep;
 
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
@@ -587,20 +691,18 @@ namespace HYDROTEL
 	}
 
 
-	void ONDE_CINEMATIQUE::Initialise()
+	void ONDE_CINEMATIQUE::InitialiseParametres()
 	{
 		auto& occupation_sol = _sim_hyd.PrendreOccupationSol();
 		const size_t nb_zone = _sim_hyd.PrendreZones().PrendreNbZone();
 
-		vector<size_t> index_autres;
+		_index_autres.clear();
 		for (size_t index = 0; index < occupation_sol.PrendreNbClasse(); ++index)
 		{
 			if (find(begin(_index_eaux), end(_index_eaux), index) == end(_index_eaux) &&
 				find(begin(_index_forets), end(_index_forets), index) == end(_index_forets))
-				index_autres.push_back(index);
+				_index_autres.push_back(index);
 		}
-		index_autres.shrink_to_fit();
-		_index_autres.swap(index_autres);
 
 		// calcul pourcentage des classes integrees
 
@@ -630,6 +732,26 @@ namespace HYDROTEL
 		for (size_t index_zone = 0; index_zone < nb_zone; ++index_zone)
 			_pourcentage_autres[index_zone] = max(1.0 - (_pourcentage_forets[index_zone] + _pourcentage_eaux[index_zone]), 0.0);
 
+		//hgm deja en memoire: recalcul si la lame ou les coefficients de manning ont change (calibration);
+		//les matrices sont deja chargees apres le premier calcul
+		if(_nb_debit != 0 && (_lame != _lame_hgm || _manning_forets != _manning_forets_hgm || _manning_eaux != _manning_eaux_hgm || _manning_autres != _manning_autres_hgm))
+		{
+			CalculeHgm();
+
+			_lame_hgm = _lame;
+			_manning_forets_hgm = _manning_forets;
+			_manning_eaux_hgm = _manning_eaux;
+			_manning_autres_hgm = _manning_autres;
+		}
+	}
+
+
+	void ONDE_CINEMATIQUE::Initialise()
+	{
+		_debut_debits = 0;
+
+		InitialiseParametres();
+
 		//obtient la liste des fichiers hgm disponible
 		vector<string> listHGM;
 		string srcDir, str, sHGMini;
@@ -771,6 +893,11 @@ namespace HYDROTEL
 		if(_nb_debit == 0)
 			throw ERREUR("Error: hgm file is invalid (flows number equal 0): " + _nom_fichier_hgm);
 
+		_lame_hgm = _lame;
+		_manning_forets_hgm = _manning_forets;
+		_manning_eaux_hgm = _manning_eaux;
+		_manning_autres_hgm = _manning_autres;
+
 		if(!_nom_fichier_lecture_etat.empty())
 			LectureEtat( _sim_hyd.PrendreDateDebut() );
 
@@ -787,67 +914,66 @@ namespace HYDROTEL
 		DATE_HEURE date_courante = _sim_hyd.PrendreDateCourante();
 
 		TRONCON* troncon;
-		size_t nb_pixel, index_zone, index, j;
-		double dPdts, m2_sec, resolution, production, prod_surf, prod_hypo, prod_base, tmp1, tmp2;
+		size_t nb_pixel, index_zone, debut;
+		double dPdts, m2_sec, resolution, production;
 		float apport;
-		int pdts;
+		int pdts, index, nb_zone_simule;
 
 		pdts = _sim_hyd.PrendrePasDeTemps() * 60 * 60;
 		dPdts = static_cast<double>(pdts);
 
 		resolution = static_cast<double>(zones.PrendreResolution());
 
-		for(index = 0; index < index_zones.size(); index++)
+		nb_zone_simule = static_cast<int>(index_zones.size());
+		debut = _debut_debits;
+
+		ETAT_ZONES& etat = zones.PrendreEtat();
+
+		//convolution des productions avec les distributions (hydrogramme unitaire) des sous bassins
+		//chaque uhrh est independante; le resultat est identique peu importe le nombre de thread
+		#pragma omp parallel for num_threads(_sim_hyd.PrendreNbThread()) schedule(dynamic, 64)
+		for(index = 0; index < nb_zone_simule; index++)
 		{
-			index_zone = index_zones[index];
+			size_t idx = index_zones[index];
 
-			ZONE& zone = zones[index_zone];
+			if(zones[idx].PrendreTypeZone() == ZONE::SOUS_BASSIN)
+			{
+				const float surf = etat._surf[idx];
+				const float hypo = etat._hypo[idx];
+				const float base = etat._base[idx];
+
+				AjouteDistribution(_oc_zone[idx], static_cast<double>(surf + hypo + base) / 1000.0, debut);	// mm ====> m
 
-			production = static_cast<double>(zone.PrendreProductionTotal()) / 1000.0; // mm ====> m
+				AjouteDistribution(_oc_surf[idx], static_cast<double>(surf) / 1000.0, debut);	//mm -> m
+				AjouteDistribution(_oc_hypo[idx], static_cast<double>(hypo) / 1000.0, debut);	//mm -> m
+				AjouteDistribution(_oc_base[idx], static_cast<double>(base) / 1000.0, debut);	//mm -> m
+			}
+		}
+
+		for(index = 0; index < nb_zone_simule; index++)
+		{
+			index_zone = index_zones[index];
 
-			prod_surf = static_cast<double>(zone.PrendreProdSurf()) / 1000.0;	//mm -> m
-			prod_hypo = static_cast<double>(zone.PrendreProdHypo()) / 1000.0;	//mm -> m
-			prod_base = static_cast<double>(zone.PrendreProdBase()) / 1000.0;	//mm -> m
+			ZONE& zone = zones[index_zone];
 
 			switch (zone.PrendreTypeZone())
 			{
 			case ZONE::SOUS_BASSIN:
-
-				for(j=0; j<_nb_debit; j++)
-				{						
-					tmp1 = _oc_zone[index_zone].debits[j];
-					tmp2 = _oc_zone[index_zone].distri[j];
-					tmp1 = tmp1 + tmp2 * production / _lame;
-					_oc_zone[index_zone].debits[j] = tmp1;
-
-					tmp1 = _oc_surf[index_zone].debits[j];
-					tmp2 = _oc_surf[index_zone].distri[j];
-					tmp1 = tmp1 + tmp2 * prod_surf / _lame;
-					_oc_surf[index_zone].debits[j] = tmp1;
-
-					tmp1 = _oc_hypo[index_zone].debits[j];
-					tmp2 = _oc_hypo[index_zone].distri[j];
-					tmp1 = tmp1 + tmp2 * prod_hypo / _lame;
-					_oc_hypo[index_zone].debits[j] = tmp1;
-
-					tmp1 = _oc_base[index_zone].debits[j];
-					tmp2 = _oc_base[index_zone].distri[j];
-					tmp1 = tmp1 + tmp2 * prod_base / _lame;
-					_oc_base[index_zone].debits[j] = tmp1;
-				}
 				break;
 
 			case ZONE::LAC:
 
+				production = static_cast<double>(zone.PrendreProductionTotal()) / 1000.0; // mm ====> m
+
 				nb_pixel = zone.PrendreNbPixel();
 
 				m2_sec = static_cast<double>(nb_pixel) * resolution * resolution / dPdts;
 
-				_oc_zone[index_zone].debits[0] = m2_sec * production;
+				_oc_zone[index_zone].debits[debut] = m2_sec * production;
 
-				_oc_surf[index_zone].debits[0] = _oc_zone[index_zone].debits[0];
-				_oc_hypo[index_zone].debits[0] = 0.0;
-				_oc_base[index_zone].debits[0] = 0.0;
+				_oc_surf[index_zone].debits[debut] = _oc_zone[index_zone].debits[debut];
+				_oc_hypo[index_zone].debits[debut] = 0.0;
+				_oc_base[index_zone].debits[debut] = 0.0;
 				break;
 
 			default:
@@ -856,36 +982,30 @@ namespace HYDROTEL
 
 			troncon = zone.PrendreTronconAval();
 
-			zone._apport_lateral_uhrh = static_cast<float>(_oc_zone[index_zone].debits[0]);
+			etat._apport_lateral_uhrh[index_zone] = static_cast<float>(_oc_zone[index_zone].debits[debut]);
 
-			apport = troncon->PrendreApportLateral() + zone._apport_lateral_uhrh;
+			apport = troncon->PrendreApportLateral() + etat._apport_lateral_uhrh[index_zone];
 			troncon->ChangeApportLateral(max(0.0f, apport));
 
-			troncon->_surf = max(0.0f, troncon->_surf + static_cast<float>(_oc_surf[index_zone].debits[0]));
-			troncon->_hypo = max(0.0f, troncon->_hypo + static_cast<float>(_oc_hypo[index_zone].debits[0]));
-			troncon->_base = max(0.0f, troncon->_base + static_cast<float>(_oc_base[index_zone].debits[0]));
+			troncon->_surf = max(0.0f, troncon->_surf + static_cast<float>(_oc_surf[index_zone].debits[debut]));
+			troncon->_hypo = max(0.0f, troncon->_hypo + static_cast<float>(_oc_hypo[index_zone].debits[debut]));
+			troncon->_base = max(0.0f, troncon->_base + static_cast<float>(_oc_base[index_zone].debits[debut]));
 
-			zone._ecoulementSurf = static_cast<float>(_oc_surf[index_zone].debits[0]);
-			zone._ecoulementHypo = static_cast<float>(_oc_hypo[index_zone].debits[0]);
-			zone._ecoulementBase = static_cast<float>(_oc_base[index_zone].debits[0]);
+			etat._ecoulement_surf[index_zone] = static_cast<float>(_oc_surf[index_zone].debits[debut]);
+			etat._ecoulement_hypo[index_zone] = static_cast<float>(_oc_hypo[index_zone].debits[debut]);
+			etat._ecoulement_base[index_zone] = static_cast<float>(_oc_base[index_zone].debits[debut]);
 
-			// decale les debits
-			for(j=0; j<_nb_debit-1; j++)
-			{
-				_oc_zone[index_zone].debits[j] = _oc_zone[index_zone].debits[j + 1];
+			// le debit courant devient le dernier debit du tampon circulaire
+			_oc_zone[index_zone].debits[debut] = 0.0;
 
-				_oc_surf[index_zone].debits[j] = _oc_surf[index_zone].debits[j + 1];
-				_oc_hypo[index_zone].debits[j] = _oc_hypo[index_zone].debits[j + 1];
-				_oc_base[index_zone].debits[j] = _oc_base[index_zone].debits[j + 1];
-			}
-			
-			_oc_zone[index_zone].debits[_nb_debit - 1] = 0.0;
-
-			_oc_surf[index_zone].debits[_nb_debit - 1] = 0.0;
-			_oc_hypo[index_zone].debits[_nb_debit - 1] = 0.0;
-			_oc_base[index_zone].debits[_nb_debit - 1] = 0.0;
+			_oc_surf[index_zone].debits[debut] = 0.0;
+			_oc_hypo[index_zone].debits[debut] = 0.0;
+			_oc_base[index_zone].debits[debut] = 0.0;
 		}
 
+		// decale les debits
+		_debut_debits = (_debut_debits + 1) % _nb_debit;
+
 		if (_sauvegarde_tous_etat || (_sauvegarde_etat && _date_sauvegarde_etat - pas_de_temps == date_courante))
 			SauvegardeEtat(date_courante);
 
@@ -893,6 +1013,76 @@ namespace HYDROTEL
 	}
 
 
+	void ONDE_CINEMATIQUE::LectureEtatBinaire(const string& nom_fichier, vector<oc_zone>& oc)
+	{
+		ETAT_BINAIRE etat;
+		etat.Lecture(nom_fichier, _nb_debit);
+
+		if(etat.PrendreNbColonne() != _nb_debit)
+		{
+			ostringstream oss;
+			oss << "RUISSELEMENT_SURFACE; fichier etat ONDE_CINEMATIQUE; " + nom_fichier + "; nombre de valeur invalide; selon les parametres actuels, il devrait y avoir "  << _nb_debit << " pas de temps pour les debits.";
+			throw ERREUR_LECTURE_FICHIER(oss.str());
+		}
+
+		vector<size_t> index_ligne = etat.AssocieIndex(_sim_hyd.PrendreZones(), _sim_hyd.PrendreZonesSimules(), "RUISSELEMENT_SURFACE; fichier etat ONDE_CINEMATIQUE");
+
+		for(size_t ligne=0; ligne<index_ligne.size(); ligne++)
+		{
+			if(index_ligne[ligne] != string::npos)
+			{
+				const double* valeurs = etat.PrendreLigne(ligne);
+				vector<double>& debits = oc[index_ligne[ligne]].debits;
+
+				for (size_t index = 0; index < _nb_debit; ++index)
+					debits[(_debut_debits + index) % _nb_debit] = valeurs[index];
+			}
+		}
+	}
+
+
+	void ONDE_CINEMATIQUE::SauvegardeEtatBinaire(const string& nom_fichier, const vector<oc_zone>& oc, const DATE_HEURE& date_courante) const
+	{
+		ZONES& zones = _sim_hyd.PrendreZones();
+		ETAT_BINAIRE etat;
+		vector<string> colonnes;
+
+		for (size_t index = 0; index < _nb_debit; ++index)
+			colonnes.push_back("DEBIT " + to_string(index+1));
+
+		etat.Initialise(PrendreNomSousModele(), date_courante, colonnes, _sim_hyd.PrendreZonesSimules().size());
+
+		for(size_t index_zone : _sim_hyd.PrendreZonesSimules())
+		{
+			double* valeurs = etat.AjouteLigne(zones[index_zone].PrendreIdent());
+			const vector<double>& debits = oc[index_zone].debits;
+
+			for (size_t index = 0; index < _nb_debit; ++index)
+				valeurs[index] = debits[(_debut_debits + index) % _nb_debit];
+		}
+
+		etat.Sauvegarde(nom_fichier);
+	}
+
+
+	void ONDE_CINEMATIQUE::AjouteDistribution(oc_zone& oc, double production, size_t debut)
+	{
+		const double* distri = oc.distri.data();
+		double* debits = oc.debits.data();
+
+		size_t j, nb;
+
+		// debits[debut + j] (tampon circulaire) += distri[j] * production / lame; deux segments contigus
+		nb = _nb_debit - debut;
+
+		for(j=0; j<nb; j++)
+			debits[debut + j] = debits[debut + j] + distri[j] * production / _lame;
+
+		for(j=nb; j<_nb_debit; j++)
+			debits[j - nb] = debits[j - nb] + distri[j] * production / _lame;
+	}
+
+
 	void ONDE_CINEMATIQUE::Termine()
 	{
 		_pourcentage_forets.clear();
@@ -936,7 +1126,10 @@ namespace HYDROTEL
 		fichier << "PAS DE TEMPS;" << _sim_hyd.PrendrePasDeTemps() << endl;
 		fichier << endl;
 
-		fichier << "LAME;" << _lame << endl;
+		string texte;
+		double lame = FormateReel(_lame, texte);
+
+		fichier << "LAME;" << texte << endl;
 		fichier << endl;
 
 		fichier << "CLASSE INTEGRE FORETS;";
@@ -954,13 +1147,20 @@ namespace HYDROTEL
 		ZONES& zones = _sim_hyd.PrendreZones();
 		const size_t nb_zone = zones.PrendreNbZone();
 
+		vector<hgm_manning> manning(nb_zone);
+
 		fichier << "UHRH; MANNING FORETS; MANNING EAUX; MANNING AUTRES" << endl;
 		for (size_t index_zone = 0; index_zone < nb_zone; ++index_zone)
 		{
-			fichier << zones[index_zone].PrendreIdent() << ';'
-				<< _manning_forets[index_zone] << ';'
-				<< _manning_eaux[index_zone] << ';'
-				<< _manning_autres[index_zone] << endl;
+			manning[index_zone].ident = zones[index_zone].PrendreIdent();
+
+			fichier << zones[index_zone].PrendreIdent() << ';';
+			manning[index_zone].foret = FormateReel(_manning_forets[index_zone], texte);
+			fichier << texte << ';';
+			manning[index_zone].eau = FormateReel(_manning_eaux[index_zone], texte);
+			fichier << texte << ';';
+			manning[index_zone].autre = FormateReel(_manning_autres[index_zone], texte);
+			fichier << texte << endl;
 		}
 		fichier << endl;
 
@@ -974,14 +1174,169 @@ namespace HYDROTEL
 		}
 		fichier << endl;
 
+		//le fichier binaire contient les valeurs telles que relues du fichier texte
+		vector<float> distri(nb_zone * _nb_debit);
+
 		for (size_t index_zone = 0; index_zone < nb_zone; ++index_zone)
 		{
-			fichier << zones[index_zone].PrendreIdent();
+			ostringstream oss;
+			oss << zones[index_zone].PrendreIdent();
 			for (size_t index_distri = 0; index_distri < _nb_debit; ++index_distri)
 			{
-				fichier << ';' << _oc_zone[index_zone].distri[index_distri];
+				oss << ';' << _oc_zone[index_zone].distri[index_distri];
 			}
-			fichier << endl;
+
+			texte = oss.str();
+			fichier << texte << endl;
+
+			auto val = extrait_fvaleur(texte, ";");
+			copy(begin(val) + 1, end(val), begin(distri) + index_zone * _nb_debit);
+		}
+
+		fichier.close();
+		if (!fichier)
+			throw ERREUR_ECRITURE_FICHIER(_nom_fichier_hgm);
+
+		SauvegardeHgmBinaire(lame, manning, distri);
+	}
+
+
+	bool ONDE_CINEMATIQUE::LectureHgmBinaire()
+	{
+		ENTETE_HGM entete;
+
+		memset(&entete, 0, sizeof(entete));
+		if (!PrendreInfoSource(_nom_fichier_hgm, entete.taille_source, entete.date_source))
+			return false;
+
+		try
+		{
+			boost::interprocess::file_mapping fichier((_nom_fichier_hgm + ".bin").c_str(), boost::interprocess::read_only);
+			boost::interprocess::mapped_region region(fichier, boost::interprocess::read_only);
+
+			const char* donnees = static_cast<const char*>(region.get_address());
+			const size_t taille = region.get_size();
+
+			if (taille < sizeof(ENTETE_HGM))
+				return false;
+
+			ENTETE_HGM lu;
+			memcpy(&lu, donnees, sizeof(lu));
+
+			if (memcmp(lu.signature, HGM_SIGNATURE, sizeof(HGM_SIGNATURE)) != 0 || lu.version != HGM_VERSION)
+				return false;
+
+			//fichier texte modifie depuis l'ecriture du fichier binaire
+			if (lu.taille_source != entete.taille_source || lu.date_source != entete.date_source)
+				return false;
+
+			ZONES& zones = _sim_hyd.PrendreZones();
+			const size_t nb_zone = zones.PrendreNbZone();
+
+			if (lu.pas_de_temps != _sim_hyd.PrendrePasDeTemps() || lu.lame != _lame ||
+				lu.nb_foret != _index_forets.size() || lu.nb_eau != _index_eaux.size() || lu.nb_zone != nb_zone)
+				return false;
+
+			const size_t nb_debit = static_cast<size_t>(lu.nb_debit);
+
+			if (taille != sizeof(ENTETE_HGM) + (_index_forets.size() + _index_eaux.size()) * sizeof(uint64_t) + 
+				nb_zone * sizeof(hgm_manning) + nb_zone * nb_debit * sizeof(float))
+				return false;
+
+			const char* pos = donnees + sizeof(ENTETE_HGM);
+			uint64_t index;
+
+			for (size_t i = 0; i < _index_forets.size(); ++i, pos+= sizeof(uint64_t))
+			{
+				memcpy(&index, pos, sizeof(index));
+				if (index != _index_forets[i])
+					return false;
+			}
+
+			for (size_t i = 0; i < _index_eaux.size(); ++i, pos+= sizeof(uint64_t))
+			{
+				memcpy(&index, pos, sizeof(index));
+				if (index != _index_eaux[i])
+					return false;
+			}
+
+			hgm_manning manning;
+
+			for (size_t index_zone = 0; index_zone < nb_zone; ++index_zone, pos+= sizeof(hgm_manning))
+			{
+				memcpy(&manning, pos, sizeof(manning));
+
+				if (manning.ident != zones[index_zone].PrendreIdent() ||
+					manning.foret != _manning_forets[index_zone] ||
+					manning.eau != _manning_eaux[index_zone] ||
+					manning.autre != _manning_autres[index_zone])
+					return false;
+			}
+
+			const float* distri = reinterpret_cast<const float*>(pos);
+
+			vector<oc_zone> oc_zone(nb_zone);
+
+			for (size_t index_zone = 0; index_zone < nb_zone; ++index_zone)
+			{
+				oc_zone[index_zone].debits.resize(nb_debit);
+				oc_zone[index_zone].distri.assign(distri + index_zone * nb_debit, distri + (index_zone + 1) * nb_debit);
+			}
+
+			_nb_debit = nb_debit;
+			_oc_zone.swap(oc_zone);
+
+			_oc_surf = _oc_zone;
+			_oc_hypo = _oc_zone;
+			_oc_base = _oc_zone;
+		}
+		catch (...)
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+
+	void ONDE_CINEMATIQUE::SauvegardeHgmBinaire(double lame, const vector<hgm_manning>& manning, const vector<float>& distri) const
+	{
+		ENTETE_HGM entete;
+		string nom_fichier = _nom_fichier_hgm + ".bin";
+
+		memset(&entete, 0, sizeof(entete));
+		memcpy(entete.signature, HGM_SIGNATURE, sizeof(HGM_SIGNATURE));
+		entete.version = HGM_VERSION;
+
+		if (!PrendreInfoSource(_nom_fichier_hgm, entete.taille_source, entete.date_source))
+			return;
+
+		entete.pas_de_temps = _sim_hyd.PrendrePasDeTemps();
+		entete.lame = lame;
+		entete.nb_foret = _index_forets.size();
+		entete.nb_eau = _index_eaux.size();
+		entete.nb_zone = manning.size();
+		entete.nb_debit = _nb_debit;
+
+		vector<uint64_t> index_forets(begin(_index_forets), end(_index_forets));
+		vector<uint64_t> index_eaux(begin(_index_eaux), end(_index_eaux));
+
+		//le fichier binaire est optionnel; une erreur d'ecriture (ex: repertoire en lecture seule) est ignoree
+		ofstream fichier(nom_fichier, ios::binary | ios::trunc);
+		if (!fichier)
+			return;
+
+		fichier.write(reinterpret_cast<const char*>(&entete), sizeof(entete));
+		fichier.write(reinterpret_cast<const char*>(index_forets.data()), static_cast<streamsize>(index_forets.size() * sizeof(uint64_t)));
+		fichier.write(reinterpret_cast<const char*>(index_eaux.data()), static_cast<streamsize>(index_eaux.size() * sizeof(uint64_t)));
+		fichier.write(reinterpret_cast<const char*>(manning.data()), static_cast<streamsize>(manning.size() * sizeof(hgm_manning)));
+		fichier.write(reinterpret_cast<const char*>(distri.data()), static_cast<streamsize>(distri.size() * sizeof(float)));
+		fichier.close();
+
+		if (!fichier)
+		{
+			boost::system::error_code ec;
+			boost::filesystem::remove(nom_fichier, ec);
 		}
 	}
 
@@ -993,6 +1348,9 @@ namespace HYDROTEL
 		if (!fichier)
 			throw ERREUR("The specified HGM file does not exist");
 
+		if (LectureHgmBinaire())
+			return;
+
 		fichier.exceptions(ios::failbit | ios::badbit);
 
 		string ligne;
@@ -1025,7 +1383,8 @@ namespace HYDROTEL
 				lire_cle_valeur(fichier2, cle, valeur); // lame
 				getline_mod(fichier2, ligne);
 
-				if (_lame != string_to_double(valeur))
+				double lame = string_to_double(valeur);
+				if (_lame != lame)
 					throw ERREUR("the depth specified in the HGM file is different from the depth specified in the simulation file for the kinematic wave model");
 
 				// lecture des classes integrees
@@ -1054,6 +1413,8 @@ namespace HYDROTEL
 				ZONES& zones = _sim_hyd.PrendreZones();
 				const size_t nb_zone = zones.PrendreNbZone();
 
+				vector<hgm_manning> manning(nb_zone);
+
 				getline_mod(fichier2, ligne); // commentaires
 				for (size_t index_zone = 0; index_zone < nb_zone; ++index_zone)
 				{
@@ -1076,6 +1437,11 @@ namespace HYDROTEL
 
 					if (_manning_autres[index] != manning_autre)
 						throw ERREUR("the `other` class manning value of the HGM file are different from the classes specified in the simulation file for the kinematic wave model");
+
+					manning[index_zone].ident = ident;
+					manning[index_zone].foret = manning_foret;
+					manning[index_zone].eau = manning_eau;
+					manning[index_zone].autre = manning_autre;
 				}
 				getline_mod(fichier2, ligne);
 
@@ -1086,6 +1452,7 @@ namespace HYDROTEL
 				iss >> _nb_debit;
 
 				vector<oc_zone> oc_zone(nb_zone);
+				vector<float> distri(nb_zone * _nb_debit);
 
 				getline_mod(fichier2, ligne); // commentaires
 				for (size_t index_zone = 0; index_zone < nb_zone; ++index_zone)
@@ -1102,6 +1469,7 @@ namespace HYDROTEL
 					for (size_t index_distri = 0; index_distri < _nb_debit; ++index_distri)
 					{
 						oc_zone[index_zone].distri[index_distri] = val[index_distri + 1];
+						distri[index_zone * _nb_debit + index_distri] = val[index_distri + 1];
 					}
 				}
 
@@ -1110,6 +1478,9 @@ namespace HYDROTEL
 				_oc_surf = _oc_zone;
 				_oc_hypo = _oc_zone;
 				_oc_base = _oc_zone;
+
+				fichier2.close();
+				SauvegardeHgmBinaire(lame, manning, distri);
 			}
 			catch(const ERREUR& err)
 			{
@@ -1170,7 +1541,7 @@ namespace HYDROTEL
 		double man;
 		string str;
 		size_t ligne, colonne, idx3, idxZone, stMaxdeb, z;
-		int uhrhNoData, ident, tmax, maxThread, nbThread, maxdeb;
+		int uhrhNoData, ident, tmax, nbThread, maxdeb;
 
 		vector<string> vErr;
 		vector<int> vTmax;
@@ -1305,17 +1676,7 @@ namespace HYDROTEL
 		//omp_set_dynamic(0);     //explicitly disable dynamic teams
 		//omp_set_num_threads(n); //use n threads for all consecutive parallel regions
 
-		maxThread = omp_get_max_threads();
-
-		if(_sim_hyd._nbThread == 0)
-			nbThread = maxThread;
-		else
-		{
-			if(_sim_hyd._nbThread > maxThread)
-				nbThread = maxThread;
-			else
-				nbThread = _sim_hyd._nbThread;
-		}
+		nbThread = _sim_hyd.PrendreNbThread();
 
 		omp_set_num_threads(nbThread);
 
@@ -1913,91 +2274,90 @@ namespace HYDROTEL
 	//}
 
 
+	//ordonne les carreaux de la zone de l'amont vers l'aval (tri topologique selon les orientations)
+	//ordre: longueur du plus long chemin amont, puis ligne et colonne
 	void ONDE_CINEMATIQUE::TriCarreaux3(RasterInt2* uhrh, rectangle r, int ident, vector<size_t>& ind)
 	{
-		size_t idx;
-		int k, zone, v_ori, v_mat, l, i, j;
-		int a, b, iNbCarreau;
-
-		size_t nbPixel = (r.max_lig - r.min_lig + 1) * (r.max_col - r.min_col + 1);
-		int nb_ligne = static_cast<int>(r.max_lig - r.min_lig + 1);
-		int nb_colonne = static_cast<int>(r.max_col - r.min_col + 1);
-		int li = static_cast<int>(r.min_lig);
-		int ci = static_cast<int>(r.min_col);
+		size_t idx, p, q, l, nbPixel, nb_ligne, nb_colonne, li, ci, i, j, niveau_max;
+		int a, b;
 
-		//allocation temporaire pour le calcul
-		int* mat = new int[nbPixel]();	//Zero-initialized -> ()
+		const size_t aucun = static_cast<size_t>(-1);
 
-		//trouve l'ordre d'valuation
-		int fini = 0;
+		nb_ligne = r.max_lig - r.min_lig + 1;
+		nb_colonne = r.max_col - r.min_col + 1;
+		nbPixel = nb_ligne * nb_colonne;
+		li = r.min_lig;
+		ci = r.min_col;
 
-		iNbCarreau = static_cast<int>(r.nb_car);
+		vector<char> dans_zone(nbPixel, 0);
+		vector<size_t> aval(nbPixel, aucun);	//carreau aval dans le rectangle
+		vector<size_t> nb_amont(nbPixel, 0);	//nb de carreaux amont de la zone non traites
+		vector<size_t> niveau(nbPixel, 0);		//longueur du plus long chemin amont (ordre d'evaluation)
 
-		for(k=0; !fini && k!=iNbCarreau; k++)
+		for(i=0; i!=nb_ligne; i++)
 		{
-			fini = 1;
-			for(i=0; i!=nb_ligne; i++)
+			for(j=0; j!=nb_colonne; j++)
 			{
-				for(j=0; j!=nb_colonne; j++)
+				idx = (li+i) * uhrh->_xSize + ci + j;
+				if(uhrh->_values[idx] == ident)
 				{
-					idx = (li+i) * uhrh->_xSize + ci + j;
-
-					zone = uhrh->_values[idx];
-					v_ori = _sim_hyd._pRasterOri->_values[idx];
-
-					v_mat = mat[i*nb_colonne+j];
-
-					if(zone == ident && v_mat >= k)
-					{
-						fini = 0;
-
-						a = 0;
-
-						CarreauAval(li+i, ci+j, v_ori, a, b);
-
-						a-= li;
-						b-= ci;
-
-						if(a >= 0 && a < nb_ligne && b >= 0 && b < nb_colonne)
-						{
-							idx = a * nb_colonne + b;
-							mat[idx] = k + 1;
-						}
-					}
+					p = i * nb_colonne + j;
+					dans_zone[p] = 1;
+					CarreauAval(static_cast<int>(li+i), static_cast<int>(ci+j), _sim_hyd._pRasterOri->_values[idx], a, b);
+					a-= static_cast<int>(li);
+					b-= static_cast<int>(ci);
+					if(a >= 0 && a < static_cast<int>(nb_ligne) && b >= 0 && b < static_cast<int>(nb_colonne))
+						aval[p] = static_cast<size_t>(a) * nb_colonne + static_cast<size_t>(b);
 				}
 			}
 		}
 
-		//On devrait faire un test ici pour valider la matrice d'ordre "mat".
-		//Si un de ces elements est egale au nombre de carreaux "iNbCarreau"
-		//alors il y a un cycle, d'ou un message d'erreur a l'usager indiquant
-		//qu'il y a un cycle dans sa matrice d'orientations.
-		//Aussi, l'exutoire de la zone doit avoir le nombre le plus eleve dans "mat".
+		//traitement des carreaux sans carreau amont non traite (Kahn)
+		vector<size_t> file;
+		file.reserve(r.nb_car);
 
-		//transfert dans les vecteurs
-		l = 0;
-		fini = 0;
-		for(k=0; !fini && k!=iNbCarreau; k++)
+		for(p=0; p!=nbPixel; p++)
 		{
-			fini = 1;
-			for(i=0; i!=nb_ligne; i++)
-			{
-				for(j=0; j!=nb_colonne; j++)
-				{
-					idx = (li+i) * uhrh->_xSize + ci + j;
+			if(dans_zone[p] && aval[p] != aucun && dans_zone[aval[p]])
+				++nb_amont[aval[p]];
+		}
 
-					zone = uhrh->_values[idx];
+		for(p=0; p!=nbPixel; p++)
+		{
+			if(dans_zone[p] && nb_amont[p] == 0)
+				file.push_back(p);
+		}
 
-					v_mat = mat[i * nb_colonne + j];
+		niveau_max = 0;
+		for(l=0; l!=file.size(); l++)
+		{
+			p = file[l];
+			niveau_max = max(niveau_max, niveau[p]);
+			q = aval[p];
+			if(q != aucun && dans_zone[q])
+			{
+				niveau[q] = max(niveau[q], niveau[p] + 1);
+				if(--nb_amont[q] == 0)
+					file.push_back(q);
+			}
+		}
 
-					if(zone == ident && v_mat == k)
-					{
-						fini = 0;
-						ind[l] = idx;
+		//les carreaux d'un cycle (ou en aval d'un cycle) ne sont pas traites et ne sont pas ajoutes a ind
 
-						++l;
-					}
-				}
+		//position de chaque niveau dans ind
+		vector<size_t> debut(niveau_max + 2, 0);
+		for(l=0; l!=file.size(); l++)
+			++debut[niveau[file[l]] + 1];
+		for(l=1; l!=debut.size(); l++)
+			debut[l]+= debut[l-1];
+
+		for(i=0; i!=nb_ligne; i++)
+		{
+			for(j=0; j!=nb_colonne; j++)
+			{
+				p = i * nb_colonne + j;
+				if(dans_zone[p] && nb_amont[p] == 0)
+					ind[debut[niveau[p]]++] = (li+i) * uhrh->_xSize + ci + j;
 			}
 		}
 	}
@@ -2361,4 +2721,60 @@ namespace HYDROTEL
 		}
 	}
 
+
+	void ONDE_CINEMATIQUE::SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const
+	{
+		const vector<oc_zone>* hydrogrammes[] = { &_oc_zone, &_oc_surf, &_oc_hypo, &_oc_base };
+
+		for(size_t x=0; x<4; x++)
+		{
+			etat.Ecrit(hydrogrammes[x]->size());
+			for(size_t index_zone=0; index_zone<hydrogrammes[x]->size(); index_zone++)
+				etat.Ecrit((*hydrogrammes[x])[index_zone].debits);
+		}
+
+		etat.Ecrit(_debut_debits);
+	}
+
+	void ONDE_CINEMATIQUE::LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur)
+	{
+		vector<oc_zone>* hydrogrammes[] = { &_oc_zone, &_oc_surf, &_oc_hypo, &_oc_base };
+		size_t nb;
+
+		for(size_t x=0; x<4; x++)
+		{
+			lecteur.Lit(nb);
+			if(nb != hydrogrammes[x]->size())
+				throw ERREUR("In-memory state: ONDE_CINEMATIQUE: number of zones does not match the simulation.");
+
+			for(size_t index_zone=0; index_zone<nb; index_zone++)
+				lecteur.Lit((*hydrogrammes[x])[index_zone].debits);
+		}
+
+		lecteur.Lit(_debut_debits);
+
+		//hgm recalcule depuis la sauvegarde (calibration): debits remis dans l'ordre et ajustes au nouveau nombre de pas de temps
+		bool realigne = false;
+
+		for(size_t x=0; x<4; x++)
+		{
+			for(auto& oc : *hydrogrammes[x])
+			{
+				const size_t nb_sauve = oc.debits.size();
+				if(nb_sauve == 0 || nb_sauve == _nb_debit)
+					continue;
+
+				vector<double> debits(_nb_debit, 0.0);
+				for(size_t index=0; index<min(nb_sauve, _nb_debit); index++)
+					debits[index] = oc.debits[(_debut_debits + index) % nb_sauve];
+
+				oc.debits.swap(debits);
+				realigne = true;
+			}
+		}
+
+		if(realigne)
+			_debut_debits = 0;
+	}
+
 }
@@ -24,6 +24,8 @@
 
 #include "ruisselement_surface.hpp"
 
+#include <cstdint>
+
 
 namespace HYDROTEL
 {
@@ -46,6 +48,12 @@ namespace HYDROTEL
 
 		virtual void SauvegardeParametres();
 
+		virtual void InitialiseParametres();
+
+		virtual void SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const;
+
+		virtual void LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur);
+
 		double PrendreLame() const;
 
 		std::string PrendreNomFichierHgm() const;
@@ -112,21 +120,41 @@ namespace HYDROTEL
 			size_t nb_car;
 		};
 		
+		//ligne du fichier hgm binaire (valeurs telles que relues du fichier texte)
+		struct hgm_manning
+		{
+			int64_t ident;
+			double foret;
+			double eau;
+			double autre;
+		};
+
 		void CalculePourcentageOccupation();
 		void LectureHgm();
 		void SauvegardeHgm();
 
+		//fichier hgm binaire (_nom_fichier_hgm + ".bin") associe au fichier texte; lu par projection en memoire
+		bool LectureHgmBinaire();
+		void SauvegardeHgmBinaire(double lame, const std::vector<hgm_manning>& manning, const std::vector<float>& distri) const;
+
 		void CalculeHgm();
 
 		//void TriCarreaux(const RASTER<int>& grille, const RASTER<int>& orientations, rectangle r, int ident, std::vector<size_t>& ind_lig, std::vector<size_t>& ind_col);
 		//void TriCarreaux2(RasterInt2* uhrh, rectangle2 r, int ident, std::vector<size_t>& ind);
 		void TriCarreaux3(RasterInt2* uhrh, rectangle r, int ident, std::vector<size_t>& ind);
 
+		// ajoute la distribution de la production aux debits de la zone (tampon circulaire)
+		void AjouteDistribution(oc_zone& oc, double production, size_t debut);
+
 		void Ruisselement(double arete, double pte, double man, double ra, double rb, double rc, double p, int dt, double& rd);
 
 		void LectureEtat(DATE_HEURE date_courante);
 		void SauvegardeEtat(DATE_HEURE date_courante) const;
 
+		// fichiers d'etat binaires (ETAT_BINAIRE); une colonne par pas de temps des debits
+		void LectureEtatBinaire(const std::string& nom_fichier, std::vector<oc_zone>& oc);
+		void SauvegardeEtatBinaire(const std::string& nom_fichier, const std::vector<oc_zone>& oc, const DATE_HEURE& date_courante) const;
+
 		SIM_HYD*				_pSim_hyd;
 
 		std::string				_nom_fichier_hgm;
@@ -137,6 +165,12 @@ namespace HYDROTEL
 		std::vector<double>		_manning_eaux;
 		std::vector<double>		_manning_autres;
 
+		// parametres ayant servi au calcul de l'hgm en memoire (calibration)
+		double					_lame_hgm;
+		std::vector<double>		_manning_forets_hgm;
+		std::vector<double>		_manning_eaux_hgm;
+		std::vector<double>		_manning_autres_hgm;
+
 		std::vector<size_t>		_index_forets;
 		std::vector<size_t>		_index_eaux;
 		std::vector<size_t>		_index_autres;
@@ -164,6 +198,8 @@ namespace HYDROTEL
 		std::vector<oc_zone>	_oc_surf;
 		std::vector<oc_zone>	_oc_hypo;
 		std::vector<oc_zone>	_oc_base;
+
+		size_t					_debut_debits;	// position de debits[0] dans les tampons circulaires oc_zone::debits
 	};
 
 }
@@ -23,6 +23,7 @@
 #include "barrage_historique.hpp"
 #include "constantes.hpp"
 #include "erreur.hpp"
+#include "etat_binaire.hpp"
 #include "lac.hpp"
 #include "lac_sans_laminage.hpp"
 #include "riviere.hpp"
@@ -49,6 +50,8 @@ namespace HYDROTEL
 
 	ONDE_CINEMATIQUE_MODIFIEE::~ONDE_CINEMATIQUE_MODIFIEE()
 	{
+		for(auto milieu_humide : _milieu_humide_riverain)
+			delete milieu_humide;
 	}
 
 	float ONDE_CINEMATIQUE_MODIFIEE::PrendreOptimisationRugosite(size_t index_troncon) const
@@ -133,6 +136,86 @@ namespace HYDROTEL
 	
 	void ONDE_CINEMATIQUE_MODIFIEE::LectureEtat(DATE_HEURE date_courante)
 	{
+		TRACE_PERFORMANCE trace("ONDE_CINEMATIQUE_MODIFIEE::LectureEtat");
+
+		if(ETAT_BINAIRE::EstBinaire(_nom_fichier_lecture_etat))
+		{
+			TRONCONS& troncons = _sim_hyd.PrendreTroncons();
+
+			ETAT_BINAIRE etat;
+			etat.Lecture(_nom_fichier_lecture_etat, 3);
+
+			vector<size_t> index_ligne = etat.AssocieIndex(troncons, _sim_hyd.PrendreTronconsSimules(), "ACHEMINEMENT_RIVIERE; fichier etat ONDE_CINEMATIQUE_MODIFIEE");
+
+			for(size_t ligne=0; ligne<index_ligne.size(); ligne++)
+			{
+				const size_t index_troncon = index_ligne[ligne];
+
+				if(index_troncon != string::npos)
+				{
+					const double* valeurs = etat.PrendreLigne(ligne);
+					TRONCON* troncon = troncons[index_troncon];
+
+					troncon->ChangeDebitAmont(static_cast<float>(valeurs[0]));
+					troncon->ChangeDebitAval(static_cast<float>(valeurs[1]));
+					troncon->ChangeApportLateral(static_cast<float>(valeurs[2]));
+
+					_ocm[index_troncon].qamont = static_cast<float>(valeurs[0]);
+					_ocm[index_troncon].qaval = static_cast<float>(valeurs[1]);
+					_ocm[index_troncon].qapportlat = static_cast<float>(valeurs[2]);
+
+					if(etat.PrendreNbColonne() >= 4)
+						_hauteur[index_troncon] = valeurs[3];
+				}
+			}
+
+			//acheminement_riviere MH
+			if(_milieu_humide_riverain.size() != 0 && _nom_fichier_lecture_etat.length() >= 15)
+			{
+				string str = _nom_fichier_lecture_etat;
+				str.insert(str.length()-14, "MH_");
+				if(boost::filesystem::exists(str))
+				{
+					//seuls les troncons simules ayant un milieu humide sont presents
+					vector<size_t> tronconsMH_simules;
+					for(size_t index : _sim_hyd.PrendreTronconsSimules())
+					{
+						if(_milieu_humide_riverain[index])
+							tronconsMH_simules.push_back(index);
+					}
+
+					ETAT_BINAIRE etatMH;
+					etatMH.Lecture(str, 12);
+
+					index_ligne = etatMH.AssocieIndex(troncons, tronconsMH_simules, "ACHEMINEMENT_RIVIERE; fichier etat ONDE_CINEMATIQUE_MODIFIEE");
+
+					for(size_t ligne=0; ligne<index_ligne.size(); ligne++)
+					{
+						const size_t index_troncon = index_ligne[ligne];
+
+						if(index_troncon != string::npos)
+						{
+							const double* valeurs = etatMH.PrendreLigne(ligne);
+							vector<OCM>& ocm_mh = _ocm_mh[etatMH.PrendreIdent(ligne)];
+
+							_milieu_humide_riverain[index_troncon]->set_wet_v(static_cast<float>(valeurs[0]));
+							_milieu_humide_riverain[index_troncon]->set_wet_a(static_cast<float>(valeurs[1]));
+							_milieu_humide_riverain[index_troncon]->set_wet_d(static_cast<float>(valeurs[2]));
+
+							for(size_t i=0; i<3; i++)
+							{
+								ocm_mh[i].qamont = static_cast<float>(valeurs[3+i*3]);
+								ocm_mh[i].qapportlat = static_cast<float>(valeurs[4+i*3]);
+								ocm_mh[i].qaval = static_cast<float>(valeurs[5+i*3]);
+							}
+						}
+					}
+				}
+			}
+
+			return;
+		}
+
 		//acheminement_riviere
 		ifstream fichier(_nom_fichier_lecture_etat);
 		if (!fichier)
@@ -271,6 +354,8 @@ namespace HYDROTEL
 
 	void ONDE_CINEMATIQUE_MODIFIEE::SauvegardeEtat(DATE_HEURE date_courante)
 	{
+		TRACE_PERFORMANCE trace("ONDE_CINEMATIQUE_MODIFIEE::SauvegardeEtat");
+
 		BOOST_ASSERT(_repertoire_ecriture_etat.size() != 0);
 
 		date_courante.AdditionHeure( _sim_hyd.PrendrePasDeTemps() );
@@ -295,7 +380,13 @@ namespace HYDROTEL
 			        << setw(2) << date_courante.PrendreMois() 
 			        << setw(2) << date_courante.PrendreJour() 
 			        << setw(2) << date_courante.PrendreHeure() 
-					<< ".csv";
+					<< _pOutput->ExtensionFichiersEtats();
+
+		if(_pOutput->_bFichiersEtatsBinaire)
+		{
+			SauvegardeEtatBinaire(nom_fichier.str(), date_courante);
+			return;
+		}
 
 		ofstream fichier(nom_fichier.str());
 		if (!fichier)
@@ -412,6 +503,72 @@ namespace HYDROTEL
 	}
 
 
+	void ONDE_CINEMATIQUE_MODIFIEE::SauvegardeEtatBinaire(const string& nom_fichier, const DATE_HEURE& date_courante)
+	{
+		TRONCONS& troncons = _sim_hyd.PrendreTroncons();
+
+		//acheminement_riviere
+		ETAT_BINAIRE etat;
+		etat.Initialise(PrendreNomSousModele(), date_courante, { "DEBIT AMONT", "DEBIT AVAL", "APPORTLAT", "HAUTEUR" }, _sim_hyd.PrendreTronconsSimules().size());
+
+		for(size_t index_troncon : _sim_hyd.PrendreTronconsSimules())
+		{
+			TRONCON* troncon = troncons[index_troncon];
+			double* valeurs = etat.AjouteLigne(troncon->PrendreIdent());
+
+			valeurs[0] = troncon->PrendreDebitAmont();
+			valeurs[1] = troncon->PrendreDebitAval();
+			valeurs[2] = troncon->PrendreApportLateral();
+			valeurs[3] = _hauteur[index_troncon];
+		}
+
+		etat.Sauvegarde(nom_fichier);
+
+		//acheminement_riviere MH
+		if(_milieu_humide_riverain.size() != 0)
+		{
+			string str = nom_fichier;
+			str.insert(str.length()-14, "MH_");
+
+			size_t nbMH = 0;
+			for(size_t index_troncon : _sim_hyd.PrendreTronconsSimules())
+			{
+				if(_milieu_humide_riverain[index_troncon])
+					++nbMH;
+			}
+
+			ETAT_BINAIRE etatMH;
+			etatMH.Initialise(PrendreNomSousModele(), date_courante, 
+				{ "WET V", "WET A", "WET D", 
+				  "OCM QAMONT 1", "OCM QAPPORTLAT 1", "OCM QAVAL 1", 
+				  "OCM QAMONT 2", "OCM QAPPORTLAT 2", "OCM QAVAL 2", 
+				  "OCM QAMONT 3", "OCM QAPPORTLAT 3", "OCM QAVAL 3" }, nbMH);
+
+			for(size_t index_troncon : _sim_hyd.PrendreTronconsSimules())
+			{
+				if(_milieu_humide_riverain[index_troncon])
+				{
+					const int iIdent = troncons[index_troncon]->PrendreIdent();
+					double* valeurs = etatMH.AjouteLigne(iIdent);
+
+					valeurs[0] = _milieu_humide_riverain[index_troncon]->get_wet_v();
+					valeurs[1] = _milieu_humide_riverain[index_troncon]->get_wet_a();
+					valeurs[2] = _milieu_humide_riverain[index_troncon]->get_wet_d();
+
+					for(size_t i=0; i<3; i++)
+					{
+						valeurs[3+i*3] = _ocm_mh[iIdent][i].qamont;
+						valeurs[4+i*3] = _ocm_mh[iIdent][i].qapportlat;
+						valeurs[5+i*3] = _ocm_mh[iIdent][i].qaval;
+					}
+				}
+			}
+
+			etatMH.Sauvegarde(str);
+		}
+	}
+
+
 	void ONDE_CINEMATIQUE_MODIFIEE::Initialise()
 	{
 		TRONCONS& troncons = _sim_hyd.PrendreTroncons();
@@ -438,19 +595,6 @@ namespace HYDROTEL
 		
 		TrieTroncons();
 
-		//vector<size_t> index_troncons = _sim_hyd.PrendreTronconsSimules();
-		//size_t index;
-
-		//mapShreveTroncon.clear();
-		//iShreveMax = 1;
-
-		//for(index=0; index<index_troncons.size(); index++)
-		//{
-		//	mapShreveTroncon[troncons[index_troncons[index]]->_iSchreve].push_back(index_troncons[index]);
-		//	if( troncons[index_troncons[index]]->_iSchreve > iShreveMax)
-		//		iShreveMax = troncons[index_troncons[index]]->_iSchreve;
-		//}
-
 		//conserve la hauteur d'eau (m)
 		_hauteur.resize(nbTroncon, 0.0);
 
@@ -548,17 +692,8 @@ namespace HYDROTEL
 			ostringstream oss;
 			oss.str("");
 
-			for(size_t index = 0; index < troncons.PrendreNbTroncon(); ++index)
-			{
-				if(find(begin(_sim_hyd.PrendreTronconsSimules()), end(_sim_hyd.PrendreTronconsSimules()), index) != end(_sim_hyd.PrendreTronconsSimules()))
-				{
-					if(_pOutput->_bSauvegardeTous ||
-						find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), troncons[index]->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
-					{
-						oss << troncons[index]->PrendreIdent() << _pOutput->Separator();
-					}
-				}
-			}
+			for (size_t n = 0; n < _pOutput->_tronconOutputNb; ++n)
+				oss << troncons[_pOutput->_tronconOutputIndex[n]]->PrendreIdent() << _pOutput->Separator();
 
 			str1 = oss.str();
 			str1 = str1.substr(0, str1.length()-1); //enleve le dernier separateur
@@ -634,6 +769,9 @@ namespace HYDROTEL
 			dt = static_cast<int>(pdts / nt);
 		}
 
+		if(_sim_hyd._bLogPerf)
+			_sim_hyd._logPerformance._nbReachSubstep+= nbTronconSim * static_cast<size_t>(nt);
+
 		//prelevements
 		if(_sim_hyd._pr->_bSimulePrelevements)
 		{
@@ -642,8 +780,10 @@ namespace HYDROTEL
 		}
 		//
 
-		//vector<future<void>> vFutures;		
-		//int iIndex;
+		const int nbThread = _sim_hyd.PrendreNbThread();
+		const bool bSortieTroncon = _milieu_humide_riverain.size() != 0 || _sim_hyd._pr->_bSimulePrelevements;
+
+		vector<string> vErr(troncons.PrendreNbTroncon());
 
 		for(t=0; t!=nt; t++)
 		{
@@ -657,50 +797,64 @@ namespace HYDROTEL
 			}
 
 			//----------------------
-			for(auto iter=_troncons_tries.rbegin(); iter!=_troncons_tries.rend(); iter++)
+			//les troncons d'un meme niveau ne dependent que des niveaux precedents; ils sont calcules en parallele
+			for(auto& niveau : _troncons_niveaux)
 			{
-				i = *iter;
-				CalculeTroncon(i, t, dt);
+				const int nbTronconNiveau = static_cast<int>(niveau.size());
 
-				//DEBITS AVAL MOY7J MIN
-				if(_pOutput->_debit_aval_moy7j_min && t == nt-1)	//pour le dernier pdt interne seulement
+				#pragma omp parallel for num_threads(nbThread) schedule(dynamic) if(nbThread > 1 && nbTronconNiveau > 1)
+				for(int n=0; n<nbTronconNiveau; n++)
 				{
-					troncons[i]->_debit_aval_7jrs.push_back(troncons[i]->PrendreDebitAvalMoyen());
+					size_t idx = niveau[n];
 
-					if(troncons[i]->_debit_aval_7jrs.size() > _q7avgNbPdt)
-						troncons[i]->_debit_aval_7jrs.erase(troncons[i]->_debit_aval_7jrs.begin());
+					try
+					{
+						CalculeTroncon(idx, t, dt);
+					}
+					catch(const exception& ex)
+					{
+						vErr[idx] = ex.what();
+						continue;
+					}
+
+					//DEBITS AVAL MOY7J MIN
+					if(_pOutput->_debit_aval_moy7j_min && t == nt-1)	//pour le dernier pdt interne seulement
+					{
+						troncons[idx]->_debit_aval_7jrs.push_back(troncons[idx]->PrendreDebitAvalMoyen());
+
+						if(troncons[idx]->_debit_aval_7jrs.size() > _q7avgNbPdt)
+							troncons[idx]->_debit_aval_7jrs.erase(troncons[idx]->_debit_aval_7jrs.begin());
+					}
+				}
+
+				for(auto idx : niveau)
+				{
+					if(vErr[idx] != "")
+						throw ERREUR(vErr[idx]);
 				}
 			}
 
 			//----------------------
-			//for (index=0; index<mapShreveTroncon[1].size(); ++index)
-			//	vFutures.push_back(async(launch::any, &HYDROTEL::ONDE_CINEMATIQUE_MODIFIEE::CalculeTroncon, this, mapShreveTroncon[1][index], t, dt));
-
-			//for(auto &e : vFutures)
-			//	e.get();
+			//ecriture des sorties des troncons dans l'ordre de calcul serie
+			if(bSortieTroncon)
+			{
+				for(auto iter=_troncons_tries.rbegin(); iter!=_troncons_tries.rend(); iter++)
+				{
+					i = *iter;
 
-			//vFutures.clear();
+					if(!_sortie_milieu_humide[i].empty())
+					{
+						m_wetfichier << _sortie_milieu_humide[i] << flush;
+						_sortie_milieu_humide[i].clear();
+					}
 
-			//----------------------
-			//for (iIndex=1; iIndex<=iShreveMax; iIndex++)
-			//{
-			//	//if(mapShreveTroncon[iIndex].size() > 80)
-			//	//{
-			//		for (index=0; index<mapShreveTroncon[iIndex].size(); ++index)
-			//			vFutures.push_back(async(launch::any, &HYDROTEL::ONDE_CINEMATIQUE_MODIFIEE::CalculeTroncon, this, mapShreveTroncon[iIndex][index], t, dt));
-
-			//		for(auto &e : vFutures)
-			//			e.get();
-			//	//}
-			//	//else
-			//	//{
-			//		//for (index=0; index<mapShreveTroncon[iIndex].size(); ++index)
-			//		//	CalculeTroncon(mapShreveTroncon[iIndex][index], t, dt);
-			//	//}
-
-			//	vFutures.clear();
-			//}
-			//----------------------
+					if(!_sortie_prelevement[i].empty())
+					{
+						_sim_hyd._pr->_ofsPrelevementCalcule << _sortie_prelevement[i] << flush;
+						_sortie_prelevement[i].clear();
+					}
+				}
+			}
 
 		}	//for	t
 
@@ -710,18 +864,12 @@ namespace HYDROTEL
 			oss.str("");
 			oss << _sim_hyd.PrendreDateCourante() << _pOutput->Separator() << setprecision(_pOutput->_nbDigit_m) << setiosflags(ios::fixed);
 
-			for(index = 0; index < troncons.PrendreNbTroncon(); ++index)
+			for (size_t n = 0; n < _pOutput->_tronconOutputNb; ++n)
 			{
-				if(find(begin(_sim_hyd.PrendreTronconsSimules()), end(_sim_hyd.PrendreTronconsSimules()), index) != end(_sim_hyd.PrendreTronconsSimules()))
-				{
-					if(_pOutput->_bSauvegardeTous ||
-						find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), troncons[index]->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
-					{
+				index = _pOutput->_tronconOutputIndex[n];
 
-						fVal = static_cast<float>(ObtientPMGrillePH(index, troncons[index]->_hauteurAvalMoy));
-						oss << fVal << _pOutput->Separator();
-					}
-				}
+				fVal = static_cast<float>(ObtientPMGrillePH(index, troncons[index]->_hauteurAvalMoy));
+				oss << fVal << _pOutput->Separator();
 			}
 			
 			str = oss.str();
@@ -760,7 +908,7 @@ namespace HYDROTEL
 						for(index=0; index!=nbTronconSim; index++)
 						{
 							i = index_troncons[index];
-							if(_pOutput->_bSauvegardeTous || find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), troncons[i]->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
+							if(_pOutput->_vTronconOutput[i])
 							{
 								//si le troncon est simul et en output
 								fQMoy7j = 0.0f;										//calcule la moyenne
@@ -777,7 +925,7 @@ namespace HYDROTEL
 						for(index=0; index!=nbTronconSim; index++)
 						{
 							i = index_troncons[index];
-							if(_pOutput->_bSauvegardeTous || find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), troncons[i]->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
+							if(_pOutput->_vTronconOutput[i])
 							{
 								//si le troncon est simul et en output
 								_q7avgMinY[i].push_back(1000000000.0f);	//la moyenne au 1er janvier n'est pas disponible (elle sera disponible au plus tard le 7 janvier)
@@ -795,7 +943,7 @@ namespace HYDROTEL
 							for(index=0; index!=nbTronconSim; index++)
 							{
 								i = index_troncons[index];
-								if(_pOutput->_bSauvegardeTous || find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), troncons[i]->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
+								if(_pOutput->_vTronconOutput[i])
 								{
 									//si le troncon est simul et en output
 									fQMoy7j = 0.0f;										//calcule la moyenne
@@ -831,7 +979,7 @@ namespace HYDROTEL
 								for(index=0; index!=nbTronconSim; index++)
 								{
 									i = index_troncons[index];
-									if(_pOutput->_bSauvegardeTous || find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), troncons[i]->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
+									if(_pOutput->_vTronconOutput[i])
 									{
 										//si le troncon est simul et en output
 										fQMoy7j = 0.0f;										//calcule la moyenne
@@ -848,7 +996,7 @@ namespace HYDROTEL
 								for(index=0; index!=nbTronconSim; index++)
 								{
 									i = index_troncons[index];
-									if(_pOutput->_bSauvegardeTous || find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), troncons[i]->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
+									if(_pOutput->_vTronconOutput[i])
 									{
 										//si le troncon est simul et en output
 										_q7avgMinS[i].push_back(1000000000.0f);	//la moyenne au 1er juin n'est pas disponible (elle sera disponible au plus tard le 7 juin)
@@ -865,7 +1013,7 @@ namespace HYDROTEL
 									for(index=0; index!=nbTronconSim; index++)
 									{
 										i = index_troncons[index];
-										if(_pOutput->_bSauvegardeTous || find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), troncons[i]->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
+										if(_pOutput->_vTronconOutput[i])
 										{
 											//si le troncon est simul et en output
 											fQMoy7j = 0.0f;										//calcule la moyenne
@@ -898,6 +1046,8 @@ namespace HYDROTEL
 	//---------------------------------------------------------------------------------
 	void ONDE_CINEMATIQUE_MODIFIEE::CalculeTroncon(size_t indexTroncon, int t, int dt)
 	{
+		TRACE_PERFORMANCE trace("ONDE_CINEMATIQUE_MODIFIEE::CalculeTroncon", true);
+
 		TRONCONS& troncons = _sim_hyd.PrendreTroncons();
 		TRONCON::TYPE_TRONCON type_troncon = troncons[indexTroncon]->PrendreType();
 		DATE_HEURE date_courante = _sim_hyd.PrendreDateCourante();
@@ -920,6 +1070,17 @@ namespace HYDROTEL
 
 		qd = 0.0f;
 
+		//debit amont: cumul des debits aval des troncons amont (calcules au niveau precedent), dans le meme ordre que le calcul serie
+		qamont = 0.0f;
+		for(auto idxAmont : _troncons_amont[indexTroncon])
+		{
+			if(_sim_hyd._bActiveTronconDeconnecte && _sim_hyd._mapIndexTronconDeconnecte.find(idxAmont) != _sim_hyd._mapIndexTronconDeconnecte.end())
+				qamont = 0.0f;
+
+			qamont = max(0.0f, qamont + _ocm[idxAmont].qaval);
+		}
+		troncons[indexTroncon]->ChangeDebitAmont(qamont);
+
 		if(_sim_hyd._bActiveTronconDeconnecte && _sim_hyd._mapIndexTronconDeconnecte.find(indexTroncon) != _sim_hyd._mapIndexTronconDeconnecte.end())
 			qamont = 0.0f;	//troncon deconnecte
 		else
@@ -975,7 +1136,8 @@ namespace HYDROTEL
 							<< setprecision(_pOutput->_nbDigit_m) << setiosflags(ios::fixed) << haut << _pOutput->Separator()							//m
 							<< setprecision(_pOutput->_nbDigit_m3s) << setiosflags(ios::fixed) << qd;												//m3/s
 
-						m_wetfichier << oss.str() << endl;
+						oss << '\n';
+						_sortie_milieu_humide[indexTroncon]+= oss.str();
 					}
 				}
 				else
@@ -1115,7 +1277,8 @@ namespace HYDROTEL
 				{
 					oss.str("");
 					oss << annee << "-" << setfill('0') << setw(2) << mois << "-" << setw(2) << jour << " " << setw(2) << heure << ";" << troncons[indexTroncon]->PrendreIdent() << ";" << "PR " << _sim_hyd._pr->_tronconsPrelevementString[indexTroncon][i];
-					_sim_hyd._pr->_ofsPrelevementCalcule << oss.str() << endl;
+					oss << '\n';
+					_sortie_prelevement[indexTroncon]+= oss.str();
 				}
 			}
 			if(_sim_hyd._pr->_tronconsPrelevementCultureString.count(indexTroncon) != 0)
@@ -1124,7 +1287,8 @@ namespace HYDROTEL
 				{
 					oss.str("");
 					oss << annee << "-" << setfill('0') << setw(2) << mois << "-" << setw(2) << jour << " " << setw(2) << heure << ";" << troncons[indexTroncon]->PrendreIdent() << ";" << "PR " << _sim_hyd._pr->_tronconsPrelevementCultureString[indexTroncon][i];
-					_sim_hyd._pr->_ofsPrelevementCalcule << oss.str() << endl;
+					oss << '\n';
+					_sortie_prelevement[indexTroncon]+= oss.str();
 				}
 			}
 			if(_sim_hyd._pr->_tronconsRejetString.count(indexTroncon) != 0)
@@ -1133,7 +1297,8 @@ namespace HYDROTEL
 				{
 					oss.str("");
 					oss << annee << "-" << setfill('0') << setw(2) << mois << "-" << setw(2) << jour << " " << setw(2) << heure << ";" << troncons[indexTroncon]->PrendreIdent() << ";" << "RE " << _sim_hyd._pr->_tronconsRejetString[indexTroncon][i];
-					_sim_hyd._pr->_ofsPrelevementCalcule << oss.str() << endl;
+					oss << '\n';
+					_sortie_prelevement[indexTroncon]+= oss.str();
 				}
 			}
 			if(_sim_hyd._pr->_tronconsRejetEffluentString.count(indexTroncon) != 0)
@@ -1142,7 +1307,8 @@ namespace HYDROTEL
 				{
 					oss.str("");
 					oss << annee << "-" << setfill('0') << setw(2) << mois << "-" << setw(2) << jour << " " << setw(2) << heure << ";" << troncons[indexTroncon]->PrendreIdent() << ";" << "RE " << _sim_hyd._pr->_tronconsRejetEffluentString[indexTroncon][i];
-					_sim_hyd._pr->_ofsPrelevementCalcule << oss.str() << endl;
+					oss << '\n';
+					_sortie_prelevement[indexTroncon]+= oss.str();
 				}
 			}
 			//}
@@ -1364,32 +1530,7 @@ namespace HYDROTEL
 		_ocm[indexTroncon].qaval = qd;
 		_ocm[indexTroncon].qapportlat = qapportlat;
 
-		//NOTE: a modifier pour la gestion des sorties multiples
-
-		//conserve les debits pour l'iteration courante
-		if(!troncons[indexTroncon]->PrendreTronconsAval().empty())
-		{
-			TRONCON* aval = troncons[indexTroncon]->PrendreTronconsAval()[0];
-
-			////**********************************************************************************
-			////il devrait y avoir 1 seul troncon aval, ne devrait donc pas tre un vecteur, a moins de sorties multiples
-			//if(troncons[indexTroncon]->PrendreTronconsAval().size() != 1)
-			//	 std::cout << "********* troncon " << troncons[indexTroncon]->PrendreIdent() << ", nb troncon aval=" << troncons[indexTroncon]->PrendreTronconsAval().size() << endl;
-			////**********************************************************************************
-
-			if(aval != nullptr)
-			{
-				float qamontTemp;
-						
-				if(_sim_hyd._bActiveTronconDeconnecte && _sim_hyd._mapIndexTronconDeconnecte.find(indexTroncon) != _sim_hyd._mapIndexTronconDeconnecte.end())
-					qamontTemp = 0.0f;
-				else
-					qamontTemp = aval->PrendreDebitAmont();
-
-				qamontTemp+= qd;
-				aval->ChangeDebitAmont(max(0.0f, qamontTemp));
-			}
-		}
+		//le debit aval (_ocm[indexTroncon].qaval) est cumule au debit amont du troncon aval lors du calcul de celui-ci (voir _troncons_amont)
 
 		//calcule et conserve les dbits au pas de temps externe de la simulation
 		qAvalNew = max(0.0f, qd);
@@ -1427,6 +1568,8 @@ namespace HYDROTEL
 		_ocm.clear();
 		_troncons_tries.clear();
 
+		for(auto milieu_humide : _milieu_humide_riverain)
+			delete milieu_humide;
 		_milieu_humide_riverain.clear();
 		_ocm_mh.clear();
 		_hauteur.clear();
@@ -1446,7 +1589,6 @@ namespace HYDROTEL
 		if(_pOutput->_debit_aval_moy7j_min)
 		{
 			TRONCONS& troncons = _sim_hyd.PrendreTroncons();
-			size_t nbTroncon = troncons.PrendreNbTroncon();
 			int x;
 
 			if(_q7avgYearEndY != -1)	//sinon il n'y a pas eu d'anne complete de simul
@@ -1461,17 +1603,8 @@ namespace HYDROTEL
 				ofs << "qmoy7j_min_annuel (m3/s)" << _pOutput->Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "annee\\troncon" << _pOutput->Separator();
 
 				oss.str("");
-				for(index=0; index!=nbTroncon; index++)
-				{
-					if(find(begin(_sim_hyd.PrendreTronconsSimules()), end(_sim_hyd.PrendreTronconsSimules()), index) != end(_sim_hyd.PrendreTronconsSimules()))
-					{
-						if(_pOutput->_bSauvegardeTous ||
-							find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), troncons[index]->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
-						{
-							oss << troncons[index]->PrendreIdent() << _pOutput->Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < _pOutput->_tronconOutputNb; ++n)
+					oss << troncons[_pOutput->_tronconOutputIndex[n]]->PrendreIdent() << _pOutput->Separator();
 				str = oss.str();
 				if(str.length() != 0)
 					str = str.substr(0, str.length()-1); //enleve le dernier separateur
@@ -1482,16 +1615,11 @@ namespace HYDROTEL
 					oss.str("");			
 					oss << _q7avgYearStartY+x << _pOutput->Separator() << setprecision(_pOutput->_nbDigit_m3s) << setiosflags(ios::fixed);
 
-					for(index=0; index!=nbTroncon; index++)
+					for (size_t n = 0; n < _pOutput->_tronconOutputNb; ++n)
 					{
-						if(find(begin(_sim_hyd.PrendreTronconsSimules()), end(_sim_hyd.PrendreTronconsSimules()), index) != end(_sim_hyd.PrendreTronconsSimules()))
-						{
-							if(_pOutput->_bSauvegardeTous || 
-								find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), troncons[index]->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
-							{
-								oss << _q7avgMinY[index][x] << _pOutput->Separator();	//m3s
-							}
-						}
+						index = _pOutput->_tronconOutputIndex[n];
+
+						oss << _q7avgMinY[index][x] << _pOutput->Separator();	//m3s
 					}
 			
 					str = oss.str();
@@ -1514,17 +1642,8 @@ namespace HYDROTEL
 				ofs << "qmoy7j_min_estival (m3/s)" << _pOutput->Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "annee\\troncon" << _pOutput->Separator();
 
 				oss.str("");
-				for(index=0; index!=nbTroncon; index++)
-				{
-					if(find(begin(_sim_hyd.PrendreTronconsSimules()), end(_sim_hyd.PrendreTronconsSimules()), index) != end(_sim_hyd.PrendreTronconsSimules()))
-					{
-						if(_pOutput->_bSauvegardeTous ||
-							find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), troncons[index]->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
-						{
-							oss << troncons[index]->PrendreIdent() << _pOutput->Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < _pOutput->_tronconOutputNb; ++n)
+					oss << troncons[_pOutput->_tronconOutputIndex[n]]->PrendreIdent() << _pOutput->Separator();
 				str = oss.str();
 				if(str.length() != 0)
 					str = str.substr(0, str.length()-1); //enleve le dernier separateur
@@ -1535,16 +1654,11 @@ namespace HYDROTEL
 					oss.str("");			
 					oss << _q7avgYearStartS+x << _pOutput->Separator() << setprecision(_pOutput->_nbDigit_m3s) << setiosflags(ios::fixed);
 
-					for(index=0; index!=nbTroncon; index++)
+					for (size_t n = 0; n < _pOutput->_tronconOutputNb; ++n)
 					{
-						if(find(begin(_sim_hyd.PrendreTronconsSimules()), end(_sim_hyd.PrendreTronconsSimules()), index) != end(_sim_hyd.PrendreTronconsSimules()))
-						{
-							if(_pOutput->_bSauvegardeTous || 
-								find(begin(_pOutput->_vIdTronconSelect), end(_pOutput->_vIdTronconSelect), troncons[index]->PrendreIdent()) != end(_pOutput->_vIdTronconSelect))
-							{
-								oss << _q7avgMinS[index][x] << _pOutput->Separator();	//m3s
-							}
-						}
+						index = _pOutput->_tronconOutputIndex[n];
+
+						oss << _q7avgMinS[index][x] << _pOutput->Separator();	//m3s
 					}
 			
 					str = oss.str();
@@ -1644,6 +1758,39 @@ namespace HYDROTEL
 		}
 
 		_troncons_tries.shrink_to_fit();
+
+		//regroupe les troncons par niveau de calcul: le niveau d'un troncon est superieur a celui de tous ses troncons amont.
+		//l'ordre de shreve du fichier de troncons (_iSchreve) n'est pas utilise car il peut provenir d'un fichier externe.
+		vector<size_t> niveaux(nb_troncon, 0);
+
+		_troncons_amont.assign(nb_troncon, vector<size_t>());
+		_troncons_niveaux.clear();
+
+		for (auto iter = _troncons_tries.rbegin(); iter != _troncons_tries.rend(); ++iter)
+		{
+			size_t index_troncon = *iter;
+			size_t niveau = 0;
+
+			for (auto index_amont : _troncons_amont[index_troncon])
+				niveau = max(niveau, niveaux[index_amont] + 1);
+
+			niveaux[index_troncon] = niveau;
+
+			if (niveau >= _troncons_niveaux.size())
+				_troncons_niveaux.resize(niveau + 1);
+
+			_troncons_niveaux[niveau].push_back(index_troncon);
+
+			//NOTE: a modifier pour la gestion des sorties multiples
+			if (!troncons[index_troncon]->PrendreTronconsAval().empty() && troncons[index_troncon]->PrendreTronconsAval()[0] != nullptr)
+			{
+				size_t index_aval = TronconToIndex(troncons, troncons[index_troncon]->PrendreTronconsAval()[0]);
+				_troncons_amont[index_aval].push_back(index_troncon);
+			}
+		}
+
+		_sortie_milieu_humide.assign(nb_troncon, "");
+		_sortie_prelevement.assign(nb_troncon, "");
 	}
 
 
@@ -1843,8 +1990,8 @@ namespace HYDROTEL
 
 		fichier.close();
 
-		//lecture des parametres pour les milieux humides riverains
-		if(_sim_hyd._bSimuleMHRiverain)
+		//lecture des parametres pour les milieux humides riverains; lus une seule fois (fichiers distincts, non modifies par la calibration)
+		if(_sim_hyd._bSimuleMHRiverain && _milieu_humide_riverain.empty())
 		{
 			LectureMilieuHumideRiverain();
 			LectureProfondeur();
@@ -1942,8 +2089,8 @@ namespace HYDROTEL
 		if(!bOK)
 			throw ERREUR_LECTURE_FICHIER(_sim_hyd._nomFichierParametresGlobal, 0, "Parametres sous-modele ONDE CINEMATIQUE MODIFIEE");
 
-		//lecture des parametres pour les milieux humides riverains
-		if(_sim_hyd._bSimuleMHRiverain)
+		//lecture des parametres pour les milieux humides riverains; lus une seule fois (fichiers distincts, non modifies par la calibration)
+		if(_sim_hyd._bSimuleMHRiverain && _milieu_humide_riverain.empty())
 		{
 			LectureMilieuHumideRiverain();
 			LectureProfondeur();
@@ -2997,4 +3144,80 @@ namespace HYDROTEL
 		return dP;
 	}
 
+
+	void ONDE_CINEMATIQUE_MODIFIEE::SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const
+	{
+		etat.Ecrit(_hauteur);
+		etat.Ecrit(_ocm);
+
+		etat.Ecrit(_q7avgYearCurrentY);
+		etat.Ecrit(_q7avgMinY);
+		etat.Ecrit(_q7avgYearCurrentS);
+		etat.Ecrit(_q7avgMinS);
+
+		etat.Ecrit(_ocm_mh.size());
+
+		for(auto iter = _ocm_mh.begin(); iter != _ocm_mh.end(); ++iter)
+		{
+			etat.Ecrit(iter->first);
+			etat.Ecrit(iter->second);
+		}
+
+		//milieux humides riverains
+		etat.Ecrit(_milieu_humide_riverain.size());
+
+		for(size_t index_troncon=0; index_troncon<_milieu_humide_riverain.size(); index_troncon++)
+		{
+			if(_milieu_humide_riverain[index_troncon])
+			{
+				etat.Ecrit(_milieu_humide_riverain[index_troncon]->get_wet_v());
+				etat.Ecrit(_milieu_humide_riverain[index_troncon]->get_wet_a());
+				etat.Ecrit(_milieu_humide_riverain[index_troncon]->get_wet_d());
+			}
+		}
+	}
+
+	void ONDE_CINEMATIQUE_MODIFIEE::LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur)
+	{
+		lecteur.Lit(_hauteur);
+		lecteur.Lit(_ocm);
+
+		lecteur.Lit(_q7avgYearCurrentY);
+		lecteur.Lit(_q7avgMinY);
+		lecteur.Lit(_q7avgYearCurrentS);
+		lecteur.Lit(_q7avgMinS);
+
+		size_t nb, x;
+		float wet_v, wet_a, wet_d;
+		int ident;
+
+		lecteur.Lit(nb);
+
+		_ocm_mh.clear();
+		for(x=0; x<nb; x++)
+		{
+			lecteur.Lit(ident);
+			lecteur.Lit(_ocm_mh[ident]);
+		}
+
+		//milieux humides riverains
+		lecteur.Lit(nb);
+		if(nb != _milieu_humide_riverain.size())
+			throw ERREUR("In-memory state: ONDE_CINEMATIQUE_MODIFIEE: riparian wetlands do not match the simulation.");
+
+		for(size_t index_troncon=0; index_troncon<_milieu_humide_riverain.size(); index_troncon++)
+		{
+			if(_milieu_humide_riverain[index_troncon])
+			{
+				lecteur.Lit(wet_v);
+				lecteur.Lit(wet_a);
+				lecteur.Lit(wet_d);
+
+				_milieu_humide_riverain[index_troncon]->set_wet_v(wet_v);
+				_milieu_humide_riverain[index_troncon]->set_wet_a(wet_a);
+				_milieu_humide_riverain[index_troncon]->set_wet_d(wet_d);
+			}
+		}
+	}
+
 }
@@ -52,6 +52,10 @@ namespace HYDROTEL
 
 		virtual void SauvegardeParametres();
 
+		virtual void SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const;
+
+		virtual void LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur);
+
 		float PrendreOptimisationRugosite(size_t index_troncon) const;
 
 		float PrendreOptimisationLargeurRiviere(size_t index_troncon) const;
@@ -102,9 +106,6 @@ namespace HYDROTEL
 
 	private:
 
-		//std::map<int, std::vector<size_t>>		mapShreveTroncon;	//NoOrdreShreve 1-X, index des troncons
-		//int										iShreveMax;			//no ordre max
-
 		void TrieTroncons();
 
 		void TransfertRiviere(size_t idxTroncon, int pdts, float lng, float lrg, float pte, float man, float qa, float ql,  float qb, float qc, float qm, float& hauteur, float& section, float& qd);
@@ -124,6 +125,9 @@ namespace HYDROTEL
 		void LectureEtat(DATE_HEURE date_courante);
 		void SauvegardeEtat(DATE_HEURE date_courante);
 
+		// fichiers d'etat binaires (ETAT_BINAIRE); nom_fichier: fichier principal (le fichier MH est derive de ce nom)
+		void SauvegardeEtatBinaire(const std::string& nom_fichier, const DATE_HEURE& date_courante);
+
 		std::vector<float> _coefficient_optimisation_rugosite;		//parametre
 		std::vector<float> _coefficient_largeurs_rivieres;			//parametre
 
@@ -142,6 +146,12 @@ namespace HYDROTEL
 		std::vector<OCM> _ocm;
 		std::vector<size_t> _troncons_tries;
 
+		std::vector<std::vector<size_t>>	_troncons_niveaux;		//index des troncons simules regroupes par niveau de calcul (1er niveau: troncons sans amont); les troncons d'un meme niveau sont independants
+		std::vector<std::vector<size_t>>	_troncons_amont;		//[index troncon] index des troncons amont simules, dans l'ordre de calcul serie (_troncons_tries inverse)
+
+		std::vector<std::string>			_sortie_milieu_humide;	//[index troncon] lignes du pas de temps interne pour wetland_riverain.csv, ecrites dans l'ordre de calcul serie
+		std::vector<std::string>			_sortie_prelevement;	//[index troncon] lignes du pas de temps interne pour prelevements_calcule.csv
+
         // milieux humides riverain
 		std::vector<MILIEUHUMIDE_RIVERAIN*> _milieu_humide_riverain;
 
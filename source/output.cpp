@@ -21,6 +21,8 @@
 #include "output.hpp"
 
 #include "erreur.hpp"
+#include "output_csv.hpp"
+#include "output_netcdf.hpp"
 #include "util.hpp"
 #include "version.hpp"
 #include "util.hpp"
@@ -43,6 +45,7 @@ namespace HYDROTEL
 	OUTPUT::OUTPUT()
 		: _sSeparator(";")
 		, _sFichiersEtatsSeparator(";")
+		, _bFichiersEtatsBinaire(false)
 		, _bSauvegardeTous(false)
 		, _debit_aval(true)
 		, _debit_aval_moy7j_min(false)
@@ -85,13 +88,18 @@ namespace HYDROTEL
 		, _iIDTronconExutoire(1)
 	{
 		_sim_hyd = NULL;
-		_timeVectorEpoch = NULL;
+		_tronconOutputNb = 0;
 		_tronconOutputIndex = NULL;
 		_tronconOutputIDs = NULL;
+		_uhrhOutputNb = 0;
 		_uhrhOutputIndex = NULL;
 		_uhrhOutputIDs = NULL;
 
 		_iOutputCDF = -1;
+		_netCdfChunkTemps = 0;
+		_netCdfChunkElement = 1;
+		_netCdfDeflate = 1;
+		_pEcrivainCsv = NULL;
 		_bOutputUhrhVar = false;
 		_bOutputTronconVar = false;
 
@@ -108,8 +116,8 @@ namespace HYDROTEL
 
 	OUTPUT::~OUTPUT()
 	{
-		if(_timeVectorEpoch != NULL)
-			delete [] _timeVectorEpoch;
+		if (_pEcrivainCsv != NULL)
+			delete _pEcrivainCsv;
 
 		if (_tronconOutputIndex != NULL)
 		{
@@ -325,10 +333,20 @@ namespace HYDROTEL
 					_sFichiersEtatsSeparator = valeur;
 				else if (cle == "FICHIERS_ETATS_SEPARATEUR")
 					_sFichiersEtatsSeparator = valeur;
+				else if (cle == "FICHIERS ETATS BINAIRE")
+					_bFichiersEtatsBinaire = (valeur == "1") ? true : false;
+				else if (cle == "FICHIERS_ETATS_BINAIRE")
+					_bFichiersEtatsBinaire = (valeur == "1") ? true : false;
 				else if (cle == "OUTPUT NETCDF")
 					_iOutputCDF = (valeur == "1") ? 1 : 0;
 				else if (cle == "OUTPUT_NETCDF")
 					_iOutputCDF = (valeur == "1") ? 1 : 0;
+				else if (cle == "NETCDF_CHUNK_TEMPS")
+					_netCdfChunkTemps = static_cast<size_t>(stoul(valeur));
+				else if (cle == "NETCDF_CHUNK_ELEMENT")
+					_netCdfChunkElement = static_cast<size_t>(stoul(valeur));
+				else if (cle == "NETCDF_DEFLATE")
+					_netCdfDeflate = min(max(stoi(valeur), 0), 9);
 			}
 		}
 		catch (...)
@@ -422,9 +440,13 @@ namespace HYDROTEL
 		fichier << "DEBITS_AVAL_MOY7J_MIN;"			<< (_debit_aval_moy7j_min ? 1 : 0) << endl;
 		
 		fichier << "FICHIERS_ETATS_SEPARATEUR;"		<< _sFichiersEtatsSeparator << endl;
+		fichier << "FICHIERS_ETATS_BINAIRE;"		<< (_bFichiersEtatsBinaire ? 1 : 0) << endl;
 		fichier << "SEPARATEUR;"					<< _sSeparator << endl;
 
 		fichier << "OUTPUT_NETCDF;"					<< (_iOutputCDF == 1 ? 1 : 0) << endl;
+		fichier << "NETCDF_CHUNK_TEMPS;"			<< _netCdfChunkTemps << endl;
+		fichier << "NETCDF_CHUNK_ELEMENT;"			<< _netCdfChunkElement << endl;
+		fichier << "NETCDF_DEFLATE;"				<< _netCdfDeflate << endl;
 
 		fichier.close();
 	}
@@ -574,190 +596,82 @@ namespace HYDROTEL
 		return _profondeurgel;
 	}
 
+	string OUTPUT::ExtensionFichiersEtats() const
+	{
+		return _bFichiersEtatsBinaire ? ".bin" : ".csv";
+	}
+
+	void OUTPUT::DesactiveSorties()
+	{
+		_bSauvegardeTous = false;
+		_debit_aval = false;
+		_debit_aval_moy7j_min = false;
+		_debit_amont = false;
+		_hauteur_aval = false;
+		_apport = false;
+		_apport_glacier = false;
+		_eau_glacier = false;
+		_apport_lateral = false;
+		_apport_lateral_uhrh = false;
+		_ecoulement_surf = false;
+		_ecoulement_hypo = false;
+		_ecoulement_base = false;
+		_etp = false;
+		_neige = false;
+		_pluie = false;
+		_production_base = false;
+		_production_hypo = false;
+		_production_surf = false;
+		_theta1 = false;
+		_theta2 = false;
+		_theta3 = false;
+		_tmin = false;
+		_tmax = false;
+		_tmin_jr = false;
+		_tmax_jr = false;
+		_etr1 = false;
+		_etr2 = false;
+		_etr3 = false;
+		_etr_total = false;
+		_couvert_nival = false;
+		_hauteur_neige = false;
+		_albedo_neige = false;
+		_q12 = false;
+		_q23 = false;
+		_q23SumYearly = false;
+		_qRecharge = false;
+		_profondeurgel = false;
+		_weighted_avg = false;
+	}
 
-	//--------------------------------------------------------------------------------------------------------------------
-	string OUTPUT::SauvegardeOutputNetCDF(string sPathFile, bool bUHRH, 
-											string sOutputVariableName, float* pData, string sUnits, string sDescription)
-	{
-		ostringstream oss;
-		string sDimName, str;
-		time_t currentTime;
-		size_t chunksize[2];
-		size_t lDimSize;
-		int dimidsElement[1];
-		int dimidsTime[1];
-		int dimidsVar[2];
-		int ret, iNcid, iDimID, iDimTimeID, iVarID, iElemID, iTimeID;
-
-		if(FichierExiste(sPathFile))
-			SupprimerFichier(sPathFile);
-
-		if(bUHRH)
-		{
-			sDimName = "uhrh";
-			lDimSize = _uhrhOutputNb;
-		}
-		else
-		{
-			sDimName = "troncon";
-			lDimSize = _tronconOutputNb;
-		}
 
-		//chunksize optimis pour srie temporelle par UHRH/troncon
-		chunksize[0] = _sim_hyd->_lNbPasTempsSim;	//time dimension
-		chunksize[1] = 1;
+	//--------------------------------------------------------------------------------------------------------------------
+	OUTPUT_NETCDF* OUTPUT::CreeOutputNetCDF(string sPathFile, bool bUHRH, 
+											string sOutputVariableName, string sUnits, string sDescription)
+	{
+		OUTPUT_NETCDF* pNetCdf;
+		string str;
 
-		////chunksize optimis pour obtenir tous les UHRH/troncon pour 1 pas de temps
-		//chunksize[0] = 1;	//time dimension
-		//chunksize[1] = lDimSize;	//troncon/uhrh dimension
+		pNetCdf = new OUTPUT_NETCDF();
 
-		if(_timeVectorEpoch == NULL)
+		str = pNetCdf->Ouvre(*this, sPathFile, bUHRH, sOutputVariableName, sUnits, sDescription);
+		if(str != "")
 		{
-			int step, currentdate;
-			size_t x;
-
-			step = _sim_hyd->_pas_de_temps * 60;	//minutes
-			currentdate = static_cast<int>(_sim_hyd->_date_debut.EpochTime() / 60.0);	//minutes since 1970/01/01
-			
-			_timeVectorEpoch = new int[_sim_hyd->_lNbPasTempsSim];
-			for(x=0; x<_sim_hyd->_lNbPasTempsSim; x++)
-			{
-				_timeVectorEpoch[x] = currentdate;
-				currentdate+= step;
-			}
+			delete pNetCdf;
+			throw ERREUR(str);
 		}
 
-		//ret = nc_create(sPathFile.c_str(), NC_NETCDF4|NC_64BIT_OFFSET, &iNcid);
-		//ret = nc_create(sPathFile.c_str(), NC_NETCDF4|NC_64BIT_DATA, &iNcid);		
-		//ret = nc_create(sPathFile.c_str(), NC_64BIT_OFFSET, &iNcid);	//File type : NetCDF - 3 / CDM
-		ret = nc_create(sPathFile.c_str(), NC_NETCDF4, &iNcid);	//
-		if (ret != NC_NOERR)
-			return "error creating file: " + sPathFile + ": error 1";
-
-		//global attributes
-		str = "Variable de sortie simulation Hydrotel";
-		ret = nc_put_att_text(iNcid, NC_GLOBAL, "description", str.size(), str.c_str());
-		if (ret != NC_NOERR)
-			return "error creating file: " + sPathFile + ": error 2";
-
-		str = _sim_hyd->PrendreRepertoireSimulation();
-		ret = nc_put_att_text(iNcid, NC_GLOBAL, "initial_simulation_path", str.size(), str.c_str());
-		if (ret != NC_NOERR)
-			return "error creating file: " + sPathFile + ": error 3";
-
-		currentTime = time(0);   // get time now
-
-#if defined(_WIN64) || defined(_WIN32)
-
-		struct tm now;
-		localtime_s(&now, &currentTime);
-
-		oss << setw(2) << setfill('0') << now.tm_mday << '-' 
-			<< setw(2) << setfill('0') << (now.tm_mon + 1) << '-' 
-			<< (now.tm_year + 1900) << ' ' 
-			<< setw(2) << setfill('0') << now.tm_hour << ":"
-			<< setw(2) << setfill('0') << now.tm_min << ":"
-			<< setw(2) << setfill('0') << now.tm_sec;
-
-#else
-
-		tm* now = localtime(&currentTime);
-
-		oss << setw(2) << setfill('0') << now->tm_mday << '-' 
-			<< setw(2) << setfill('0') << (now->tm_mon + 1) << '-' 
-			<< (now->tm_year + 1900) << ' ' 
-			<< setw(2) << setfill('0') << now->tm_hour << ":" 
-			<< setw(2) << setfill('0') << now->tm_min << ":" 
-			<< setw(2) << setfill('0') << now->tm_sec;
-
-#endif
-
-		str = oss.str();
-		ret = nc_put_att_text(iNcid, NC_GLOBAL, "creation_time", str.size(), str.c_str());
-		if (ret != NC_NOERR)
-			return "error creating file: " + sPathFile + ": error 4";
-
-		//dimensions
-		ret = nc_def_dim(iNcid, sDimName.c_str(), lDimSize, &iDimID);
-		if (ret != NC_NOERR)
-			return "error creating file: " + sPathFile + ": error 5";
-
-		ret = nc_def_dim(iNcid, "time", _sim_hyd->_lNbPasTempsSim, &iDimTimeID);
-		if (ret != NC_NOERR)
-			return "error creating file: " + sPathFile + ": error 6";
-
-		//variables
-
-		//idtroncon/iduhrh
-		dimidsElement[0] = iDimID;
-		str = "id" + sDimName;
-
-		ret = nc_def_var(iNcid, str.c_str(), NC_INT, 1, dimidsElement, &iElemID);
-		if (ret != NC_NOERR)
-			return "error creating file: " + sPathFile + ": error 7";
-
-		//time
-		dimidsTime[0] = iDimTimeID;
-
-		ret = nc_def_var(iNcid, "time", NC_INT, 1, dimidsTime, &iTimeID);
-		if (ret != NC_NOERR)
-			return "error creating file: " + sPathFile + ": error 8"; 
-		
-		str = "minutes since 1970-01-01 00:00:00";
-		ret = nc_put_att_text(iNcid, iTimeID, "units", str.size(), str.c_str());
-		if (ret != NC_NOERR)
-			return "error creating file: " + sPathFile + ": error 9";
-
-		//output var
-		dimidsVar[0] = iDimTimeID;
-		dimidsVar[1] = iDimID;
-		
-		ret = nc_def_var(iNcid, sOutputVariableName.c_str(), NC_FLOAT, 2, dimidsVar, &iVarID);
-		if (ret != NC_NOERR)
-			return "error creating file: " + sPathFile + ": error 10";
-
-		ret = nc_def_var_chunking(iNcid, iVarID, NC_CHUNKED, chunksize);
-		if (ret != NC_NOERR)
-			return "error creating file: " + sPathFile + ": error 11";
-
-		ret = nc_def_var_deflate(iNcid, iVarID, 0, 1, 1);	//set deflate level 1
-		if (ret != NC_NOERR)
-			return "error creating file: " + sPathFile + ": error 12";
-
-		ret = nc_put_att_text(iNcid, iVarID, "units", sUnits.size(), sUnits.c_str());
-		if (ret != NC_NOERR)
-			return "error creating file: " + sPathFile + ": error 13";
-
-		ret = nc_put_att_text(iNcid, iVarID, "description", sDescription.size(), sDescription.c_str());
-		if (ret != NC_NOERR)
-			return "error creating file: " + sPathFile + ": error 14";
-
-		ret = nc_enddef(iNcid);
-		if (ret != NC_NOERR)
-			return "error creating file: " + sPathFile + ": error 15";
-
-		//save data
-		if (bUHRH)
-			ret = nc_put_var_int(iNcid, iElemID, _uhrhOutputIDs);
-		else
-			ret = nc_put_var_int(iNcid, iElemID, _tronconOutputIDs);
-
-		if (ret != NC_NOERR)
-			return "error creating file: " + sPathFile + ": error 16";
-
-		ret = nc_put_var_int(iNcid, iTimeID, _timeVectorEpoch);
-		if (ret != NC_NOERR)
-			return "error creating file: " + sPathFile + ": error 17";
+		return pNetCdf;
+	}
 
-		ret = nc_put_var_float(iNcid, iVarID, pData);
-		if (ret != NC_NOERR)
-			return "error creating file: " + sPathFile + ": error 18";
 
-		ret = nc_close(iNcid);
-		if (ret != NC_NOERR)
-			return "error creating file: " + sPathFile + ": error 19";
+	//--------------------------------------------------------------------------------------------------------------------
+	ECRIVAIN_CSV* OUTPUT::PrendreEcrivainCsv()
+	{
+		if(_pEcrivainCsv == NULL)
+			_pEcrivainCsv = new ECRIVAIN_CSV();
 
-		return "";
+		return _pEcrivainCsv;
 	}
 
 }
@@ -31,6 +31,8 @@ namespace HYDROTEL
 {
 
 	class SIM_HYD;
+	class OUTPUT_NETCDF;
+	class ECRIVAIN_CSV;
 
 	class OUTPUT
 	{
@@ -100,8 +102,18 @@ namespace HYDROTEL
 
 		bool SauvegardeProfondeurGel() const;
 
-		std::string SauvegardeOutputNetCDF(std::string sPathFile, bool bUHRH, 
-											std::string sOutputVariableName, float* pData, std::string sUnits, std::string sDescription);
+		//extension des fichiers d'etat sauvegardes (.bin ou .csv)
+		std::string ExtensionFichiersEtats() const;
+
+		//desactive la sauvegarde de toutes les variables de sortie (mode calibration)
+		void DesactiveSorties();
+
+		//cree le fichier netcdf d'une variable de sortie; les pas de temps y sont ajoutes pendant la simulation
+		OUTPUT_NETCDF* CreeOutputNetCDF(std::string sPathFile, bool bUHRH, 
+										std::string sOutputVariableName, std::string sUnits, std::string sDescription);
+
+		//retourne le thread d'ecriture des fichiers csv; demarre au premier appel
+		ECRIVAIN_CSV* PrendreEcrivainCsv();
 
 
 	public:
@@ -112,6 +124,7 @@ namespace HYDROTEL
 		//output variables
 		std::string			_sSeparator;
 		std::string			_sFichiersEtatsSeparator;
+		bool				_bFichiersEtatsBinaire;		//fichiers d'etat binaires (ETAT_BINAIRE) au lieu de csv
 		bool				_bSauvegardeTous;
 		bool				_debit_aval;
 		bool				_debit_aval_moy7j_min;
@@ -168,15 +181,23 @@ namespace HYDROTEL
 		bool				_bOutputUhrhVar;
 		bool				_bOutputTronconVar;
 
-		int*				_timeVectorEpoch; 
+		size_t				_netCdfChunkTemps;		//nb pas de temps par chunk (0: 30 jours)
+		size_t				_netCdfChunkElement;	//nb uhrh/troncon par chunk (0: tous)
+		int					_netCdfDeflate;			//0-9
+
+		//csv
+		ECRIVAIN_CSV*		_pEcrivainCsv;
 		
+		//colonnes des fichiers de sortie; calcule une seule fois par SIM_HYD::Initialise
 		size_t				_uhrhOutputNb; 
 		size_t*				_uhrhOutputIndex;
 		int*				_uhrhOutputIDs;
+		std::vector<bool>	_vUhrhOutput;		//[index uhrh] true si sauvegarde
 		
 		size_t				_tronconOutputNb; 
 		size_t*				_tronconOutputIndex;
 		int*				_tronconOutputIDs;
+		std::vector<bool>	_vTronconOutput;	//[index troncon] true si sauvegarde
 
 		//for weighted avg computations
 		std::vector<int>	_wavg_IdTronconMoyPond;
@@ -0,0 +1,357 @@
+//
+// HYDROTEL a spatially distributed hydrological model
+// Copyright (C) 2013 INRS Eau Terre Environnement
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+// USA
+//
+
+#include "output_csv.hpp"
+
+#include "erreur.hpp"
+#include "log-performance.hpp"
+#include "output.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <iomanip>
+#include <sstream>
+
+
+using namespace std;
+
+
+namespace HYDROTEL
+{
+
+	namespace
+	{
+		//nb valeurs par bloc transmis au thread d'ecriture
+		const size_t NB_VALEUR_BLOC = 16384;
+
+		void AjouteEntier(string& str, unsigned int uiVal, size_t lLargeur)
+		{
+			char buf[16];
+
+			to_chars_result res = to_chars(buf, buf + sizeof(buf), uiVal);
+			size_t lNb = static_cast<size_t>(res.ptr - buf);
+
+			if(lNb < lLargeur)
+				str.append(lLargeur - lNb, '0');
+
+			str.append(buf, lNb);
+		}
+
+		void AjouteReel(string& str, double dVal, int iNbDigit)
+		{
+			char buf[512];
+
+			to_chars_result res = to_chars(buf, buf + sizeof(buf), dVal, chars_format::fixed, iNbDigit);
+			if(res.ec == errc())
+				str.append(buf, static_cast<size_t>(res.ptr - buf));
+			else
+			{
+				ostringstream oss;
+				oss << setprecision(iNbDigit) << setiosflags(ios::fixed) << dVal;
+				str+= oss.str();
+			}
+		}
+	}
+
+
+	ECRIVAIN_CSV::ECRIVAIN_CSV()
+	{
+		_lNbLigne = 0;
+		_lNbOctet = 0;
+		_lNbBlocMax = 0;
+
+		_bArret = false;
+
+		_thread = thread(&ECRIVAIN_CSV::Execute, this);
+	}
+
+
+	ECRIVAIN_CSV::~ECRIVAIN_CSV()
+	{
+		{
+			lock_guard<mutex> lock(_mutex);
+			_bArret = true;
+		}
+
+		_cvFile.notify_all();
+
+		if(_thread.joinable())
+			_thread.join();
+	}
+
+
+	//--------------------------------------------------------------------------------------------------------------------
+	void ECRIVAIN_CSV::Ajoute(BLOC_CSV* pBloc)
+	{
+		{
+			lock_guard<mutex> lock(_mutex);
+
+			_file.push_back(pBloc);
+			++pBloc->pFichier->_lNbBlocTransmis;
+
+			_lNbBlocMax = max(_lNbBlocMax, _file.size());
+		}
+
+		_cvFile.notify_one();
+	}
+
+
+	//--------------------------------------------------------------------------------------------------------------------
+	BLOC_CSV* ECRIVAIN_CSV::PrendreBloc(OUTPUT_CSV* pFichier)
+	{
+		BLOC_CSV* pBloc;
+
+		{
+			lock_guard<mutex> lock(_mutex);
+
+			if(!pFichier->_vBlocLibre.empty())
+			{
+				pBloc = pFichier->_vBlocLibre.back();
+				pFichier->_vBlocLibre.pop_back();
+				return pBloc;
+			}
+		}
+
+		pBloc = new BLOC_CSV;
+
+		pBloc->pFichier = pFichier;
+		pBloc->lNbLigne = 0;
+		pBloc->vDate.resize(pFichier->_lNbLigneBloc);
+		pBloc->vValeur.resize(pFichier->_lNbLigneBloc * pFichier->_lNbColonne);
+
+		return pBloc;
+	}
+
+
+	//--------------------------------------------------------------------------------------------------------------------
+	bool ECRIVAIN_CSV::Attend(OUTPUT_CSV* pFichier)
+	{
+		unique_lock<mutex> lock(_mutex);
+
+		_cvEcrit.wait(lock, [pFichier] { return pFichier->_lNbBlocTransmis == 0; });
+
+		return !pFichier->_bErreur;
+	}
+
+
+	//--------------------------------------------------------------------------------------------------------------------
+	void ECRIVAIN_CSV::Execute()
+	{
+		BLOC_CSV* pBloc;
+		size_t lNbLigne;
+		bool bOk;
+
+		unique_lock<mutex> lock(_mutex);
+
+		for(;;)
+		{
+			_cvFile.wait(lock, [this] { return _bArret || !_file.empty(); });
+
+			if(_file.empty())
+				break;	//arret
+
+			pBloc = _file.front();
+			_file.pop_front();
+
+			lock.unlock();
+			bOk = Ecrit(*pBloc);
+			lock.lock();
+
+			lNbLigne = pBloc->lNbLigne;
+
+			_lNbLigne+= lNbLigne;
+			_lNbOctet+= _tampon.size();
+
+			if(!bOk)
+				pBloc->pFichier->_bErreur = true;
+
+			pBloc->lNbLigne = 0;
+			pBloc->pFichier->_vBlocLibre.push_back(pBloc);
+			--pBloc->pFichier->_lNbBlocTransmis;
+
+			_cvEcrit.notify_all();
+		}
+	}
+
+
+	//--------------------------------------------------------------------------------------------------------------------
+	bool ECRIVAIN_CSV::Ecrit(BLOC_CSV& bloc)
+	{
+		TRACE_PERFORMANCE trace("ECRIVAIN_CSV::Ecrit");
+
+		const OUTPUT_CSV& fichier = *bloc.pFichier;
+		const double* pValeur;
+		size_t x, y;
+
+		_tampon.clear();
+
+		for(x=0; x<bloc.lNbLigne; x++)
+		{
+			//date heure: aaaa-mm-jj hh:00
+			AjouteEntier(_tampon, bloc.vDate[x].PrendreAnnee(), 4);
+			_tampon+= '-';
+			AjouteEntier(_tampon, bloc.vDate[x].PrendreMois(), 2);
+			_tampon+= '-';
+			AjouteEntier(_tampon, bloc.vDate[x].PrendreJour(), 2);
+			_tampon+= ' ';
+			AjouteEntier(_tampon, bloc.vDate[x].PrendreHeure(), 2);
+			_tampon+= ":00";
+
+			pValeur = bloc.vValeur.data() + x * fichier._lNbColonne;
+
+			for(y=0; y<fichier._lNbColonne; y++)
+			{
+				_tampon+= fichier._sSeparateur;
+				AjouteReel(_tampon, pValeur[y], fichier._iNbDigit);
+			}
+
+			_tampon+= '\n';
+		}
+
+		bloc.pFichier->_fichier.write(_tampon.data(), static_cast<streamsize>(_tampon.size()));
+
+		return !bloc.pFichier->_fichier.fail();
+	}
+
+
+	OUTPUT_CSV::OUTPUT_CSV()
+	{
+		_pEcrivain = NULL;
+
+		_iNbDigit = 0;
+		_lNbColonne = 0;
+		_lNbLigneBloc = 0;
+
+		_pBloc = NULL;
+
+		_lNbBlocTransmis = 0;
+		_bErreur = false;
+	}
+
+
+	OUTPUT_CSV::~OUTPUT_CSV()
+	{
+		//fermeture sur exception; conserve les lignes deja calculees
+		if(_fichier.is_open())
+		{
+			if(_pBloc != NULL && _pBloc->lNbLigne != 0)
+				Transmet();
+
+			_pEcrivain->Attend(this);
+			_fichier.close();
+		}
+
+		Libere();
+	}
+
+
+	//--------------------------------------------------------------------------------------------------------------------
+	void OUTPUT_CSV::Ouvre(OUTPUT& output, const string& sPathFile, bool bUHRH, int iNbDigit)
+	{
+		_pEcrivain = output.PrendreEcrivainCsv();
+
+		_sPathFile = sPathFile;
+		_sSeparateur = output.Separator();
+		_iNbDigit = iNbDigit;
+
+		_lNbColonne = bUHRH ? output._uhrhOutputNb : output._tronconOutputNb;
+		_lNbLigneBloc = max(static_cast<size_t>(1), NB_VALEUR_BLOC / max(static_cast<size_t>(1), _lNbColonne));
+
+		_lNbBlocTransmis = 0;
+		_bErreur = false;
+
+		_fichier.open(sPathFile);
+		if(!_fichier)
+			throw ERREUR_ECRITURE_FICHIER(sPathFile);
+	}
+
+
+	//--------------------------------------------------------------------------------------------------------------------
+	ofstream& OUTPUT_CSV::Entete()
+	{
+		return _fichier;
+	}
+
+
+	//--------------------------------------------------------------------------------------------------------------------
+	double* OUTPUT_CSV::Ligne(const DATE_HEURE& date)
+	{
+		if(_pBloc != NULL && _pBloc->lNbLigne == _lNbLigneBloc)
+			Transmet();
+
+		if(_pBloc == NULL)
+			_pBloc = _pEcrivain->PrendreBloc(this);
+
+		_pBloc->vDate[_pBloc->lNbLigne] = date;
+
+		return _pBloc->vValeur.data() + _pBloc->lNbLigne++ * _lNbColonne;
+	}
+
+
+	//--------------------------------------------------------------------------------------------------------------------
+	void OUTPUT_CSV::Transmet()
+	{
+		_pEcrivain->Ajoute(_pBloc);
+		_pBloc = NULL;
+	}
+
+
+	//--------------------------------------------------------------------------------------------------------------------
+	void OUTPUT_CSV::Ferme()
+	{
+		bool bOk;
+
+		if(!_fichier.is_open())
+			return;
+
+		if(_pBloc != NULL && _pBloc->lNbLigne != 0)
+			Transmet();
+
+		bOk = _pEcrivain->Attend(this);
+
+		_fichier.close();
+		if(_fichier.fail())
+			bOk = false;
+
+		Libere();
+
+		if(!bOk)
+			throw ERREUR_ECRITURE_FICHIER(_sPathFile);
+	}
+
+
+	//--------------------------------------------------------------------------------------------------------------------
+	void OUTPUT_CSV::Libere()
+	{
+		size_t x;
+
+		if(_pBloc != NULL)
+		{
+			delete _pBloc;
+			_pBloc = NULL;
+		}
+
+		for(x=0; x<_vBlocLibre.size(); x++)
+			delete _vBlocLibre[x];
+
+		_vBlocLibre.clear();
+	}
+
+}
@@ -0,0 +1,139 @@
+//
+// HYDROTEL a spatially distributed hydrological model
+// Copyright (C) 2013 INRS Eau Terre Environnement
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+// USA
+//
+
+#ifndef OUTPUT_CSV_H_INCLUDED
+#define OUTPUT_CSV_H_INCLUDED
+
+
+#include "date_heure.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace HYDROTEL
+{
+
+	class OUTPUT;
+	class OUTPUT_CSV;
+
+	//bloc de lignes transmis au thread d'ecriture
+	struct BLOC_CSV
+	{
+		OUTPUT_CSV*					pFichier;
+		size_t						lNbLigne;
+		std::vector<DATE_HEURE>		vDate;		//[ligne]
+		std::vector<double>			vValeur;	//[ligne * nb colonne]
+	};
+
+
+	//thread d'ecriture des fichiers csv de sortie
+	//le formatage des valeurs (std::to_chars) et l'ecriture sur disque sont faits hors du thread de simulation
+	class ECRIVAIN_CSV
+	{
+	public:
+		ECRIVAIN_CSV();
+		~ECRIVAIN_CSV();
+
+		size_t					_lNbLigne;		//nb lignes ecrites
+		size_t					_lNbOctet;		//nb octets ecrits
+		size_t					_lNbBlocMax;	//profondeur maximale de la file (nb blocs)
+
+	private:
+		friend class OUTPUT_CSV;
+
+		//ajoute un bloc a la file; ne bloque jamais le thread de simulation
+		void		Ajoute(BLOC_CSV* pBloc);
+
+		//retourne un bloc libre du fichier (reutilise ou nouveau)
+		BLOC_CSV*	PrendreBloc(OUTPUT_CSV* pFichier);
+
+		//attend que tous les blocs du fichier soient ecrits; retourne false si une erreur d'ecriture est survenue
+		bool		Attend(OUTPUT_CSV* pFichier);
+
+		void		Execute();
+
+		bool		Ecrit(BLOC_CSV& bloc);
+
+		std::thread					_thread;
+		std::mutex					_mutex;
+		std::condition_variable		_cvFile;
+		std::condition_variable		_cvEcrit;
+
+		std::deque<BLOC_CSV*>		_file;
+		bool						_bArret;
+
+		std::string					_tampon;	//ligne formatee (thread d'ecriture)
+	};
+
+
+	//fichier csv de sortie d'une variable uhrh/troncon
+	//les lignes sont accumulees par bloc et transmises au thread d'ecriture (ECRIVAIN_CSV)
+	class OUTPUT_CSV
+	{
+	public:
+		OUTPUT_CSV();
+		~OUTPUT_CSV();
+
+		//cree le fichier; bUHRH: colonnes uhrh sinon troncon; iNbDigit: nb decimales
+		void		Ouvre(OUTPUT& output, const std::string& sPathFile, bool bUHRH, int iNbDigit);
+
+		//flux pour l'ecriture de l'entete; valide seulement avant le premier appel a Ligne
+		std::ofstream& Entete();
+
+		//retourne la ligne (uhrh/troncon) a remplir pour le pas de temps
+		double*		Ligne(const DATE_HEURE& date);
+
+		//transmet les dernieres lignes, attend leur ecriture et ferme le fichier
+		void		Ferme();
+
+	private:
+		friend class ECRIVAIN_CSV;
+
+		void		Transmet();
+
+		void		Libere();
+
+		ECRIVAIN_CSV*				_pEcrivain;
+
+		std::ofstream				_fichier;
+		std::string					_sPathFile;
+		std::string					_sSeparateur;
+
+		int							_iNbDigit;
+		size_t						_lNbColonne;
+		size_t						_lNbLigneBloc;
+
+		BLOC_CSV*					_pBloc;			//bloc en cours de remplissage
+
+		//acces protege par le mutex de l'ecrivain
+		std::vector<BLOC_CSV*>		_vBlocLibre;
+		size_t						_lNbBlocTransmis;
+		bool						_bErreur;
+	};
+
+}
+
+#endif
@@ -0,0 +1,338 @@
+//
+// HYDROTEL a spatially distributed hydrological model
+// Copyright (C) 2013 INRS Eau Terre Environnement
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+// USA
+//
+
+#include "output_netcdf.hpp"
+
+#include "erreur.hpp"
+#include "output.hpp"
+#include "sim_hyd.hpp"
+#include "util.hpp"
+
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+
+#include <netcdf.h>
+
+
+using namespace std;
+
+
+namespace HYDROTEL
+{
+
+	OUTPUT_NETCDF::OUTPUT_NETCDF()
+	{
+		_iNcid = -1;
+		_iVarID = -1;
+		_iTimeID = -1;
+
+		_lNbElement = 0;
+		_lNbPasTempsBloc = 0;
+		_lDebutBloc = 0;
+		_lNbLigne = 0;
+
+		_iDateDebut = 0;
+		_iPasTemps = 0;
+
+		_pBloc = NULL;
+		_pTemps = NULL;
+	}
+
+
+	OUTPUT_NETCDF::~OUTPUT_NETCDF()
+	{
+		//fermeture sur exception; conserve les pas de temps deja calcules
+		if(_iNcid != -1)
+			Ferme();
+
+		if(_pBloc != NULL)
+			delete [] _pBloc;
+
+		if(_pTemps != NULL)
+			delete [] _pTemps;
+	}
+
+
+	//--------------------------------------------------------------------------------------------------------------------
+	string OUTPUT_NETCDF::Ouvre(const OUTPUT& output, string sPathFile, bool bUHRH, 
+								string sOutputVariableName, string sUnits, string sDescription)
+	{
+		ostringstream oss;
+		string sDimName, str;
+		time_t currentTime;
+		size_t chunksize[2];
+		int dimidsElement[1];
+		int dimidsTime[1];
+		int dimidsVar[2];
+		int ret, iDimID, iDimTimeID, iElemID;
+
+		SIM_HYD* sim_hyd = output._sim_hyd;
+
+		_sPathFile = sPathFile;
+
+		if(FichierExiste(sPathFile))
+			SupprimerFichier(sPathFile);
+
+		if(bUHRH)
+		{
+			sDimName = "uhrh";
+			_lNbElement = output._uhrhOutputNb;
+		}
+		else
+		{
+			sDimName = "troncon";
+			_lNbElement = output._tronconOutputNb;
+		}
+
+		//chunk temporel; 0 = 30 jours
+		_lNbPasTempsBloc = output._netCdfChunkTemps;
+		if(_lNbPasTempsBloc == 0)
+			_lNbPasTempsBloc = 720 / sim_hyd->_pas_de_temps;
+
+		_lNbPasTempsBloc = max(static_cast<size_t>(1), min(_lNbPasTempsBloc, sim_hyd->_lNbPasTempsSim));
+
+		//chunk uhrh/troncon; 0 = tous
+		chunksize[0] = _lNbPasTempsBloc;	//time dimension
+		chunksize[1] = output._netCdfChunkElement;
+
+		if(chunksize[1] == 0 || chunksize[1] > _lNbElement)
+			chunksize[1] = _lNbElement;
+
+		_iPasTemps = sim_hyd->_pas_de_temps * 60;	//minutes
+		_iDateDebut = static_cast<int>(sim_hyd->_date_debut.EpochTime() / 60.0);	//minutes since 1970/01/01
+
+		_pBloc = new float[_lNbPasTempsBloc * _lNbElement];
+		_pTemps = new int[_lNbPasTempsBloc];
+
+		_lDebutBloc = 0;
+		_lNbLigne = 0;
+
+		ret = nc_create(sPathFile.c_str(), NC_NETCDF4, &_iNcid);
+		if (ret != NC_NOERR)
+		{
+			_iNcid = -1;
+			return "error creating file: " + sPathFile + ": error 1";
+		}
+
+		//global attributes
+		str = "Variable de sortie simulation Hydrotel";
+		ret = nc_put_att_text(_iNcid, NC_GLOBAL, "description", str.size(), str.c_str());
+		if (ret != NC_NOERR)
+			return "error creating file: " + sPathFile + ": error 2";
+
+		str = sim_hyd->PrendreRepertoireSimulation();
+		ret = nc_put_att_text(_iNcid, NC_GLOBAL, "initial_simulation_path", str.size(), str.c_str());
+		if (ret != NC_NOERR)
+			return "error creating file: " + sPathFile + ": error 3";
+
+		currentTime = time(0);   // get time now
+
+#if defined(_WIN64) || defined(_WIN32)
+
+		struct tm now;
+		localtime_s(&now, &currentTime);
+
+		oss << setw(2) << setfill('0') << now.tm_mday << '-' 
+			<< setw(2) << setfill('0') << (now.tm_mon + 1) << '-' 
+			<< (now.tm_year + 1900) << ' ' 
+			<< setw(2) << setfill('0') << now.tm_hour << ":"
+			<< setw(2) << setfill('0') << now.tm_min << ":"
+			<< setw(2) << setfill('0') << now.tm_sec;
+
+#else
+
+		tm* now = localtime(&currentTime);
+
+		oss << setw(2) << setfill('0') << now->tm_mday << '-' 
+			<< setw(2) << setfill('0') << (now->tm_mon + 1) << '-' 
+			<< (now->tm_year + 1900) << ' ' 
+			<< setw(2) << setfill('0') << now->tm_hour << ":" 
+			<< setw(2) << setfill('0') << now->tm_min << ":" 
+			<< setw(2) << setfill('0') << now->tm_sec;
+
+#endif
+
+		str = oss.str();
+		ret = nc_put_att_text(_iNcid, NC_GLOBAL, "creation_time", str.size(), str.c_str());
+		if (ret != NC_NOERR)
+			return "error creating file: " + sPathFile + ": error 4";
+
+		//dimensions
+		ret = nc_def_dim(_iNcid, sDimName.c_str(), _lNbElement, &iDimID);
+		if (ret != NC_NOERR)
+			return "error creating file: " + sPathFile + ": error 5";
+
+		ret = nc_def_dim(_iNcid, "time", NC_UNLIMITED, &iDimTimeID);
+		if (ret != NC_NOERR)
+			return "error creating file: " + sPathFile + ": error 6";
+
+		//variables
+
+		//idtroncon/iduhrh
+		dimidsElement[0] = iDimID;
+		str = "id" + sDimName;
+
+		ret = nc_def_var(_iNcid, str.c_str(), NC_INT, 1, dimidsElement, &iElemID);
+		if (ret != NC_NOERR)
+			return "error creating file: " + sPathFile + ": error 7";
+
+		//time
+		dimidsTime[0] = iDimTimeID;
+
+		ret = nc_def_var(_iNcid, "time", NC_INT, 1, dimidsTime, &_iTimeID);
+		if (ret != NC_NOERR)
+			return "error creating file: " + sPathFile + ": error 8"; 
+		
+		str = "minutes since 1970-01-01 00:00:00";
+		ret = nc_put_att_text(_iNcid, _iTimeID, "units", str.size(), str.c_str());
+		if (ret != NC_NOERR)
+			return "error creating file: " + sPathFile + ": error 9";
+
+		//output var
+		dimidsVar[0] = iDimTimeID;
+		dimidsVar[1] = iDimID;
+		
+		ret = nc_def_var(_iNcid, sOutputVariableName.c_str(), NC_FLOAT, 2, dimidsVar, &_iVarID);
+		if (ret != NC_NOERR)
+			return "error creating file: " + sPathFile + ": error 10";
+
+		ret = nc_def_var_chunking(_iNcid, _iVarID, NC_CHUNKED, chunksize);
+		if (ret != NC_NOERR)
+			return "error creating file: " + sPathFile + ": error 11";
+
+		if(output._netCdfDeflate > 0)
+		{
+			ret = nc_def_var_deflate(_iNcid, _iVarID, 0, 1, output._netCdfDeflate);
+			if (ret != NC_NOERR)
+				return "error creating file: " + sPathFile + ": error 12";
+		}
+
+		ret = nc_put_att_text(_iNcid, _iVarID, "units", sUnits.size(), sUnits.c_str());
+		if (ret != NC_NOERR)
+			return "error creating file: " + sPathFile + ": error 13";
+
+		ret = nc_put_att_text(_iNcid, _iVarID, "description", sDescription.size(), sDescription.c_str());
+		if (ret != NC_NOERR)
+			return "error creating file: " + sPathFile + ": error 14";
+
+		ret = nc_enddef(_iNcid);
+		if (ret != NC_NOERR)
+			return "error creating file: " + sPathFile + ": error 15";
+
+		//save data
+		if (bUHRH)
+			ret = nc_put_var_int(_iNcid, iElemID, output._uhrhOutputIDs);
+		else
+			ret = nc_put_var_int(_iNcid, iElemID, output._tronconOutputIDs);
+
+		if (ret != NC_NOERR)
+			return "error creating file: " + sPathFile + ": error 16";
+
+		return "";
+	}
+
+
+	//--------------------------------------------------------------------------------------------------------------------
+	float* OUTPUT_NETCDF::Ligne(size_t lPasTemps)
+	{
+		string str;
+
+		if(lPasTemps < _lDebutBloc || lPasTemps >= _lDebutBloc + _lNbPasTempsBloc)
+		{
+			str = Ecrit();
+			if(str != "")
+				throw ERREUR(str);
+
+			_lDebutBloc = lPasTemps - lPasTemps % _lNbPasTempsBloc;	//aligne sur les chunks
+			_lNbLigne = 0;
+		}
+
+		_lNbLigne = max(_lNbLigne, lPasTemps - _lDebutBloc + 1);
+
+		return _pBloc + (lPasTemps - _lDebutBloc) * _lNbElement;
+	}
+
+
+	//--------------------------------------------------------------------------------------------------------------------
+	string OUTPUT_NETCDF::Ecrit()
+	{
+		TRACE_PERFORMANCE trace("OUTPUT_NETCDF::Ecrit");
+
+		size_t start[2];
+		size_t count[2];
+		size_t x;
+		int ret;
+
+		if(_lNbLigne == 0)
+			return "";
+
+		for(x=0; x<_lNbLigne; x++)
+			_pTemps[x] = _iDateDebut + static_cast<int>(_lDebutBloc + x) * _iPasTemps;
+
+		start[0] = _lDebutBloc;
+		count[0] = _lNbLigne;
+
+		ret = nc_put_vara_int(_iNcid, _iTimeID, start, count, _pTemps);
+		if (ret != NC_NOERR)
+			return "error writing file: " + _sPathFile + ": error 17";
+
+		start[1] = 0;
+		count[1] = _lNbElement;
+
+		ret = nc_put_vara_float(_iNcid, _iVarID, start, count, _pBloc);
+		if (ret != NC_NOERR)
+			return "error writing file: " + _sPathFile + ": error 18";
+
+		//le fichier reste lisible si la simulation est interrompue
+		ret = nc_sync(_iNcid);
+		if (ret != NC_NOERR)
+			return "error writing file: " + _sPathFile + ": error 19";
+
+		_lNbLigne = 0;
+		return "";
+	}
+
+
+	//--------------------------------------------------------------------------------------------------------------------
+	string OUTPUT_NETCDF::Ferme()
+	{
+		string str;
+		int ret;
+
+		if(_iNcid == -1)
+			return "";
+
+		str = Ecrit();
+
+		ret = nc_close(_iNcid);
+		_iNcid = -1;
+
+		if(str != "")
+			return str;
+
+		if (ret != NC_NOERR)
+			return "error creating file: " + _sPathFile + ": error 20";
+
+		return "";
+	}
+
+}
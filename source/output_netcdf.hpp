@@ -0,0 +1,74 @@
+//
+// HYDROTEL a spatially distributed hydrological model
+// Copyright (C) 2013 INRS Eau Terre Environnement
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+// USA
+//
+
+#ifndef OUTPUT_NETCDF_H_INCLUDED
+#define OUTPUT_NETCDF_H_INCLUDED
+
+
+#include <string>
+
+
+namespace HYDROTEL
+{
+
+	class OUTPUT;
+
+	//ecriture en continu d'une variable de sortie dans un fichier netcdf (dimension temps illimitee)
+	//les pas de temps sont accumules par bloc de la taille du chunk temporel puis ajoutes au fichier
+	class OUTPUT_NETCDF
+	{
+	public:
+		OUTPUT_NETCDF();
+		~OUTPUT_NETCDF();
+
+		//cree le fichier et definit les dimensions/variables; retourne un message d'erreur ou ""
+		std::string Ouvre(const OUTPUT& output, std::string sPathFile, bool bUHRH, 
+							std::string sOutputVariableName, std::string sUnits, std::string sDescription);
+
+		//retourne la ligne (uhrh/troncon) a remplir pour le pas de temps; ecrit le bloc precedent au besoin
+		float* Ligne(size_t lPasTemps);
+
+		//ecrit le dernier bloc et ferme le fichier; retourne un message d'erreur ou ""
+		std::string Ferme();
+
+	private:
+		std::string Ecrit();
+
+		std::string			_sPathFile;
+
+		int					_iNcid;
+		int					_iVarID;
+		int					_iTimeID;
+
+		size_t				_lNbElement;
+		size_t				_lNbPasTempsBloc;	//taille du bloc (chunk temporel)
+		size_t				_lDebutBloc;		//index du premier pas de temps du bloc
+		size_t				_lNbLigne;			//nb pas de temps remplis dans le bloc
+
+		int					_iDateDebut;		//minutes since 1970/01/01
+		int					_iPasTemps;			//minutes
+
+		float*				_pBloc;
+		int*				_pTemps;
+	};
+
+}
+
+#endif
@@ -43,6 +43,7 @@ namespace HYDROTEL
 		_FolderNameSrc = sim_hyd._sFolderNamePrelevementsSrc;
 
 		_bSimulePrelevements = false;
+		_iAnneeDebut = 0;
 	}
 
 
@@ -593,6 +594,9 @@ namespace HYDROTEL
 		if(_donneesGPE.size() != 0 || _donneesPR.size() != 0 || _donneesEFFLUENT.size() != 0) //on ne met pas || _donneesCULTURESite.size() != 0 || _donneesELEVAGE.size() != 0 : les prelevements des sites de culture et des sites d'levage sont effectu avec les sites de prlevement. Si pas de site Pr pas de prlevement culture/elevage...
 			_bSimulePrelevements = true;
 
+		if(!CompilePrelevements())
+			return false;
+
 		return true;
 	}
 
@@ -1516,25 +1520,20 @@ namespace HYDROTEL
 
 
 	//----------------------------------------------------------------------------------------------------------------
-	//Calcule les prelevements et rejets  effectuer pour le pas de temps courant (pour tous les troncons)
-	//
-	//Si le fichier TypePrelevement.csv est prsent, le type doit tre  1 pour que le prlvement soit effectu.
-	//Si le type est absent du fichier (le fichier est prsent et contient d'autre type), le prlvement est effectu.
+	//Compile les sites de chaque troncon simul (valeurs des colonnes, jours et mois de prlvement)
+	//pour viter la lecture des lignes csv  chaque pas de temps (CalculePrelevements)
 	//
-	bool PRELEVEMENTS::CalculePrelevements()
+	bool PRELEVEMENTS::CompilePrelevements()
 	{
 		string ColNbJour = "NBJ M";
 		string ColVol = "VOL M";
 		string ColCons = "CONS M";
 
-		DATE_HEURE dt;
-		size_t index, i, j;
-		size_t indexTroncon;
-		ostringstream oss, ossAnnee, ossDateStr;
-		string ColNbJourTemp, ColVolTemp, ColConsTemp, sAnnee, str1, str2, sType;
-		double dNbJour, dVal1, dVal2, dPrelevementSite, dRejetSite, dCoeff, dCoeffApplicable;
-		bool OnProcede, OnRejete, bTypeOk;
-		int moisCourant, anneeCourant, jourCourant, idTroncon, idUhrh, iNbJourAnneeCourant, iMoisDebut, iMoisFin;
+		ostringstream oss;
+		string sAnnee, str1, sType, sLigne;
+		size_t index, i, x;
+		int idTroncon, idUhrh, iAnnee, iAnneeFin, jour, mois, iMoisDebut, iMoisFin;
+		bool bTypeOk, bReduction, bPr;
 
 		map<int, map<int, map<string, string>>>::const_iterator itGpe;
 		map<int, map<string, string>>::const_iterator itGpeSite;
@@ -1544,198 +1543,141 @@ namespace HYDROTEL
 		vector<size_t> index_troncons = _sim_hyd.PrendreTronconsSimules();
 		TRONCONS& troncons = _sim_hyd.PrendreTroncons();
 		ZONES& zones = _sim_hyd.PrendreZones();
-		TRONCON* troncon;
-
-		try{
-		
-		dt = _sim_hyd.PrendreDateCourante();
-		jourCourant = dt.PrendreJour();
-		moisCourant = dt.PrendreMois();
-		anneeCourant = dt.PrendreAnnee();
 
-		dCoeffApplicable = 1.0;
-		if(_donneesTYPE_redCoeff.size() != 0)	//only if the reduction coefficient is enabled at least for one type
+		//coefficient de rduction applicable au type
+		auto Reduction = [this](const string& sTypePr) -> bool
 		{
-			ossDateStr.str("");
-			ossDateStr << std::setfill('0') << std::setw(4) << anneeCourant << std::setw(2) << moisCourant << std::setw(2) << jourCourant;
-
-			if(_donneesREDCOEFF.count(ossDateStr.str()) != 0)
-				dCoeffApplicable-= _donneesREDCOEFF[ossDateStr.str()];
-		}
-
-		if(dt.Bissextile())
-			iNbJourAnneeCourant = 366;
-		else
-			iNbJourAnneeCourant = 365;
+			return _donneesTYPE_redCoeff.size() != 0 && _donneesTYPE_redCoeff.count(sTypePr) != 0 && _donneesTYPE_redCoeff[sTypePr] == 1;
+		};
 
-		if(_donneesGPE.size() != 0)
+		//TYPE du prlvement activ
+		auto TypeActif = [this](const string& sTypePr) -> bool
 		{
-			oss.str("");
-			oss << moisCourant;
+			return _donneesTYPE.count(sTypePr) == 0 || _donneesTYPE[sTypePr] == 1;
+		};
 
-			ColNbJourTemp = ColNbJour + oss.str();	//pour prelevements GPE
-			ColVolTemp = ColVol + oss.str();		//
-			ColConsTemp = ColCons + oss.str();		//
-		}
+		_iAnneeDebut = _sim_hyd.PrendreDateDebut().PrendreAnnee();
+		iAnneeFin = _sim_hyd.PrendreDateFin().PrendreAnnee();
 
-		ossAnnee << anneeCourant;
+		_prelevementsTroncon.clear();
+		_prelevementsTroncon.resize(index_troncons.size());
 
-		_tronconsPrelevementString.clear();
-		_tronconsPrelevementVal.clear();
-		_tronconsPrelevementCultureString.clear();
-		_tronconsPrelevementCultureVal.clear();
-		_tronconsRejetString.clear();
-		_tronconsRejetVal.clear();
-		_tronconsRejetEffluentString.clear();
-		_tronconsRejetEffluentVal.clear();
-
-		//boucle sur les troncons simuls
 		for(index=0; index!=index_troncons.size(); index++)
 		{
-			indexTroncon = index_troncons[index];			
-			troncon = troncons[indexTroncon];
-
-			idTroncon = troncon->PrendreIdent();
+			PRELEVEMENTS_TRONCON& prTroncon = _prelevementsTroncon[index];
 
-			troncon->_prPrelevementTotal = 0.0;
-			troncon->_prPrelevementCulture = 0.0;
-			troncon->_prRejetTotal = 0.0;
-			troncon->_prRejetEffluent = 0.0;
+			idTroncon = troncons[index_troncons[index]]->PrendreIdent();
 
 			//Sites GPE
 
 			itGpe = _donneesGPE.find(idTroncon);
 			if(itGpe != _donneesGPE.end())
 			{
-				//pour chaque site gpe associ au troncon courant
 				for(itGpeSite=itGpe->second.begin(); itGpeSite!=itGpe->second.end(); itGpeSite++)
 				{
-					OnProcede = false;
-					dCoeff = 1.0;
+					PRELEVEMENT_GPE gpe;
+
+					bPr = _donneesGPE_PR.count(itGpeSite->first) != 0;		//s'il y a un site de prelevement associ au site gpe
 
 					bTypeOk = true;
-					if(_donneesTYPE.size() != 0)	//si le fichier TypePrelevement.csv est prsent
+					gpe.bReduction = false;
+
+					if(_donneesTYPE.size() != 0 && bPr)
 					{
-						if(_donneesGPE_PR.count(itGpeSite->first) != 0)		//s'il y a un site de prelevement associ au site gpe
-						{
-							str1 = TrimString(GetPrStr(_donneesPRSite[_donneesGPE_PR[itGpeSite->first]], "TYPE"));
-							boost::algorithm::to_upper(str1);	//uppercase
+						str1 = TrimString(GetPrStr(_donneesPRSite[_donneesGPE_PR[itGpeSite->first]], "TYPE"));
+						boost::algorithm::to_upper(str1);	//uppercase
 
-							if(_donneesTYPE.count(str1) != 0 && _donneesTYPE[str1] == 0)
-								bTypeOk = false;
-							else
-							{
-								//coefficient de rduction
-								if(_donneesTYPE_redCoeff.size() != 0 && _donneesTYPE_redCoeff.count(str1) != 0 && _donneesTYPE_redCoeff[str1] == 1)
-									dCoeff = dCoeffApplicable;
-							}
-						}
+						if(_donneesTYPE.count(str1) != 0 && _donneesTYPE[str1] == 0)
+							bTypeOk = false;
+						else
+							gpe.bReduction = Reduction(str1);
 					}
 
-					if(bTypeOk)
-					{
-						if(itGpeSite->second.count(ossAnnee.str()) != 0)	//si l'annee courante est presente
-							sAnnee = ossAnnee.str();
-						else
-							sAnnee = "MOY";
+					if(!bTypeOk)
+						continue;
 
-						str1 = TrimString(GetGpeStr(itGpeSite->second.at(sAnnee), "SOURCE"));
-						boost::algorithm::to_upper(str1);	//uppercase
-					
-						if(str1 == "SURFACE" && TrimString(GetGpeStr(itGpeSite->second.at(sAnnee), "CRITERE")) == "1")
-						{
-							//Verifie si c'est un jour de prelevement
-							//Les jours de prlvements ont t pralablement dtermins pour toute les annes de simulation (fonction LecturePrelevements)
-							//avec alatoire lorsque NbJ MX est < que le nb de jour du mois
+					oss.str("");
+					oss << "GPE;" << itGpeSite->first << ";";
+					if(bPr)
+						oss << _donneesGPE_PR[itGpeSite->first];
+					oss << ";";
+					gpe.sDescription = oss.str();
 
-							if(std::find(_donneesGPE_Jours[idTroncon][itGpeSite->first][anneeCourant][moisCourant].begin(), _donneesGPE_Jours[idTroncon][itGpeSite->first][anneeCourant][moisCourant].end(), jourCourant) != _donneesGPE_Jours[idTroncon][itGpeSite->first][anneeCourant][moisCourant].end())
-							{
-								OnProcede = true;
+					gpe.bRejet = true;
+					gpe.bDesactiveAnneeMax = false;
 
-								if(sAnnee == "MOY")
-								{
-									if(anneeCourant > _donneesGPE_AnneeMax[idTroncon][itGpeSite->first])
-									{
-										//s'il y a un site de prelevement associ au site gpe
-										if(_donneesGPE_PR.count(itGpeSite->first) != 0)
-										{
-											//si CRITERE du site PR correspondant gal 0 (dsactiv)
-											str1 = TrimString(GetPrStr(_donneesPRSite[_donneesGPE_PR[itGpeSite->first]], "CRITERE"));
-											if(str1 == "0")
-												OnProcede = false;
-										}
-									}
-								}
-							}
-						}
+					if(bPr)
+					{
+						sLigne = _donneesPRSite[_donneesGPE_PR[itGpeSite->first]];
+
+						if(TrimString(GetPrStr(sLigne, "CRITERE_CONSOMMATION")) != "1")
+							gpe.bRejet = false;
+
+						if(TrimString(GetPrStr(sLigne, "CRITERE")) == "0")
+							gpe.bDesactiveAnneeMax = true;
 					}
 
-					if(OnProcede)
-					{
-						//prelevement
-						dNbJour = GetGpeDbl(itGpeSite->second.at(sAnnee), ColNbJourTemp);
-						dVal1 = GetGpeDbl(itGpeSite->second.at(sAnnee), ColVolTemp);
+					gpe.iAnneeMax = _donneesGPE_AnneeMax[idTroncon][itGpeSite->first];
 
-						dVal1*= dCoeff;		//coefficient de rduction (la valeur est  1 si non applicable)
-						
-						dPrelevementSite = dVal1 / dNbJour;	//l/jour
-						dPrelevementSite = dPrelevementSite / 1000.0 / 86400.0;	//m3/s
+					gpe.vAnnee.resize(static_cast<size_t>(iAnneeFin - _iAnneeDebut + 1));
 
-						if(dPrelevementSite > 0.0)
-						{
-							troncon->_prPrelevementTotal+= dPrelevementSite;
+					for(iAnnee=_iAnneeDebut; iAnnee!=iAnneeFin+1; iAnnee++)
+					{
+						PRELEVEMENT_GPE_ANNEE& annee = gpe.vAnnee[static_cast<size_t>(iAnnee - _iAnneeDebut)];
 
-							oss.str("");
-							oss << "GPE;" << itGpeSite->first << ";";
+						oss.str("");
+						oss << iAnnee;
+
+						if(itGpeSite->second.count(oss.str()) != 0)	//si l'annee est presente
+							sAnnee = oss.str();
+						else
+							sAnnee = "MOY";
 
-							if(_donneesGPE_PR.count(itGpeSite->first) != 0)		//s'il y a un site de prelevement associ au site gpe
-								oss << _donneesGPE_PR[itGpeSite->first];
+						annee.bMoy = (sAnnee == "MOY");
 
-							oss << ";" << setprecision(_sim_hyd.PrendreOutput()._nbDigit_m3s) << setiosflags(ios::fixed) << dPrelevementSite;
+						sLigne = itGpeSite->second.at(sAnnee);
 
-							_tronconsPrelevementString[indexTroncon].push_back(oss.str());
-							_tronconsPrelevementVal[indexTroncon].push_back(dPrelevementSite);
-						}
+						str1 = TrimString(GetGpeStr(sLigne, "SOURCE"));
+						boost::algorithm::to_upper(str1);	//uppercase
 
-						//rejet
-						OnRejete = true;
+						annee.bSurface = (str1 == "SURFACE" && TrimString(GetGpeStr(sLigne, "CRITERE")) == "1");
 
-						//s'il y a un site de prelevement associ au site gpe
-						if(_donneesGPE_PR.count(itGpeSite->first) != 0)
+						for(x=0; x!=12; x++)
 						{
-							str1 = TrimString(GetPrStr(_donneesPRSite[_donneesGPE_PR[itGpeSite->first]], "CRITERE_CONSOMMATION"));
-							if(str1 != "1")
-								OnRejete = false;
+							annee.uiMasqueJours[x] = 0;
+							annee.dNbJour[x] = 0.0;
+							annee.dVol[x] = 0.0;
+							annee.dCons[x] = 0.0;
 						}
-						
-						if(OnRejete)
-						{
-							dVal2 = GetGpeDbl(itGpeSite->second.at(sAnnee), ColConsTemp);
-							dVal2*= dCoeff;		//coefficient de rduction (la valeur est  1 si non applicable)
-
-							dRejetSite = (dVal1 - dVal2) / dNbJour;			//l/jour
-							dRejetSite = dRejetSite / 1000.0 / 86400.0;		//m3/s
 
-							if(dRejetSite > 0.0)
-							{
-								if(dPrelevementSite > 0.0 && dRejetSite > dPrelevementSite)
-									dRejetSite = dPrelevementSite;
+						if(!annee.bSurface)
+							continue;
 
-								troncon->_prRejetTotal+= dRejetSite;
+						for(mois=1; mois!=13; mois++)
+						{
+							x = static_cast<size_t>(mois - 1);
 
-								oss.str("");
-								oss << "GPE;" << itGpeSite->first << ";";
+							//jours de prlvements dtermins par LecturePrelevementsGPE
+							const vector<int>& vJours = _donneesGPE_Jours[idTroncon][itGpeSite->first][iAnnee][mois];
+							for(i=0; i!=vJours.size(); i++)
+							{
+								jour = vJours[i];
+								if(jour >= 1 && jour <= 31)
+									annee.uiMasqueJours[x]|= (1u << (jour - 1));
+							}
 
-								if(_donneesGPE_PR.count(itGpeSite->first) != 0)		//s'il y a un site de prelevement associ au site gpe
-									oss << _donneesGPE_PR[itGpeSite->first];
+							oss.str("");
+							oss << mois;
 
-								oss << ";" << setprecision(_sim_hyd.PrendreOutput()._nbDigit_m3s) << setiosflags(ios::fixed) << dRejetSite;
+							annee.dNbJour[x] = GetGpeDbl(sLigne, ColNbJour + oss.str());
+							annee.dVol[x] = GetGpeDbl(sLigne, ColVol + oss.str());
 
-								_tronconsRejetString[indexTroncon].push_back(oss.str());
-								_tronconsRejetVal[indexTroncon].push_back(dRejetSite);
-							}
+							if(gpe.bRejet)
+								annee.dCons[x] = GetGpeDbl(sLigne, ColCons + oss.str());
 						}
 					}
+
+					prTroncon.vGpe.push_back(gpe);
 				}
 			}
 
@@ -1744,119 +1686,76 @@ namespace HYDROTEL
 			itTroncon = _donneesPR.find(idTroncon);
 			if(itTroncon != _donneesPR.end())
 			{
-				//pour chaque site de prlvement associ au troncon courant
 				for(itSite=itTroncon->second.begin(); itSite!=itTroncon->second.end(); itSite++)
 				{
 					str1 = TrimString(GetPrStr(itSite->second, "SOURCE"));
 					boost::algorithm::to_upper(str1);	//uppercase
 
-					if(str1 == "SURFACE" && TrimString(GetPrStr(itSite->second, "CRITERE")) == "1" && 
-						TrimString(GetPrStr(itSite->second, "SITE_GPE")) == "" && TrimString(GetPrStr(itSite->second, "SITE_ELEVAGES")) == "")
-					{
-						if(TrimString(GetPrStr(itSite->second, "SITE_CULTURES")) == "")
-						{
-							OnProcede = false;
+					if(str1 != "SURFACE" || TrimString(GetPrStr(itSite->second, "CRITERE")) != "1" || 
+						TrimString(GetPrStr(itSite->second, "SITE_GPE")) != "" || TrimString(GetPrStr(itSite->second, "SITE_ELEVAGES")) != "")
+						continue;
 
-							//si le TYPE du prlvement est activ
-							str1 = TrimString(GetPrStr(itSite->second, "TYPE"));
-							boost::algorithm::to_upper(str1);	//uppercase
-							if(_donneesTYPE.count(str1) == 0 || _donneesTYPE[str1] == 1)
-							{
-								//si dans l'intervalle de temps (mois dbut et fin)
-								iMoisDebut = GetPrInt(itSite->second, "MOIS D");
-								iMoisFin = GetPrInt(itSite->second, "MOIS FIN");
+					sType = TrimString(GetPrStr(itSite->second, "TYPE"));
+					boost::algorithm::to_upper(sType);	//uppercase
 
-								if(iMoisDebut <= iMoisFin && moisCourant >= iMoisDebut && moisCourant <= iMoisFin)
-									OnProcede = true;
-								else
-								{
-									if( iMoisDebut > iMoisFin && (moisCourant >= iMoisDebut || moisCourant <= iMoisFin) )
-										OnProcede = true;
-								}
-							}
-					
-							if(OnProcede)
-							{
-								//prelevement
-								dVal1 = GetPrDbl(itSite->second, "PRELEV (L/J)");
+					if(!TypeActif(sType))
+						continue;
 
-								//coefficient de rduction
-								if(_donneesTYPE_redCoeff.size() != 0 && _donneesTYPE_redCoeff.count(str1) != 0 && _donneesTYPE_redCoeff[str1] == 1)
-									dVal1*= dCoeffApplicable;
+					bReduction = Reduction(sType);
 
-								dPrelevementSite = dVal1 / 1000.0 / 86400.0;	//m3/s
+					str1 = TrimString(GetPrStr(itSite->second, "SITE_CULTURES"));
+					if(str1 == "")
+					{
+						PRELEVEMENT_PR pr;
 
-								if(dPrelevementSite > 0.0)
-								{
-									troncon->_prPrelevementTotal+= dPrelevementSite;
+						oss.str("");
+						oss << "PR;" << itSite->first << ";" << ";";
+						pr.sDescription = oss.str();
 
-									oss.str("");
-									oss << "PR;" << itSite->first << ";" << ";" << setprecision(_sim_hyd.PrendreOutput()._nbDigit_m3s) << setiosflags(ios::fixed) << dPrelevementSite;
-									_tronconsPrelevementString[indexTroncon].push_back(oss.str());
-									_tronconsPrelevementVal[indexTroncon].push_back(dPrelevementSite);
-								}
+						//mois de prlvement (mois dbut et fin)
+						iMoisDebut = GetPrInt(itSite->second, "MOIS D");
+						iMoisFin = GetPrInt(itSite->second, "MOIS FIN");
 
-								//rejet
-								str1 = TrimString(GetPrStr(itSite->second, "CRITERE_CONSOMMATION"));
-								if(str1 == "1")
-								{
-									dVal2 = GetPrDbl(itSite->second, "COEF_CONS");
-									dRejetSite = (dVal1 - dVal1 * dVal2) / 1000.0 / 86400.0;		//m3/s
-								
-									if(dRejetSite > 0.0)
-									{
-										if(dPrelevementSite > 0.0 && dRejetSite > dPrelevementSite)
-											dRejetSite = dPrelevementSite;
+						pr.uiMasqueMois = 0;
+						for(mois=1; mois!=13; mois++)
+						{
+							if( (iMoisDebut <= iMoisFin && mois >= iMoisDebut && mois <= iMoisFin) || 
+								(iMoisDebut > iMoisFin && (mois >= iMoisDebut || mois <= iMoisFin)) )
+								pr.uiMasqueMois|= (1u << (mois - 1));
+						}
 
-										troncon->_prRejetTotal+= dRejetSite;
+						pr.dPrelevement = GetPrDbl(itSite->second, "PRELEV (L/J)");
+						pr.bReduction = bReduction;
 
-										oss.str("");
-										oss << "PR;" << itSite->first << ";" << ";" << setprecision(_sim_hyd.PrendreOutput()._nbDigit_m3s) << setiosflags(ios::fixed) << dRejetSite;
-										_tronconsRejetString[indexTroncon].push_back(oss.str());
-										_tronconsRejetVal[indexTroncon].push_back(dRejetSite);
-									}
-								}
-							}
-						}
-						else
+						pr.bRejet = (TrimString(GetPrStr(itSite->second, "CRITERE_CONSOMMATION")) == "1");
+						pr.dCoefCons = pr.bRejet ? GetPrDbl(itSite->second, "COEF_CONS") : 0.0;
+
+						prTroncon.vPr.push_back(pr);
+					}
+					else
+					{
+						if(str1 == "1")
 						{
-							if(TrimString(GetPrStr(itSite->second, "SITE_CULTURES")) == "1")
+							const vector<int>& vCultures = _donnees_PR_CULTURE[itSite->first];
+
+							for(i=0; i!=vCultures.size(); i++)	//pour chaque site de culture associ au site de prlevement
 							{
-								//si le TYPE du prlvement est activ
-								str1 = TrimString(GetPrStr(itSite->second, "TYPE"));
-								boost::algorithm::to_upper(str1);	//uppercase
-								if(_donneesTYPE.count(str1) == 0 || _donneesTYPE[str1] == 1)
-								{
-									for(i=0; i!=_donnees_PR_CULTURE[itSite->first].size(); i++)	//pour chaque site de culture associ au site de prlevement
-									{
-										//verifie si c'est un jour d'irrigation pour le uhrh du site de culture en cours
-										dVal1 = GetCuDbl(_donneesCULTURESite[_donnees_PR_CULTURE[itSite->first][i]], "IDUHRH");
-										idUhrh = static_cast<int>(dVal1);
-										j = zones._vIdentVersIndex[static_cast<size_t>(abs(idUhrh))];
-
-										if(zones[j]._prJourIrrigation)
-										{
-											dVal1 = GetCuDbl(_donneesCULTURESite[_donnees_PR_CULTURE[itSite->first][i]], "MAX_7_JOUR");
-											dVal2 = GetCuDbl(_donneesCULTURESite[_donnees_PR_CULTURE[itSite->first][i]], "SUP");
-
-											dPrelevementSite = dVal1 / 1000.0 * dVal2 / 7.0 / 86400.0;	//m3/s
-
-											if(dPrelevementSite > 0.0)
-											{
-												//coefficient de rduction
-												if(_donneesTYPE_redCoeff.size() != 0 && _donneesTYPE_redCoeff.count(str1) != 0 && _donneesTYPE_redCoeff[str1] == 1)
-													dPrelevementSite*= dCoeffApplicable;
-
-												troncon->_prPrelevementCulture+= dPrelevementSite;
-
-												oss.str("");
-												oss << "CULTURE;" << _donnees_PR_CULTURE[itSite->first][i] << ";" << itSite->first << ";" << setprecision(_sim_hyd.PrendreOutput()._nbDigit_m3s) << setiosflags(ios::fixed) << dPrelevementSite;
-												_tronconsPrelevementCultureString[indexTroncon].push_back(oss.str());
-												_tronconsPrelevementCultureVal[indexTroncon].push_back(dPrelevementSite);
-											}
-										}
-									}
-								}
+								PRELEVEMENT_CULTURE culture;
+
+								sLigne = _donneesCULTURESite[vCultures[i]];
+
+								oss.str("");
+								oss << "CULTURE;" << vCultures[i] << ";" << itSite->first << ";";
+								culture.sDescription = oss.str();
+
+								idUhrh = static_cast<int>(GetCuDbl(sLigne, "IDUHRH"));
+								culture.index_zone = zones._vIdentVersIndex[static_cast<size_t>(abs(idUhrh))];
+
+								culture.dMax7Jour = GetCuDbl(sLigne, "MAX_7_JOUR");
+								culture.dSuperficie = GetCuDbl(sLigne, "SUP");
+								culture.bReduction = bReduction;
+
+								prTroncon.vCulture.push_back(culture);
 							}
 						}
 					}
@@ -1868,76 +1767,332 @@ namespace HYDROTEL
 			itTroncon = _donneesELEVAGE.find(idTroncon);
 			if(itTroncon != _donneesELEVAGE.end())
 			{
-				//pour chaque site d'levage associ au troncon courant
 				for(itSite=itTroncon->second.begin(); itSite!=itTroncon->second.end(); itSite++)
-				{					
-					if(TrimString(GetElStr(itSite->second, "CRITERE")) == "1")
-					{
-						if(_donneesELEVAGE_PR.count(itSite->first) != 0)		//s'il y a un site de prlvement associ au site d'levage
-						{
-							//si le TYPE du prlvement est activ
-							sType = TrimString(GetPrStr(_donneesPRSite[_donneesELEVAGE_PR[itSite->first]], "TYPE"));
-							boost::algorithm::to_upper(sType);	//uppercase
-							if(_donneesTYPE.count(sType) == 0 || _donneesTYPE[sType] == 1)
-							{
-								str1 = TrimString(GetPrStr(_donneesPRSite[_donneesELEVAGE_PR[itSite->first]], "SOURCE"));
-								boost::algorithm::to_upper(str1);	//uppercase
+				{
+					if(TrimString(GetElStr(itSite->second, "CRITERE")) != "1" || _donneesELEVAGE_PR.count(itSite->first) == 0)
+						continue;
 
-								if(str1 == "SURFACE" && TrimString(GetPrStr(_donneesPRSite[_donneesELEVAGE_PR[itSite->first]], "SITE_GPE")) == "")
-								{
-									dVal1 = GetElDbl(itSite->second, "CONSOMMATION TOTAL M3/AN");
-									dPrelevementSite = dVal1 / iNbJourAnneeCourant / 86400.0;	//m3/s
+					sLigne = _donneesPRSite[_donneesELEVAGE_PR[itSite->first]];
 
-									if(dPrelevementSite > 0.0)
-									{
-										//coefficient de rduction
-										if(_donneesTYPE_redCoeff.size() != 0 && _donneesTYPE_redCoeff.count(sType) != 0 && _donneesTYPE_redCoeff[sType] == 1)
-											dPrelevementSite*= dCoeffApplicable;
+					sType = TrimString(GetPrStr(sLigne, "TYPE"));
+					boost::algorithm::to_upper(sType);	//uppercase
+					if(!TypeActif(sType))
+						continue;
 
-										troncon->_prPrelevementTotal+= dPrelevementSite;
+					str1 = TrimString(GetPrStr(sLigne, "SOURCE"));
+					boost::algorithm::to_upper(str1);	//uppercase
 
-										oss.str("");
-										oss << "ELEVAGE;" << itSite->first << ";" << _donneesELEVAGE_PR[itSite->first] << ";" << setprecision(_sim_hyd.PrendreOutput()._nbDigit_m3s) << setiosflags(ios::fixed) << dPrelevementSite;
-										_tronconsPrelevementString[indexTroncon].push_back(oss.str());
-										_tronconsPrelevementVal[indexTroncon].push_back(dPrelevementSite);
-									}
-								}
-							}
-						}
+					if(str1 == "SURFACE" && TrimString(GetPrStr(sLigne, "SITE_GPE")) == "")
+					{
+						PRELEVEMENT_ELEVAGE elevage;
+
+						oss.str("");
+						oss << "ELEVAGE;" << itSite->first << ";" << _donneesELEVAGE_PR[itSite->first] << ";";
+						elevage.sDescription = oss.str();
+
+						elevage.dConsommation = GetElDbl(itSite->second, "CONSOMMATION TOTAL M3/AN");
+						elevage.bReduction = Reduction(sType);
+
+						prTroncon.vElevage.push_back(elevage);
 					}
 				}
 			}
 
 			//Sites effluent
-			if(_donneesTYPE.count("EFFLUENT") == 0 || _donneesTYPE["EFFLUENT"] == 1)
+
+			if(TypeActif("EFFLUENT"))
 			{
 				itTroncon = _donneesEFFLUENT.find(idTroncon);
 				if(itTroncon != _donneesEFFLUENT.end())
 				{
-					//pour chaque site effluent associ au troncon courant
 					for(itSite=itTroncon->second.begin(); itSite!=itTroncon->second.end(); itSite++)
 					{
 						str1 = TrimString(GetEfStr(itSite->second, "SOURCE"));
 						boost::algorithm::to_upper(str1);	//uppercase
-					
+
 						if(str1 == "SURFACE" && TrimString(GetEfStr(itSite->second, "CRITERE")) == "1")
 						{
-							dVal1 = GetEfDbl(itSite->second, "EFFLUENT (L/J)");
-							dRejetSite = dVal1 / 1000.0 / 86400.0;	//m3/s
+							REJET_EFFLUENT effluent;
 
-							if(dRejetSite > 0.0)
-							{
-								troncon->_prRejetEffluent+= dRejetSite;
+							oss.str("");
+							oss << "EFFLUENT;" << itSite->first << ";" << ";";
+							effluent.sDescription = oss.str();
 
-								oss.str("");
-								oss << "EFFLUENT;" << itSite->first << ";" << ";" << setprecision(_sim_hyd.PrendreOutput()._nbDigit_m3s) << setiosflags(ios::fixed) << dRejetSite;
-								_tronconsRejetEffluentString[indexTroncon].push_back(oss.str());
-								_tronconsRejetEffluentVal[indexTroncon].push_back(dRejetSite);
-							}
+							effluent.dEffluent = GetEfDbl(itSite->second, "EFFLUENT (L/J)");
+
+							prTroncon.vEffluent.push_back(effluent);
+						}
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+
+
+	//----------------------------------------------------------------------------------------------------------------
+	//Calcule les prelevements et rejets  effectuer pour le pas de temps courant (pour tous les troncons)
+	//
+	//Si le fichier TypePrelevement.csv est prsent, le type doit tre  1 pour que le prlvement soit effectu.
+	//Si le type est absent du fichier (le fichier est prsent et contient d'autre type), le prlvement est effectu.
+	//
+	bool PRELEVEMENTS::CalculePrelevements()
+	{
+		TRACE_PERFORMANCE trace("PRELEVEMENTS::CalculePrelevements");
+
+		DATE_HEURE dt;
+		size_t index, i, indexTroncon, indexAnnee, indexMois;
+		ostringstream oss, ossDateStr;
+		double dNbJour, dVal1, dVal2, dPrelevementSite, dRejetSite, dCoeff, dCoeffApplicable;
+		bool OnProcede;
+		int moisCourant, anneeCourant, jourCourant, iNbJourAnneeCourant, iNbDigit;
+		unsigned int uiMasqueJour, uiMasqueMois;
+
+		vector<size_t> index_troncons = _sim_hyd.PrendreTronconsSimules();
+		TRONCONS& troncons = _sim_hyd.PrendreTroncons();
+		ZONES& zones = _sim_hyd.PrendreZones();
+		TRONCON* troncon;
+
+		try{
+		
+		dt = _sim_hyd.PrendreDateCourante();
+		jourCourant = dt.PrendreJour();
+		moisCourant = dt.PrendreMois();
+		anneeCourant = dt.PrendreAnnee();
+
+		dCoeffApplicable = 1.0;
+		if(_donneesTYPE_redCoeff.size() != 0)	//only if the reduction coefficient is enabled at least for one type
+		{
+			ossDateStr.str("");
+			ossDateStr << std::setfill('0') << std::setw(4) << anneeCourant << std::setw(2) << moisCourant << std::setw(2) << jourCourant;
+
+			if(_donneesREDCOEFF.count(ossDateStr.str()) != 0)
+				dCoeffApplicable-= _donneesREDCOEFF[ossDateStr.str()];
+		}
+
+		if(dt.Bissextile())
+			iNbJourAnneeCourant = 366;
+		else
+			iNbJourAnneeCourant = 365;
+
+		iNbDigit = _sim_hyd.PrendreOutput()._nbDigit_m3s;
+
+		indexAnnee = static_cast<size_t>(anneeCourant - _iAnneeDebut);	//les jours de prlvements gpe sont dtermins pour les annes de simulation seulement
+		indexMois = static_cast<size_t>(moisCourant - 1);
+		uiMasqueJour = 1u << (jourCourant - 1);
+		uiMasqueMois = 1u << (moisCourant - 1);
+
+		_tronconsPrelevementString.clear();
+		_tronconsPrelevementVal.clear();
+		_tronconsPrelevementCultureString.clear();
+		_tronconsPrelevementCultureVal.clear();
+		_tronconsRejetString.clear();
+		_tronconsRejetVal.clear();
+		_tronconsRejetEffluentString.clear();
+		_tronconsRejetEffluentVal.clear();
+
+		//boucle sur les troncons simuls
+		for(index=0; index!=index_troncons.size(); index++)
+		{
+			indexTroncon = index_troncons[index];			
+			troncon = troncons[indexTroncon];
+
+			const PRELEVEMENTS_TRONCON& prTroncon = _prelevementsTroncon[index];
+
+			troncon->_prPrelevementTotal = 0.0;
+			troncon->_prPrelevementCulture = 0.0;
+			troncon->_prRejetTotal = 0.0;
+			troncon->_prRejetEffluent = 0.0;
+
+			//Sites GPE
+
+			for(i=0; i!=prTroncon.vGpe.size(); i++)
+			{
+				const PRELEVEMENT_GPE& gpe = prTroncon.vGpe[i];
+
+				if(anneeCourant < _iAnneeDebut || indexAnnee >= gpe.vAnnee.size())
+					continue;
+
+				const PRELEVEMENT_GPE_ANNEE& annee = gpe.vAnnee[indexAnnee];
+
+				//Verifie si c'est un jour de prelevement
+				//Les jours de prlvements ont t pralablement dtermins pour toute les annes de simulation (fonction LecturePrelevements)
+				//avec alatoire lorsque NbJ MX est < que le nb de jour du mois
+				OnProcede = annee.bSurface && (annee.uiMasqueJours[indexMois] & uiMasqueJour) != 0;
+
+				//si CRITERE du site PR correspondant gal 0 (dsactiv)
+				if(OnProcede && annee.bMoy && anneeCourant > gpe.iAnneeMax && gpe.bDesactiveAnneeMax)
+					OnProcede = false;
+
+				if(OnProcede)
+				{
+					dCoeff = gpe.bReduction ? dCoeffApplicable : 1.0;
+
+					//prelevement
+					dNbJour = annee.dNbJour[indexMois];
+					dVal1 = annee.dVol[indexMois];
+
+					dVal1*= dCoeff;		//coefficient de rduction (la valeur est  1 si non applicable)
+					
+					dPrelevementSite = dVal1 / dNbJour;	//l/jour
+					dPrelevementSite = dPrelevementSite / 1000.0 / 86400.0;	//m3/s
+
+					if(dPrelevementSite > 0.0)
+					{
+						troncon->_prPrelevementTotal+= dPrelevementSite;
+
+						oss.str("");
+						oss << gpe.sDescription << setprecision(iNbDigit) << setiosflags(ios::fixed) << dPrelevementSite;
+
+						_tronconsPrelevementString[indexTroncon].push_back(oss.str());
+						_tronconsPrelevementVal[indexTroncon].push_back(dPrelevementSite);
+					}
+
+					//rejet
+					if(gpe.bRejet)
+					{
+						dVal2 = annee.dCons[indexMois];
+						dVal2*= dCoeff;		//coefficient de rduction (la valeur est  1 si non applicable)
+
+						dRejetSite = (dVal1 - dVal2) / dNbJour;			//l/jour
+						dRejetSite = dRejetSite / 1000.0 / 86400.0;		//m3/s
+
+						if(dRejetSite > 0.0)
+						{
+							if(dPrelevementSite > 0.0 && dRejetSite > dPrelevementSite)
+								dRejetSite = dPrelevementSite;
+
+							troncon->_prRejetTotal+= dRejetSite;
+
+							oss.str("");
+							oss << gpe.sDescription << setprecision(iNbDigit) << setiosflags(ios::fixed) << dRejetSite;
+
+							_tronconsRejetString[indexTroncon].push_back(oss.str());
+							_tronconsRejetVal[indexTroncon].push_back(dRejetSite);
 						}
 					}
 				}
 			}
+
+			//Sites de prlvements (PR)
+
+			for(i=0; i!=prTroncon.vPr.size(); i++)
+			{
+				const PRELEVEMENT_PR& pr = prTroncon.vPr[i];
+
+				//si dans l'intervalle de temps (mois dbut et fin)
+				if((pr.uiMasqueMois & uiMasqueMois) == 0)
+					continue;
+
+				//prelevement
+				dVal1 = pr.dPrelevement;
+
+				//coefficient de rduction
+				if(pr.bReduction)
+					dVal1*= dCoeffApplicable;
+
+				dPrelevementSite = dVal1 / 1000.0 / 86400.0;	//m3/s
+
+				if(dPrelevementSite > 0.0)
+				{
+					troncon->_prPrelevementTotal+= dPrelevementSite;
+
+					oss.str("");
+					oss << pr.sDescription << setprecision(iNbDigit) << setiosflags(ios::fixed) << dPrelevementSite;
+					_tronconsPrelevementString[indexTroncon].push_back(oss.str());
+					_tronconsPrelevementVal[indexTroncon].push_back(dPrelevementSite);
+				}
+
+				//rejet
+				if(pr.bRejet)
+				{
+					dVal2 = pr.dCoefCons;
+					dRejetSite = (dVal1 - dVal1 * dVal2) / 1000.0 / 86400.0;		//m3/s
+				
+					if(dRejetSite > 0.0)
+					{
+						if(dPrelevementSite > 0.0 && dRejetSite > dPrelevementSite)
+							dRejetSite = dPrelevementSite;
+
+						troncon->_prRejetTotal+= dRejetSite;
+
+						oss.str("");
+						oss << pr.sDescription << setprecision(iNbDigit) << setiosflags(ios::fixed) << dRejetSite;
+						_tronconsRejetString[indexTroncon].push_back(oss.str());
+						_tronconsRejetVal[indexTroncon].push_back(dRejetSite);
+					}
+				}
+			}
+
+			//Sites de cultures (associs aux sites de prlvements)
+
+			for(i=0; i!=prTroncon.vCulture.size(); i++)
+			{
+				const PRELEVEMENT_CULTURE& culture = prTroncon.vCulture[i];
+
+				//verifie si c'est un jour d'irrigation pour le uhrh du site de culture
+				if(!zones[culture.index_zone]._prJourIrrigation)
+					continue;
+
+				dPrelevementSite = culture.dMax7Jour / 1000.0 * culture.dSuperficie / 7.0 / 86400.0;	//m3/s
+
+				if(dPrelevementSite > 0.0)
+				{
+					//coefficient de rduction
+					if(culture.bReduction)
+						dPrelevementSite*= dCoeffApplicable;
+
+					troncon->_prPrelevementCulture+= dPrelevementSite;
+
+					oss.str("");
+					oss << culture.sDescription << setprecision(iNbDigit) << setiosflags(ios::fixed) << dPrelevementSite;
+					_tronconsPrelevementCultureString[indexTroncon].push_back(oss.str());
+					_tronconsPrelevementCultureVal[indexTroncon].push_back(dPrelevementSite);
+				}
+			}
+
+			//Sites d'levages
+
+			for(i=0; i!=prTroncon.vElevage.size(); i++)
+			{
+				const PRELEVEMENT_ELEVAGE& elevage = prTroncon.vElevage[i];
+
+				dPrelevementSite = elevage.dConsommation / iNbJourAnneeCourant / 86400.0;	//m3/s
+
+				if(dPrelevementSite > 0.0)
+				{
+					//coefficient de rduction
+					if(elevage.bReduction)
+						dPrelevementSite*= dCoeffApplicable;
+
+					troncon->_prPrelevementTotal+= dPrelevementSite;
+
+					oss.str("");
+					oss << elevage.sDescription << setprecision(iNbDigit) << setiosflags(ios::fixed) << dPrelevementSite;
+					_tronconsPrelevementString[indexTroncon].push_back(oss.str());
+					_tronconsPrelevementVal[indexTroncon].push_back(dPrelevementSite);
+				}
+			}
+
+			//Sites effluent
+
+			for(i=0; i!=prTroncon.vEffluent.size(); i++)
+			{
+				const REJET_EFFLUENT& effluent = prTroncon.vEffluent[i];
+
+				dRejetSite = effluent.dEffluent / 1000.0 / 86400.0;	//m3/s
+
+				if(dRejetSite > 0.0)
+				{
+					troncon->_prRejetEffluent+= dRejetSite;
+
+					oss.str("");
+					oss << effluent.sDescription << setprecision(iNbDigit) << setiosflags(ios::fixed) << dRejetSite;
+					_tronconsRejetEffluentString[indexTroncon].push_back(oss.str());
+					_tronconsRejetEffluentVal[indexTroncon].push_back(dRejetSite);
+				}
+			}
 		}
 
 		}
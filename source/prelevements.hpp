@@ -30,6 +30,70 @@
 namespace HYDROTEL
 {
 
+	//donnees des sites compilees par troncon lors de la lecture (LecturePrelevements) pour le calcul a chaque pas de temps (CalculePrelevements)
+
+	struct PRELEVEMENT_GPE_ANNEE
+	{
+		bool					bSurface;			//SOURCE == SURFACE et CRITERE == 1
+		bool					bMoy;				//ligne MOY utilisee pour l'annee
+		unsigned int			uiMasqueJours[12];	//[mois - 1]: bit (jour - 1) actif si jour de prelevement
+		double					dNbJour[12];		//NBJ M
+		double					dVol[12];			//VOL M
+		double					dCons[12];			//CONS M
+	};
+
+	struct PRELEVEMENT_GPE
+	{
+		std::string								sDescription;			//GPE;#SITE GPE;#SITE PR;
+		bool									bReduction;				//coefficient de rduction applicable au type
+		bool									bRejet;					//CRITERE_CONSOMMATION du site pr == 1 (ou pas de site pr)
+		bool									bDesactiveAnneeMax;		//CRITERE du site pr == 0: pas de prelevement MOY apres la derniere annee du site
+		int										iAnneeMax;
+		std::vector<PRELEVEMENT_GPE_ANNEE>		vAnnee;					//[annee - annee debut simulation]
+	};
+
+	struct PRELEVEMENT_PR
+	{
+		std::string				sDescription;		//PR;#SITE;;
+		unsigned int			uiMasqueMois;		//bit (mois - 1) actif si mois de prelevement
+		double					dPrelevement;		//PRELEV (L/J)
+		double					dCoefCons;			//COEF_CONS
+		bool					bReduction;
+		bool					bRejet;				//CRITERE_CONSOMMATION == 1
+	};
+
+	struct PRELEVEMENT_CULTURE
+	{
+		std::string				sDescription;		//CULTURE;ID;#SITE PR;
+		size_t					index_zone;
+		double					dMax7Jour;			//MAX_7_JOUR
+		double					dSuperficie;		//SUP
+		bool					bReduction;
+	};
+
+	struct PRELEVEMENT_ELEVAGE
+	{
+		std::string				sDescription;		//ELEVAGE;#SITE;#SITE PR;
+		double					dConsommation;		//CONSOMMATION TOTAL M3/AN
+		bool					bReduction;
+	};
+
+	struct REJET_EFFLUENT
+	{
+		std::string				sDescription;		//EFFLUENT;#SITE;;
+		double					dEffluent;			//EFFLUENT (L/J)
+	};
+
+	struct PRELEVEMENTS_TRONCON
+	{
+		std::vector<PRELEVEMENT_GPE>			vGpe;
+		std::vector<PRELEVEMENT_PR>				vPr;
+		std::vector<PRELEVEMENT_CULTURE>		vCulture;
+		std::vector<PRELEVEMENT_ELEVAGE>		vElevage;
+		std::vector<REJET_EFFLUENT>				vEffluent;
+	};
+
+
 	class PRELEVEMENTS
 	{
 	public:
@@ -77,6 +141,9 @@ namespace HYDROTEL
 
 		std::map<int, std::vector<int>>															_donnees_PR_CULTURE;	//key: idPr, value: idCulture	//sites de cultures associs aux sites de prlvements
 
+		std::vector<PRELEVEMENTS_TRONCON>														_prelevementsTroncon;	//[index dans PrendreTronconsSimules()]	//sites compiles (CompilePrelevements)
+		int																						_iAnneeDebut;			//annee de debut de simulation (index de PRELEVEMENT_GPE::vAnnee)
+
 		
 		//pour validation
 		std::map<size_t, std::vector<std::string>>												_tronconsPrelevementString;			//key: indexTroncon, value: string descriptif du prelevement
@@ -113,6 +180,8 @@ namespace HYDROTEL
 
 		bool							LecturePrelevementsREDCOEFF();
 
+		bool							CompilePrelevements();	//compile les sites de chaque troncon simul pour CalculePrelevements (appel par LecturePrelevements)
+
 		bool							CalculePrelevements();	//calcule les prelevements et rejets  effectuer pour le pas de temps courant (pour tous les troncons)
 
 		double							GetGpeDbl(std::string sLine, std::string sColNameUpperCase);
@@ -21,6 +21,7 @@
 #include "rankinen.hpp"
 
 #include "erreur.hpp"
+#include "etat_binaire.hpp"
 #include "util.hpp"
 #include "version.hpp"
 
@@ -638,6 +639,44 @@ namespace HYDROTEL
 	
 	void RANKINEN::LectureEtat(DATE_HEURE date_courante)
 	{
+		TRACE_PERFORMANCE trace("RANKINEN::LectureEtat");
+
+		if(ETAT_BINAIRE::EstBinaire(_nom_fichier_lecture_etat))
+		{
+			ETAT_BINAIRE etat;
+			etat.Lecture(_nom_fichier_lecture_etat, 2);	//2 intervalles minimum
+
+			vector<size_t> index_ligne = etat.AssocieIndex(_sim_hyd.PrendreZones(), _sim_hyd.PrendreZonesSimules(), "TEMPERATURE DU SOL; fichier etat RANKINEN");
+
+			for(size_t ligne=0; ligne<index_ligne.size(); ligne++)
+			{
+				const size_t index_zone = index_ligne[ligne];
+
+				if(index_zone != string::npos)
+				{
+					const double* valeurs = etat.PrendreLigne(ligne);
+					vector<float>& temperature = _mapTemperature[index_zone];
+
+					//les colonnes au-dela du nb de profils du uhrh valent -999
+					size_t nbValeur = etat.PrendreNbColonne();
+					while(nbValeur > 0 && valeurs[nbValeur-1] == -999.0)
+						--nbValeur;
+
+					if(nbValeur != temperature.size())
+					{
+						ostringstream oss;
+						oss << "TEMPERATURE DU SOL; fichier etat RANKINEN; " + _nom_fichier_lecture_etat + "; nombre de valeur invalide; selon les parametres actuels, il devrait y avoir "  << temperature.size() << " profils de temperature.";
+						throw ERREUR_LECTURE_FICHIER(oss.str());
+					}
+
+					for(size_t index2=0; index2<nbValeur; index2++)
+						temperature[index2] = static_cast<float>(valeurs[index2]);
+				}
+			}
+
+			return;
+		}
+
 		ifstream fichier(_nom_fichier_lecture_etat);
 		if (!fichier)
 			throw ERREUR_LECTURE_FICHIER("TEMPERATURE DU SOL; fichier etat RANKINEN; " + _nom_fichier_lecture_etat);
@@ -701,6 +740,8 @@ namespace HYDROTEL
 
 	void RANKINEN::SauvegardeEtat(DATE_HEURE date_courante) const
 	{
+		TRACE_PERFORMANCE trace("RANKINEN::SauvegardeEtat");
+
 		BOOST_ASSERT(_repertoire_ecriture_etat.size() != 0);
 
 		date_courante.AdditionHeure( _sim_hyd.PrendrePasDeTemps() );
@@ -722,7 +763,39 @@ namespace HYDROTEL
 			        << setw(2) << date_courante.PrendreMois() 
 			        << setw(2) << date_courante.PrendreJour() 
 			        << setw(2) << date_courante.PrendreHeure() 
-					<< ".csv";
+					<< _sim_hyd._output.ExtensionFichiersEtats();
+
+		if(_sim_hyd._output._bFichiersEtatsBinaire)
+		{
+			ZONES& zones = _sim_hyd.PrendreZones();
+			ETAT_BINAIRE etat;
+			vector<string> colonnes;
+
+			nbIntervalleMax = 0;
+			for(size_t index_zone : _sim_hyd.PrendreZonesSimules())
+				nbIntervalleMax = max(nbIntervalleMax, _mapTemperature.at(index_zone).size());
+
+			for(index2=0; index2<nbIntervalleMax; index2++)
+			{
+				oss.str("");
+				oss << "Temp. profil " << index2+1 << " (dC)";
+				colonnes.push_back(oss.str());
+			}
+
+			etat.Initialise(PrendreNomSousModele(), date_courante, colonnes, _sim_hyd.PrendreZonesSimules().size());
+
+			for(size_t index_zone : _sim_hyd.PrendreZonesSimules())
+			{
+				double* valeurs = etat.AjouteLigne(zones[index_zone].PrendreIdent());
+				const vector<float>& temperature = _mapTemperature.at(index_zone);
+
+				for(index2=0; index2<nbIntervalleMax; index2++)
+					valeurs[index2] = index2 < temperature.size() ? temperature[index2] : -999.0;
+			}
+
+			etat.Sauvegarde(nom_fichier.str());
+			return;
+		}
 
 		ofstream fichier(nom_fichier.str());
 		if (!fichier)
@@ -780,4 +853,31 @@ namespace HYDROTEL
 		fichier.close();
 	}
 
+
+	void RANKINEN::SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const
+	{
+		etat.Ecrit(_mapTemperature.size());
+
+		for(auto iter = _mapTemperature.begin(); iter != _mapTemperature.end(); ++iter)
+		{
+			etat.Ecrit(iter->first);
+			etat.Ecrit(iter->second);
+		}
+	}
+
+	void RANKINEN::LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur)
+	{
+		size_t nb, index, x;
+
+		lecteur.Lit(nb);
+		if(nb != _mapTemperature.size())
+			throw ERREUR("In-memory state: RANKINEN: number of zones does not match the simulation.");
+
+		for(x=0; x<nb; x++)
+		{
+			lecteur.Lit(index);
+			lecteur.Lit(_mapTemperature[index]);
+		}
+	}
+
 }
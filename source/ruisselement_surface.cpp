@@ -47,6 +47,17 @@ namespace HYDROTEL
 
 	RUISSELEMENT_SURFACE::~RUISSELEMENT_SURFACE()
 	{
+		//fichiers netcdf non fermes par Termine (exception); OUTPUT_NETCDF ecrit les pas de temps deja calcules
+		if(_netCdf_apport_lateral != NULL)
+			delete _netCdf_apport_lateral;
+		if(_netCdf_apport_lateral_uhrh != NULL)
+			delete _netCdf_apport_lateral_uhrh;
+		if(_netCdf_ecoulement_surf != NULL)
+			delete _netCdf_ecoulement_surf;
+		if(_netCdf_ecoulement_hypo != NULL)
+			delete _netCdf_ecoulement_hypo;
+		if(_netCdf_ecoulement_base != NULL)
+			delete _netCdf_ecoulement_base;
 	}
 
 
@@ -57,33 +68,24 @@ namespace HYDROTEL
 		if (_sim_hyd.PrendreOutput().SauvegardeApportLateral())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_apport_lateral = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._tronconOutputNb];
+				_netCdf_apport_lateral = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "apport_lateral.nc"), false, "apport_lateral", "m3/s", "Apport lateral");
 			else
 			{
 				string nom_fichier( Combine(_sim_hyd.PrendreRepertoireResultat(), "apport_lateral.csv") );
-				_fichier_apport_lateral.open(nom_fichier.c_str());
-				_fichier_apport_lateral << "Apport lateral (m3/s)" << _sim_hyd.PrendreOutput().Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\troncon" << _sim_hyd.PrendreOutput().Separator();
+				_fichier_apport_lateral.Ouvre(_sim_hyd.PrendreOutput(), nom_fichier, false, _sim_hyd.PrendreOutput()._nbDigit_m3s);
+				_fichier_apport_lateral.Entete() << "Apport lateral (m3/s)" << _sim_hyd.PrendreOutput().Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\troncon" << _sim_hyd.PrendreOutput().Separator();
 
 				TRONCONS& troncons = _sim_hyd.PrendreTroncons();
 
 				ostringstream oss;
 				oss.str("");
 			
-				for (size_t index = 0; index < troncons.PrendreNbTroncon(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreTronconsSimules()), end(_sim_hyd.PrendreTronconsSimules()), index) != end(_sim_hyd.PrendreTronconsSimules()))
-					{
-						if (_sim_hyd.PrendreOutput()._bSauvegardeTous || 
-							find(begin(_sim_hyd.PrendreOutput()._vIdTronconSelect), end(_sim_hyd.PrendreOutput()._vIdTronconSelect), troncons[index]->PrendreIdent()) != end(_sim_hyd.PrendreOutput()._vIdTronconSelect))
-						{
-							oss << troncons[index]->PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < _sim_hyd.PrendreOutput()._tronconOutputNb; ++n)
+					oss << troncons[_sim_hyd.PrendreOutput()._tronconOutputIndex[n]]->PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
 
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_apport_lateral << str << endl;
+				_fichier_apport_lateral.Entete() << str << endl;
 			}
 		}
 
@@ -92,31 +94,22 @@ namespace HYDROTEL
 			ZONES& zones = _sim_hyd.PrendreZones();
 
 			if (_sim_hyd._outputCDF)
-				_netCdf_ecoulement_surf = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_ecoulement_surf = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "ecoulement_surf.nc"), true, "ecoulement_surf", "m3/s", "Ecoulement vers le reseau hydrographique (couche 1) (surface)");
 			else
 			{
 				string nom_fichier_surf( Combine(_sim_hyd.PrendreRepertoireResultat(), "ecoulement_surf.csv") );
-				_fichier_ecoulement_surf.open(nom_fichier_surf.c_str());
-				_fichier_ecoulement_surf << "coulement vers le rseau hydrographique (couche 1) (surface) (m3/s)" << _sim_hyd.PrendreOutput().Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
+				_fichier_ecoulement_surf.Ouvre(_sim_hyd.PrendreOutput(), nom_fichier_surf, true, _sim_hyd.PrendreOutput()._nbDigit_m3s);
+				_fichier_ecoulement_surf.Entete() << "coulement vers le rseau hydrographique (couche 1) (surface) (m3/s)" << _sim_hyd.PrendreOutput().Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
 
 				ostringstream oss;
 				oss.str("");
 			
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (_sim_hyd.PrendreOutput()._bSauvegardeTous || 
-							find(begin(_sim_hyd.PrendreOutput()._vIdTronconSelect), end(_sim_hyd.PrendreOutput()._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(_sim_hyd.PrendreOutput()._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < _sim_hyd.PrendreOutput()._uhrhOutputNb; ++n)
+					oss << zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[n]].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
 			
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_ecoulement_surf << str << endl;
+				_fichier_ecoulement_surf.Entete() << str << endl;
 			}
 		}
 
@@ -125,31 +118,22 @@ namespace HYDROTEL
 			ZONES& zones = _sim_hyd.PrendreZones();
 
 			if (_sim_hyd._outputCDF)
-				_netCdf_ecoulement_hypo = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_ecoulement_hypo = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "ecoulement_hypo.nc"), true, "ecoulement_hypo", "m3/s", "Ecoulement vers le reseau hydrographique (couche 2) (hypodermique)");
 			else
 			{
 				string nom_fichier_hypo( Combine(_sim_hyd.PrendreRepertoireResultat(), "ecoulement_hypo.csv") );
-				_fichier_ecoulement_hypo.open(nom_fichier_hypo.c_str());
-				_fichier_ecoulement_hypo << "coulement vers le rseau hydrographique (couche 2) (hypodermique) (m3/s)" << _sim_hyd.PrendreOutput().Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
+				_fichier_ecoulement_hypo.Ouvre(_sim_hyd.PrendreOutput(), nom_fichier_hypo, true, _sim_hyd.PrendreOutput()._nbDigit_m3s);
+				_fichier_ecoulement_hypo.Entete() << "coulement vers le rseau hydrographique (couche 2) (hypodermique) (m3/s)" << _sim_hyd.PrendreOutput().Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
 
 				ostringstream oss;
 				oss.str("");
 
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (_sim_hyd.PrendreOutput()._bSauvegardeTous || 
-							find(begin(_sim_hyd.PrendreOutput()._vIdTronconSelect), end(_sim_hyd.PrendreOutput()._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(_sim_hyd.PrendreOutput()._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < _sim_hyd.PrendreOutput()._uhrhOutputNb; ++n)
+					oss << zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[n]].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
 
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_ecoulement_hypo << str << endl;
+				_fichier_ecoulement_hypo.Entete() << str << endl;
 			}
 		}
 
@@ -158,31 +142,22 @@ namespace HYDROTEL
 			ZONES& zones = _sim_hyd.PrendreZones();
 
 			if (_sim_hyd._outputCDF)
-				_netCdf_ecoulement_base = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_ecoulement_base = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "ecoulement_base.nc"), true, "ecoulement_base", "m3/s", "Ecoulement vers le reseau hydrographique (couche 3) (base)");
 			else
 			{
 				string nom_fichier_base( Combine(_sim_hyd.PrendreRepertoireResultat(), "ecoulement_base.csv") );
-				_fichier_ecoulement_base.open(nom_fichier_base.c_str());
-				_fichier_ecoulement_base << "coulement vers le rseau hydrographique (couche 3) (base) (m3/s)" << _sim_hyd.PrendreOutput().Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
+				_fichier_ecoulement_base.Ouvre(_sim_hyd.PrendreOutput(), nom_fichier_base, true, _sim_hyd.PrendreOutput()._nbDigit_m3s);
+				_fichier_ecoulement_base.Entete() << "coulement vers le rseau hydrographique (couche 3) (base) (m3/s)" << _sim_hyd.PrendreOutput().Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
 
 				ostringstream oss;
 				oss.str("");
 
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (_sim_hyd.PrendreOutput()._bSauvegardeTous || 
-							find(begin(_sim_hyd.PrendreOutput()._vIdTronconSelect), end(_sim_hyd.PrendreOutput()._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(_sim_hyd.PrendreOutput()._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < _sim_hyd.PrendreOutput()._uhrhOutputNb; ++n)
+					oss << zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[n]].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
 
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_ecoulement_base << str << endl;
+				_fichier_ecoulement_base.Entete() << str << endl;
 			}
 		}
 
@@ -191,31 +166,22 @@ namespace HYDROTEL
 			ZONES& zones = _sim_hyd.PrendreZones();
 
 			if (_sim_hyd._outputCDF)
-				_netCdf_apport_lateral_uhrh = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_apport_lateral_uhrh = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "apport_lateral_uhrh.nc"), true, "apport_lateral_uhrh", "m3/s", "Apport lateral au troncon");
 			else
 			{
 				str = Combine(_sim_hyd.PrendreRepertoireResultat(), "apport_lateral_uhrh.csv");
-				_fichier_apport_lateral_uhrh.open(str.c_str());
-				_fichier_apport_lateral_uhrh << "Apport lateral au troncon (m3/s)" << _sim_hyd.PrendreOutput().Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
+				_fichier_apport_lateral_uhrh.Ouvre(_sim_hyd.PrendreOutput(), str, true, _sim_hyd.PrendreOutput()._nbDigit_m3s);
+				_fichier_apport_lateral_uhrh.Entete() << "Apport lateral au troncon (m3/s)" << _sim_hyd.PrendreOutput().Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << _sim_hyd.PrendreOutput().Separator();
 
 				ostringstream oss;
 				oss.str("");
 
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (_sim_hyd.PrendreOutput()._bSauvegardeTous || 
-							find(begin(_sim_hyd.PrendreOutput()._vIdTronconSelect), end(_sim_hyd.PrendreOutput()._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(_sim_hyd.PrendreOutput()._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < _sim_hyd.PrendreOutput()._uhrhOutputNb; ++n)
+					oss << zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[n]].PrendreIdent() << _sim_hyd.PrendreOutput().Separator();
 
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_apport_lateral_uhrh << str << endl;
+				_fichier_apport_lateral_uhrh.Entete() << str << endl;
 			}
 		}
 	}
@@ -223,8 +189,8 @@ namespace HYDROTEL
 
 	void RUISSELEMENT_SURFACE::Calcule()
 	{
-		size_t i, idx;
-		string str;
+		size_t i;
+		float* pLigne;
 
 		if (_sim_hyd.PrendreOutput().SauvegardeApportLateral())
 		{
@@ -232,179 +198,99 @@ namespace HYDROTEL
 			{
 				TRONCONS& troncons = _sim_hyd.PrendreTroncons();
 
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._tronconOutputNb;
+				pLigne = _netCdf_apport_lateral->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for(i=0; i<_sim_hyd.PrendreOutput()._tronconOutputNb; i++)
-					_netCdf_apport_lateral[idx+i] = troncons[_sim_hyd.PrendreOutput()._tronconOutputIndex[i]]->PrendreApportLateral();
+					pLigne[i] = troncons[_sim_hyd.PrendreOutput()._tronconOutputIndex[i]]->PrendreApportLateral();
 			}
 			else
 			{
 				TRONCONS& troncons = _sim_hyd.PrendreTroncons();
 
-				ostringstream oss;
-				oss.str("");
-			
-				oss << _sim_hyd.PrendreDateCourante() << _sim_hyd.PrendreOutput().Separator() << setprecision(_sim_hyd.PrendreOutput()._nbDigit_m3s) << setiosflags(ios::fixed);
-
-				for (size_t index = 0; index < troncons.PrendreNbTroncon(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreTronconsSimules()), end(_sim_hyd.PrendreTronconsSimules()), index) != end(_sim_hyd.PrendreTronconsSimules()))
-					{
-						if (_sim_hyd.PrendreOutput()._bSauvegardeTous || 
-							find(begin(_sim_hyd.PrendreOutput()._vIdTronconSelect), end(_sim_hyd.PrendreOutput()._vIdTronconSelect), troncons[index]->PrendreIdent()) != end(_sim_hyd.PrendreOutput()._vIdTronconSelect))
-						{
-							oss << troncons[index]->PrendreApportLateral() << _sim_hyd.PrendreOutput().Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_apport_lateral << str << endl;
+				double* pValeur = _fichier_apport_lateral.Ligne(_sim_hyd.PrendreDateCourante());
+
+				for (size_t n = 0; n < _sim_hyd.PrendreOutput()._tronconOutputNb; ++n)
+					pValeur[n] = troncons[_sim_hyd.PrendreOutput()._tronconOutputIndex[n]]->PrendreApportLateral();
 			}
 		}
 
 		if (_sim_hyd.PrendreOutput()._ecoulement_surf)
 		{
-			ZONES& zones = _sim_hyd.PrendreZones();
+			const ETAT_ZONES& etat_zones = _sim_hyd.PrendreZones().PrendreEtat();
 
 			if (_netCdf_ecoulement_surf != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_ecoulement_surf->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_ecoulement_surf[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]]._ecoulementSurf;
+					pLigne[i] = etat_zones._ecoulement_surf[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]];
 			}
 			else
 			{
-				ostringstream oss;
-				oss.str("");
-
-				oss << _sim_hyd.PrendreDateCourante() << _sim_hyd.PrendreOutput().Separator() << setprecision(_sim_hyd.PrendreOutput()._nbDigit_m3s) << setiosflags(ios::fixed);
+				double* pValeur = _fichier_ecoulement_surf.Ligne(_sim_hyd.PrendreDateCourante());
 
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (_sim_hyd.PrendreOutput()._bSauvegardeTous || 
-							find(begin(_sim_hyd.PrendreOutput()._vIdTronconSelect), end(_sim_hyd.PrendreOutput()._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(_sim_hyd.PrendreOutput()._vIdTronconSelect))
-						{
-							oss << zones[index]._ecoulementSurf << _sim_hyd.PrendreOutput().Separator();
-						}
-					}
-				}
-
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_ecoulement_surf << str << endl;
+				for (size_t n = 0; n < _sim_hyd.PrendreOutput()._uhrhOutputNb; ++n)
+					pValeur[n] = etat_zones._ecoulement_surf[_sim_hyd.PrendreOutput()._uhrhOutputIndex[n]];
 			}
 		}
 
 		if (_sim_hyd.PrendreOutput()._ecoulement_hypo)
 		{
-			ZONES& zones = _sim_hyd.PrendreZones();
+			const ETAT_ZONES& etat_zones = _sim_hyd.PrendreZones().PrendreEtat();
 
 			if (_netCdf_ecoulement_hypo != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_ecoulement_hypo->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_ecoulement_hypo[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]]._ecoulementHypo;
+					pLigne[i] = etat_zones._ecoulement_hypo[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]];
 			}
 			else
 			{
-				ostringstream oss;
-				oss.str("");
+				double* pValeur = _fichier_ecoulement_hypo.Ligne(_sim_hyd.PrendreDateCourante());
 
-				oss << _sim_hyd.PrendreDateCourante() << _sim_hyd.PrendreOutput().Separator() << setprecision(_sim_hyd.PrendreOutput()._nbDigit_m3s) << setiosflags(ios::fixed);
-
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (_sim_hyd.PrendreOutput()._bSauvegardeTous || 
-							find(begin(_sim_hyd.PrendreOutput()._vIdTronconSelect), end(_sim_hyd.PrendreOutput()._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(_sim_hyd.PrendreOutput()._vIdTronconSelect))
-						{
-							oss << zones[index]._ecoulementHypo << _sim_hyd.PrendreOutput().Separator();
-						}
-					}
-				}
-
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_ecoulement_hypo << str << endl;
+				for (size_t n = 0; n < _sim_hyd.PrendreOutput()._uhrhOutputNb; ++n)
+					pValeur[n] = etat_zones._ecoulement_hypo[_sim_hyd.PrendreOutput()._uhrhOutputIndex[n]];
 			}
 		}
 
 		if (_sim_hyd.PrendreOutput()._ecoulement_base)
 		{
-			ZONES& zones = _sim_hyd.PrendreZones();
+			const ETAT_ZONES& etat_zones = _sim_hyd.PrendreZones().PrendreEtat();
 
 			if (_netCdf_ecoulement_base != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_ecoulement_base->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_ecoulement_base[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]]._ecoulementBase;
+					pLigne[i] = etat_zones._ecoulement_base[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]];
 			}
 			else
 			{
-				ostringstream oss;
-				oss.str("");
-
-				oss << _sim_hyd.PrendreDateCourante() << _sim_hyd.PrendreOutput().Separator() << setprecision(_sim_hyd.PrendreOutput()._nbDigit_m3s) << setiosflags(ios::fixed);
-
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (_sim_hyd.PrendreOutput()._bSauvegardeTous || 
-							find(begin(_sim_hyd.PrendreOutput()._vIdTronconSelect), end(_sim_hyd.PrendreOutput()._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(_sim_hyd.PrendreOutput()._vIdTronconSelect))
-						{
-							oss << zones[index]._ecoulementBase << _sim_hyd.PrendreOutput().Separator();
-						}
-					}
-				}
+				double* pValeur = _fichier_ecoulement_base.Ligne(_sim_hyd.PrendreDateCourante());
 
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_ecoulement_base << str << endl;
+				for (size_t n = 0; n < _sim_hyd.PrendreOutput()._uhrhOutputNb; ++n)
+					pValeur[n] = etat_zones._ecoulement_base[_sim_hyd.PrendreOutput()._uhrhOutputIndex[n]];
 			}
 		}
 
 		if (_sim_hyd.PrendreOutput()._apport_lateral_uhrh)
 		{
-			ZONES& zones = _sim_hyd.PrendreZones();
+			const ETAT_ZONES& etat_zones = _sim_hyd.PrendreZones().PrendreEtat();
 
 			if (_netCdf_apport_lateral_uhrh != NULL)
 			{
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_apport_lateral_uhrh->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_apport_lateral_uhrh[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]]._apport_lateral_uhrh;
+					pLigne[i] = etat_zones._apport_lateral_uhrh[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]];
 			}
 			else
 			{
-				ostringstream oss;
-				oss.str("");
+				double* pValeur = _fichier_apport_lateral_uhrh.Ligne(_sim_hyd.PrendreDateCourante());
 
-				oss << _sim_hyd.PrendreDateCourante() << _sim_hyd.PrendreOutput().Separator() << setprecision(_sim_hyd.PrendreOutput()._nbDigit_m3s) << setiosflags(ios::fixed);
-
-				for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (_sim_hyd.PrendreOutput()._bSauvegardeTous || 
-							find(begin(_sim_hyd.PrendreOutput()._vIdTronconSelect), end(_sim_hyd.PrendreOutput()._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(_sim_hyd.PrendreOutput()._vIdTronconSelect))
-						{
-							oss << zones[index]._apport_lateral_uhrh << _sim_hyd.PrendreOutput().Separator();
-						}
-					}
-				}
-
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_apport_lateral_uhrh << str << endl;
+				for (size_t n = 0; n < _sim_hyd.PrendreOutput()._uhrhOutputNb; ++n)
+					pValeur[n] = etat_zones._apport_lateral_uhrh[_sim_hyd.PrendreOutput()._uhrhOutputIndex[n]];
 			}
 		}
 	}
@@ -416,93 +302,85 @@ namespace HYDROTEL
 		{
 			if (_netCdf_apport_lateral != NULL)
 			{
-				string str1, str2;
+				string str;
 
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "ruissellement-apport_lateral.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "apport_lateral.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, false, "ruissellement-apport_lateral", _netCdf_apport_lateral, "m3/s", "Apport lateral");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, false, "apport_lateral", _netCdf_apport_lateral, "m3/s", "Apport lateral");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_apport_lateral->Ferme();
+				delete _netCdf_apport_lateral;
+				_netCdf_apport_lateral = NULL;
 
-				delete [] _netCdf_apport_lateral;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_apport_lateral.close();
+				_fichier_apport_lateral.Ferme();
 		}
 
 		if (_sim_hyd.PrendreOutput()._ecoulement_surf)
 		{
 			if (_netCdf_ecoulement_surf != NULL)
 			{
-				string str1, str2;
+				string str;
 
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "ruissellement-apport_lateral.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "ecoulement_surf.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, false, "ruissellement-apport_lateral", _netCdf_apport_lateral, "m3/s", "Apport lateral");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "ecoulement_surf", _netCdf_ecoulement_surf, "m3/s", "Ecoulement vers le reseau hydrographique (couche 1) (surface)");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_ecoulement_surf->Ferme();
+				delete _netCdf_ecoulement_surf;
+				_netCdf_ecoulement_surf = NULL;
 
-				delete [] _netCdf_ecoulement_surf;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_ecoulement_surf.close();
+				_fichier_ecoulement_surf.Ferme();
 		}
 
 		if (_sim_hyd.PrendreOutput()._ecoulement_hypo)
 		{
 			if (_netCdf_ecoulement_hypo != NULL)
 			{
-				string str1, str2;
+				string str;
 
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "ruissellement-apport_lateral.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "ecoulement_hypo.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, false, "ruissellement-apport_lateral", _netCdf_apport_lateral, "m3/s", "Apport lateral");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "ecoulement_hypo", _netCdf_ecoulement_hypo, "m3/s", "Ecoulement vers le reseau hydrographique (couche 2) (hypodermique)");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_ecoulement_hypo->Ferme();
+				delete _netCdf_ecoulement_hypo;
+				_netCdf_ecoulement_hypo = NULL;
 
-				delete [] _netCdf_ecoulement_hypo;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_ecoulement_hypo.close();
+				_fichier_ecoulement_hypo.Ferme();
 		}
 
 		if (_sim_hyd.PrendreOutput()._ecoulement_base)
 		{
 			if (_netCdf_ecoulement_base != NULL)
 			{
-				string str1, str2;
+				string str;
 
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "ruissellement-apport_lateral.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "ecoulement_base.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, false, "ruissellement-apport_lateral", _netCdf_apport_lateral, "m3/s", "Apport lateral");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "ecoulement_base", _netCdf_ecoulement_base, "m3/s", "Ecoulement vers le reseau hydrographique (couche 3) (base)");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_ecoulement_base->Ferme();
+				delete _netCdf_ecoulement_base;
+				_netCdf_ecoulement_base = NULL;
 
-				delete [] _netCdf_ecoulement_base;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_ecoulement_base.close();
+				_fichier_ecoulement_base.Ferme();
 		}
 
 		if (_sim_hyd.PrendreOutput()._apport_lateral_uhrh)
 		{
 			if (_netCdf_apport_lateral_uhrh != NULL)
 			{
-				string str1, str2;
+				string str;
 
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "apport_lateral_uhrh.nc");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "apport_lateral_uhrh", _netCdf_apport_lateral_uhrh, "m3/s", "Apport lateral au troncon");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_apport_lateral_uhrh->Ferme();
+				delete _netCdf_apport_lateral_uhrh;
+				_netCdf_apport_lateral_uhrh = NULL;
 
-				delete [] _netCdf_apport_lateral_uhrh;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_apport_lateral_uhrh.close();
+				_fichier_apport_lateral_uhrh.Ferme();
 		}
 	}
 
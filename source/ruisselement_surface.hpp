@@ -23,6 +23,8 @@
 
 
 #include "sous_modele.hpp"
+#include "output_netcdf.hpp"
+#include "output_csv.hpp"
 
 #include <fstream>
 
@@ -46,21 +48,21 @@ namespace HYDROTEL
 
 		std::string			_nom_fichier_apport_lateral;
 
-		float*				_netCdf_apport_lateral;
-		float*				_netCdf_apport_lateral_uhrh;
+		OUTPUT_NETCDF*		_netCdf_apport_lateral;
+		OUTPUT_NETCDF*		_netCdf_apport_lateral_uhrh;
 
-		float*				_netCdf_ecoulement_surf;
-		float*				_netCdf_ecoulement_hypo;
-		float*				_netCdf_ecoulement_base;
+		OUTPUT_NETCDF*		_netCdf_ecoulement_surf;
+		OUTPUT_NETCDF*		_netCdf_ecoulement_hypo;
+		OUTPUT_NETCDF*		_netCdf_ecoulement_base;
 
 	private:
 
-		std::ofstream _fichier_apport_lateral;
-		std::ofstream _fichier_apport_lateral_uhrh;
+		OUTPUT_CSV _fichier_apport_lateral;
+		OUTPUT_CSV _fichier_apport_lateral_uhrh;
 
-		std::ofstream _fichier_ecoulement_surf;
-		std::ofstream _fichier_ecoulement_hypo;
-		std::ofstream _fichier_ecoulement_base;
+		OUTPUT_CSV _fichier_ecoulement_surf;
+		OUTPUT_CSV _fichier_ecoulement_hypo;
+		OUTPUT_CSV _fichier_ecoulement_base;
 	};
 
 }
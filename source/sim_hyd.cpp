@@ -22,6 +22,7 @@
 
 #include "mise_a_jour.hpp"
 #include "gdal_util.hpp"
+#include "output_csv.hpp"
 #include "lecture_interpolation_donnees.hpp"
 #include "thiessen1.hpp"
 #include "thiessen2.hpp"
@@ -57,9 +58,11 @@
 #include "version.hpp"
 #include "constantes.hpp"
 #include "station_hydro.hpp"
+#include "statistiques.hpp"
 
 #include <fstream>
 #include <regex>
+#include <omp.h>
 
 #include <boost/algorithm/string/case_conv.hpp>
 
@@ -159,6 +162,7 @@ namespace HYDROTEL
 		
 		_bAutoInverseTMinTMax = false;
 		_bStationInterpolation = true;
+		_lTailleBlocHdf5 = TAILLE_BLOC_HDF5;
 		_bSkipCharacterValidation = false;
 		_bLogPerf = false;
 
@@ -174,11 +178,15 @@ namespace HYDROTEL
 		_sFolderNamePrelevements = "prelevements";
 		_sFolderNamePrelevementsSrc = "SitesPrelevements";
 		_pr = new PRELEVEMENTS(*this);
+		_statistiques = nullptr;
 	}
 
 
 	SIM_HYD::~SIM_HYD()
 	{
+		if(_statistiques)
+			delete _statistiques;
+
 		if(_vOutputIndexZone != nullptr)
 			delete [] _vOutputIndexZone;
 
@@ -265,6 +273,8 @@ namespace HYDROTEL
 
 	void SIM_HYD::Lecture(bool bDisplayInfo)
 	{
+		TRACE_PERFORMANCE trace("SIM_HYD::Lecture");
+
 		vector<string> fileList;
 		ostringstream oss;
 		ofstream file;
@@ -1009,6 +1019,7 @@ namespace HYDROTEL
 	{
 		_stations_meteo._bAutoInverseTMinTMax = _bAutoInverseTMinTMax;
 		_stations_meteo._bStationInterpolation = _bStationInterpolation;
+		_stations_meteo._lTailleBlocHdf5 = _lTailleBlocHdf5;
 		_stations_meteo._pSimHyd = this;
 
 		_stations_meteo.Lecture(_zones.PrendreProjection());
@@ -1165,6 +1176,16 @@ namespace HYDROTEL
 		return _pas_de_temps; 
 	}
 
+	int SIM_HYD::PrendreNbThread() const
+	{
+		int maxThread = omp_get_max_threads();
+
+		if(_nbThread == 0 || _nbThread > maxThread)
+			return maxThread;
+
+		return _nbThread;
+	}
+
 	DATE_HEURE SIM_HYD::PrendreDateCourante() const
 	{
 		return _date_courante;
@@ -2750,6 +2771,8 @@ namespace HYDROTEL
 
 	void SIM_HYD::Initialise()	
 	{
+		TRACE_PERFORMANCE trace("SIM_HYD::Initialise");
+
 		std::vector<size_t> vect;
 		size_t i, j, index, idx;
 		string str;
@@ -2928,66 +2951,70 @@ namespace HYDROTEL
 		else
 			_bRayonnementNet = false;
 
-		//initialization for NetCDF output
-		if (_outputCDF)
+		//index des uhrh/troncons sauvegardes (colonnes des fichiers de sortie csv et netcdf)
+		std::vector<int> vIdTronconSelect(_output._vIdTronconSelect);
+		std::sort(vIdTronconSelect.begin(), vIdTronconSelect.end());
+
+		//uhrh
+		_output._vUhrhOutput.assign(_zones.PrendreNbZone(), false);
+		for (auto iter = begin(_zones_simules); iter != end(_zones_simules); iter++)
 		{
-			//uhrh
-			if(_output._bOutputUhrhVar)
-			{
-				vect.clear();
+			if (_output._bSauvegardeTous || std::binary_search(vIdTronconSelect.begin(), vIdTronconSelect.end(), _zones[*iter].PrendreTronconAval()->PrendreIdent()))
+				_output._vUhrhOutput[*iter] = true;
+		}
 
-				i = 0;
-				for (index=0; index<_zones.PrendreNbZone(); index++)
-				{
-					if (find(begin(_zones_simules), end(_zones_simules), index) != end(_zones_simules))
-					{
-						if (_output._bSauvegardeTous || find(begin(_output._vIdTronconSelect), end(_output._vIdTronconSelect), _zones[index].PrendreTronconAval()->PrendreIdent()) != end(_output._vIdTronconSelect))
-						{
-							vect.push_back(index);
-							++i;
-						}
-					}
-				}
+		vect.clear();
+		for (index=0; index<_zones.PrendreNbZone(); index++)
+		{
+			if (_output._vUhrhOutput[index])
+				vect.push_back(index);
+		}
 
-				_output._uhrhOutputNb = vect.size();
-				_output._uhrhOutputIndex = new size_t[_output._uhrhOutputNb];
-				_output._uhrhOutputIDs = new int[_output._uhrhOutputNb];
+		if (_output._uhrhOutputIndex != NULL)
+		{
+			delete [] _output._uhrhOutputIndex;
+			delete [] _output._uhrhOutputIDs;
+		}
 
-				for (i=0; i<_output._uhrhOutputNb; i++)
-				{
-					_output._uhrhOutputIndex[i] = vect[i];
-					_output._uhrhOutputIDs[i] = _zones[_output._uhrhOutputIndex[i]].PrendreIdent();
-				}
-			}
+		_output._uhrhOutputNb = vect.size();
+		_output._uhrhOutputIndex = new size_t[_output._uhrhOutputNb];
+		_output._uhrhOutputIDs = new int[_output._uhrhOutputNb];
 
-			//troncon
-			if (_output._bOutputTronconVar)
-			{
-				vect.clear();
+		for (i=0; i<_output._uhrhOutputNb; i++)
+		{
+			_output._uhrhOutputIndex[i] = vect[i];
+			_output._uhrhOutputIDs[i] = _zones[_output._uhrhOutputIndex[i]].PrendreIdent();
+		}
 
-				i = 0;			
-				for (index=0; index<_troncons.PrendreNbTroncon(); index++)
-				{
-					if (find(begin(_troncons_simules), end(_troncons_simules), index) != end(_troncons_simules))
-					{
-						if (_output._bSauvegardeTous || find(begin(_output._vIdTronconSelect), end(_output._vIdTronconSelect), _troncons[index]->PrendreIdent()) != end(_output._vIdTronconSelect))
-						{
-							vect.push_back(index);
-							++i;
-						}
-					}
-				}
+		//troncon
+		_output._vTronconOutput.assign(_troncons.PrendreNbTroncon(), false);
+		for (auto iter = begin(_troncons_simules); iter != end(_troncons_simules); iter++)
+		{
+			if (_output._bSauvegardeTous || std::binary_search(vIdTronconSelect.begin(), vIdTronconSelect.end(), _troncons[*iter]->PrendreIdent()))
+				_output._vTronconOutput[*iter] = true;
+		}
 
-				_output._tronconOutputNb = vect.size();
-				_output._tronconOutputIndex = new size_t[_output._tronconOutputNb];
-				_output._tronconOutputIDs = new int[_output._tronconOutputNb];
+		vect.clear();
+		for (index=0; index<_troncons.PrendreNbTroncon(); index++)
+		{
+			if (_output._vTronconOutput[index])
+				vect.push_back(index);
+		}
 
-				for(i=0; i<_output._tronconOutputNb; i++)
-				{
-					_output._tronconOutputIndex[i] = vect[i];
-					_output._tronconOutputIDs[i] = _troncons[_output._tronconOutputIndex[i]]->PrendreIdent();
-				}
-			}
+		if (_output._tronconOutputIndex != NULL)
+		{
+			delete [] _output._tronconOutputIndex;
+			delete [] _output._tronconOutputIDs;
+		}
+
+		_output._tronconOutputNb = vect.size();
+		_output._tronconOutputIndex = new size_t[_output._tronconOutputNb];
+		_output._tronconOutputIDs = new int[_output._tronconOutputNb];
+
+		for(i=0; i<_output._tronconOutputNb; i++)
+		{
+			_output._tronconOutputIndex[i] = vect[i];
+			_output._tronconOutputIDs[i] = _troncons[_output._tronconOutputIndex[i]]->PrendreIdent();
 		}
 
 		if(_bLogPerf)
@@ -3113,6 +3140,24 @@ namespace HYDROTEL
 			if(_bLogPerf)
 				_logPerformance.EndStep(idx, boost::chrono::high_resolution_clock::now());
 		}
+
+		//statistiques cumulees pendant la simulation (csv et netcdf)
+		if(_statistiques)
+		{
+			delete _statistiques;
+			_statistiques = nullptr;
+		}
+
+		str = Combine(PrendreRepertoireSimulation(), "stats.txt");
+		if(_acheminement_riviere && FichierExiste(str))
+		{
+			_statistiques = new STATISTIQUES(*this, str);
+			_statistiques->Initialise();
+		}
+
+		//debit (throughput) du log de performance
+		_logPerformance._nbZone = _zones_simules.size();
+		_logPerformance._nbReach = _troncons_simules.size();
 	}
 
 
@@ -3127,6 +3172,13 @@ namespace HYDROTEL
 		boost::chrono::steady_clock::time_point t1;
 		boost::chrono::steady_clock::time_point t2;
 
+		_logPerformance._lTraceStep = _lPasTempsCourantIndex;
+
+		TRACE_PERFORMANCE trace("SIM_HYD::Calcule");
+
+		if(_bLogPerf)
+			++_logPerformance._nbStep;
+
 		// initialise les variables cumulant les resultats
 		for (index_troncon = 0; index_troncon < _troncons.PrendreNbTroncon(); ++index_troncon)
 		{
@@ -3140,6 +3192,8 @@ namespace HYDROTEL
 		//
 		if (_interpolation_donnees)
 		{
+			TRACE_PERFORMANCE trace_sm("INTERPOLATION_DONNEES::Calcule");
+
 			if(_bLogPerf)
 				t1 = boost::chrono::high_resolution_clock::now();
 
@@ -3161,6 +3215,8 @@ namespace HYDROTEL
 
 		if (_fonte_neige)
 		{
+			TRACE_PERFORMANCE trace_sm("FONTE_NEIGE::Calcule");
+
 			if(_bLogPerf)
 				t1 = boost::chrono::high_resolution_clock::now();
 
@@ -3176,6 +3232,8 @@ namespace HYDROTEL
 
 		if (_fonte_glacier)
 		{
+			TRACE_PERFORMANCE trace_sm("FONTE_GLACIER::Calcule");
+
 			if(_bLogPerf)
 				t1 = boost::chrono::high_resolution_clock::now();
 
@@ -3191,6 +3249,8 @@ namespace HYDROTEL
 
 		if (_tempsol)
 		{
+			TRACE_PERFORMANCE trace_sm("TEMPSOL::Calcule");
+
 			if(_bLogPerf)
 				t1 = boost::chrono::high_resolution_clock::now();
 
@@ -3206,6 +3266,8 @@ namespace HYDROTEL
 
 		if (_evapotranspiration)
 		{
+			TRACE_PERFORMANCE trace_sm("EVAPOTRANSPIRATION::Calcule");
+
 			if(_bLogPerf)
 				t1 = boost::chrono::high_resolution_clock::now();
 
@@ -3221,6 +3283,8 @@ namespace HYDROTEL
 
 		if (_bilan_vertical)
 		{
+			TRACE_PERFORMANCE trace_sm("BILAN_VERTICAL::Calcule");
+
 			if(_bLogPerf)
 				t1 = boost::chrono::high_resolution_clock::now();
 
@@ -3236,6 +3300,8 @@ namespace HYDROTEL
 
 		if (_ruisselement_surface)
 		{
+			TRACE_PERFORMANCE trace_sm("RUISSELEMENT_SURFACE::Calcule");
+
 			if(_bLogPerf)
 				t1 = boost::chrono::high_resolution_clock::now();
 
@@ -3251,6 +3317,8 @@ namespace HYDROTEL
 
 		if (_acheminement_riviere)
 		{
+			TRACE_PERFORMANCE trace_sm("ACHEMINEMENT_RIVIERE::Calcule");
+
 			if(_bLogPerf)
 				t1 = boost::chrono::high_resolution_clock::now();
 
@@ -3264,6 +3332,12 @@ namespace HYDROTEL
 			}
 		}
 
+		if(_statistiques)
+		{
+			TRACE_PERFORMANCE trace_sm("STATISTIQUES::Calcule");
+			_statistiques->Calcule();
+		}
+
 		if(_output._weighted_avg)
 		{
 			DEGRE_JOUR_GLACIER* ptr = NULL;
@@ -3361,6 +3435,12 @@ namespace HYDROTEL
 
 	void SIM_HYD::Termine()
 	{
+		_logPerformance._lTraceStep = string::npos;
+
+		TRACE_PERFORMANCE trace("SIM_HYD::Termine");
+
+		size_t idx;
+
 		if(PrendreOutput()._weighted_avg)
 		{
 			for(size_t i=0; i<_wavg_idtroncon.size(); i++)
@@ -3390,6 +3470,114 @@ namespace HYDROTEL
 
 		if (_acheminement_riviere)
 			_acheminement_riviere->Termine();
+
+		if(_statistiques)
+		{
+			if(_bLogPerf)
+				idx = _logPerformance.AddStep("Statistics", boost::chrono::high_resolution_clock::now());
+
+			_statistiques->Termine();
+
+			if(_bLogPerf)
+				_logPerformance.EndStep(idx, boost::chrono::high_resolution_clock::now());
+		}
+
+		if(_bLogPerf && _output._pEcrivainCsv != NULL)
+		{
+			ostringstream oss;
+
+			oss << "Output csv writer: " << _output._pEcrivainCsv->_lNbLigne << " lines, " 
+				<< _output._pEcrivainCsv->_lNbOctet << " bytes written, max queue depth " 
+				<< _output._pEcrivainCsv->_lNbBlocMax << " blocks";
+
+			_logPerformance.AddStep(oss.str());
+		}
+	}
+
+
+	void SIM_HYD::SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const
+	{
+		TRACE_PERFORMANCE trace("SIM_HYD::SauvegardeEtatMemoire");
+
+		const SOUS_MODELE* sous_modeles[] = { _interpolation_donnees, _fonte_neige, _fonte_glacier, _tempsol, _evapotranspiration, _bilan_vertical, _ruisselement_surface, _acheminement_riviere };
+		size_t i;
+
+		etat.Efface();
+		etat.ChangeDateHeure(_date_courante);
+
+		//entete: configuration de la simulation
+		etat.Ecrit(_zones.PrendreNbZone());
+		etat.Ecrit(_troncons.PrendreNbTroncon());
+		etat.Ecrit(_pas_de_temps);
+
+		for(i=0; i<8; i++)
+			etat.Ecrit(sous_modeles[i] ? sous_modeles[i]->PrendreNomSousModele() : string());
+
+		etat.Ecrit(_statistiques != nullptr);
+		etat.Ecrit(_lPasTempsCourantIndex);
+
+		//variables d'etat
+		_zones.SauvegardeEtatMemoire(etat);
+		_troncons.SauvegardeEtatMemoire(etat);
+
+		for(i=0; i<8; i++)
+		{
+			if(sous_modeles[i])
+				sous_modeles[i]->SauvegardeEtatMemoire(etat);
+		}
+
+		if(_statistiques)
+			_statistiques->SauvegardeEtatMemoire(etat);
+	}
+
+
+	void SIM_HYD::LectureEtatMemoire(const ETAT_MEMOIRE& etat)
+	{
+		TRACE_PERFORMANCE trace("SIM_HYD::LectureEtatMemoire");
+
+		SOUS_MODELE* sous_modeles[] = { _interpolation_donnees, _fonte_neige, _fonte_glacier, _tempsol, _evapotranspiration, _bilan_vertical, _ruisselement_surface, _acheminement_riviere };
+		LECTEUR_ETAT_MEMOIRE lecteur(etat);
+		size_t nb_zone, nb_troncon, i;
+		unsigned short pas_de_temps;
+		string nom;
+		bool bStatistiques;
+
+		lecteur.Lit(nb_zone);
+		lecteur.Lit(nb_troncon);
+		lecteur.Lit(pas_de_temps);
+
+		if(nb_zone != _zones.PrendreNbZone() || nb_troncon != _troncons.PrendreNbTroncon() || pas_de_temps != _pas_de_temps)
+			throw ERREUR("In-memory state: state does not match the simulation (number of zones, reaches or time step).");
+
+		for(i=0; i<8; i++)
+		{
+			lecteur.Lit(nom);
+			if(nom != (sous_modeles[i] ? sous_modeles[i]->PrendreNomSousModele() : string()))
+				throw ERREUR("In-memory state: state does not match the simulation submodels: " + nom);
+		}
+
+		lecteur.Lit(bStatistiques);
+		if(bStatistiques != (_statistiques != nullptr))
+			throw ERREUR("In-memory state: state does not match the simulation (statistics).");
+
+		lecteur.Lit(_lPasTempsCourantIndex);
+
+		_zones.LectureEtatMemoire(lecteur);
+		_troncons.LectureEtatMemoire(lecteur);
+
+		for(i=0; i<8; i++)
+		{
+			if(sous_modeles[i])
+				sous_modeles[i]->LectureEtatMemoire(lecteur);
+		}
+
+		if(_statistiques)
+			_statistiques->LectureEtatMemoire(lecteur);
+
+		if(!lecteur.Termine())
+			throw ERREUR("In-memory state: invalid or incompatible state (unread data).");
+
+		_date_courante = etat.PrendreDateHeure();
 	}
 
 
@@ -4036,11 +4224,14 @@ namespace HYDROTEL
 		if(_vOutputIndexZone != nullptr)
 			delete [] _vOutputIndexZone;
 		
+		vector<int> vIdTronconSelect(_output._vIdTronconSelect);
+		std::sort(vIdTronconSelect.begin(), vIdTronconSelect.end());
+
 		vector<size_t> indexOutput;
 		for (auto iter=begin(_zones_simules); iter!=end(_zones_simules); iter++)
 		{
 			if(_output._bSauvegardeTous || 
-				find(begin(_output._vIdTronconSelect), end(_output._vIdTronconSelect), _zones[*iter].PrendreTronconAval()->PrendreIdent()) != end(_output._vIdTronconSelect))
+				std::binary_search(vIdTronconSelect.begin(), vIdTronconSelect.end(), _zones[*iter].PrendreTronconAval()->PrendreIdent()))
 			{
 				indexOutput.push_back(*iter);
 			}
@@ -4083,6 +4274,25 @@ namespace HYDROTEL
 		return _corrections;
 	}
 
+	SOUS_MODELE* SIM_HYD::RechercheSousModele(const string& nom_sous_modele)
+	{
+		SOUS_MODELE* sous_modeles[] = { _interpolation_donnees, _fonte_neige, _fonte_glacier, _tempsol, _evapotranspiration, _bilan_vertical, _ruisselement_surface, _acheminement_riviere };
+		string nom = boost::algorithm::to_upper_copy(nom_sous_modele);
+
+		for(size_t i=0; i<8; i++)
+		{
+			if(sous_modeles[i] && (sous_modeles[i]->PrendreNomSousModele() == nom || sous_modeles[i]->PrendreNomSousModeleWithoutVersion() == nom))
+				return sous_modeles[i];
+		}
+
+		return nullptr;
+	}
+
+	STATISTIQUES* SIM_HYD::PrendreStatistiques()
+	{
+		return _statistiques;
+	}
+
 	GROUPE_ZONE* SIM_HYD::RechercheGroupeZone(const string& nom)
 	{
 		return _map_groupes_zone.find(nom) != end(_map_groupes_zone) ? _map_groupes_zone[nom] : nullptr;
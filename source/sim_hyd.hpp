@@ -52,6 +52,9 @@ namespace HYDROTEL
 	class RUISSELEMENT_SURFACE;
 	class ACHEMINEMENT_RIVIERE;
 	class PRELEVEMENTS;
+	class SOUS_MODELE;
+	class STATISTIQUES;
+	class ETAT_MEMOIRE;
 
 	class THIESSEN1;
 	class THIESSEN2;
@@ -199,6 +202,9 @@ namespace HYDROTEL
 		// retourne le pas de temps de simulation (h)
 		unsigned short PrendrePasDeTemps() const;
 
+		// retourne le nombre de thread a utiliser pour les calculs paralleles (option -t)
+		int PrendreNbThread() const;
+
 		// retourne la date du pas courant de simulation
 		DATE_HEURE PrendreDateCourante() const;
 
@@ -273,6 +279,12 @@ namespace HYDROTEL
 		// retourne la liste des corrections
 		CORRECTIONS& PrendreCorrections();
 
+		// retourne le sous modele courant portant ce nom (ex: BV3C1 ou BV3C), nullptr si absent
+		SOUS_MODELE* RechercheSousModele(const std::string& nom_sous_modele);
+
+		// retourne les statistiques debits simules/observes (stats.txt), nullptr si inactif
+		STATISTIQUES* PrendreStatistiques();
+
 		void Lecture(bool bDisplayInfo = true);
 
 		void SauvegardeSous(std::string repertoire);
@@ -287,6 +299,12 @@ namespace HYDROTEL
 
 		void Termine();
 
+		/// copie en memoire l'etat complet de la simulation (zones, troncons, sous-modeles) a la date courante
+		void SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const;
+
+		/// restaure un etat copie par SauvegardeEtatMemoire; la simulation reprend a la date de l'etat
+		void LectureEtatMemoire(const ETAT_MEMOIRE& etat);
+
 		void CreerNouveauProjet(std::string repertoire);
 
 		void DisplayInfo();
@@ -303,7 +321,7 @@ namespace HYDROTEL
 
 	public:
 
-		int									_nbThread;	//nb thread to use for hgm computation	//0=max available threads
+		int									_nbThread;	//nb thread to use for hgm computation and parallel submodels	//0=max available threads
 
 		std::string							_versionSimStr;
 		size_t								_versionSim;
@@ -356,6 +374,7 @@ namespace HYDROTEL
 
 		bool								_bAutoInverseTMinTMax;
 		bool								_bStationInterpolation;
+		size_t								_lTailleBlocHdf5;				//nb pas de temps par bloc de lecture des donnees meteo hdf5
 		
 		bool								_bSkipCharacterValidation;		//tell to skip validation of input files characters (only ASCII/UTF8 char code 32 to 126 are valid in input files)
 		std::vector<std::string>			_listErrMessCharValidation;
@@ -396,6 +415,8 @@ namespace HYDROTEL
 
 		PRELEVEMENTS*			_pr;
 
+		STATISTIQUES*			_statistiques;		//statistiques debits simules/observes (stats.txt), nullptr si inactif
+
 		// sous modeles
 		THIESSEN1*				_smThiessen1;
 		THIESSEN2*				_smThiessen2;
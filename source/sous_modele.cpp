@@ -53,6 +53,18 @@ namespace HYDROTEL
 		return str;
 	}
 
+	void SOUS_MODELE::InitialiseParametres()
+	{
+	}
+
+	void SOUS_MODELE::SauvegardeEtatMemoire(ETAT_MEMOIRE& /*etat*/) const
+	{
+	}
+
+	void SOUS_MODELE::LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& /*lecteur*/)
+	{
+	}
+
 	void SOUS_MODELE::ChangeNomFichierParametres(string nom_fichier_parametres)
 	{
 		_nom_fichier_parametres = nom_fichier_parametres;
@@ -23,6 +23,7 @@
 
 
 #include "sim_hyd.hpp"
+#include "etat_memoire.hpp"
 
 
 namespace HYDROTEL
@@ -46,6 +47,15 @@ namespace HYDROTEL
 
 		virtual void SauvegardeParametres() = 0;
 
+		/// recalcule les variables derivees des parametres, sans lecture de fichier ni etat (appele par Initialise et par la calibration)
+		virtual void InitialiseParametres();
+
+		/// copie les variables d'etat du sous-modele dans l'etat en memoire
+		virtual void SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const;
+
+		/// restaure les variables d'etat du sous-modele (meme ordre que SauvegardeEtatMemoire)
+		virtual void LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur);
+
 		std::string PrendreNomSousModele() const;								//include version number sufix (ex: BV3C1)
 
 		std::string PrendreNomSousModeleWithoutVersion() const;					//not including version number sufix (ex: BV3C)
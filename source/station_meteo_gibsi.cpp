@@ -24,9 +24,13 @@
 #include "erreur.hpp"
 #include "util.hpp"
 
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 
+#include <boost/filesystem.hpp>
+
 
 using namespace std;
 
@@ -34,6 +38,46 @@ using namespace std;
 namespace HYDROTEL
 {
 
+	namespace
+	{
+		const char			CACHE_SIGNATURE[8] = { 'H', 'Y', 'D', 'M', 'E', 'T', 'C', '1' };
+
+		//en-tete du fichier cache; la periode et les options de lecture doivent correspondre
+		struct ENTETE_CACHE
+		{
+			char			signature[8];
+			uint64_t		taille_source;		//octets
+			int64_t			date_source;		//date de modification (time_t)
+			uint16_t		debut[4];			//annee, mois, jour, heure
+			uint16_t		fin[4];
+			uint16_t		pas_de_temps;
+			uint16_t		inverse_tmin_tmax;
+			int32_t			version_thiessen;
+			uint64_t		nb_donnee;
+		};
+
+		void ChangeDate(uint16_t* pDate, const DATE_HEURE& date)
+		{
+			pDate[0] = date.PrendreAnnee();
+			pDate[1] = date.PrendreMois();
+			pDate[2] = date.PrendreJour();
+			pDate[3] = date.PrendreHeure();
+		}
+
+		bool PrendreInfoSource(const string& nom_fichier, uint64_t& taille, int64_t& date)
+		{
+			boost::system::error_code ec;
+
+			taille = static_cast<uint64_t>(boost::filesystem::file_size(nom_fichier, ec));
+			if (ec)
+				return false;
+
+			date = static_cast<int64_t>(boost::filesystem::last_write_time(nom_fichier, ec));
+			return !ec;
+		}
+	}
+
+
 	STATION_METEO_GIBSI::STATION_METEO_GIBSI(const string& nom_fichier, bool bAutoInverseTMinTMax)
 		: STATION_METEO(nom_fichier)
 		, _nb_donnee(0)
@@ -63,6 +107,9 @@ namespace HYDROTEL
 		//h2 = fin.PrendreHeure();
 		//-----TESTS-----
 
+		if (LectureCache(debut, fin, pas_de_temps))
+			return;
+
 		ifstream fichier(_nom_fichier);
 		if (!fichier)
 			throw ERREUR_LECTURE_FICHIER(_nom_fichier);
@@ -355,6 +402,108 @@ namespace HYDROTEL
 		_nb_donnee = _tmin.size();
 
 		_pas_de_temps = pas_de_temps;
+
+		SauvegardeCache(debut, fin, pas_de_temps);
+	}
+
+
+	bool STATION_METEO_GIBSI::LectureCache(const DATE_HEURE& debut, const DATE_HEURE& fin, unsigned short pas_de_temps)
+	{
+		ENTETE_CACHE entete, lu;
+
+		memset(&entete, 0, sizeof(entete));
+		memcpy(entete.signature, CACHE_SIGNATURE, sizeof(CACHE_SIGNATURE));
+
+		if (!PrendreInfoSource(_nom_fichier, entete.taille_source, entete.date_source))
+			return false;
+
+		ChangeDate(entete.debut, debut);
+		ChangeDate(entete.fin, fin);
+		entete.pas_de_temps = pas_de_temps;
+		entete.inverse_tmin_tmax = _bAutoInverseTMinTMax ? 1 : 0;
+		entete.version_thiessen = _iVersionThiessenMoy3Station;
+
+		ifstream fichier(_nom_fichier + ".cache", ios::binary);
+		if (!fichier)
+			return false;
+
+		memset(&lu, 0, sizeof(lu));
+		if (!fichier.read(reinterpret_cast<char*>(&lu), sizeof(lu)))
+			return false;
+
+		entete.nb_donnee = lu.nb_donnee;
+		if (memcmp(&entete, &lu, sizeof(entete)) != 0)
+			return false;
+
+		size_t nb = static_cast<size_t>(lu.nb_donnee);
+		streamsize taille = static_cast<streamsize>(nb * sizeof(float));
+
+		vector<float> tmin(nb), tmax(nb), pluie(nb), neige(nb);
+
+		if (nb != 0)
+		{
+			if (!fichier.read(reinterpret_cast<char*>(tmin.data()), taille) ||
+				!fichier.read(reinterpret_cast<char*>(tmax.data()), taille) ||
+				!fichier.read(reinterpret_cast<char*>(pluie.data()), taille) ||
+				!fichier.read(reinterpret_cast<char*>(neige.data()), taille))
+			{
+				return false;
+			}
+		}
+
+		_tmin.swap(tmin);
+		_tmax.swap(tmax);
+		_pluie.swap(pluie);
+		_neige.swap(neige);
+
+		_date_debut = debut;
+		_nb_donnee = nb;
+		_pas_de_temps = pas_de_temps;
+
+		return true;
+	}
+
+
+	void STATION_METEO_GIBSI::SauvegardeCache(const DATE_HEURE& debut, const DATE_HEURE& fin, unsigned short pas_de_temps)
+	{
+		ENTETE_CACHE entete;
+		string nom_fichier = _nom_fichier + ".cache";
+
+		memset(&entete, 0, sizeof(entete));
+		memcpy(entete.signature, CACHE_SIGNATURE, sizeof(CACHE_SIGNATURE));
+
+		if (!PrendreInfoSource(_nom_fichier, entete.taille_source, entete.date_source))
+			return;
+
+		ChangeDate(entete.debut, debut);
+		ChangeDate(entete.fin, fin);
+		entete.pas_de_temps = pas_de_temps;
+		entete.inverse_tmin_tmax = _bAutoInverseTMinTMax ? 1 : 0;
+		entete.version_thiessen = _iVersionThiessenMoy3Station;
+		entete.nb_donnee = _nb_donnee;
+
+		//le cache est optionnel; une erreur d'ecriture (ex: repertoire en lecture seule) est ignoree
+		ofstream fichier(nom_fichier, ios::binary | ios::trunc);
+		if (!fichier)
+			return;
+
+		streamsize taille = static_cast<streamsize>(_nb_donnee * sizeof(float));
+
+		fichier.write(reinterpret_cast<const char*>(&entete), sizeof(entete));
+		if (_nb_donnee != 0)
+		{
+			fichier.write(reinterpret_cast<const char*>(_tmin.data()), taille);
+			fichier.write(reinterpret_cast<const char*>(_tmax.data()), taille);
+			fichier.write(reinterpret_cast<const char*>(_pluie.data()), taille);
+			fichier.write(reinterpret_cast<const char*>(_neige.data()), taille);
+		}
+
+		fichier.close();
+		if (fichier.fail())
+		{
+			boost::system::error_code ec;
+			boost::filesystem::remove(nom_fichier, ec);
+		}
 	}
 
 
@@ -46,6 +46,10 @@ namespace HYDROTEL
 		bool				_bAutoInverseTMinTMax;
 
 	private:
+		//cache binaire des donnees lues (<fichier>.cache); valide selon la taille et la date de modification du fichier source
+		bool LectureCache(const DATE_HEURE& debut, const DATE_HEURE& fin, unsigned short pas_de_temps);
+		void SauvegardeCache(const DATE_HEURE& debut, const DATE_HEURE& fin, unsigned short pas_de_temps);
+
 		//std::vector<DONNEE_METEO> _donnees_meteo;
 
 		std::vector<float> _tmin;			// C
@@ -22,6 +22,7 @@
 
 #include "constantes.hpp"
 #include "erreur.hpp"
+#include "log-performance.hpp"
 
 #include <vector>
 
@@ -89,38 +90,85 @@ namespace HYDROTEL
 	{
 	}
 
-	float LectureDataset(int dataset, int memspace, int dataspace, size_t index, size_t time)
+	BLOC_HDF5::BLOC_HDF5(const string& nom_fichier, int dataset_tmin, int dataspace_tmin, int dataset_tmax, int dataspace_tmax, 
+		int dataset_pr, int dataspace_pr, size_t nb_station, size_t nb_donnees, size_t taille_bloc)
+		: _nom_fichier(nom_fichier)
+		, _dataset_tmin(dataset_tmin)
+		, _dataspace_tmin(dataspace_tmin)
+		, _dataset_tmax(dataset_tmax)
+		, _dataspace_tmax(dataspace_tmax)
+		, _dataset_pr(dataset_pr)
+		, _dataspace_pr(dataspace_pr)
+		, _nb_station(nb_station)
+		, _nb_donnees(nb_donnees)
+		, _taille_bloc(max(taille_bloc, static_cast<size_t>(1)))
+		, _debut(0)
+		, _nb(0)
 	{
-		static const hsize_t count[2] = { 1, 1 };
-		hsize_t offset[2] = { index, time };
-		float data_out;
+	}
+
+	void BLOC_HDF5::PrendreValeurs(size_t index, size_t time, float& tmin, float& tmax, float& pr)
+	{
+		if (time < _debut || time >= _debut + _nb)
+			LectureBloc(time);
+
+		size_t idx = index * _nb + (time - _debut);
+
+		tmin = _tmin[idx];
+		tmax = _tmax[idx];
+		pr = _pr[idx];
+	}
+
+	void BLOC_HDF5::LectureBloc(size_t time)
+	{
+		TRACE_PERFORMANCE trace("BLOC_HDF5::LectureBloc");
+
+		if (time >= _nb_donnees || _nb_station == 0)
+			throw ERREUR("LectureDataset: " + _nom_fichier + ": pas de temps hors du fichier");
+
+		_debut = time;
+		_nb = min(_taille_bloc, _nb_donnees - time);
+
+		hsize_t dimsm[2] = { _nb_station, _nb };
+		hid_t memspace = H5Screate_simple(2, dimsm, NULL);
+
+		_tmin.resize(_nb_station * _nb);
+		_tmax.resize(_nb_station * _nb);
+		_pr.resize(_nb_station * _nb);
+
+		try
+		{
+			LectureVariable(_dataset_tmin, _dataspace_tmin, memspace, _tmin);
+			LectureVariable(_dataset_tmax, _dataspace_tmax, memspace, _tmax);
+			LectureVariable(_dataset_pr, _dataspace_pr, memspace, _pr);
+		}
+		catch (...)
+		{
+			H5Sclose(memspace);
+			_nb = 0;
+			throw;
+		}
+
+		H5Sclose(memspace);
+	}
+
+	void BLOC_HDF5::LectureVariable(int dataset, int dataspace, hid_t memspace, vector<float>& valeurs)
+	{
+		hsize_t offset[2] = { 0, _debut };
+		hsize_t count[2] = { _nb_station, _nb };
 
 		int status = H5Sselect_hyperslab(dataspace, H5S_SELECT_SET, offset, NULL, count, NULL);
 		if (status < 0)
 			throw ERREUR("LectureDataset::H5Sselect_hyperslab");
 
-		status = H5Dread(dataset, H5T_NATIVE_FLOAT, memspace, dataspace, H5P_DEFAULT, &data_out);
+		status = H5Dread(dataset, H5T_NATIVE_FLOAT, memspace, dataspace, H5P_DEFAULT, &valeurs[0]);
 		if (status < 0)
 			throw ERREUR("LectureDataset::H5Dread");
-
-		return data_out;
 	}
 
-	void STATION_METEO_HDF5::ChangeInfoHDF5(int dataset_tmin, int dataspace_tmin, int memspace_tmin,
-		int dataset_tmax, int dataspace_tmax, int memspace_tmax,
-		int dataset_pr, int dataspace_pr, int memspace_pr)
+	void STATION_METEO_HDF5::ChangeBlocHDF5(shared_ptr<BLOC_HDF5> bloc)
 	{
-		_dataset_tmin = dataset_tmin;
-		_dataspace_tmin = dataspace_tmin;
-		_memspace_tmin = memspace_tmin;
-
-		_dataset_tmax = dataset_tmax;
-		_dataspace_tmax = dataspace_tmax;
-		_memspace_tmax = memspace_tmax;
-
-		_dataset_pr = dataset_pr;
-		_dataspace_pr = dataspace_pr;
-		_memspace_pr = memspace_pr;
+		_bloc = bloc;
 	}
 
 	void STATION_METEO_HDF5::LectureDonnees(const DATE_HEURE& /*debut*/, const DATE_HEURE& /*fin*/, unsigned short pas_de_temps)
@@ -150,9 +198,9 @@ namespace HYDROTEL
 
 		for (int n = 0; n < nb_pas; ++n)
 		{
-			float minl = LectureDataset(_dataset_tmin, _memspace_tmin, _dataspace_tmin, _index, index + n);
-			float maxl = LectureDataset(_dataset_tmax, _memspace_tmax, _dataspace_tmax, _index, index + n);			
-			float pr = LectureDataset(_dataset_pr, _memspace_pr, _dataspace_pr, _index, index + n);
+			float minl, maxl, pr;
+
+			_bloc->PrendreValeurs(_index, static_cast<size_t>(index + n), minl, maxl, pr);
 
 			if (n == 0)
 			{
@@ -26,10 +26,50 @@
 
 #include <hdf5.h>
 
+#include <memory>
+#include <vector>
+
 
 namespace HYDROTEL
 {
 
+	//donnees [station, temps] d'un bloc de pas de temps du fichier hdf5; partage par toutes les stations du fichier
+	//chaque bloc est lu avec une seule selection (hyperslab) et un seul H5Dread par variable
+	class BLOC_HDF5
+	{
+	public:
+		BLOC_HDF5(const std::string& nom_fichier, int dataset_tmin, int dataspace_tmin, int dataset_tmax, int dataspace_tmax, 
+			int dataset_pr, int dataspace_pr, size_t nb_station, size_t nb_donnees, size_t taille_bloc);
+
+		//retourne les valeurs de la station pour le pas de temps (index du fichier); lit le bloc au besoin
+		void PrendreValeurs(size_t index, size_t time, float& tmin, float& tmax, float& pr);
+
+	private:
+		void LectureBloc(size_t time);
+		void LectureVariable(int dataset, int dataspace, hid_t memspace, std::vector<float>& valeurs);
+
+		std::string _nom_fichier;
+
+		int _dataset_tmin;
+		int _dataspace_tmin;
+		int _dataset_tmax;
+		int _dataspace_tmax;
+		int _dataset_pr;
+		int _dataspace_pr;
+
+		size_t _nb_station;
+		size_t _nb_donnees;		//nb pas de temps du fichier
+		size_t _taille_bloc;	//nb pas de temps par bloc
+
+		size_t _debut;			//index du premier pas de temps du bloc en memoire
+		size_t _nb;				//nb pas de temps du bloc en memoire
+
+		std::vector<float> _tmin;	//[station * _nb + temps]
+		std::vector<float> _tmax;
+		std::vector<float> _pr;
+	};
+
+
 	class STATION_METEO_HDF5 : public STATION_METEO
 	{
 	public:
@@ -44,25 +84,12 @@ namespace HYDROTEL
 
 		virtual std::pair<float, float> PrendreTemperatureJournaliere(const DATE_HEURE& date_heure);
 
-		void ChangeInfoHDF5(
-			int dataset_tmin, int dataspace_tmin, int memspace_tmin,
-			int dataset_tmax, int dataspace_tmax, int memspace_tmax,
-			int dataset_pr, int dataspace_pr, int memspace_pr);
+		void ChangeBlocHDF5(std::shared_ptr<BLOC_HDF5> bloc);
 
 	private:
 		hid_t _hdid;
 
-        int _dataset_tmin;
-        int _dataspace_tmin;
-        int _memspace_tmin;
-
-        int _dataset_tmax;
-        int _dataspace_tmax;
-        int _memspace_tmax;
-
-        int _dataset_pr;
-        int _dataspace_pr;
-        int _memspace_pr;
+		std::shared_ptr<BLOC_HDF5> _bloc;
 
 		size_t _index;
 		DATE_HEURE _date_debut;
@@ -37,21 +37,6 @@ namespace HYDROTEL
 		_pStations = pStations;
 
 		_lIndexStation = lIndexStation;
-
-		_lIndexLat = 0;
-		_lIndexLon = 0;
-	}
-
-
-	STATION_METEO_NETCDF_STATION::STATION_METEO_NETCDF_STATION(const string& nom_fichier, STATIONS_METEO* pStations, size_t lIndexLat, size_t lIndexLon) 
-		: STATION_METEO(nom_fichier)
-	{
-		_pStations = pStations;
-		
-		_lIndexLat = lIndexLat;
-		_lIndexLon = lIndexLon;
-
-		_lIndexStation = 0;
 	}
 
 
@@ -83,18 +68,12 @@ namespace HYDROTEL
 		size_t idxTime, idx;
 		float fVal;
 
-		idx = 0;
 		idxTime = _pStations->_netCdf_dateDebutVecteur.NbHeureEntre(date_heure) / pas_de_temps;
-		
-		switch(_pStations->_netCdf_iType)
-		{
-		case 0:
-			idx = idxTime * _pStations->_netCdf_lNbStations + _lIndexStation;
-			break;
+		if (idxTime >= _pStations->_netCdf_lNbPasTemps)
+			throw ERREUR_LECTURE_FICHIER(_nom_fichier);
 
-		case 1:
-			idx = (idxTime * _pStations->_netCdf_lNbCoord) + (_lIndexLat * _pStations->_netCdf_lNbLong + _lIndexLon);
-		}
+		//serie de la station contigue: [station retenue*time]
+		idx = _lIndexStation * _pStations->_netCdf_lNbPasTemps + idxTime;
 		
 
 		//int nb_pas = pas_de_temps / _pas_de_temps;
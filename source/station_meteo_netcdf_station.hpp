@@ -34,8 +34,8 @@ namespace HYDROTEL
 	class STATION_METEO_NETCDF_STATION : public STATION_METEO
 	{
 	public:
+		//lIndexStation: index de la station (ou du point de grille) parmi les stations retenues de STATIONS_METEO
 		STATION_METEO_NETCDF_STATION(const std::string& nom_fichier, STATIONS_METEO* pStations, size_t lIndexStation);
-		STATION_METEO_NETCDF_STATION(const std::string& nom_fichier, STATIONS_METEO* pStations, size_t lIndexLat, size_t lIndexLon);
 
 		virtual ~STATION_METEO_NETCDF_STATION();
 
@@ -50,10 +50,7 @@ namespace HYDROTEL
 	private:
 		STATIONS_METEO* _pStations;
 
-		size_t			_lIndexStation;		//pour  type STATION (0)
-		
-		size_t			_lIndexLat;			//pour  type GRID (1)
-		size_t			_lIndexLon;			//
+		size_t			_lIndexStation;		//type STATION (0) et GRID (1)
 	};
 
 }
@@ -44,6 +44,15 @@ using namespace std;
 namespace HYDROTEL
 {
 
+	namespace
+	{
+		//retourne vrai si une des valeurs interpolees (tmin, tmax, pluie) est manquante
+		bool DonneeManquante(const DONNEE_METEO& donnee)
+		{
+			return donnee.PrendreTMin() <= VALEUR_MANQUANTE || donnee.PrendreTMax() <= VALEUR_MANQUANTE || donnee.PrendrePluie() <= VALEUR_MANQUANTE;
+		}
+	}
+
 	STATIONS_METEO::STATIONS_METEO()
 		: _bAutoInverseTMinTMax(false)
 		, _bStationInterpolation(true)
@@ -51,15 +60,17 @@ namespace HYDROTEL
 		, _dataset_tmin(-1)
 		, _dataspace_tmin(-1)
 		, _rank_tmin(-1)
-		, _memspace_tmin(-1)
 	{
 		_pSimHyd = nullptr;
 
+		_lTailleBlocHdf5 = TAILLE_BLOC_HDF5;
+
 		_netCdf_iType = -1;
 
 		_netCdf_lPasTemps = 0;
 		_netCdf_lNbPasTemps = 0;
 		_netCdf_lNbStations = 0;
+		_netCdf_lNbStationsRetenues = 0;
 			
 		_netCdf_dataStationPrecip = NULL;
 		_netCdf_dataStationTMin = NULL;
@@ -79,13 +90,6 @@ namespace HYDROTEL
 		}
 
 		/*
-        if (_memspace_tmin != -1)
-		{
-			herr_t status = H5Sclose(_memspace_tmin);
-			if (status < 0)
-				throw ERREUR_LECTURE_FICHIER(_nom_fichier);
-		}
-
         if (_dataspace_tmin != -1)
 		{
 			herr_t status = H5Sclose(_dataspace_tmin);
@@ -845,36 +849,9 @@ namespace HYDROTEL
 
 		_netCdf_lNbPasTemps = indexFin - indexDebut + 1;
 
-		//lit et conserve les donnees en ram		
-		size_t start[] = { indexDebut, 0 };	//row, col
-		size_t count[] = { _netCdf_lNbPasTemps, _netCdf_lNbStations };	//row, col
-
-		_netCdf_dataStationPrecip = new float[_netCdf_lNbPasTemps*_netCdf_lNbStations];
-		_netCdf_dataStationTMin = new float[_netCdf_lNbPasTemps*_netCdf_lNbStations];
-		_netCdf_dataStationTMax = new float[_netCdf_lNbPasTemps*_netCdf_lNbStations];
-
-		ret = nc_get_vara_float(iNcid, precipid, start, count, &_netCdf_dataStationPrecip[0]);
-		if (ret != NC_NOERR)
-		{
-			oss << ret;
-			throw ERREUR("Error reading NetCDF file: " + _nom_fichier + ": error reading precip data: error code " + oss.str() + ".");
-		}
-
-		ret = nc_get_vara_float(iNcid, tminid, start, count, &_netCdf_dataStationTMin[0]);
-		if (ret != NC_NOERR)
-		{
-			oss << ret;
-			throw ERREUR("Error reading NetCDF file: " + _nom_fichier + ": error reading tmin data: error code " + oss.str() + ".");
-		}
-
-		ret = nc_get_vara_float(iNcid, tmaxid, start, count, &_netCdf_dataStationTMax[0]);
-		if (ret != NC_NOERR)
-		{
-			oss << ret;
-			throw ERREUR("Error reading NetCDF file: " + _nom_fichier + ": error reading tmax data: error code " + oss.str() + ".");
-		}
-
 		//initialisation des objets station
+		vector<size_t> colonnes;
+
 		_stations.clear();
 
 		j = 0;
@@ -885,7 +862,7 @@ namespace HYDROTEL
 				(latitudes[i] <= _dExtentLimitNorth && latitudes[i] >= _dExtentLimitSouth &&
 				 longitudes[i] <= _dExtentLimitEast && longitudes[i] >= _dExtentLimitWest) )
 			{
-				shared_ptr<STATION> st = make_shared<STATION_METEO_NETCDF_STATION>(_nom_fichier, this, i);
+				shared_ptr<STATION> st = make_shared<STATION_METEO_NETCDF_STATION>(_nom_fichier, this, j);
 				if(_pSimHyd->PrendreNomInterpolationDonnees() == "THIESSEN1" || _pSimHyd->PrendreNomInterpolationDonnees() == "MOYENNE 3 STATIONS1")
 					st.get()->_iVersionThiessenMoy3Station = 1;
 
@@ -897,10 +874,14 @@ namespace HYDROTEL
 				st->ChangeCoordonnee(COORDONNEE(longitudes[i], latitudes[i], elevations[i]));
 
 				_stations.push_back(st);
+				colonnes.push_back(i);
 				++j;
 			}
 		}
 
+		//lit et conserve les donnees des stations retenues en ram
+		LectureNetCDFDonnees(iNcid, precipid, tminid, tmaxid, indexDebut, colonnes);
+
 		ret = nc_close(iNcid);
 		if (ret != NC_NOERR)
 		{
@@ -1221,36 +1202,9 @@ namespace HYDROTEL
 
 		_netCdf_lNbPasTemps = indexFin - indexDebut + 1;
 
-		//lit et conserve les donnees en ram
-		size_t start[] = { indexDebut, 0, 0 };	//depth, row, col	//time, y, x
-		size_t count[] = { _netCdf_lNbPasTemps, _netCdf_lNbLat, _netCdf_lNbLong };
-
-		_netCdf_dataStationPrecip = new float[_netCdf_lNbPasTemps*_netCdf_lNbCoord];
-		_netCdf_dataStationTMin = new float[_netCdf_lNbPasTemps*_netCdf_lNbCoord];
-		_netCdf_dataStationTMax = new float[_netCdf_lNbPasTemps*_netCdf_lNbCoord];
-
-		ret = nc_get_vara_float(iNcid, precipid, start, count, &_netCdf_dataStationPrecip[0]);
-		if (ret != NC_NOERR)
-		{
-			oss << ret;
-			throw ERREUR("Error reading NetCDF file: " + _nom_fichier + ": error reading precip data: error code " + oss.str() + ".");
-		}
-
-		ret = nc_get_vara_float(iNcid, tminid, start, count, &_netCdf_dataStationTMin[0]);
-		if (ret != NC_NOERR)
-		{
-			oss << ret;
-			throw ERREUR("Error reading NetCDF file: " + _nom_fichier + ": error reading tmin data: error code " + oss.str() + ".");
-		}
-
-		ret = nc_get_vara_float(iNcid, tmaxid, start, count, &_netCdf_dataStationTMax[0]);
-		if (ret != NC_NOERR)
-		{
-			oss << ret;
-			throw ERREUR("Error reading NetCDF file: " + _nom_fichier + ": error reading tmax data: error code " + oss.str() + ".");
-		}
-
 		//initialisation des objets station
+		vector<size_t> colonnes;
+
 		_stations.clear();
 
 		k = 0;
@@ -1263,7 +1217,7 @@ namespace HYDROTEL
 					(latitudes[i] <= _dExtentLimitNorth && latitudes[i] >= _dExtentLimitSouth &&
 						longitudes[j] <= _dExtentLimitEast && longitudes[j] >= _dExtentLimitWest) )
 				{
-					shared_ptr<STATION> st = make_shared<STATION_METEO_NETCDF_STATION>(_nom_fichier, this, i, j);
+					shared_ptr<STATION> st = make_shared<STATION_METEO_NETCDF_STATION>(_nom_fichier, this, k);
 					if(_pSimHyd->PrendreNomInterpolationDonnees() == "THIESSEN1" || _pSimHyd->PrendreNomInterpolationDonnees() == "MOYENNE 3 STATIONS1")
 						st.get()->_iVersionThiessenMoy3Station = 1;
 
@@ -1275,11 +1229,15 @@ namespace HYDROTEL
 					st->ChangeCoordonnee(COORDONNEE(longitudes[j], latitudes[i], elevations[i * _netCdf_lNbLong + j]));
 
 					_stations.push_back(st);
+					colonnes.push_back(i * _netCdf_lNbLong + j);
 					++k;
 				}
 			}
 		}
 
+		//lit et conserve les donnees des points de grille retenus en ram
+		LectureNetCDFDonnees(iNcid, precipid, tminid, tmaxid, indexDebut, colonnes);
+
 		ret = nc_close(iNcid);
 		if (ret != NC_NOERR)
 		{
@@ -1289,6 +1247,81 @@ namespace HYDROTEL
 	}
 
 
+	//------------------------------------------------------------------------------------------------
+	//Pour type == STATION et GRID
+	//les colonnes du fichier sont les stations (STATION) ou les points de grille y*x (GRID)
+
+	void STATIONS_METEO::LectureNetCDFDonnees(int iNcid, int precipid, int tminid, int tmaxid, size_t indexDebut, const vector<size_t>& colonnes)
+	{
+		const int varids[] = { precipid, tminid, tmaxid };
+		const string noms[] = { "precip", "tmin", "tmax" };
+		ostringstream oss;
+		size_t lNbColonne, lNbPasBloc, debut, nb, t, s;
+		int ret;
+
+		lNbColonne = (_netCdf_iType == 0) ? _netCdf_lNbStations : _netCdf_lNbCoord;
+		_netCdf_lNbStationsRetenues = colonnes.size();
+
+		if(_netCdf_dataStationPrecip != NULL)
+		{
+			delete [] _netCdf_dataStationPrecip;
+			delete [] _netCdf_dataStationTMin;
+			delete [] _netCdf_dataStationTMax;
+		}
+
+		_netCdf_dataStationPrecip = new float[_netCdf_lNbPasTemps*_netCdf_lNbStationsRetenues];
+		_netCdf_dataStationTMin = new float[_netCdf_lNbPasTemps*_netCdf_lNbStationsRetenues];
+		_netCdf_dataStationTMax = new float[_netCdf_lNbPasTemps*_netCdf_lNbStationsRetenues];
+
+		float* donnees[] = { _netCdf_dataStationPrecip, _netCdf_dataStationTMin, _netCdf_dataStationTMax };
+
+		if(_netCdf_lNbStationsRetenues == 0)
+			return;
+
+		//tampon [pas de temps du bloc * colonnes]; un appel nc_get_vara_float par variable et par bloc
+		lNbPasBloc = max(static_cast<size_t>(1), TAILLE_TAMPON_NETCDF / max(static_cast<size_t>(1), lNbColonne));
+		lNbPasBloc = min(lNbPasBloc, _netCdf_lNbPasTemps);
+
+		vector<float> tampon(lNbPasBloc * lNbColonne);
+
+		for(debut=0; debut<_netCdf_lNbPasTemps; debut+= lNbPasBloc)
+		{
+			nb = min(lNbPasBloc, _netCdf_lNbPasTemps - debut);
+
+			size_t start[] = { indexDebut + debut, 0, 0 };	//time, y, x
+			size_t count[] = { nb, 0, 0 };
+
+			if(_netCdf_iType == 0)
+				count[1] = _netCdf_lNbStations;
+			else
+			{
+				count[1] = _netCdf_lNbLat;
+				count[2] = _netCdf_lNbLong;
+			}
+
+			for(size_t v=0; v<3; v++)
+			{
+				ret = nc_get_vara_float(iNcid, varids[v], start, count, &tampon[0]);
+				if (ret != NC_NOERR)
+				{
+					oss << ret;
+					throw ERREUR("Error reading NetCDF file: " + _nom_fichier + ": error reading " + noms[v] + " data: error code " + oss.str() + ".");
+				}
+
+				//transpose vers [station retenue*time]
+				for(s=0; s<_netCdf_lNbStationsRetenues; s++)
+				{
+					float* serie = donnees[v] + s * _netCdf_lNbPasTemps + debut;
+					const float* src = &tampon[colonnes[s]];
+
+					for(t=0; t<nb; t++)
+						serie[t] = src[t * lNbColonne];
+				}
+			}
+		}
+	}
+
+
 	//ANCIENNES FONCTIONS
 
 	void STATIONS_METEO::LectureFormatHDF5()
@@ -1330,31 +1363,38 @@ namespace HYDROTEL
 
 		_projection = PROJECTIONS::LONGLAT_WGS84();
 
-        // NOTE: buffer pour les differents dataspace, memspace et dataset
+        // NOTE: dataspace et dataset partages par le bloc de lecture
 
-		hsize_t dimsm[2] = { 1, 1 };
+		_dataset_tmin = static_cast<int>(H5Dopen(_hdid, "meteo/tmin", H5P_DEFAULT));
+		_dataspace_tmin = static_cast<int>(H5Dget_space(_dataset_tmin));
 
-		{
-		    _dataset_tmin = static_cast<int>(H5Dopen(_hdid, "meteo/tmin", H5P_DEFAULT));
-		    _dataspace_tmin = static_cast<int>(H5Dget_space(_dataset_tmin));
-		    rank = H5Sget_simple_extent_ndims(_dataspace_tmin);	
-		    _memspace_tmin = static_cast<int>(H5Screate_simple(rank, dimsm, NULL));
-		}
+		_dataset_tmax = static_cast<int>(H5Dopen(_hdid, "meteo/tmax", H5P_DEFAULT));
+		_dataspace_tmax = static_cast<int>(H5Dget_space(_dataset_tmax));
 
-		{
-		    _dataset_tmax = static_cast<int>(H5Dopen(_hdid, "meteo/tmax", H5P_DEFAULT));
-		    _dataspace_tmax = static_cast<int>(H5Dget_space(_dataset_tmax));
-		    rank = H5Sget_simple_extent_ndims(_dataspace_tmax);	
-		    _memspace_tmax = static_cast<int>(H5Screate_simple(rank, dimsm, NULL));
-		}
+		_dataset_pr = static_cast<int>(H5Dopen(_hdid, "meteo/pr", H5P_DEFAULT));
+		_dataspace_pr = static_cast<int>(H5Dget_space(_dataset_pr));
+
+		//dimensions [station, temps]; validees pour chaque variable car le bloc de lecture utilise la meme selection pour les 3
+		dims_out.assign(2, 0);
 
+		for(int dataspace_var : { _dataspace_tmin, _dataspace_tmax, _dataspace_pr })
 		{
-		    _dataset_pr = static_cast<int>(H5Dopen(_hdid, "meteo/pr", H5P_DEFAULT));
-		    _dataspace_pr = static_cast<int>(H5Dget_space(_dataset_pr));
-		    rank = H5Sget_simple_extent_ndims(_dataspace_pr);	
-		    _memspace_pr = static_cast<int>(H5Screate_simple(rank, dimsm, NULL));
+			vector<hsize_t> dims_var(2);
+
+			rank = H5Sget_simple_extent_ndims(dataspace_var);
+			if (rank != 2)
+				throw ERREUR_LECTURE_FICHIER(_nom_fichier);
+
+			status_n = H5Sget_simple_extent_dims(dataspace_var, &dims_var[0], nullptr);
+			if (status_n < 0 || dims_var[0] != nb_station || (dims_out[1] != 0 && dims_var[1] != dims_out[1]))
+				throw ERREUR_LECTURE_FICHIER(_nom_fichier);
+
+			dims_out = dims_var;
 		}
 
+		_blocHdf5 = make_shared<BLOC_HDF5>(_nom_fichier, _dataset_tmin, _dataspace_tmin, _dataset_tmax, _dataspace_tmax, 
+			_dataset_pr, _dataspace_pr, nb_station, static_cast<size_t>(dims_out[1]), _lTailleBlocHdf5);
+
 
 		for (unsigned int index = 0; index < nb_station; ++index)
 		{
@@ -1369,10 +1409,7 @@ namespace HYDROTEL
 			station->ChangeIdent(ss.str());
 			station->ChangeCoordonnee(COORDONNEE(longitude[index], latitude[index], elevation[index]));
 
-			station->ChangeInfoHDF5(
-				_dataset_tmin, _dataspace_tmin, _memspace_tmin,
-				_dataset_tmax, _dataspace_tmax, _memspace_tmax,
-				_dataset_pr, _dataspace_pr, _memspace_pr);
+			station->ChangeBlocHDF5(_blocHdf5);
 
 			_stations[index] = station;
 		}
@@ -1642,13 +1679,14 @@ namespace HYDROTEL
 					station1 = *iter;
 					date_courante = debut;
 
+					//l'ordre des stations voisines depend seulement de la position des stations
+					distances = CalculDistance_v1(coordonnees_station, station1->_coordonneeCRSprojet);
+
 					while(date_courante < fin)
 					{
 						donnee1 = station1->PrendreDonnees(date_courante, pas_de_temps);
 
-						distances = CalculDistance_v1(coordonnees_station, station1->_coordonneeCRSprojet);
-				
-						for(index = 1; index < distances.size(); ++index)
+						for(index = 1; index < distances.size() && DonneeManquante(donnee1); ++index)
 						{
 							station2 = static_pointer_cast<STATION_METEO>(_stations[distances[index]]);
 							diff_alt = station1->PrendreCoordonnee().PrendreZ() - station2->PrendreCoordonnee().PrendreZ();
@@ -1789,6 +1827,9 @@ namespace HYDROTEL
 					//int mm = fin.PrendreMois();
 					//int dd = fin.PrendreJour();
 
+					//l'ordre des stations voisines depend seulement de la position des stations
+					distances = CalculDistance(coordonnees_station, station1->_coordonneeCRSprojet);
+
 					date_courante = debut;
 					while(date_courante != fin)
 					{
@@ -1799,9 +1840,9 @@ namespace HYDROTEL
 						//	yy=yy;
 
 						donnee1 = station1->PrendreDonnees(date_courante, pas_de_temps);
-						distances = CalculDistance(coordonnees_station, station1->_coordonneeCRSprojet);
-				
-						for(index=0; index!=distances.size(); index++)
+
+						//les stations voisines sont parcourues seulement tant qu'il reste une valeur manquante
+						for(index=0; index!=distances.size() && DonneeManquante(donnee1); index++)
 						{
 							if(distances[index] != idxLoop)
 							{
@@ -27,11 +27,14 @@
 
 #include <hdf5.h>
 
+#include <memory>
+
 
 namespace HYDROTEL
 {
 
 	class SIM_HYD;
+	class BLOC_HDF5;
 
 	class STATIONS_METEO : public STATIONS
 	{
@@ -52,6 +55,8 @@ namespace HYDROTEL
 
 		SIM_HYD*		_pSimHyd;
 
+		size_t			_lTailleBlocHdf5;			//nb pas de temps lus par bloc (format hdf5)
+
 		float			_fGradientStationTemp;		// C/100m	//gradient vertical pour interpolation des donnees manquante aux stations
 		float			_fGradientStationPrecip;	// mm/100m	//gradient vertical pour interpolation des donnees manquante aux stations
 
@@ -77,13 +82,11 @@ namespace HYDROTEL
 
 		DATE_HEURE		_netCdf_dateDebutVecteur;
 
-		float*			_netCdf_dataStationPrecip;	//STATION	[time*stations]	//size_t idxTime = _pStations->_pSimHyd->_date_debut.NbHeureEntre(date_heure) / pas_de_temps;
-		float*			_netCdf_dataStationTMin;	//			[time*stations]	//size_t idx = idxTime * _pStations->_netCdf_lNbStations + _lIndexStation;
-		float*			_netCdf_dataStationTMax;	//			[time*stations]
-													//
-													//GRID			[time*y*x]
-													//				[time*y*x]	//size_t idx = (idxTime * _pStations->_netCdf_lNbCoord) + (idxLat * _pStations->_netCdf_lNbLong + idxLong);
-													//				[time*y*x]
+		size_t			_netCdf_lNbStationsRetenues;	//stations (ou points de grille) dans l'extent
+
+		float*			_netCdf_dataStationPrecip;	//[station retenue*time]	//size_t idxTime = _netCdf_dateDebutVecteur.NbHeureEntre(date_heure) / pas_de_temps;
+		float*			_netCdf_dataStationTMin;	//[station retenue*time]	//size_t idx = _lIndexStation * _netCdf_lNbPasTemps + idxTime;
+		float*			_netCdf_dataStationTMax;	//[station retenue*time]	//la serie de chaque station est contigue
 
         //NetCDF	//OLD
 		//hdf5
@@ -95,17 +98,16 @@ namespace HYDROTEL
         int _dataset_tmin;
         int _dataspace_tmin;
         int _rank_tmin;
-        int _memspace_tmin;
 
         int _dataset_tmax;
         int _dataspace_tmax;
         int _rank_tmax;
-        int _memspace_tmax;
 
         int _dataset_pr;
         int _dataspace_pr;
         int _rank_pr;
-        int _memspace_pr;
+
+		std::shared_ptr<BLOC_HDF5> _blocHdf5;
 
 	private:	
 
@@ -125,6 +127,9 @@ namespace HYDROTEL
 		void		LectureFormatNetCDFTypeStation();
 		void		LectureFormatNetCDFTypeGrid();
 
+		//lit la periode simulee par blocs de pas de temps contigus [time*colonnes] et conserve seulement les colonnes retenues (stations dans l'extent)
+		void		LectureNetCDFDonnees(int iNcid, int precipid, int tminid, int tmaxid, size_t indexDebut, const std::vector<size_t>& colonnes);
+
 	};
 
 }
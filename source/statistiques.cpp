@@ -25,6 +25,7 @@
 #include "station_hydro.hpp"
 #include "util.hpp"
 
+#include <algorithm>
 #include <fstream>
 
 #include <boost/algorithm/string/case_conv.hpp>
@@ -40,8 +41,6 @@ namespace HYDROTEL
 		: _sim_hyd(&sim_hyd)
 		, _nom_fichier_parametres(nom_fichier_parametres)
 	{
-		LectureParametres();
-		LectureDonnees();
 	}
 
 	STATISTIQUES::~STATISTIQUES()
@@ -86,440 +85,285 @@ namespace HYDROTEL
 	}
 	
 
-	//creation du fichier stats.csv
-	void STATISTIQUES::LectureDonnees()
+	void STATISTIQUES::Initialise()
 	{
-		string path = Combine(_sim_hyd->PrendreRepertoireResultat(), "debit_aval.csv");
-		
 		DATE_HEURE date_debut = _sim_hyd->PrendreDateDebut();
 		DATE_HEURE date_fin = _sim_hyd->PrendreDateFin();
 		unsigned short pas_de_temps = _sim_hyd->PrendrePasDeTemps();
-		size_t nb_troncon;
-			
-		map<int, vector<pair<float, float>>> donnees;
+		vector<int>& troncons_simules = _sim_hyd->PrendreTronconsSimulesIdent();
+		TRONCONS& troncons = _sim_hyd->PrendreTroncons();
+		string tmp;
 
-		vector<size_t> vIDTroncon;
-		string sDate;
-
-		try
-		{
-			map<int, float> ecart2s;
-			map<int, float> nashs;
-			map<int, float> biais_relatif;
-			map<int, float> biais_absolue;
-			map<int, float> coefficient_correlation;
-			map<int, float> mapKGE_2009;
-			map<int, float> mapKGE_2012;
-			map<int, float> mapCoeffPointe;
-			map<int, float> mapCoeffVolume;
-			map<int, float> mapNashLog;
-			map<int, float> mapNashMod;
-			map<int, float> mapEcartQuad;
-			
-			map<int, float> somme_obs;
-			map<int, float> somme_sim;
-			
-			map<int, float> moyenne_obs;
-			map<int, float> moyenne_sim;
+		LectureParametres();
 
-			vector<float> vVal;
+		_troncons.clear();
 
-			vector<int> idents;
-			for (auto iter = begin(_troncon_station); iter != end(_troncon_station); ++iter)
-				idents.push_back(iter->first);
+		try{
 
-			// lecture des valeurs simulees					
-			ifstream fichier(path);
-			
-			string ligne, sTemp, sTemp2;
+		STATIONS_HYDRO& stations_hydro = _sim_hyd->PrendreStationsHydro();
 
-			getline_mod(fichier, ligne); // commentaire
-			
-			//lecture de l'entete et conserve les numero de troncon present dans le fichier
-			getline_mod(fichier, sTemp);
-			sTemp2 = "date heure\\troncon;";
-			ligne = sTemp.substr(sTemp2.size(), sTemp.size() - sTemp2.size());
-			vIDTroncon = extrait_svaleur(ligne, _sim_hyd->PrendreOutput().Separator());
-			nb_troncon = vIDTroncon.size();
-
-			DATE_HEURE date_courante(date_debut);
-			while (date_courante < date_fin)
-			{
-				getline_mod(fichier, sTemp);
-				if(sTemp.size() < 18)
-				{
-					fichier.close();
-					throw ERREUR("Computation of statistics: flows reading error: invalid debit_aval.csv file.");
-				}
+		for (auto iter = begin(_troncon_station); iter != end(_troncon_station); ++iter)
+		{
+			//seuls les troncons simules sont conserves
+			if (find(begin(troncons_simules), end(troncons_simules), iter->first) == end(troncons_simules))
+				continue;
 
-				sDate = sTemp.substr(0, 16);
-				sTemp = sTemp.substr(17);
+			TRONCON_STATION ts;
 
-				vVal = extrait_fvaleur(sTemp, _sim_hyd->PrendreOutput().Separator());
-				if(vVal.size() != nb_troncon)
-				{
-					fichier.close();
-					throw ERREUR("Computation of statistics: flows reading error: invalid debit_aval.csv file.");
-				}
+			ts.ident = iter->first;
+			ts.station = iter->second;
+			ts.troncon = troncons[troncons.IdentVersIndex(iter->first)];
+			ts.station_hydro = static_cast<STATION_HYDRO*>(stations_hydro.Recherche(iter->second));
 
-				for (size_t n = 0; n < nb_troncon; ++n)
-				{
-					if (find(begin(idents), end(idents), static_cast<int>(vIDTroncon[n])) != end(idents))
-						donnees[ static_cast<int>(vIDTroncon[n]) ].push_back(make_pair(vVal[n], VALEUR_MANQUANTE));
-				}
-				
-				date_courante.AdditionHeure(pas_de_temps);
+			if (ts.station_hydro)
+			{
+				// lecture des valeurs observees
+				ts.station_hydro->LectureDonnees(date_debut, date_fin, pas_de_temps);
 			}
-
-			fichier.close();
-
-			// lecture des valeurs observees
-
-			try{
-
-			STATIONS_HYDRO& stations_hydro = _sim_hyd->PrendreStationsHydro();
-
-			for (auto iter = begin(_troncon_station); iter != end(_troncon_station); ++iter)
+			else
 			{
-				if(donnees.find(iter->first) != donnees.end())
-				{
-					STATION_HYDRO* station_hydro = static_cast<STATION_HYDRO*>(stations_hydro.Recherche(iter->second));
+				tmp = iter->second;
+				boost::algorithm::to_lower(tmp);
 
-					size_t index = 0;
-					DATE_HEURE date_courante2(date_debut);
-
-					if (station_hydro)
-					{
-						// lecture des valeurs observees
-						station_hydro->LectureDonnees(date_debut, date_fin, pas_de_temps);
-
-						while (date_courante2 < date_fin)
-						{
-							donnees[iter->first][index++].second = station_hydro->PrendreDebit(date_courante2, pas_de_temps);
-							date_courante2.AdditionHeure(pas_de_temps);
-						}
-					}
-					else
-					{
-						string tmp;
-						tmp = iter->second;
-						boost::algorithm::to_lower(tmp);
-
-						if(tmp == "absent")
-						{
-							while (date_courante2 < date_fin)
-							{
-								donnees[iter->first][index++].second = VALEUR_MANQUANTE;
-								date_courante2.AdditionHeure(pas_de_temps);
-							}
-						}
-						else
-							throw ERREUR("Computation of statistics: hydrometric station not found: " + iter->second);
-					}
-				}
+				if(tmp != "absent")
+					throw ERREUR("Computation of statistics: hydrometric station not found: " + iter->second);
 			}
 
-			}
-			catch(const ERREUR_LECTURE_FICHIER& err)
-			{
-				throw ERREUR(err.what());
-			}
-			catch(const ERREUR& err2)
-			{
-				throw ERREUR(err2.what());
-			}
+			_troncons.push_back(ts);
+		}
 
-			// calcul des statistiques
-			for (auto iter = begin(donnees); iter != end(donnees); ++iter)
-			{
-				float moy_obs = 0.0f;
-				float moy_log_obs = 0.0f;
-				float som_obs = 0.0f;
-				size_t nb_pas_obs = 0;
+		}
+		catch(const ERREUR_LECTURE_FICHIER& err)
+		{
+			throw ERREUR(err.what());
+		}
+	}
 
-				float moy_sim = 0.0f;
-				float som_sim = 0.0f;
-				size_t nb_pas_sim = 0;
 
-				for (auto debits = begin(iter->second); debits != end(iter->second); ++debits)
-				{
-					if (debits->first > VALEUR_MANQUANTE)
-					{
-						moy_sim += debits->first;
-						som_sim += debits->first;
+	void STATISTIQUES::Calcule()
+	{
+		DATE_HEURE date_courante = _sim_hyd->PrendreDateCourante();
+		unsigned short pas_de_temps = _sim_hyd->PrendrePasDeTemps();
 
-						nb_pas_sim++;
-					}
+		for (size_t index = 0; index < _troncons.size(); ++index)
+		{
+			TRONCON_STATION& ts = _troncons[index];
 
-					if (debits->second > VALEUR_MANQUANTE)
-					{
-						moy_obs += debits->second;
-						som_obs += debits->second;
-						moy_log_obs+= log(debits->second);
+			ts.sim.push_back(ts.troncon->PrendreDebitAvalMoyen());
+			ts.obs.push_back(ts.station_hydro ? ts.station_hydro->PrendreDebit(date_courante, pas_de_temps) : VALEUR_MANQUANTE);
+		}
+	}
 
-						nb_pas_obs++;
-					}
-				}
 
-				if (nb_pas_obs > 0)
-				{
-					moy_obs /= nb_pas_obs;
-					moy_log_obs/= nb_pas_obs;
+	//calcul des statistiques de chaque troncon a partir des series simulees/observees
+	void STATISTIQUES::CalculeResultats(vector<RESULTAT>& resultats) const
+	{
+		resultats.resize(_troncons.size());
 
-					somme_obs[iter->first] = som_obs;
-					moyenne_obs[iter->first] = moy_obs;
-				}
-				else
-				{
-					somme_obs[iter->first] = VALEUR_MANQUANTE;
-					moyenne_obs[iter->first] = VALEUR_MANQUANTE;
-				}
+		for (size_t index = 0; index < _troncons.size(); ++index)
+		{
+			const vector<float>& sim = _troncons[index].sim;
+			const vector<float>& obs = _troncons[index].obs;
+			RESULTAT& r = resultats[index];
 
-				if (nb_pas_sim > 0)
-				{
-					moy_sim /= nb_pas_sim;
+			r.ident = _troncons[index].ident;
 
-					somme_sim[iter->first] = som_sim;
-					moyenne_sim[iter->first] = moy_sim;
-				}
-				else
+			size_t nb_pas_obs = 0;
+			size_t nb_pas_sim = 0;
+			double som_obs = 0.0;
+			double som_sim = 0.0;
+			double som_log_obs = 0.0;
+			double s, o;
+
+			//1re passe: moyennes
+			for (size_t pas = 0; pas < sim.size(); ++pas)
+			{
+				if (sim[pas] > VALEUR_MANQUANTE)
 				{
-					moyenne_sim[iter->first] = VALEUR_MANQUANTE;
-					somme_sim[iter->first] = VALEUR_MANQUANTE;
+					som_sim+= sim[pas];
+					++nb_pas_sim;
 				}
 
-				// nash, ecart
-				float ecart2 = VALEUR_MANQUANTE;
-				float nash = VALEUR_MANQUANTE;
-				if (nb_pas_obs > 0)
+				if (obs[pas] > VALEUR_MANQUANTE)
 				{
-					ecart2 = 0.0f;
-					nash = 0.0f;
-
-					for (auto debits = begin(iter->second); debits != end(iter->second); ++debits)
-					{
-						if (debits->second > VALEUR_MANQUANTE)
-						{
-							ecart2 += pow(debits->second - debits->first, 2.0f);
-						}
-					}
-
-					for (auto debits = begin(iter->second); debits != end(iter->second); ++debits)
-					{
-						if (debits->second > VALEUR_MANQUANTE)
-						{
-							nash += pow(debits->second - moy_obs, 2.0f);
-						}
-					}
-
-					if(nash != 0.0f)
-						nash = 1.0f - ecart2 / nash;
-
-					ecart2 = sqrt((1.0f / nb_pas_obs) * ecart2);
+					o = obs[pas];
+					som_obs+= o;
+					som_log_obs+= log(o);
+					++nb_pas_obs;
 				}
+			}
 
-				// biais relatif
-				float biais = VALEUR_MANQUANTE;
-				if (nb_pas_obs > 0)
-				{
-					float difference = 0.0f;
-					for (auto debits = begin(iter->second); debits != end(iter->second); ++debits)
-					{
-						if (debits->second > VALEUR_MANQUANTE)
-						{
-							difference += debits->first - debits->second;
-						}
-					}
+			double n = static_cast<double>(nb_pas_obs);
+			double moy_obs = 0.0;
+			double moy_log_obs = 0.0;
+			double moy_sim = 0.0;
 
-					if(som_obs != 0.0f)
-					{
-						//biais = difference / som_obs * 100.0f;	//Pourcentage de biais relatif (P-Biais)
-						biais = difference / som_obs;				//Biais relatif
-					}
-				}
+			if (nb_pas_obs > 0)
+			{
+				moy_obs = som_obs / n;
+				moy_log_obs = som_log_obs / n;
 
-				// biais absolue
-				float biaisAbsolue = VALEUR_MANQUANTE;
-				if (nb_pas_obs > 0)
-				{
-					float difference = 0.0f;
-					for (auto debits = begin(iter->second); debits != end(iter->second); ++debits)
-					{
-						if (debits->second > VALEUR_MANQUANTE)
-							difference += debits->second - debits->first;
-					}
+				r.somme_obs = static_cast<float>(som_obs);
+				r.moyenne_obs = static_cast<float>(moy_obs);
+			}
+			else
+			{
+				r.somme_obs = VALEUR_MANQUANTE;
+				r.moyenne_obs = VALEUR_MANQUANTE;
+			}
 
-					if(som_obs != 0.0f)
-						biaisAbsolue = abs(difference / som_obs);
-				}
+			if (nb_pas_sim > 0)
+			{
+				moy_sim = som_sim / nb_pas_sim;
 
-				// coefficient correlation
-				float coeff_corr = VALEUR_MANQUANTE;
-				if (nb_pas_obs > 0)
-				{
-					float multValeurMoy = 0.0f;
-					for (auto debits = begin(iter->second); debits != end(iter->second); ++debits)
-					{
-						if (debits->second > VALEUR_MANQUANTE)
-						{
-							multValeurMoy  += (debits->second - moy_obs) * (debits->first - moy_sim);
-						}
-					}
+				r.somme_sim = static_cast<float>(som_sim);
+				r.moyenne_sim = static_cast<float>(moy_sim);
+			}
+			else
+			{
+				r.somme_sim = VALEUR_MANQUANTE;
+				r.moyenne_sim = VALEUR_MANQUANTE;
+			}
 
-					float obs2 = 0.0f;
-					float sim2 = 0.0f;
-					for (auto debits = begin(iter->second); debits != end(iter->second); ++debits)
-					{
-						if (debits->second > VALEUR_MANQUANTE)
-						{
-							obs2 += pow(debits->second - moy_obs, 2.0f);	
-							sim2 += pow(debits->first - moy_sim, 2.0f);
-						}
-					}
-					
-					if(obs2 != 0.0f && sim2 != 0.0f)
-						coeff_corr = multValeurMoy / ((sqrt(obs2) * sqrt(sim2)));
-				}
+			r.ecart2 = VALEUR_MANQUANTE;
+			r.nash = VALEUR_MANQUANTE;
+			r.biais_relatif = VALEUR_MANQUANTE;
+			r.biais_absolue = VALEUR_MANQUANTE;
+			r.coeff_correlation = VALEUR_MANQUANTE;
+			r.kge_2009 = VALEUR_MANQUANTE;
+			r.kge_2012 = VALEUR_MANQUANTE;
+			r.coeff_pointe = VALEUR_MANQUANTE;
+			r.coeff_volume = VALEUR_MANQUANTE;
+			r.nash_log = VALEUR_MANQUANTE;
+			r.nash_mod = VALEUR_MANQUANTE;
+			r.ecart_quad = VALEUR_MANQUANTE;
+
+			if (nb_pas_obs == 0)
+				continue;
+
+			//2e passe: sommes des ecarts (pas de temps observes, sauf var_sim)
+			double ecart2 = 0.0;			//(o-s)^2
+			double difference = 0.0;		//s-o
+			double obs2 = 0.0;				//(o-moy_obs)^2
+			double sim2 = 0.0;				//(s-moy_sim)^2
+			double mult_valeur_moy = 0.0;	//(o-moy_obs)*(s-moy_sim)
+			double var_sim = 0.0;			//(s-moy_sim)^2 sur les pas de temps simules
+			double som_obs2 = 0.0;			//o^2
+			double pointe = 0.0;			//o*(o-s)^2
+			double log_ecart2 = 0.0;		//(log(o)-log(s))^2
+			double log2 = 0.0;				//(log(o)-moy_log_obs)^2
+			double mod_ecart2 = 0.0;		//(o*(o-s))^2
+			double mod2 = 0.0;				//(o*(o-moy_obs))^2
+			double ecart_relatif2 = 0.0;	//((s-o)/o)^2
+
+			for (size_t pas = 0; pas < sim.size(); ++pas)
+			{
+				s = sim[pas];
 
-				//KGE1 - KGE original (2009) & KGE2 - KGE modifi (2012)
-				float kge1 = VALEUR_MANQUANTE;
-				float kge2 = VALEUR_MANQUANTE;
+				if (sim[pas] > VALEUR_MANQUANTE)
+					var_sim+= (s - moy_sim) * (s - moy_sim);
 
-				if(nb_pas_obs > 0 && coeff_corr > VALEUR_MANQUANTE)
+				if (obs[pas] > VALEUR_MANQUANTE)
 				{
-					float temp1 = 0.0f;
-					float temp2 = 0.0f;
-					float varObs, varSim, fA, fB, fCV;
+					o = obs[pas];
 
-					for(auto debits = begin(iter->second); debits != end(iter->second); ++debits)
-					{
-						if(debits->second > VALEUR_MANQUANTE)
-							temp1 = temp1 + debits->second * debits->second;
-
-						temp2 = temp2 + debits->first * debits->first;
-					}
+					ecart2+= (o - s) * (o - s);
+					difference+= s - o;
 
-					varObs = temp1 / nb_pas_obs - moy_obs * moy_obs;
-                    varSim = temp2 / nb_pas_sim - moy_sim * moy_sim;
+					obs2+= (o - moy_obs) * (o - moy_obs);
+					sim2+= (s - moy_sim) * (s - moy_sim);
+					mult_valeur_moy+= (o - moy_obs) * (s - moy_sim);
 
-					fA = varSim / varObs;
-					fA = sqrt(fA);
+					som_obs2+= o * o;
+					pointe+= o * (o - s) * (o - s);
 
-                    fB = moy_sim / moy_obs;
+					log_ecart2+= (log(o) - log(s)) * (log(o) - log(s));
+					log2+= (log(o) - moy_log_obs) * (log(o) - moy_log_obs);
 
-					fCV = (sqrt(varSim) / moy_sim) / (sqrt(varObs) / moy_obs);
+					mod_ecart2+= (o * (o - s)) * (o * (o - s));
+					mod2+= (o * (o - moy_obs)) * (o * (o - moy_obs));
 
-					kge1 = 1.0f - sqrt(pow(coeff_corr - 1.0f, 2.0f) + pow(fA - 1.0f, 2.0f) + pow(fB - 1.0f, 2.0f));
-					kge2 = 1.0f - sqrt(pow(coeff_corr - 1.0f, 2.0f) + pow(fCV - 1.0f, 2.0f) + pow(fB - 1.0f, 2.0f));
+					ecart_relatif2+= ((s - o) / o) * ((s - o) / o);
 				}
+			}
 
-				//coefficient de pointe
-				float coeffPointe = VALEUR_MANQUANTE;
-				if (nb_pas_obs > 0)
-				{
-					float temp1 = 0.0f;
-					float temp2 = 0.0f;
+			// nash, ecart
+			double nash = 0.0;
+			if (obs2 != 0.0)
+				nash = 1.0 - ecart2 / obs2;
 
-					for (auto debits = begin(iter->second); debits != end(iter->second); ++debits)
-					{
-						if (debits->second > VALEUR_MANQUANTE)
-						{
-							temp2 = temp2 + pow(debits->second, 2.0f);
-							temp1 = temp1 + debits->second * pow(debits->second - debits->first, 2.0f);
-						}
-					}
+			r.nash = static_cast<float>(nash);
+			r.ecart2 = static_cast<float>(sqrt(ecart2 / n));
 
-					if (temp2 != 0.0)
-						coeffPointe = pow(temp1, 0.25f) / pow(temp2, 0.5f);
-				}
+			// biais relatif, biais absolue
+			if (som_obs != 0.0)
+			{
+				//biais = difference / som_obs * 100.0;	//Pourcentage de biais relatif (P-Biais)
+				r.biais_relatif = static_cast<float>(difference / som_obs);	//Biais relatif
+				r.biais_absolue = static_cast<float>(abs(-difference / som_obs));
+			}
 
-				//coefficient de volume
-				float coeffVolume = VALEUR_MANQUANTE;
-				if (nb_pas_obs > 0)
-				{
-					float temp1 = 0.0f;
+			// coefficient correlation
+			double coeff_corr = VALEUR_MANQUANTE;
+			if (obs2 != 0.0 && sim2 != 0.0)
+				coeff_corr = mult_valeur_moy / (sqrt(obs2) * sqrt(sim2));
 
-					for (auto debits = begin(iter->second); debits != end(iter->second); ++debits)
-					{
-						if (debits->second > VALEUR_MANQUANTE)
-							temp1 = temp1 + (debits->second - debits->first);
-					}
+			r.coeff_correlation = static_cast<float>(coeff_corr);
 
-					if (moy_obs != 0.0f)
-						coeffVolume = temp1 / (nb_pas_obs * moy_obs);
-				}
+			//KGE1 - KGE original (2009) & KGE2 - KGE modifie (2012)
+			if (coeff_corr > VALEUR_MANQUANTE)
+			{
+				double varObs, varSim, dA, dB, dCV;
 
-				//Nash-Log
-				float nashLog = VALEUR_MANQUANTE;
-				if (nb_pas_obs > 0)
-				{
-					float temp1 = 0.0f;
-					float temp2 = 0.0f;
+				varObs = obs2 / n;
+				varSim = var_sim / nb_pas_sim;
 
-					for (auto debits = begin(iter->second); debits != end(iter->second); ++debits)
-					{
-						if (debits->second > VALEUR_MANQUANTE)
-						{
-							temp1 = temp1 + pow(log(debits->second) - log(debits->first), 2.0f);
-							temp2 = temp2 + pow(log(debits->second) - moy_log_obs, 2.0f);
-						}
-					}
+				dA = sqrt(varSim / varObs);
+				dB = moy_sim / moy_obs;
+				dCV = (sqrt(varSim) / moy_sim) / (sqrt(varObs) / moy_obs);
 
-					if (temp2 != 0.0f)
-						nashLog = 1.0f - temp1 / temp2;
-				}
+				r.kge_2009 = static_cast<float>(1.0 - sqrt(pow(coeff_corr - 1.0, 2.0) + pow(dA - 1.0, 2.0) + pow(dB - 1.0, 2.0)));
+				r.kge_2012 = static_cast<float>(1.0 - sqrt(pow(coeff_corr - 1.0, 2.0) + pow(dCV - 1.0, 2.0) + pow(dB - 1.0, 2.0)));
+			}
 
-				//Nash-M
-				float nashMod = VALEUR_MANQUANTE;
-				if (nb_pas_obs > 0)
-				{
-					float temp1 = 0.0f;
-					float temp2 = 0.0f;
+			//coefficient de pointe
+			if (som_obs2 != 0.0)
+				r.coeff_pointe = static_cast<float>(pow(pointe, 0.25) / pow(som_obs2, 0.5));
 
-					for (auto debits = begin(iter->second); debits != end(iter->second); ++debits)
-					{
-						if (debits->second > VALEUR_MANQUANTE)
-						{
-							temp2 = temp2 + pow(debits->second * (debits->second - moy_obs), 2.0f);
-							temp1 = temp1 + pow(debits->second * (debits->second - debits->first), 2.0f);
-						}
-					}
+			//coefficient de volume
+			if (moy_obs != 0.0)
+				r.coeff_volume = static_cast<float>(-difference / (n * moy_obs));
 
-					if (temp2 != 0.0f)
-						nashMod = 1.0f - temp1 / temp2;
-				}
+			//Nash-Log
+			if (log2 != 0.0)
+				r.nash_log = static_cast<float>(1.0 - log_ecart2 / log2);
 
-				//EcartQdrMoyen
-				float ecartQuadratique = VALEUR_MANQUANTE;
-				if (nb_pas_obs > 0)
-				{
-					float temp1 = 0.0f;
+			//Nash-M
+			if (mod2 != 0.0)
+				r.nash_mod = static_cast<float>(1.0 - mod_ecart2 / mod2);
 
-					for (auto debits = begin(iter->second); debits != end(iter->second); ++debits)
-					{
-						if (debits->second > VALEUR_MANQUANTE)
-							temp1 = temp1 + pow((debits->first - debits->second) / debits->second, 2.0f);
-					}
+			//EcartQdrMoyen
+			r.ecart_quad = static_cast<float>(sqrt(ecart_relatif2));
+		}
+	}
 
-					ecartQuadratique = sqrt(temp1);
-				}
 
-				//
-				ecart2s[iter->first] = ecart2;
-				nashs[iter->first] = nash;
-				biais_relatif[iter->first] = biais;
-				biais_absolue[iter->first] = biaisAbsolue;
-				coefficient_correlation[iter->first] = coeff_corr;
-				mapKGE_2009[iter->first] = kge1;
-				mapKGE_2012[iter->first] = kge2;
-				mapCoeffPointe[iter->first] = coeffPointe;
-				mapCoeffVolume[iter->first] = coeffVolume;
-				mapNashLog[iter->first] = nashLog;
-				mapNashMod[iter->first] = nashMod;
-				mapEcartQuad[iter->first] = ecartQuadratique;
+	//creation du fichier stats.csv
+	void STATISTIQUES::Termine()
+	{
+		string path;
 
-			}
+		DATE_HEURE date_debut = _sim_hyd->PrendreDateDebut();
+		unsigned short pas_de_temps = _sim_hyd->PrendrePasDeTemps();
 
+		size_t nb_troncon = _troncons.size();
+		size_t nb_pas = nb_troncon == 0 ? 0 : _troncons[0].sim.size();
+
+		vector<RESULTAT> resultats;
+		CalculeResultats(resultats);
+
+		try
+		{
 			// ecriture des resultats
 			{
 				path = Combine(_sim_hyd->PrendreRepertoireResultat(), "stats.csv");
@@ -536,27 +380,25 @@ namespace HYDROTEL
 					<< sep << "Nash-M" << sep << "cart quadratique moyen" << sep << "Somme Obs." 
 					<< sep << "Somme Sim." << sep << "Moyenne Obs." << sep << "Moyenne Sim." << endl;
 
-				for (auto iter = begin(donnees); iter != end(donnees); ++iter)
+				for (size_t index = 0; index < nb_troncon; ++index)
 				{
-					int ident = iter->first;
-
-					fichier3 << ident << sep 
-						<< ecart2s[ident] << sep 
-						<< nashs[ident] << sep
-						<< biais_relatif[ident] << sep
-						<< biais_absolue[ident] << sep
-						<< coefficient_correlation[ident] << sep
-						<< mapKGE_2009[ident] << sep
-						<< mapKGE_2012[ident] << sep
-						<< mapCoeffPointe[ident] << sep
-						<< mapCoeffVolume[ident] << sep
-						<< mapNashLog[ident] << sep
-						<< mapNashMod[ident] << sep
-						<< mapEcartQuad[ident] << sep
-						<< somme_obs[ident] << sep
-						<< somme_sim[ident] << sep
-						<< moyenne_obs[ident] << sep
-						<< moyenne_sim[ident] << endl;
+					fichier3 << resultats[index].ident << sep 
+						<< resultats[index].ecart2 << sep 
+						<< resultats[index].nash << sep
+						<< resultats[index].biais_relatif << sep
+						<< resultats[index].biais_absolue << sep
+						<< resultats[index].coeff_correlation << sep
+						<< resultats[index].kge_2009 << sep
+						<< resultats[index].kge_2012 << sep
+						<< resultats[index].coeff_pointe << sep
+						<< resultats[index].coeff_volume << sep
+						<< resultats[index].nash_log << sep
+						<< resultats[index].nash_mod << sep
+						<< resultats[index].ecart_quad << sep
+						<< resultats[index].somme_obs << sep
+						<< resultats[index].somme_sim << sep
+						<< resultats[index].moyenne_obs << sep
+						<< resultats[index].moyenne_sim << endl;
 				}
 				fichier3 << endl;
 
@@ -567,13 +409,10 @@ namespace HYDROTEL
 				ostringstream oss;
 				oss.str("");
 
-				for (auto iter = begin(_troncon_station); iter != end(_troncon_station); ++iter)
+				for (size_t index = 0; index < nb_troncon; ++index)
 				{
-					if(donnees.find(iter->first) != donnees.end())
-					{
-						oss << "troncon id " << iter->first << sep;
-						oss << "station id " << iter->second << sep;
-					}
+					oss << "troncon id " << _troncons[index].ident << sep;
+					oss << "station id " << _troncons[index].station << sep;
 				}
 
 				str = oss.str();
@@ -586,21 +425,19 @@ namespace HYDROTEL
 					fichier3 << endl;
 
 				DATE_HEURE date_courante3 = date_debut;
-				int pas = 0;
 
-				while (date_courante3 < date_fin)
+				for (size_t pas = 0; pas < nb_pas; ++pas)
 				{
 					fichier3 << date_courante3;
 
-					for (auto iter = begin(donnees); iter != end(donnees); ++iter)
+					for (size_t index = 0; index < nb_troncon; ++index)
 					{
-						fichier3 << sep << iter->second[pas].first;		//debit simule
-						fichier3 << sep << iter->second[pas].second;		//debit observe
+						fichier3 << sep << _troncons[index].sim[pas];		//debit simule
+						fichier3 << sep << _troncons[index].obs[pas];		//debit observe
 					}
 					fichier3 << endl;
 
 					date_courante3.AdditionHeure(pas_de_temps);
-					pas++;
 				}
 
 				fichier3.close();
@@ -614,53 +451,25 @@ namespace HYDROTEL
 			if (!fichier2)
 				throw ERREUR_ECRITURE_FICHIER(path);
 
-			//string str;
-			//ostringstream oss;
-			//oss.str("");
-
-			//for (auto iter = begin(_troncon_station); iter != end(_troncon_station); ++iter)
-			//{
-			//	if(donnees.find(iter->first) != donnees.end())
-			//	{
-			//		oss << "troncon id " << iter->first << sep;
-			//		oss << "station id " << iter->second << sep;
-			//	}
-			//}
-
-			//str = oss.str();
-			//if(str != "")
-			//{
-			//	str = str.substr(0, str.length()-1); //enleve le dernier separateur
-			//	fichier2 << str << endl;
-			//}
-			//else
-			//	fichier2 << endl;
-
 			ostringstream oss;
 			DATE_HEURE date_courante4 = date_debut;
-			int pas = 0;
 
-			while (date_courante4 < date_fin)
+			for (size_t pas = 0; pas < nb_pas; ++pas)
 			{
 				fichier2 << date_courante4;
 
-				for (auto iter = begin(donnees); iter != end(donnees); ++iter)
+				for (size_t index = 0; index < nb_troncon; ++index)
 				{
-					//iter->second[pas].second -> debit observe
-					//iter->second[pas].first -> debit simule
-
 					oss.str("");
-					oss << sep << setprecision(_sim_hyd->PrendreOutput()._nbDigit_m3s) << setiosflags(ios::fixed) << iter->second[pas].second << sep << setprecision(_sim_hyd->PrendreOutput()._nbDigit_m3s) << setiosflags(ios::fixed) << iter->second[pas].first;
+					oss << sep << setprecision(_sim_hyd->PrendreOutput()._nbDigit_m3s) << setiosflags(ios::fixed) << _troncons[index].obs[pas] << sep << setprecision(_sim_hyd->PrendreOutput()._nbDigit_m3s) << setiosflags(ios::fixed) << _troncons[index].sim[pas];
 					fichier2 << oss.str();
 				}
 				fichier2 << endl;
 
 				date_courante4.AdditionHeure(pas_de_temps);
-				pas++;
 			}
 
 			fichier2.close();
-
 		}
 		catch (const ERREUR& err)
 		{
@@ -668,9 +477,42 @@ namespace HYDROTEL
 		}
 		catch (exception&)
 		{
-			throw ERREUR_LECTURE_FICHIER(path);
+			throw ERREUR_ECRITURE_FICHIER(path);
+		}
+	}
+
+
+	void STATISTIQUES::SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const
+	{
+		etat.Ecrit(_troncons.size());
+
+		for (size_t index = 0; index < _troncons.size(); ++index)
+		{
+			etat.Ecrit(_troncons[index].ident);
+			etat.Ecrit(_troncons[index].sim);
+			etat.Ecrit(_troncons[index].obs);
+		}
+	}
+
+
+	void STATISTIQUES::LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur)
+	{
+		size_t nb;
+		int ident;
+
+		lecteur.Lit(nb);
+		if (nb != _troncons.size())
+			throw ERREUR("In-memory state: statistics reaches do not match the simulation.");
+
+		for (size_t index = 0; index < _troncons.size(); ++index)
+		{
+			lecteur.Lit(ident);
+			if (ident != _troncons[index].ident)
+				throw ERREUR("In-memory state: statistics reaches do not match the simulation.");
+
+			lecteur.Lit(_troncons[index].sim);
+			lecteur.Lit(_troncons[index].obs);
 		}
-		
 	}
 	
 }
@@ -23,6 +23,7 @@
 
 
 #include "sim_hyd.hpp"
+#include "etat_memoire.hpp"
 
 #include <map>
 
@@ -30,21 +31,78 @@
 namespace HYDROTEL
 {
 
+	class STATION_HYDRO;
+
+	//statistiques debits simules/observes (stats.csv); les series sont conservees pendant la simulation
+	//et les statistiques calculees en deux passes (moyennes puis ecarts a la moyenne)
 	class STATISTIQUES
 	{
 	public:
-		/// construit un objet statistiques et calcul les statistiques
+		//statistiques d'un troncon (stats.csv)
+		struct RESULTAT
+		{
+			int		ident;
+
+			float	ecart2;				//RCEQM
+			float	nash;
+			float	biais_relatif;
+			float	biais_absolue;
+			float	coeff_correlation;
+			float	kge_2009;
+			float	kge_2012;
+			float	coeff_pointe;
+			float	coeff_volume;
+			float	nash_log;
+			float	nash_mod;
+			float	ecart_quad;
+
+			float	somme_obs;
+			float	somme_sim;
+			float	moyenne_obs;
+			float	moyenne_sim;
+		};
+
 		STATISTIQUES(SIM_HYD& sim_hyd, const std::string& nom_fichier_parametres);
 
 		~STATISTIQUES();
 
+		/// lecture des parametres (troncon - station) et des debits observes
+		void Initialise();
+
+		/// conserve les debits du pas de temps courant; appele apres le calcul de l'acheminement riviere
+		void Calcule();
+
+		/// calcul des statistiques a partir des series conservees, sans ecriture de fichier
+		void CalculeResultats(std::vector<RESULTAT>& resultats) const;
+
+		/// calcul des statistiques et creation des fichiers stats.csv et obs-sim-flows.csv
+		void Termine();
+
+		void SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const;
+
+		void LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur);
+
 	private:
+
+		struct TRONCON_STATION
+		{
+			int					ident;
+			std::string			station;
+
+			TRONCON*			troncon;
+			STATION_HYDRO*		station_hydro;	//nullptr si station absente
+
+			std::vector<float>	sim;			//[pas de temps]
+			std::vector<float>	obs;			//[pas de temps]
+		};
+
 		void LectureParametres();
-		void LectureDonnees();
-				
+
 		SIM_HYD* _sim_hyd;
 		std::string _nom_fichier_parametres;
 		std::map<int, std::string> _troncon_station;
+
+		std::vector<TRONCON_STATION> _troncons;
 	};
 
 }
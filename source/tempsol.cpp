@@ -43,6 +43,9 @@ namespace HYDROTEL
 
 	TEMPSOL::~TEMPSOL()
 	{
+		//fichiers netcdf non fermes par Termine (exception); OUTPUT_NETCDF ecrit les pas de temps deja calcules
+		if(_netCdf_profondeurgel != NULL)
+			delete _netCdf_profondeurgel;
 	}
 
 
@@ -62,31 +65,22 @@ namespace HYDROTEL
 		if (output.SauvegardeProfondeurGel())
 		{
 			if (_sim_hyd._outputCDF)
-				_netCdf_profondeurgel = new float[_sim_hyd._lNbPasTempsSim*_sim_hyd.PrendreOutput()._uhrhOutputNb];
+				_netCdf_profondeurgel = _sim_hyd.PrendreOutput().CreeOutputNetCDF(Combine(_sim_hyd.PrendreRepertoireResultat(), "profondeur_gel.nc"), true, "profondeur_gel", "cm", "Profondeur du gel au sol");
 			else
 			{
 				string nom_fichier( Combine(_sim_hyd.PrendreRepertoireResultat(), "profondeur_gel.csv") );
-				_fichier_tempsol.open(nom_fichier);
-				_fichier_tempsol << "profondeur du gel (cm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
+				_fichier_tempsol.Ouvre(output, nom_fichier, true, output._nbDigit_cm);
+				_fichier_tempsol.Entete() << "profondeur du gel (cm)" << output.Separator() << PrendreNomSousModele() << " ( VERSION " << HYDROTEL_VERSION << " )" << endl << "date heure\\uhrh" << output.Separator();
 
 				ostringstream oss;
 				oss.str("");
 				
-				for (size_t index = 0; index < _nbZone; ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreIdent() << output.Separator();
-						}
-					}
-				}
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					oss << zones[output._uhrhOutputIndex[n]].PrendreIdent() << output.Separator();
 
 				str = oss.str();
 				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_tempsol << str << endl;
+				_fichier_tempsol.Entete() << str << endl;
 			}
 		}
 	}
@@ -97,42 +91,25 @@ namespace HYDROTEL
 		ZONES& zones = _sim_hyd.PrendreZones();
 		OUTPUT& output = _sim_hyd.PrendreOutput();
 
-		string str;
-		size_t index;
 
 		if (output.SauvegardeProfondeurGel())
 		{
 			if (_netCdf_profondeurgel != NULL)
 			{
-				size_t i, idx;
+				size_t i;
+				float* pLigne;
 
-				idx = _sim_hyd._lPasTempsCourantIndex * _sim_hyd.PrendreOutput()._uhrhOutputNb;
+				pLigne = _netCdf_profondeurgel->Ligne(_sim_hyd._lPasTempsCourantIndex);
 
 				for (i=0; i<_sim_hyd.PrendreOutput()._uhrhOutputNb; i++)
-					_netCdf_profondeurgel[idx+i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreProfondeurGel();
+					pLigne[i] = zones[_sim_hyd.PrendreOutput()._uhrhOutputIndex[i]].PrendreProfondeurGel();
 			}
 			else
 			{
-				ostringstream oss;
-				oss.str("");
-			
-				oss << _sim_hyd.PrendreDateCourante() << output.Separator() << setprecision(output._nbDigit_cm) << setiosflags(ios::fixed);
-
-				for (index = 0; index < _nbZone; ++index)
-				{
-					if(find(begin(_sim_hyd.PrendreZonesSimules()), end(_sim_hyd.PrendreZonesSimules()), index) != end(_sim_hyd.PrendreZonesSimules()))
-					{
-						if (output._bSauvegardeTous || 
-							find(begin(output._vIdTronconSelect), end(output._vIdTronconSelect), zones[index].PrendreTronconAval()->PrendreIdent()) != end(output._vIdTronconSelect))
-						{
-							oss << zones[index].PrendreProfondeurGel() << output.Separator();
-						}
-					}
-				}
-			
-				str = oss.str();
-				str = str.substr(0, str.length()-1); //enleve le dernier separateur
-				_fichier_tempsol << str << endl;
+				double* pValeur = _fichier_tempsol.Ligne(_sim_hyd.PrendreDateCourante());
+
+				for (size_t n = 0; n < output._uhrhOutputNb; ++n)
+					pValeur[n] = zones[output._uhrhOutputIndex[n]].PrendreProfondeurGel();
 			}
 		}
 	}
@@ -146,19 +123,17 @@ namespace HYDROTEL
 		{
 			if (_netCdf_profondeurgel != NULL)
 			{
-				string str1, str2;
+				string str;
 
-				//str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "tempsol-profondeur_gel.nc");
-				str1 = Combine(_sim_hyd.PrendreRepertoireResultat(), "profondeur_gel.nc");
-				//str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "tempsol-profondeur_gel", _netCdf_profondeurgel, "cm", "Profondeur du gel au sol");
-				str2 = _sim_hyd.PrendreOutput().SauvegardeOutputNetCDF(str1, true, "profondeur_gel", _netCdf_profondeurgel, "cm", "Profondeur du gel au sol");
-				if(str2 != "")
-					throw ERREUR(str2);
+				str = _netCdf_profondeurgel->Ferme();
+				delete _netCdf_profondeurgel;
+				_netCdf_profondeurgel = NULL;
 
-				delete [] _netCdf_profondeurgel;
+				if(str != "")
+					throw ERREUR(str);
 			}
 			else
-				_fichier_tempsol.close();
+				_fichier_tempsol.Ferme();
 		}
 	}
 
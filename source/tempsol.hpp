@@ -23,6 +23,8 @@
 
 
 #include "sous_modele.hpp"
+#include "output_netcdf.hpp"
+#include "output_csv.hpp"
 
 #include <fstream>
 
@@ -57,10 +59,10 @@ namespace HYDROTEL
 
 		std::string			_nom_fichier_tempsol;
 
-		float*				_netCdf_profondeurgel;
+		OUTPUT_NETCDF*		_netCdf_profondeurgel;
 
 	private:
-		std::ofstream		_fichier_tempsol;
+		OUTPUT_CSV			_fichier_tempsol;
 		size_t				_nbZone;
 	};
 
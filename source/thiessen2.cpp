@@ -20,6 +20,7 @@
 
 #include "thiessen2.hpp"
 
+#include "arbre_kd.hpp"
 #include "constantes.hpp"
 #include "erreur.hpp"
 #include "station_meteo.hpp"
@@ -29,6 +30,7 @@
 
 #include <algorithm>
 #include <fstream>
+#include <map>
 #include <set>
 
 
@@ -42,7 +44,6 @@ namespace HYDROTEL
 		: INTERPOLATION_DONNEES(sim_hyd, "THIESSEN2")
 	{
 		_pSim_hyd = &sim_hyd;
-		_ponderation2 = nullptr;
 
 		_gradient_station_temp = -0.5f;		//default values
 		_gradient_station_precip = 0.5f;	//
@@ -100,15 +101,17 @@ namespace HYDROTEL
 
 	void THIESSEN2::Initialise()
 	{
-		if(_ponderation2)
-			delete [] _ponderation2;
+		//seules les ponderations non nulles sont gardees; la matrice [zone, station] complete n'est jamais construite
+		PONDERATION_CREUSE ponderation;
 
-		if (!LecturePonderation())
+		if (!LecturePonderation(_sim_hyd.PrendreStationsMeteo(), _sim_hyd.PrendreZones(), ponderation))
 		{
-			CalculePonderation();
-			SauvegardePonderation();
+			CalculePonderation(_sim_hyd.PrendreStationsMeteo(), _sim_hyd.PrendreZones(), ponderation, "THIESSEN2");
+			SauvegardePonderation(_sim_hyd.PrendreStationsMeteo(), _sim_hyd.PrendreZones(), ponderation);
 		}
 
+		ConstruitPonderationCreuse(ponderation);
+
 		_sim_hyd.PrendreStationsMeteo().LectureDonnees_v2(
 			_sim_hyd.PrendreDateDebut(), 
 			_sim_hyd.PrendreDateFin(), 
@@ -129,9 +132,6 @@ namespace HYDROTEL
 
 	void THIESSEN2::Termine()
 	{
-		if(_ponderation2)
-			delete [] _ponderation2;
-
 		INTERPOLATION_DONNEES::Termine();
 	}
 
@@ -144,21 +144,53 @@ namespace HYDROTEL
 		DATE_HEURE date_courante = _sim_hyd.PrendreDateCourante();
 		unsigned short pas_de_temps = _sim_hyd.PrendrePasDeTemps();
 
-		vector<size_t> index_zones = _sim_hyd.PrendreZonesSimules();
-
 		std::pair<float, float> temp_jour;
 		DONNEE_METEO donnee_station;
 		STATION_METEO* pStation;
 		ZONE* pZone;
-		size_t nbStation, nbStationTotal, index_station, index, index_zone;
-		float ponderation, tmin, tmax, pluie, neige, tmin_jour, tmax_jour, altStation, diff_alt;
+		size_t index_station, index, index_zone, n, nbStation;
+		float ponderation, tmin, tmax, pluie, neige, tmin_jour, tmax_jour, diff_alt;
 		float tmin_station, tmax_station, pluie_station, neige_station, tmin_jour_station, tmax_jour_station, fValTemp;
 
-		nbStationTotal = stations_meteo.PrendreNbStation();
+		//lecture une seule fois par pas de temps des donnees des stations utilisees
+		nbStation = _vStationUtilisee.size();
+
+		_vStationTMin.resize(nbStation);
+		_vStationTMax.resize(nbStation);
+		_vStationPluie.resize(nbStation);
+		_vStationNeige.resize(nbStation);
+		_vStationTMinJour.resize(nbStation);
+		_vStationTMaxJour.resize(nbStation);
+
+		if(_vStationAltitude.size() != nbStation)
+		{
+			_vStationAltitude.resize(nbStation);
+
+			for (n = 0; n < nbStation; n++)
+				_vStationAltitude[n] = static_cast<float>(stations_meteo[_vStationUtilisee[n]]->PrendreCoordonnee().PrendreZ());
+		}
+
+		for (n = 0; n < nbStation; n++)
+		{
+			pStation = static_cast<STATION_METEO*>(stations_meteo[_vStationUtilisee[n]]);
+
+			donnee_station = pStation->PrendreDonnees(date_courante, pas_de_temps);
+
+			_vStationTMin[n] = donnee_station.PrendreTMin();
+			_vStationTMax[n] = donnee_station.PrendreTMax();
+			_vStationPluie[n] = donnee_station.PrendrePluie();
+			_vStationNeige[n] = donnee_station.PrendreNeige();
+
+			temp_jour = pStation->PrendreTemperatureJournaliere(date_courante);
+
+			_vStationTMinJour[n] = temp_jour.first;
+			_vStationTMaxJour[n] = temp_jour.second;
+		}
 
-		for (index = 0; index < _pondIndexUhrh.size(); index++)
+		//produit matrice creuse (ponderations) - vecteur (valeurs des stations) pour chaque variable
+		for (index = 0; index < _pondZone.size(); index++)
 		{
-			index_zone = _pondIndexUhrh[index];
+			index_zone = _pondZone[index];
 			
 			pZone = &zones[index_zone];
 
@@ -169,18 +201,14 @@ namespace HYDROTEL
 			tmin_jour = VALEUR_MANQUANTE;
 			tmax_jour = VALEUR_MANQUANTE;
 
-			nbStation = _pondIndexStations[index].size();
-			for (index_station = 0; index_station < nbStation; index_station++)
+			for (n = _pondDebut[index]; n < _pondDebut[index+1]; n++)
 			{
-				ponderation = static_cast<float>(_ponderation2[index_zone*nbStationTotal+_pondIndexStations[index][index_station]]);
-				pStation = static_cast<STATION_METEO*>(stations_meteo[_pondIndexStations[index][index_station]]);
-
-				altStation = static_cast<float>(pStation->PrendreCoordonnee().PrendreZ());
-				diff_alt = pZone->PrendreAltitude() - altStation;
+				ponderation = _pondValeur[n];
+				index_station = _pondStation[n];
 
-				donnee_station = pStation->PrendreDonnees(date_courante, pas_de_temps);
+				diff_alt = pZone->PrendreAltitude() - _vStationAltitude[index_station];
 
-				tmin_station = donnee_station.PrendreTMin();
+				tmin_station = _vStationTMin[index_station];
 				if (tmin_station > VALEUR_MANQUANTE)
 				{
 					if(tmin == VALEUR_MANQUANTE)
@@ -189,7 +217,7 @@ namespace HYDROTEL
 					tmin+= (tmin_station + PrendreGradientTemperature(index_zone) * diff_alt / 100.0f) * ponderation;
 				}
 
-				tmax_station = donnee_station.PrendreTMax();
+				tmax_station = _vStationTMax[index_station];
 				if (tmax_station > VALEUR_MANQUANTE)
 				{
 					if(tmax == VALEUR_MANQUANTE)
@@ -198,7 +226,7 @@ namespace HYDROTEL
 					tmax+= (tmax_station + PrendreGradientTemperature(index_zone) * diff_alt / 100.0f) * ponderation;
 				}
 
-				pluie_station = donnee_station.PrendrePluie();
+				pluie_station = _vStationPluie[index_station];
 				if (pluie_station > VALEUR_MANQUANTE)
 				{
 					if(pluie == VALEUR_MANQUANTE)
@@ -212,7 +240,7 @@ namespace HYDROTEL
 					}
 				}
 
-				neige_station = donnee_station.PrendreNeige();
+				neige_station = _vStationNeige[index_station];
 				if (neige_station > VALEUR_MANQUANTE)
 				{
 					if(neige == VALEUR_MANQUANTE)
@@ -226,9 +254,7 @@ namespace HYDROTEL
 					}
 				}
 
-				temp_jour = pStation->PrendreTemperatureJournaliere(date_courante);
-
-				tmin_jour_station = temp_jour.first;
+				tmin_jour_station = _vStationTMinJour[index_station];
 				if (tmin_jour_station > VALEUR_MANQUANTE)
 				{
 					if(tmin_jour == VALEUR_MANQUANTE)
@@ -237,7 +263,7 @@ namespace HYDROTEL
 					tmin_jour+= (tmin_jour_station + PrendreGradientTemperature(index_zone) * diff_alt / 100.0f) * ponderation;
 				}
 
-				tmax_jour_station = temp_jour.second;
+				tmax_jour_station = _vStationTMaxJour[index_station];
 				if (tmax_jour_station > VALEUR_MANQUANTE)
 				{
 					if(tmax_jour == VALEUR_MANQUANTE)
@@ -334,13 +360,22 @@ namespace HYDROTEL
 	
 	
 	bool THIESSEN2::LecturePonderation(STATIONS& stations, ZONES& zones, MATRICE<double>& ponderation)
+	{
+		PONDERATION_CREUSE pond;
+
+		if (!LecturePonderation(stations, zones, pond))
+			return false;
+
+		VersMatrice(pond, stations.PrendreNbStation(), ponderation);
+		return true;
+	}
+
+	bool THIESSEN2::LecturePonderation(STATIONS& stations, ZONES& zones, PONDERATION_CREUSE& ponderation)
 	{
 		STATION* station;
-		vector<size_t> indexStation;
-		double x, y, z;
-		size_t idxZone, index;
+		double x, y, z, valeur;
+		size_t index;
 		string ident;
-		bool bSimule;
 		int ident_zone;
 		
 		string nom_fichier = RemplaceExtension(stations.PrendreNomFichier(), "pth");
@@ -384,12 +419,10 @@ namespace HYDROTEL
 			}
 		}
 
-		MATRICE<double> pond(zones.PrendreNbZone(), stations.PrendreNbStation(), 0.0);
-		vector<size_t> idxZoneSim = _pSim_hyd->PrendreZonesSimules();
-
-		_pondIndexUhrh.clear();
-		_pondIndexStations.clear();
-		_ponderation2 = new double[zones.PrendreNbZone() * nb_station];
+		//lecture ligne par ligne; seules les ponderations non nulles sont conservees
+		ponderation.debut.assign(1, 0);
+		ponderation.station.clear();
+		ponderation.valeur.clear();
 
 		for (ligne = 0; ligne < zones.PrendreNbZone(); ++ligne)
 		{
@@ -401,46 +434,51 @@ namespace HYDROTEL
 				return false;
 			}
 
-			idxZone = zones.IdentVersIndex(ident_zone);
-
-			if(find(begin(idxZoneSim), end(idxZoneSim), idxZone) != end(idxZoneSim))
-			{
-				bSimule = true;
-				indexStation.clear();
-			}
-			else
-				bSimule = false;
-
 			for (colonne = 0; colonne < nb_station; ++colonne)
 			{
-				fichier >> pond(ligne, colonne);
-				
-				_ponderation2[ligne*nb_station+colonne] = pond(ligne, colonne);
+				valeur = 0.0;
+				fichier >> valeur;
 
-				if(bSimule && pond(ligne, colonne) != 0.0)
-					indexStation.push_back(colonne);
+				if (valeur != 0.0)
+				{
+					ponderation.station.push_back(colonne);
+					ponderation.valeur.push_back(valeur);
+				}
 			}
 
-			if(bSimule)
-			{
-				_pondIndexUhrh.push_back(idxZone);
-				_pondIndexStations.push_back(indexStation);
-			}
+			ponderation.debut.push_back(ponderation.station.size());
 		}
 
 		fichier.close();
-
-		ponderation = pond;
 		return true;
 	}
-
-	bool THIESSEN2::LecturePonderation()
-	{
-		return LecturePonderation(_sim_hyd.PrendreStationsMeteo(), _sim_hyd.PrendreZones(), _ponderation);
-	}
 	
 	
 	void THIESSEN2::SauvegardePonderation(STATIONS& stations, ZONES& zones, MATRICE<double>& ponderation)
+	{
+		PONDERATION_CREUSE pond;
+		size_t i, j;
+
+		pond.debut.assign(1, 0);
+
+		for (i = 0; i < ponderation.PrendreNbLigne(); ++i)
+		{
+			for (j = 0; j < ponderation.PrendreNbColonne(); ++j)
+			{
+				if (ponderation(i, j) != 0.0)
+				{
+					pond.station.push_back(j);
+					pond.valeur.push_back(ponderation(i, j));
+				}
+			}
+
+			pond.debut.push_back(pond.station.size());
+		}
+
+		SauvegardePonderation(stations, zones, pond);
+	}
+
+	void THIESSEN2::SauvegardePonderation(STATIONS& stations, ZONES& zones, const PONDERATION_CREUSE& ponderation)
 	{
 		string nom_fichier = RemplaceExtension(stations.PrendreNomFichier(), "pth");
 
@@ -463,12 +501,20 @@ namespace HYDROTEL
 				    << coordonnee.PrendreZ() << endl;
 		}
 
+		//le fichier garde le format complet [zone, station]; les valeurs absentes de la ligne sont nulles
 		for (size_t index = 0; index < zones.PrendreNbZone(); ++index)
 		{
 			fichier << zones[index].PrendreIdent() << ' ';
 
-			for (size_t n = 0; n < nb_station; ++n)			
-				fichier << ponderation(index, n) << ' ';
+			size_t k = ponderation.debut[index];
+
+			for (size_t n = 0; n < nb_station; ++n)
+			{
+				if (k < ponderation.debut[index + 1] && ponderation.station[k] == n)
+					fichier << ponderation.valeur[k++] << ' ';
+				else
+					fichier << 0.0 << ' ';
+			}
 			
 			fichier << endl;
 		}
@@ -476,20 +522,23 @@ namespace HYDROTEL
 		fichier.close();
 	}
 	
-	void THIESSEN2::SauvegardePonderation()
-	{
-		SauvegardePonderation(_sim_hyd.PrendreStationsMeteo(), _sim_hyd.PrendreZones(), _ponderation);
-	}
-	
 	
 	void THIESSEN2::CalculePonderation(STATIONS& stations, ZONES& zones, MATRICE<double>& ponderation, string sOrigin)
+	{
+		PONDERATION_CREUSE pond;
+
+		CalculePonderation(stations, zones, pond, sOrigin);
+		VersMatrice(pond, stations.PrendreNbStation(), ponderation);
+	}
+
+	void THIESSEN2::CalculePonderation(STATIONS& stations, ZONES& zones, PONDERATION_CREUSE& ponderation, string sOrigin)
 	{
 		vector<double> uhrhPondValue;
 		vector<size_t> index_stations;
-		COORDONNEE coordonnee;
-		size_t i, j, nbStation, idxNearestStation, idx, index, nbZone;
-		bool bSimule;
-		int ligne, colonne, ident, iNoData;
+		vector<size_t> vNearestStation;
+		vector<map<size_t, double>> vPondZone;
+		size_t nbStation, idxNearestStation, idx, index, nbZone;
+		int ligne, ligneFin, colonne, ident, iNoData, nbThread, nbLigneBloc;
 
 		nbStation = stations.PrendreNbStation();
 		if (nbStation < 1)
@@ -502,16 +551,8 @@ namespace HYDROTEL
 		
 		TRANSFORME_COORDONNEE trans_coord(stations.PrendreProjection(), grille.PrendreProjection());
 
-		MATRICE<double> pond(zones.PrendreNbZone(), nbStation, 0.0);
-		
-		vector<size_t> idxZoneSim = _pSim_hyd->PrendreZonesSimules();		
-
-		vector<size_t> indexStation;
-
-		_pondIndexUhrh.clear();
-		_pondIndexStations.clear();
-
-		_ponderation2 = new double[zones.PrendreNbZone() * nbStation];
+		//ponderations non nulles de chaque zone [station]
+		vPondZone.resize(nbZone);
 
 		vector<COORDONNEE> coordonnees(nbStation);
 		for (index = 0; index < nbStation; index++)
@@ -535,66 +576,145 @@ namespace HYDROTEL
 		if(_pSim_hyd->_bLogPerf)
 			_pSim_hyd->_logPerformance.AddStep("Computing stations/rhhu weightings (thiessen)");
 
-		for (ligne=0; ligne!=nb_ligne; ligne++)
+		//recherche de la station la plus proche de chaque pixel (arbre k-d), par bloc de lignes en parallele;
+		//le cumul des ponderations est fait dans l'ordre des pixels pour conserver les memes resultats
+		ARBRE_KD arbre(coordonnees);
+
+		nbThread = _pSim_hyd->PrendreNbThread();
+		nbLigneBloc = max(1, nbThread * 16);
+
+		vNearestStation.resize(static_cast<size_t>(min(nbLigneBloc, max(nb_ligne, 1))) * static_cast<size_t>(nb_colonne));
+
+		for (int ligneDebut=0; ligneDebut<nb_ligne; ligneDebut+= nbLigneBloc)
 		{
-			for (colonne=0; colonne!=nb_colonne; colonne++)
+			ligneFin = min(ligneDebut + nbLigneBloc, nb_ligne);
+
+			#pragma omp parallel for num_threads(nbThread) schedule(dynamic) if(nbThread > 1)
+			for (int l=ligneDebut; l<ligneFin; l++)
 			{
-				ident = grille(ligne, colonne);
+				size_t offset = static_cast<size_t>(l - ligneDebut) * static_cast<size_t>(nb_colonne);
 
-				if(ident != iNoData)
+				for (int c=0; c<nb_colonne; c++)
 				{
-					coordonnee = grille.LigColVersCoordonnee(ligne, colonne);
-					
-					idxNearestStation = GetIndexNearestCoord(coordonnees, coordonnee);
-					idx = zones._vIdentVersIndex[abs(ident)];
-
-					pond(idx, idxNearestStation)+= uhrhPondValue[idx];
+					if(grille(l, c) != iNoData)
+						vNearestStation[offset + c] = arbre.PrendreIndexPlusProche(grille.LigColVersCoordonnee(l, c));
 				}
+			}
+
+			for (ligne=ligneDebut; ligne<ligneFin; ligne++)
+			{
+				for (colonne=0; colonne!=nb_colonne; colonne++)
+				{
+					ident = grille(ligne, colonne);
+
+					if(ident != iNoData)
+					{
+						idxNearestStation = vNearestStation[static_cast<size_t>(ligne - ligneDebut) * static_cast<size_t>(nb_colonne) + colonne];
+						idx = zones._vIdentVersIndex[abs(ident)];
 
-				//if(bDisplay)
-				//{
-				//	++pixelEnCours;
-				//	std::cout << "pixel " << pixelEnCours << "/" << nbPixelTotal << '\r' << std::flush;
-				//}
+						vPondZone[idx][idxNearestStation]+= uhrhPondValue[idx];
+					}
+				}
 			}
 		}
 
-		for(i=0; i!=pond.PrendreNbLigne(); i++)
+		//lignes creuses [zone], colonnes en ordre de station
+		ponderation.debut.assign(1, 0);
+		ponderation.station.clear();
+		ponderation.valeur.clear();
+
+		for (idx=0; idx!=nbZone; idx++)
 		{
-			if(find(begin(idxZoneSim), end(idxZoneSim), i) != end(idxZoneSim))
+			for (auto& pond_station : vPondZone[idx])
 			{
-				bSimule = true;
-				indexStation.clear();
+				ponderation.station.push_back(pond_station.first);
+				ponderation.valeur.push_back(pond_station.second);
 			}
-			else
-				bSimule = false;
 
-			for(j=0; j<pond.PrendreNbColonne(); j++)
-			{
-				//pond(i, j)/= zones[i].PrendreNbPixel();
-				
-				_ponderation2[i*nbStation+j] = pond(i, j);
+			ponderation.debut.push_back(ponderation.station.size());
+		}
+
+		if(_pSim_hyd->_bLogPerf)
+			_pSim_hyd->_logPerformance.AddStep("Completed");
+	}
+
+
+	void THIESSEN2::VersMatrice(const PONDERATION_CREUSE& pond, size_t nbStation, MATRICE<double>& ponderation)
+	{
+		MATRICE<double> dense(pond.debut.size() - 1, nbStation, 0.0);
+
+		for (size_t i=0; i!=pond.debut.size()-1; i++)
+		{
+			for (size_t k=pond.debut[i]; k!=pond.debut[i+1]; k++)
+				dense(i, pond.station[k]) = pond.valeur[k];
+		}
 
-				if(bSimule && pond(i, j) != 0.0)
-					indexStation.push_back(j);
+		ponderation.swap(dense);
+	}
+
+
+	void THIESSEN2::ConstruitPonderationCreuse(const PONDERATION_CREUSE& pond)
+	{
+		vector<size_t> vIndexUtilisee;
+		vector<bool> vSimule;
+		size_t i, j, k, nbZone, nbStation;
+
+		nbZone = pond.debut.size() - 1;
+		nbStation = _sim_hyd.PrendreStationsMeteo().PrendreNbStation();
+
+		vSimule.assign(nbZone, false);
+		for(i=0; i!=_pSim_hyd->PrendreZonesSimules().size(); i++)
+		{
+			if(_pSim_hyd->PrendreZonesSimules()[i] < vSimule.size())
+				vSimule[_pSim_hyd->PrendreZonesSimules()[i]] = true;
+		}
+
+		//stations utilisees par au moins une zone simulee
+		vIndexUtilisee.assign(nbStation, static_cast<size_t>(-1));
+		_vStationUtilisee.clear();
+
+		for(i=0; i!=nbZone; i++)
+		{
+			if(vSimule[i])
+			{
+				for(k=pond.debut[i]; k!=pond.debut[i+1]; k++)
+					vIndexUtilisee[pond.station[k]] = 0;
 			}
+		}
 
-			if(bSimule)
+		for(j=0; j<nbStation; j++)
+		{
+			if(vIndexUtilisee[j] != static_cast<size_t>(-1))
 			{
-				_pondIndexUhrh.push_back(i);
-				_pondIndexStations.push_back(indexStation);
+				vIndexUtilisee[j] = _vStationUtilisee.size();
+				_vStationUtilisee.push_back(j);
 			}
 		}
 
-		ponderation = pond;
+		//lignes des zones simulees
+		_pondZone.clear();
+		_pondDebut.clear();
+		_pondStation.clear();
+		_pondValeur.clear();
 
-		if(_pSim_hyd->_bLogPerf)
-			_pSim_hyd->_logPerformance.AddStep("Completed");
-	}
+		for(i=0; i!=nbZone; i++)
+		{
+			if(vSimule[i])
+			{
+				_pondZone.push_back(i);
+				_pondDebut.push_back(_pondStation.size());
 
-	void THIESSEN2::CalculePonderation()
-	{
-		CalculePonderation(_sim_hyd.PrendreStationsMeteo(), _sim_hyd.PrendreZones(), _ponderation, "THIESSEN2");
+				for(k=pond.debut[i]; k!=pond.debut[i+1]; k++)
+				{
+					_pondStation.push_back(vIndexUtilisee[pond.station[k]]);
+					_pondValeur.push_back(static_cast<float>(pond.valeur[k]));
+				}
+			}
+		}
+
+		_pondDebut.push_back(_pondStation.size());
+
+		_vStationAltitude.clear();
 	}
 
 
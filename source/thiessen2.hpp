@@ -83,20 +83,42 @@ namespace HYDROTEL
 		//internal variable
 		SIM_HYD*							_pSim_hyd;
 
-		std::vector<size_t>					_pondIndexUhrh;
-		std::vector<std::vector<size_t>>	_pondIndexStations;
+		//ponderations non nulles des zones simulees (matrice creuse CSR [zone simulee, station utilisee])
+		std::vector<size_t>					_pondZone;				//[ligne] index de la zone
+		std::vector<size_t>					_pondDebut;				//[ligne + 1] debut de la ligne dans _pondStation et _pondValeur
+		std::vector<size_t>					_pondStation;			//index dans _vStationUtilisee
+		std::vector<float>					_pondValeur;
 
-		double*								_ponderation2;
+		std::vector<size_t>					_vStationUtilisee;		//index des stations ayant une ponderation non nulle pour au moins une zone simulee
 		
 	private:
-		bool LecturePonderation();
-		void CalculePonderation();
-		void SauvegardePonderation();
+		//ponderations non nulles de toutes les zones (une ligne par zone, colonnes en ordre de station)
+		struct PONDERATION_CREUSE
+		{
+			std::vector<size_t>	debut;		//[zone + 1] debut de la ligne dans station et valeur
+			std::vector<size_t>	station;	//index de la station
+			std::vector<double>	valeur;
+		};
+
+		bool LecturePonderation(STATIONS& stations, ZONES& zones, PONDERATION_CREUSE& ponderation);
+		void CalculePonderation(STATIONS& stations, ZONES& zones, PONDERATION_CREUSE& ponderation, std::string sOrigin);
+		void SauvegardePonderation(STATIONS& stations, ZONES& zones, const PONDERATION_CREUSE& ponderation);
+
+		void VersMatrice(const PONDERATION_CREUSE& pond, size_t nbStation, MATRICE<double>& ponderation);
+
+		void ConstruitPonderationCreuse(const PONDERATION_CREUSE& pond);
 
 		void RepartieDonnees();
 		void PassagePluieNeige();
 
-		MATRICE<double>				_ponderation;
+		//valeurs du pas de temps courant des stations utilisees [index dans _vStationUtilisee]
+		std::vector<float>			_vStationAltitude;
+		std::vector<float>			_vStationTMin;
+		std::vector<float>			_vStationTMax;
+		std::vector<float>			_vStationPluie;
+		std::vector<float>			_vStationNeige;
+		std::vector<float>			_vStationTMinJour;
+		std::vector<float>			_vStationTMaxJour;
 	};
 
 }
@@ -21,6 +21,7 @@
 #include "thorsen.hpp"
 
 #include "erreur.hpp"
+#include "etat_binaire.hpp"
 #include "util.hpp"
 #include "version.hpp"
 #include "bilan_vertical.hpp"
@@ -72,6 +73,7 @@ namespace HYDROTEL
 		size_t index, index_zone;
 
 		ZONES& zones = _sim_hyd.PrendreZones();
+		ETAT_ZONES& etat_zones = zones.PrendreEtat();
 		vector<size_t> index_zones = _sim_hyd.PrendreZonesSimules();
 
 		//valeurs initiales profondeur du gel
@@ -85,9 +87,9 @@ namespace HYDROTEL
 
 			//ds le cas ou les theta sont disponible (ex bv3c), les valeurs seront ecras par bv3c (egalement la valeur initiale..)
 			//utilise theta ini de bv3c la 1ere fois, ensuite utilise la valeur calcul pour le jour prcdent (le modele temp sol est appel avant le modele bilanvertical)
-			zones[index_zone]._theta1 = _fTeneurEau;
-			zones[index_zone]._theta2 = _fTeneurEau;
-			zones[index_zone]._theta3 = _fTeneurEau;
+			etat_zones._theta1[index_zone] = _fTeneurEau;
+			etat_zones._theta2[index_zone] = _fTeneurEau;
+			etat_zones._theta3[index_zone] = _fTeneurEau;
 		}
 
 		if (!_nom_fichier_lecture_etat.empty())
@@ -100,6 +102,7 @@ namespace HYDROTEL
 	void THORSEN::Calcule()
 	{
 		ZONES& zones = _sim_hyd.PrendreZones();
+		ETAT_ZONES& etat_zones = zones.PrendreEtat();
 		vector<size_t> index_zones = _sim_hyd.PrendreZonesSimules();
 		PROPRIETE_HYDROLIQUES& propriete_hydroliques = _sim_hyd.PrendreProprieteHydrotliques();
 		unsigned short pas_de_temps = _sim_hyd.PrendrePasDeTemps();
@@ -151,12 +154,12 @@ namespace HYDROTEL
 			if(fProfondeurGel > zones[index_zone].PrendreZ11())	//la valeur pour theta est la valeur par defaut (_fTeneurEau) ou celle simule par bv3c le cas echeant
 			{
 				if(fProfondeurGel > zones[index_zone].PrendreZ11() + zones[index_zone].PrendreZ22())
-					fTheta = zones[index_zone]._theta3;
+					fTheta = etat_zones._theta3[index_zone];
 				else
-					fTheta = zones[index_zone]._theta2;
+					fTheta = etat_zones._theta2[index_zone];
 			}
 			else
-				fTheta = zones[index_zone]._theta1;
+				fTheta = etat_zones._theta1[index_zone];
 
 			if(fTheta < 0.1f)
 				fTheta = 0.1f;
@@ -467,6 +470,25 @@ namespace HYDROTEL
 
 	void THORSEN::LectureEtat(DATE_HEURE date_courante)
 	{
+		TRACE_PERFORMANCE trace("THORSEN::LectureEtat");
+
+		if(ETAT_BINAIRE::EstBinaire(_nom_fichier_lecture_etat))
+		{
+			ETAT_BINAIRE etat;
+			etat.Lecture(_nom_fichier_lecture_etat, 1);
+
+			ZONES& zones = _sim_hyd.PrendreZones();
+			vector<size_t> index_ligne = etat.AssocieIndex(zones, _sim_hyd.PrendreZonesSimules(), "TEMPERATURE DU SOL; fichier etat THORSEN");
+
+			for(size_t ligne=0; ligne<index_ligne.size(); ligne++)
+			{
+				if(index_ligne[ligne] != string::npos)
+					zones[index_ligne[ligne]].ChangeProfondeurGel(static_cast<float>(etat.PrendreLigne(ligne)[0])); //cm
+			}
+
+			return;
+		}
+
 		ifstream fichier(_nom_fichier_lecture_etat);
 		if (!fichier)
 			throw ERREUR_LECTURE_FICHIER("TEMPERATURE DU SOL; fichier etat THORSEN; " + _nom_fichier_lecture_etat);
@@ -512,6 +534,8 @@ namespace HYDROTEL
 
 	void THORSEN::SauvegardeEtat(DATE_HEURE date_courante) const
 	{
+		TRACE_PERFORMANCE trace("THORSEN::SauvegardeEtat");
+
 		BOOST_ASSERT(_repertoire_ecriture_etat.size() != 0);
 
 		date_courante.AdditionHeure( _sim_hyd.PrendrePasDeTemps() );
@@ -532,7 +556,21 @@ namespace HYDROTEL
 			        << setw(2) << date_courante.PrendreMois() 
 			        << setw(2) << date_courante.PrendreJour() 
 			        << setw(2) << date_courante.PrendreHeure() 
-					<< ".csv";
+					<< _sim_hyd._output.ExtensionFichiersEtats();
+
+		if(_sim_hyd._output._bFichiersEtatsBinaire)
+		{
+			ZONES& zones = _sim_hyd.PrendreZones();
+			ETAT_BINAIRE etat;
+
+			etat.Initialise(PrendreNomSousModele(), date_courante, { "Profondeur du gel (cm)" }, _sim_hyd.PrendreZonesSimules().size());
+
+			for(size_t index_zone : _sim_hyd.PrendreZonesSimules())
+				etat.AjouteLigne(zones[index_zone].PrendreIdent())[0] = zones[index_zone].PrendreProfondeurGel();
+
+			etat.Sauvegarde(nom_fichier.str());
+			return;
+		}
 
 		ofstream fichier(nom_fichier.str());
 		if (!fichier)
@@ -568,4 +606,15 @@ namespace HYDROTEL
 		fichier.close();
 	}
 
+
+	void THORSEN::SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const
+	{
+		etat.Ecrit(_bFirstTime);
+	}
+
+	void THORSEN::LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur)
+	{
+		lecteur.Lit(_bFirstTime);
+	}
+
 }
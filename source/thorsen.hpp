@@ -45,6 +45,10 @@ namespace HYDROTEL
 
 		virtual void SauvegardeParametres();
 
+		virtual void SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const;
+
+		virtual void LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur);
+
 		//variables d'etats
 
 		void		ChangeNomFichierLectureEtat(std::string nom_fichier);
@@ -200,4 +200,50 @@ namespace HYDROTEL
 		return _debit_aval_moyen;
 	}
 
+	void TRONCON::SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const
+	{
+		etat.Ecrit(_hauteurAvalMoy);
+
+		etat.Ecrit(_surf);
+		etat.Ecrit(_hypo);
+		etat.Ecrit(_base);
+
+		etat.Ecrit(_prPrelevementTotal);
+		etat.Ecrit(_prPrelevementCulture);
+		etat.Ecrit(_prRejetTotal);
+		etat.Ecrit(_prRejetEffluent);
+		etat.Ecrit(_prIndicePression);
+
+		etat.Ecrit(_debit_aval_7jrs);
+
+		etat.Ecrit(_apport_lateral);
+		etat.Ecrit(_debit_aval);
+		etat.Ecrit(_debit_amont);
+		etat.Ecrit(_debit_amont_moyen);
+		etat.Ecrit(_debit_aval_moyen);
+	}
+
+	void TRONCON::LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur)
+	{
+		lecteur.Lit(_hauteurAvalMoy);
+
+		lecteur.Lit(_surf);
+		lecteur.Lit(_hypo);
+		lecteur.Lit(_base);
+
+		lecteur.Lit(_prPrelevementTotal);
+		lecteur.Lit(_prPrelevementCulture);
+		lecteur.Lit(_prRejetTotal);
+		lecteur.Lit(_prRejetEffluent);
+		lecteur.Lit(_prIndicePression);
+
+		lecteur.Lit(_debit_aval_7jrs);
+
+		lecteur.Lit(_apport_lateral);
+		lecteur.Lit(_debit_aval);
+		lecteur.Lit(_debit_amont);
+		lecteur.Lit(_debit_amont_moyen);
+		lecteur.Lit(_debit_aval_moyen);
+	}
+
 }
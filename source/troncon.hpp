@@ -24,6 +24,7 @@
 
 #include "types.hpp"
 #include "noeud.hpp"
+#include "etat_memoire.hpp"
 
 #include <string>
 #include <vector>
@@ -101,6 +102,12 @@ namespace HYDROTEL
 		void ChangeDebitAmont(float debit);
 		void ChangeDebitAmontMoyen(float debitMoyen);
 
+		// copie les variables de simulation (debits, apports, prelevements) dans l'etat en memoire
+		void SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const;
+
+		// restaure les variables de simulation
+		void LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur);
+
 		double	_hauteurAvalMoy;			//hauteur d'eau en aval du troncon (moyenne des pas de temps interne)	//m
 
 		float	_surf;
@@ -809,4 +809,16 @@ namespace HYDROTEL
 		throw ERREUR("ident troncon introuvable");
 	}
 
+	void TRONCONS::SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const
+	{
+		for (size_t index = 0; index != _troncons.size(); ++index)
+			_troncons[index]->SauvegardeEtatMemoire(etat);
+	}
+
+	void TRONCONS::LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur)
+	{
+		for (size_t index = 0; index != _troncons.size(); ++index)
+			_troncons[index]->LectureEtatMemoire(lecteur);
+	}
+
 }
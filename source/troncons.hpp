@@ -75,6 +75,12 @@ namespace HYDROTEL
 		/// retourne l'index d'un troncon
 		size_t IdentVersIndex(int ident) const;
 
+		/// copie les variables de simulation de tous les troncons dans l'etat en memoire
+		void SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const;
+
+		/// restaure les variables de simulation de tous les troncons
+		void LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur);
+
 		void CalculeShreve();
 		void CalculeStrahler();
 
@@ -23,8 +23,10 @@
 #include "erreur.hpp"
 #include "gdal_util.hpp"
 
+#include <algorithm>
 #include <fstream>
 #include <memory>
+#include <numeric>
 #include <sstream>
 #include <string>
 #include <iostream>
@@ -708,9 +710,7 @@ namespace HYDROTEL
 		vector<double> vDistance;
 		vector<size_t> vIndex;
 		double distance;
-		size_t index, nbCoord, i, j, indexTemp;
-
-		indexTemp = 0;
+		size_t index, nbCoord;
 
 		nbCoord = coordonnees.size();
 
@@ -721,32 +721,11 @@ namespace HYDROTEL
 			vDistance.push_back(distance);
 		}
 
-		//trie en ordre croissant du plus pres au plus loin
-		while(vIndex.size() != nbCoord)
-		{
-			distance = -1.0;
-
-			for(i=0; i!=nbCoord; i++)
-			{
-				//verifie si l'index a deja ete ajoute
-				for(j=0; j!=vIndex.size(); j++)
-				{
-					if(i == vIndex[j])
-						break;
-				}
+		//trie en ordre croissant du plus pres au plus loin; a distance egale, l'ordre des index est conserve
+		vIndex.resize(nbCoord);
+		iota(vIndex.begin(), vIndex.end(), static_cast<size_t>(0));
 
-				if(j == vIndex.size())	//l'index n'a pas ete trouve dans vIndex
-				{
-					if(distance == -1.0 || distance > vDistance[i])
-					{
-						distance = vDistance[i];
-						indexTemp = i;
-					}
-				}				
-			}
-
-			vIndex.push_back(indexTemp);
-		}
+		stable_sort(vIndex.begin(), vIndex.end(), [&vDistance](size_t a, size_t b) { return vDistance[a] < vDistance[b]; });
 
 		return vIndex;
 	}
@@ -30,10 +30,7 @@ namespace HYDROTEL
 {
 
 	ZONE::ZONE()
-		: _theta1(VALEUR_MANQUANTE)
-		, _theta2(VALEUR_MANQUANTE)
-		, _theta3(VALEUR_MANQUANTE)
-		, _prJourIrrigation(false)
+		: _prJourIrrigation(false)
 		, _type_zone_original(SOUS_BASSIN)
 		, _ident(-1)
 		, _type_zone(SOUS_BASSIN)
@@ -44,31 +41,16 @@ namespace HYDROTEL
 		, _orientation(ORIENTATION_AUCUNE)
 		, _centroide()
 		, _troncon_aval(nullptr)
-		, _tmin(VALEUR_MANQUANTE)
-		, _tmax(VALEUR_MANQUANTE)
-		, _pluie(VALEUR_MANQUANTE)
-		, _neige(VALEUR_MANQUANTE)
+		, _etat(nullptr)
+		, _index(0)
 		, _vitesse_vent(VALEUR_MANQUANTE)
 		, _humidite_relative(VALEUR_MANQUANTE)
 		, _nb_heure_soleil(VALEUR_MANQUANTE)
-		, _tmin_jour(VALEUR_MANQUANTE)
-		, _tmax_jour(VALEUR_MANQUANTE)
-		, _etp()
 		, _iga(VALEUR_MANQUANTE)
 		, _hp(VALEUR_MANQUANTE)
 		, _indice_radiation(VALEUR_MANQUANTE)
-		, _couvert_nival(0.0f)
-		, _hauteur_couvert_nival(0.0f)
-		, _albedo_neige(0.0f)
-		, _apport(0.0f)
 		, _apport_glacier(0.0)
 		, _eau_glacier(0.0)
-		, _etr1(VALEUR_MANQUANTE)
-		, _etr2(VALEUR_MANQUANTE)
-		, _etr3(VALEUR_MANQUANTE)
-		, _surf(VALEUR_MANQUANTE)
-		, _hypo(VALEUR_MANQUANTE)
-		, _base(VALEUR_MANQUANTE)
 		, _infiltration(VALEUR_MANQUANTE)
 		, _profondeurGel(VALEUR_MANQUANTE)
 	{
@@ -76,7 +58,6 @@ namespace HYDROTEL
 		_dDureeJour = dVALEUR_MANQUANTE;
 		_dIndiceRadiation = dVALEUR_MANQUANTE;
 		_reservoirAquifer = 0.0f;
-		_apport_lateral_uhrh = VALEUR_MANQUANTE;
 	}
 
 	ZONE::~ZONE()
@@ -120,33 +101,33 @@ namespace HYDROTEL
 
 	float ZONE::PrendreTMin() const
 	{
-		return _tmin;
+		return _etat->_tmin[_index];
 	}
 
 	float ZONE::PrendreTMax() const
 	{
-		return _tmax;
+		return _etat->_tmax[_index];
 	}
 
 	float ZONE::PrendreTMinJournaliere() const
 	{
-		return _tmin_jour;
+		return _etat->_tmin_jour[_index];
 	}
 
 	float ZONE::PrendreTMaxJournaliere() const
 	{
-		return _tmax_jour;
+		return _etat->_tmax_jour[_index];
 	}
 
 
 	float ZONE::PrendrePluie() const
 	{
-		return _pluie;
+		return _etat->_pluie[_index];
 	}
 
 	float ZONE::PrendreNeige() const
 	{
-		return _neige;
+		return _etat->_neige[_index];
 	}
 
 	float ZONE::PrendreVitesseVent() const
@@ -250,27 +231,27 @@ namespace HYDROTEL
 	{
 		BOOST_ASSERT(tmin <= tmax);
 
-		_tmin = tmin;
-		_tmax = tmax;
+		_etat->_tmin[_index] = tmin;
+		_etat->_tmax[_index] = tmax;
 	}
 
 	void ZONE::ChangeTemperatureJournaliere(float tmin, float tmax)
 	{
 		BOOST_ASSERT(tmin <= tmax);
-		_tmin_jour = tmin;
-		_tmax_jour = tmax;
+		_etat->_tmin_jour[_index] = tmin;
+		_etat->_tmax_jour[_index] = tmax;
 	}
 
 	void ZONE::ChangePluie(float pluie)
 	{
 		BOOST_ASSERT(pluie >= 0);
-		_pluie = pluie;
+		_etat->_pluie[_index] = pluie;
 	}
 
 	void ZONE::ChangeNeige(float neige)
 	{
 		BOOST_ASSERT(neige >= 0);
-		_neige = neige;
+		_etat->_neige[_index] = neige;
 	}
 
 	void ZONE::ChangeTronconAval(TRONCON* troncon_aval)
@@ -281,13 +262,13 @@ namespace HYDROTEL
 
 	void ZONE::ChangeNbEtp(size_t nb_classe)
 	{
-		_etp.resize(nb_classe, VALEUR_MANQUANTE);
+		_etat->ChangeNbClasseEtp(nb_classe);
 	}
 
 	void ZONE::ChangeEtp(size_t index, float etp)	//(mm)
 	{
-		BOOST_ASSERT(index < _etp.size() && etp >= 0);
-		_etp[index] = etp;
+		BOOST_ASSERT(index < _etat->PrendreNbClasseEtp() && etp >= 0);
+		_etat->_etp[_index * _etat->PrendreNbClasseEtp() + index] = etp;
 	}
 
 	COORDONNEE ZONE::PrendreCentroide() const
@@ -327,22 +308,22 @@ namespace HYDROTEL
 
 	float ZONE::PrendreCouvertNival() const
 	{
-		return _couvert_nival;			//equivalent en eau	//mm
+		return _etat->_couvert_nival[_index];			//equivalent en eau	//mm
 	}
 
 	float ZONE::PrendreHauteurCouvertNival() const
 	{
-		return _hauteur_couvert_nival;	//m
+		return _etat->_hauteur_couvert_nival[_index];	//m
 	}
 
 	float ZONE::PrendreAlbedoNeige() const
 	{
-		return _albedo_neige;
+		return _etat->_albedo_neige[_index];
 	}
 
 	float ZONE::PrendreApport() const
 	{
-		return _apport;
+		return _etat->_apport[_index];
 	}
 
 	double ZONE::PrendreApportGlacier() const
@@ -357,10 +338,13 @@ namespace HYDROTEL
 
 	float ZONE::PrendreEtpTotal() const
 	{
+		const size_t nb_classe = _etat->PrendreNbClasseEtp();
+		const float* debut = _etat->_etp.data() + _index * nb_classe;
+
 		float etp = 0;
 		size_t n = 0;
 
-		for (auto iter = begin(_etp); iter != end(_etp); ++iter)
+		for (auto iter = debut; iter != debut + nb_classe; ++iter)
 		{
 			if (*iter > VALEUR_MANQUANTE)
 			{
@@ -377,22 +361,22 @@ namespace HYDROTEL
 
 	float ZONE::PrendreEtr1() const
 	{
-		return _etr1;
+		return _etat->_etr1[_index];
 	}
 
 	float ZONE::PrendreEtr2() const
 	{
-		return _etr2;
+		return _etat->_etr2[_index];
 	}
 
 	float ZONE::PrendreEtr3() const
 	{
-		return _etr3;
+		return _etat->_etr3[_index];
 	}
 
 	float ZONE::PrendreEtrTotal() const
 	{
-		float total = _etr1 + _etr2 + _etr3;
+		float total = _etat->_etr1[_index] + _etat->_etr2[_index] + _etat->_etr3[_index];
 		
 		if (total == (-999.0f * 3))
 			total = -999.0f;
@@ -403,28 +387,63 @@ namespace HYDROTEL
 	//Retourne l'ETP pour la classe d'occupation du sol [mm]
 	float ZONE::PrendreEtp(size_t index) const
 	{
-		BOOST_ASSERT(index < _etp.size());
-		return _etp[index];
+		BOOST_ASSERT(index < _etat->PrendreNbClasseEtp());
+		return _etat->_etp[_index * _etat->PrendreNbClasseEtp() + index];
 	}
 
 	float ZONE::PrendreProdSurf() const
 	{
-		return _surf;
+		return _etat->_surf[_index];
 	}
 
 	float ZONE::PrendreProdHypo() const
 	{
-		return _hypo;
+		return _etat->_hypo[_index];
 	}
 
 	float ZONE::PrendreProdBase() const
 	{
-		return _base;
+		return _etat->_base[_index];
 	}
 
 	float ZONE::PrendreProductionTotal() const
 	{
-		return _surf + _hypo + _base;
+		return _etat->_surf[_index] + _etat->_hypo[_index] + _etat->_base[_index];
+	}
+
+	float ZONE::PrendreTheta1() const
+	{
+		return _etat->_theta1[_index];
+	}
+
+	float ZONE::PrendreTheta2() const
+	{
+		return _etat->_theta2[_index];
+	}
+
+	float ZONE::PrendreTheta3() const
+	{
+		return _etat->_theta3[_index];
+	}
+
+	float ZONE::PrendreEcoulementSurf() const
+	{
+		return _etat->_ecoulement_surf[_index];
+	}
+
+	float ZONE::PrendreEcoulementHypo() const
+	{
+		return _etat->_ecoulement_hypo[_index];
+	}
+
+	float ZONE::PrendreEcoulementBase() const
+	{
+		return _etat->_ecoulement_base[_index];
+	}
+
+	float ZONE::PrendreApportLateralUhrh() const
+	{
+		return _etat->_apport_lateral_uhrh[_index];
 	}
 
 	float ZONE::PrendreZ11() const	//epaisseur [m]
@@ -450,24 +469,24 @@ namespace HYDROTEL
 	void ZONE::ChangeCouvertNival(float couvert_nival)
 	{
 		BOOST_ASSERT(couvert_nival >= 0);
-		_couvert_nival = couvert_nival;		//equivalent de la neige en eau //mm
+		_etat->_couvert_nival[_index] = couvert_nival;		//equivalent de la neige en eau //mm
 	}
 
 	void ZONE::ChangeHauteurCouvertNival(float hauteur_couvert_nival)
 	{
 		BOOST_ASSERT(hauteur_couvert_nival >= 0);
-		_hauteur_couvert_nival = hauteur_couvert_nival;	//m
+		_etat->_hauteur_couvert_nival[_index] = hauteur_couvert_nival;	//m
 	}
 
 	void ZONE::ChangeAlbedoNeige(float albedo_neige)
 	{
-		_albedo_neige = albedo_neige;
+		_etat->_albedo_neige[_index] = albedo_neige;
 	}
 
 	void ZONE::ChangeApport(float apport)
 	{
 		BOOST_ASSERT(apport >= 0);
-		_apport = apport;
+		_etat->_apport[_index] = apport;
 	}
 
 	void ZONE::ChangeApportGlacier(double dApportGlacier)
@@ -485,37 +504,72 @@ namespace HYDROTEL
 	void ZONE::ChangeEtr1(float etr)
 	{
 		BOOST_ASSERT(etr >= 0);
-		_etr1 = etr;
+		_etat->_etr1[_index] = etr;
 	}
 
 	void ZONE::ChangeEtr2(float etr)
 	{
 		BOOST_ASSERT(etr >= 0);
-		_etr2 = etr;
+		_etat->_etr2[_index] = etr;
 	}
 
 	void ZONE::ChangeEtr3(float etr)
 	{
 		BOOST_ASSERT(etr >= 0);
-		_etr3 = etr;
+		_etat->_etr3[_index] = etr;
 	}
 
 	void ZONE::ChangeProdSurf(float surf)
 	{
 		BOOST_ASSERT(surf >= 0);
-		_surf = surf;
+		_etat->_surf[_index] = surf;
 	}
 
 	void ZONE::ChangeProdHypo(float hypo)
 	{
 		BOOST_ASSERT(hypo >= 0);
-		_hypo = hypo;
+		_etat->_hypo[_index] = hypo;
 	}
 
 	void ZONE::ChangeProdBase(float base)
 	{
 		BOOST_ASSERT(base >= 0);
-		_base = base;
+		_etat->_base[_index] = base;
+	}
+
+	void ZONE::ChangeTheta1(float theta)
+	{
+		_etat->_theta1[_index] = theta;
+	}
+
+	void ZONE::ChangeTheta2(float theta)
+	{
+		_etat->_theta2[_index] = theta;
+	}
+
+	void ZONE::ChangeTheta3(float theta)
+	{
+		_etat->_theta3[_index] = theta;
+	}
+
+	void ZONE::ChangeEcoulementSurf(float ecoulement)
+	{
+		_etat->_ecoulement_surf[_index] = ecoulement;
+	}
+
+	void ZONE::ChangeEcoulementHypo(float ecoulement)
+	{
+		_etat->_ecoulement_hypo[_index] = ecoulement;
+	}
+
+	void ZONE::ChangeEcoulementBase(float ecoulement)
+	{
+		_etat->_ecoulement_base[_index] = ecoulement;
+	}
+
+	void ZONE::ChangeApportLateralUhrh(float apport)
+	{
+		_etat->_apport_lateral_uhrh[_index] = apport;
 	}
 
 	void ZONE::ChangeInfiltration(float infiltration)
@@ -544,4 +598,78 @@ namespace HYDROTEL
 		_profondeurGel = static_cast<float>(iVal) / 10.0f;
 	}
 
+	void ZONE::ChangeEtat(ETAT_ZONES* etat, size_t index)
+	{
+		BOOST_ASSERT(etat != nullptr && index < etat->PrendreNbZone());
+
+		_etat = etat;
+		_index = index;
+	}
+
+	void ZONE::SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const
+	{
+		etat.Ecrit(_reservoirAquifer);
+
+		etat.Ecrit(_dRayonnementSolaire);
+		etat.Ecrit(_dDureeJour);
+		etat.Ecrit(_dIndiceRadiation);
+		etat.Ecrit(_prJourIrrigation);
+
+		etat.Ecrit(_couvert_nival_m1);
+		etat.Ecrit(_couvert_nival_m2);
+		etat.Ecrit(_couvert_nival_m3);
+		etat.Ecrit(_apport_m1);
+		etat.Ecrit(_apport_m2);
+		etat.Ecrit(_apport_m3);
+		etat.Ecrit(_precip_m1);
+		etat.Ecrit(_precip_m2);
+		etat.Ecrit(_precip_m3);
+
+		etat.Ecrit(_vitesse_vent);
+		etat.Ecrit(_humidite_relative);
+		etat.Ecrit(_nb_heure_soleil);
+
+		etat.Ecrit(_iga);
+		etat.Ecrit(_hp);
+		etat.Ecrit(_indice_radiation);
+
+		etat.Ecrit(_apport_glacier);
+		etat.Ecrit(_eau_glacier);
+		etat.Ecrit(_infiltration);
+		etat.Ecrit(_profondeurGel);
+	}
+
+	void ZONE::LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur)
+	{
+		lecteur.Lit(_reservoirAquifer);
+
+		lecteur.Lit(_dRayonnementSolaire);
+		lecteur.Lit(_dDureeJour);
+		lecteur.Lit(_dIndiceRadiation);
+		lecteur.Lit(_prJourIrrigation);
+
+		lecteur.Lit(_couvert_nival_m1);
+		lecteur.Lit(_couvert_nival_m2);
+		lecteur.Lit(_couvert_nival_m3);
+		lecteur.Lit(_apport_m1);
+		lecteur.Lit(_apport_m2);
+		lecteur.Lit(_apport_m3);
+		lecteur.Lit(_precip_m1);
+		lecteur.Lit(_precip_m2);
+		lecteur.Lit(_precip_m3);
+
+		lecteur.Lit(_vitesse_vent);
+		lecteur.Lit(_humidite_relative);
+		lecteur.Lit(_nb_heure_soleil);
+
+		lecteur.Lit(_iga);
+		lecteur.Lit(_hp);
+		lecteur.Lit(_indice_radiation);
+
+		lecteur.Lit(_apport_glacier);
+		lecteur.Lit(_eau_glacier);
+		lecteur.Lit(_infiltration);
+		lecteur.Lit(_profondeurGel);
+	}
+
 }
@@ -22,6 +22,7 @@
 #define ZONE_H_INCLUDED
 
 
+#include "etat_zones.hpp"
 #include "types.hpp"
 #include "troncon.hpp"
 
@@ -146,6 +147,27 @@ namespace HYDROTEL
 		/// retourne la production total (mm)
 		float PrendreProductionTotal() const;
 
+		/// retourne la teneur en eau de la couche 1
+		float PrendreTheta1() const;
+
+		/// retourne la teneur en eau de la couche 2
+		float PrendreTheta2() const;
+
+		/// retourne la teneur en eau de la couche 3
+		float PrendreTheta3() const;
+
+		/// retourne l'ecoulement de surface vers le troncon (m3/s)
+		float PrendreEcoulementSurf() const;
+
+		/// retourne l'ecoulement hypodermique vers le troncon (m3/s)
+		float PrendreEcoulementHypo() const;
+
+		/// retourne l'ecoulement de base vers le troncon (m3/s)
+		float PrendreEcoulementBase() const;
+
+		/// retourne l'apport lateral du uhrh vers le troncon (m3/s)
+		float PrendreApportLateralUhrh() const;
+
 		/// retourne l'epaisseur de la couche 1 (m)
 		float PrendreZ11() const;
 		
@@ -250,6 +272,27 @@ namespace HYDROTEL
 		/// change la production de base (mm)
 		void ChangeProdBase(float base);
 
+		/// change la teneur en eau de la couche 1
+		void ChangeTheta1(float theta);
+
+		/// change la teneur en eau de la couche 2
+		void ChangeTheta2(float theta);
+
+		/// change la teneur en eau de la couche 3
+		void ChangeTheta3(float theta);
+
+		/// change l'ecoulement de surface vers le troncon (m3/s)
+		void ChangeEcoulementSurf(float ecoulement);
+
+		/// change l'ecoulement hypodermique vers le troncon (m3/s)
+		void ChangeEcoulementHypo(float ecoulement);
+
+		/// change l'ecoulement de base vers le troncon (m3/s)
+		void ChangeEcoulementBase(float ecoulement);
+
+		/// change l'apport lateral du uhrh vers le troncon (m3/s)
+		void ChangeApportLateralUhrh(float apport);
+
 		void ChangeInfiltration(float infiltration);
 
 		/// change les profondeurs des couches de sol (m)
@@ -258,19 +301,18 @@ namespace HYDROTEL
 		/// change la profondeur du gel au sol (cm)
 		void ChangeProfondeurGel(float fProfondeurGel);
 
-	public:
+		/// associe la zone a sa position dans le stockage des variables d'etat (ZONES)
+		void ChangeEtat(ETAT_ZONES* etat, size_t index);
 
-		float					_theta1;					//bilan vertical	//teneur en eau couche 1 pour le pas de temps courant
-		float					_theta2;					//bilan vertical	//teneur en eau couche 2 pour le pas de temps courant
-		float					_theta3;					//bilan vertical	//teneur en eau couche 3 pour le pas de temps courant
+		/// copie les variables d'etat propres a la zone (hors ETAT_ZONES) dans l'etat en memoire
+		void SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const;
 
-		float					_reservoirAquifer;			//m
+		/// restaure les variables d'etat propres a la zone
+		void LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur);
 
-		float					_ecoulementSurf;			//ecoulement vers le troncon (surface) (m3/s)
-		float					_ecoulementHypo;			//ecoulement vers le troncon (hypo) (m3/s)
-		float					_ecoulementBase;			//ecoulement vers le troncon (base) (m3/s)
+	public:
 
-		float                   _apport_lateral_uhrh;		//apport lateral du uhrh vers le troncon (m3/s)
+		float					_reservoirAquifer;			//m
 
 		int						_identABS;
 
@@ -309,42 +351,22 @@ namespace HYDROTEL
 		COORDONNEE	_centroide;			//centroide de la zone (long/lat wgs84) [decimal degree]
 		TRONCON*	_troncon_aval;
 
-		float		_tmin;					// C
-		float		_tmax;					// C
-		float		_pluie;					// mm
-		float		_neige;					// hauteur de precipitation en mm de neige (n'est pas un equivalent en eau)
+		ETAT_ZONES*	_etat;				//variables d'etat par pas de temps (tmin, tmax, pluie, neige, couvert nival, etp, etr, production, teneur en eau, ecoulements)
+		size_t		_index;				//index de la zone dans _etat
+
 		float		_vitesse_vent;			// m/s
 		float		_humidite_relative;
 		float		_nb_heure_soleil;			//h
 
-		float		_tmin_jour;				//C
-		float		_tmax_jour;				//C
-
-		std::vector<float> _etp;		// mm	//pour chaque classe d'occupation du sol
-
 		// variables de simulations
 
 		float _iga;						//rayonnement solaire sur une pente en l'absence d'atmosphere
 		float _hp;						//duree du jour sur une surface horizontale
 		float _indice_radiation;		//indice de radiation
 
-		float _couvert_nival;			//equivalent de la neige en eau //mm
-		float _hauteur_couvert_nival;   //m
-		float _albedo_neige;			//0-1
-
-		float _apport;					//mm	//neige, pluie
-
 		double _apport_glacier;			//mm
 		double _eau_glacier;			//m
 
-		float _etr1;					//mm
-		float _etr2;					//mm
-		float _etr3;					//mm
-
-		float _surf;					//mm
-		float _hypo;					//mm
-		float _base;					//mm
-
 		float _infiltration;
 
 		float _profondeurGel;			//cm		//profondeur du gel au sol		//calculer par le sous-modele TEMPSOL
@@ -137,6 +137,32 @@ namespace HYDROTEL
 		return *(_zones[index].get());
 	}
 
+	ETAT_ZONES& ZONES::PrendreEtat()
+	{
+		return _etat;
+	}
+
+	const ETAT_ZONES& ZONES::PrendreEtat() const
+	{
+		return _etat;
+	}
+
+	void ZONES::SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const
+	{
+		_etat.SauvegardeEtatMemoire(etat);
+
+		for (size_t index = 0; index < _zones.size(); ++index)
+			_zones[index]->SauvegardeEtatMemoire(etat);
+	}
+
+	void ZONES::LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur)
+	{
+		_etat.LectureEtatMemoire(lecteur);
+
+		for (size_t index = 0; index < _zones.size(); ++index)
+			_zones[index]->LectureEtatMemoire(lecteur);
+	}
+
 	void ZONES::DetruireZones()
 	{
 		_zones.clear();
@@ -176,9 +202,15 @@ namespace HYDROTEL
 			//SauvegardeResumer(nom_fichier_resumer_csv);	//doit etre effectue apres la lecture des troncons (type zone)
 		}
 
-		//obtient l'identifiant maximum
 		nbZone = _zones.size();
 
+		//variables d'etat des zones
+		_etat.Redimensionne(nbZone);
+		for(index=0; index!=nbZone; index++)
+			_zones[index].get()->ChangeEtat(&_etat, index);
+
+		//obtient l'identifiant maximum
+
 		identMax = 1;
 		for(index=0; index!=nbZone; index++)
 		{
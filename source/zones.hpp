@@ -95,6 +95,18 @@ namespace HYDROTEL
 		// retourne l'index de la zone	//ident recu en parametre doit etre positif pour les lacs
 		size_t IdentVersIndex(int ident) const;
 
+		// retourne les variables d'etat des zones (un tableau par variable, indexe par l'index de la zone)
+		ETAT_ZONES& PrendreEtat();
+
+		// retourne les variables d'etat des zones (un tableau par variable, indexe par l'index de la zone)
+		const ETAT_ZONES& PrendreEtat() const;
+
+		// copie les variables d'etat de toutes les zones dans l'etat en memoire
+		void SauvegardeEtatMemoire(ETAT_MEMOIRE& etat) const;
+
+		// restaure les variables d'etat de toutes les zones
+		void LectureEtatMemoire(LECTEUR_ETAT_MEMOIRE& lecteur);
+
 	public:
 
 		void SauvegardeResumer(const std::string& nom_fichier);
@@ -120,6 +132,8 @@ namespace HYDROTEL
 
 		std::vector<std::shared_ptr<ZONE>> _zones;
 
+		ETAT_ZONES _etat;
+
 		RASTER<int> _grille;
 
 		std::map<int, ZONE*> _map;